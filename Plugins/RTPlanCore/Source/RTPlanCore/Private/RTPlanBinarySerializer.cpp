@@ -0,0 +1,611 @@
+﻿#include "RTPlanBinarySerializer.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+#include "Misc/Compression.h"
+
+namespace RTPlanBinary
+{
+	enum EFileFlags : uint16
+	{
+		File_Compressed = 1 << 0
+	};
+
+	enum EWallFlags : uint8
+	{
+		Wall_IsArc = 1 << 0,
+		Wall_LeftSkirting = 1 << 1,
+		Wall_RightSkirting = 1 << 2,
+		Wall_CapSkirting = 1 << 3
+	};
+
+	enum EOpeningFlags : uint8
+	{
+		Opening_Flip = 1 << 0
+	};
+
+	enum EObjectFlags : uint8
+	{
+		Object_HasScale = 1 << 0
+	};
+
+	// --- Writing ---
+
+	/** Collects GUIDs / FNames while the body is written so they can be emitted once up-front. */
+	struct FTableBuilder
+	{
+		TArray<FGuid> Guids;
+		TMap<FGuid, uint32> GuidLookup;
+
+		TArray<FName> Names;
+		TMap<FName, uint32> NameLookup;
+
+		uint32 GuidIndex(const FGuid& Id)
+		{
+			if (!Id.IsValid())
+			{
+				return 0;
+			}
+			if (const uint32* Existing = GuidLookup.Find(Id))
+			{
+				return *Existing;
+			}
+			const uint32 Index = Guids.Add(Id) + 1;
+			GuidLookup.Add(Id, Index);
+			return Index;
+		}
+
+		uint32 NameIndex(FName Name)
+		{
+			if (Name.IsNone())
+			{
+				return 0;
+			}
+			if (const uint32* Existing = NameLookup.Find(Name))
+			{
+				return *Existing;
+			}
+			const uint32 Index = Names.Add(Name) + 1;
+			NameLookup.Add(Name, Index);
+			return Index;
+		}
+	};
+
+	static void WritePacked(FArchive& Ar, uint32 Value)
+	{
+		Ar.SerializeIntPacked(Value);
+	}
+
+	static void WriteFloat(FArchive& Ar, double Value)
+	{
+		float Packed = static_cast<float>(Value);
+		Ar << Packed;
+	}
+
+	static void WriteGuid(FArchive& Ar, FTableBuilder& Tables, const FGuid& Id)
+	{
+		WritePacked(Ar, Tables.GuidIndex(Id));
+	}
+
+	static void WriteName(FArchive& Ar, FTableBuilder& Tables, FName Name)
+	{
+		WritePacked(Ar, Tables.NameIndex(Name));
+	}
+
+	static void WriteBody(FArchive& Ar, const FRTPlanData& Data, FTableBuilder& Tables)
+	{
+		int32 DataVersion = Data.Version;
+		Ar << DataVersion;
+
+		WritePacked(Ar, Data.Vertices.Num());
+		for (const auto& Pair : Data.Vertices)
+		{
+			const FRTVertex& V = Pair.Value;
+			WriteGuid(Ar, Tables, V.Id);
+			WriteFloat(Ar, V.Position.X);
+			WriteFloat(Ar, V.Position.Y);
+		}
+
+		WritePacked(Ar, Data.Walls.Num());
+		for (const auto& Pair : Data.Walls)
+		{
+			const FRTWall& W = Pair.Value;
+			WriteGuid(Ar, Tables, W.Id);
+			WriteGuid(Ar, Tables, W.VertexAId);
+			WriteGuid(Ar, Tables, W.VertexBId);
+
+			uint8 Flags = 0;
+			if (W.bIsArc) Flags |= Wall_IsArc;
+			if (W.bHasLeftSkirting) Flags |= Wall_LeftSkirting;
+			if (W.bHasRightSkirting) Flags |= Wall_RightSkirting;
+			if (W.bHasCapSkirting) Flags |= Wall_CapSkirting;
+			Ar << Flags;
+
+			WriteFloat(Ar, W.ThicknessCm);
+			WriteFloat(Ar, W.HeightCm);
+			WriteFloat(Ar, W.BaseZCm);
+
+			// Arc data is meaningless for straight walls, skip it
+			if (W.bIsArc)
+			{
+				WriteFloat(Ar, W.ArcCenter.X);
+				WriteFloat(Ar, W.ArcCenter.Y);
+				WriteFloat(Ar, W.ArcSweepAngle);
+				WritePacked(Ar, static_cast<uint32>(FMath::Max(0, W.ArcNumSegments)));
+			}
+
+			WriteFloat(Ar, W.LeftSkirtingHeightCm);
+			WriteFloat(Ar, W.LeftSkirtingThicknessCm);
+			WriteFloat(Ar, W.RightSkirtingHeightCm);
+			WriteFloat(Ar, W.RightSkirtingThicknessCm);
+			WriteFloat(Ar, W.CapSkirtingHeightCm);
+			WriteFloat(Ar, W.CapSkirtingThicknessCm);
+
+			WriteName(Ar, Tables, W.FinishLeftId);
+			WriteName(Ar, Tables, W.FinishRightId);
+			WriteName(Ar, Tables, W.FinishCapsId);
+			WriteName(Ar, Tables, W.FinishLeftSkirtingId);
+			WriteName(Ar, Tables, W.FinishRightSkirtingId);
+			WriteName(Ar, Tables, W.FinishCapSkirtingId);
+		}
+
+		WritePacked(Ar, Data.Openings.Num());
+		for (const auto& Pair : Data.Openings)
+		{
+			const FRTOpening& O = Pair.Value;
+			WriteGuid(Ar, Tables, O.Id);
+			WriteGuid(Ar, Tables, O.WallId);
+
+			uint8 Type = static_cast<uint8>(O.Type);
+			uint8 Flags = O.bFlip ? Opening_Flip : 0;
+			Ar << Type;
+			Ar << Flags;
+
+			WriteFloat(Ar, O.OffsetCm);
+			WriteFloat(Ar, O.WidthCm);
+			WriteFloat(Ar, O.HeightCm);
+			WriteFloat(Ar, O.SillHeightCm);
+			WriteName(Ar, Tables, O.ProductTypeId);
+		}
+
+		WritePacked(Ar, Data.Objects.Num());
+		for (const auto& Pair : Data.Objects)
+		{
+			const FRTInteriorInstance& Obj = Pair.Value;
+			WriteGuid(Ar, Tables, Obj.Id);
+			WriteName(Ar, Tables, Obj.ProductTypeId);
+			WriteGuid(Ar, Tables, Obj.HostWallId);
+			WriteGuid(Ar, Tables, Obj.GeneratedByRunId);
+
+			uint8 HostType = static_cast<uint8>(Obj.HostType);
+			const FVector Scale = Obj.Transform.GetScale3D();
+			uint8 Flags = Scale.Equals(FVector::OneVector) ? 0 : Object_HasScale;
+			Ar << HostType;
+			Ar << Flags;
+
+			const FVector Location = Obj.Transform.GetLocation();
+			const FQuat Rotation = Obj.Transform.GetRotation();
+			WriteFloat(Ar, Location.X);
+			WriteFloat(Ar, Location.Y);
+			WriteFloat(Ar, Location.Z);
+			WriteFloat(Ar, Rotation.X);
+			WriteFloat(Ar, Rotation.Y);
+			WriteFloat(Ar, Rotation.Z);
+			WriteFloat(Ar, Rotation.W);
+			if (Flags & Object_HasScale)
+			{
+				WriteFloat(Ar, Scale.X);
+				WriteFloat(Ar, Scale.Y);
+				WriteFloat(Ar, Scale.Z);
+			}
+
+			WritePacked(Ar, Obj.Params.Num());
+			for (const auto& Param : Obj.Params)
+			{
+				WriteName(Ar, Tables, Param.Key);
+				FString Value = Param.Value;
+				Ar << Value;
+			}
+		}
+
+		WritePacked(Ar, Data.Runs.Num());
+		for (const auto& Pair : Data.Runs)
+		{
+			const FRTCabinetRun& R = Pair.Value;
+			WriteGuid(Ar, Tables, R.Id);
+			WriteGuid(Ar, Tables, R.HostWallId);
+			WriteFloat(Ar, R.StartOffsetCm);
+			WriteFloat(Ar, R.EndOffsetCm);
+			WriteFloat(Ar, R.DepthCm);
+			WriteFloat(Ar, R.HeightCm);
+			WriteName(Ar, Tables, R.StyleSetId);
+		}
+	}
+
+	static void WriteTables(FArchive& Ar, FTableBuilder& Tables)
+	{
+		WritePacked(Ar, Tables.Guids.Num());
+		for (FGuid& Id : Tables.Guids)
+		{
+			Ar << Id;
+		}
+
+		WritePacked(Ar, Tables.Names.Num());
+		for (const FName& Name : Tables.Names)
+		{
+			FString NameString = Name.ToString();
+			Ar << NameString;
+		}
+	}
+
+	// --- Reading ---
+
+	struct FTables
+	{
+		TArray<FGuid> Guids;
+		TArray<FName> Names;
+	};
+
+	static uint32 ReadPacked(FArchive& Ar)
+	{
+		uint32 Value = 0;
+		Ar.SerializeIntPacked(Value);
+		return Value;
+	}
+
+	// Counts are bounded by the remaining bytes so a corrupt file can't trigger a huge allocation
+	static bool ReadCount(FArchive& Ar, int32& OutCount)
+	{
+		const uint32 Count = ReadPacked(Ar);
+		if (Ar.IsError() || Count > static_cast<uint32>(Ar.TotalSize() - Ar.Tell()))
+		{
+			Ar.SetError();
+			return false;
+		}
+		OutCount = static_cast<int32>(Count);
+		return true;
+	}
+
+	static float ReadFloat(FArchive& Ar)
+	{
+		float Value = 0.0f;
+		Ar << Value;
+		return Value;
+	}
+
+	static FGuid ReadGuid(FArchive& Ar, const FTables& Tables)
+	{
+		const uint32 Index = ReadPacked(Ar);
+		if (Index == 0)
+		{
+			return FGuid();
+		}
+		if (!Tables.Guids.IsValidIndex(Index - 1))
+		{
+			Ar.SetError();
+			return FGuid();
+		}
+		return Tables.Guids[Index - 1];
+	}
+
+	static FName ReadName(FArchive& Ar, const FTables& Tables)
+	{
+		const uint32 Index = ReadPacked(Ar);
+		if (Index == 0)
+		{
+			return NAME_None;
+		}
+		if (!Tables.Names.IsValidIndex(Index - 1))
+		{
+			Ar.SetError();
+			return NAME_None;
+		}
+		return Tables.Names[Index - 1];
+	}
+
+	static bool ReadTables(FArchive& Ar, FTables& Tables)
+	{
+		int32 NumGuids = 0;
+		if (!ReadCount(Ar, NumGuids)) return false;
+		Tables.Guids.SetNumUninitialized(NumGuids);
+		for (FGuid& Id : Tables.Guids)
+		{
+			Ar << Id;
+		}
+
+		int32 NumNames = 0;
+		if (!ReadCount(Ar, NumNames)) return false;
+		Tables.Names.Reserve(NumNames);
+		for (int32 i = 0; i < NumNames && !Ar.IsError(); ++i)
+		{
+			FString NameString;
+			Ar << NameString;
+			Tables.Names.Add(FName(*NameString));
+		}
+
+		return !Ar.IsError();
+	}
+
+	static bool ReadBody(FArchive& Ar, const FTables& Tables, uint16 FileVersion, FRTPlanData& Data)
+	{
+		Ar << Data.Version;
+
+		int32 Num = 0;
+		if (!ReadCount(Ar, Num)) return false;
+		Data.Vertices.Reserve(Num);
+		for (int32 i = 0; i < Num && !Ar.IsError(); ++i)
+		{
+			FRTVertex V;
+			V.Id = ReadGuid(Ar, Tables);
+			V.Position.X = ReadFloat(Ar);
+			V.Position.Y = ReadFloat(Ar);
+			Data.Vertices.Add(V.Id, V);
+		}
+
+		if (!ReadCount(Ar, Num)) return false;
+		Data.Walls.Reserve(Num);
+		for (int32 i = 0; i < Num && !Ar.IsError(); ++i)
+		{
+			FRTWall W;
+			W.Id = ReadGuid(Ar, Tables);
+			W.VertexAId = ReadGuid(Ar, Tables);
+			W.VertexBId = ReadGuid(Ar, Tables);
+
+			uint8 Flags = 0;
+			Ar << Flags;
+			W.bIsArc = (Flags & Wall_IsArc) != 0;
+			W.bHasLeftSkirting = (Flags & Wall_LeftSkirting) != 0;
+			W.bHasRightSkirting = (Flags & Wall_RightSkirting) != 0;
+			W.bHasCapSkirting = (Flags & Wall_CapSkirting) != 0;
+
+			W.ThicknessCm = ReadFloat(Ar);
+			W.HeightCm = ReadFloat(Ar);
+			W.BaseZCm = ReadFloat(Ar);
+
+			if (W.bIsArc)
+			{
+				W.ArcCenter.X = ReadFloat(Ar);
+				W.ArcCenter.Y = ReadFloat(Ar);
+				W.ArcSweepAngle = ReadFloat(Ar);
+				W.ArcNumSegments = static_cast<int32>(ReadPacked(Ar));
+			}
+
+			W.LeftSkirtingHeightCm = ReadFloat(Ar);
+			W.LeftSkirtingThicknessCm = ReadFloat(Ar);
+			W.RightSkirtingHeightCm = ReadFloat(Ar);
+			W.RightSkirtingThicknessCm = ReadFloat(Ar);
+			W.CapSkirtingHeightCm = ReadFloat(Ar);
+			W.CapSkirtingThicknessCm = ReadFloat(Ar);
+
+			W.FinishLeftId = ReadName(Ar, Tables);
+			W.FinishRightId = ReadName(Ar, Tables);
+			W.FinishCapsId = ReadName(Ar, Tables);
+			W.FinishLeftSkirtingId = ReadName(Ar, Tables);
+			W.FinishRightSkirtingId = ReadName(Ar, Tables);
+			W.FinishCapSkirtingId = ReadName(Ar, Tables);
+
+			Data.Walls.Add(W.Id, W);
+		}
+
+		if (!ReadCount(Ar, Num)) return false;
+		Data.Openings.Reserve(Num);
+		for (int32 i = 0; i < Num && !Ar.IsError(); ++i)
+		{
+			FRTOpening O;
+			O.Id = ReadGuid(Ar, Tables);
+			O.WallId = ReadGuid(Ar, Tables);
+
+			uint8 Type = 0;
+			uint8 Flags = 0;
+			Ar << Type;
+			Ar << Flags;
+			O.Type = static_cast<ERTOpeningType>(FMath::Min<uint8>(Type, static_cast<uint8>(ERTOpeningType::Opening)));
+			O.bFlip = (Flags & Opening_Flip) != 0;
+
+			O.OffsetCm = ReadFloat(Ar);
+			O.WidthCm = ReadFloat(Ar);
+			O.HeightCm = ReadFloat(Ar);
+			O.SillHeightCm = ReadFloat(Ar);
+			O.ProductTypeId = ReadName(Ar, Tables);
+
+			Data.Openings.Add(O.Id, O);
+		}
+
+		if (!ReadCount(Ar, Num)) return false;
+		Data.Objects.Reserve(Num);
+		for (int32 i = 0; i < Num && !Ar.IsError(); ++i)
+		{
+			FRTInteriorInstance Obj;
+			Obj.Id = ReadGuid(Ar, Tables);
+			Obj.ProductTypeId = ReadName(Ar, Tables);
+			Obj.HostWallId = ReadGuid(Ar, Tables);
+			Obj.GeneratedByRunId = ReadGuid(Ar, Tables);
+
+			uint8 HostType = 0;
+			uint8 Flags = 0;
+			Ar << HostType;
+			Ar << Flags;
+			Obj.HostType = static_cast<ERTHostType>(FMath::Min<uint8>(HostType, static_cast<uint8>(ERTHostType::None)));
+
+			FVector Location;
+			Location.X = ReadFloat(Ar);
+			Location.Y = ReadFloat(Ar);
+			Location.Z = ReadFloat(Ar);
+
+			FQuat Rotation;
+			Rotation.X = ReadFloat(Ar);
+			Rotation.Y = ReadFloat(Ar);
+			Rotation.Z = ReadFloat(Ar);
+			Rotation.W = ReadFloat(Ar);
+
+			FVector Scale = FVector::OneVector;
+			if (Flags & Object_HasScale)
+			{
+				Scale.X = ReadFloat(Ar);
+				Scale.Y = ReadFloat(Ar);
+				Scale.Z = ReadFloat(Ar);
+			}
+
+			Obj.Transform = FTransform(Rotation.GetNormalized(), Location, Scale);
+
+			int32 NumParams = 0;
+			if (!ReadCount(Ar, NumParams)) return false;
+			for (int32 p = 0; p < NumParams && !Ar.IsError(); ++p)
+			{
+				const FName Key = ReadName(Ar, Tables);
+				FString Value;
+				Ar << Value;
+				Obj.Params.Add(Key, MoveTemp(Value));
+			}
+
+			Data.Objects.Add(Obj.Id, Obj);
+		}
+
+		if (!ReadCount(Ar, Num)) return false;
+		Data.Runs.Reserve(Num);
+		for (int32 i = 0; i < Num && !Ar.IsError(); ++i)
+		{
+			FRTCabinetRun R;
+			R.Id = ReadGuid(Ar, Tables);
+			R.HostWallId = ReadGuid(Ar, Tables);
+			R.StartOffsetCm = ReadFloat(Ar);
+			R.EndOffsetCm = ReadFloat(Ar);
+			R.DepthCm = ReadFloat(Ar);
+			R.HeightCm = ReadFloat(Ar);
+			R.StyleSetId = ReadName(Ar, Tables);
+			Data.Runs.Add(R.Id, R);
+		}
+
+		// Future versions append sections here, gated on FileVersion
+		(void)FileVersion;
+
+		return !Ar.IsError();
+	}
+}
+
+bool FRTPlanBinarySerializer::Save(const FRTPlanData& Data, TArray<uint8>& OutBytes, bool bCompress)
+{
+	using namespace RTPlanBinary;
+
+	// 1. Body first, so the tables know every GUID / FName that is referenced
+	FTableBuilder Tables;
+	TArray<uint8> Body;
+	{
+		FMemoryWriter BodyAr(Body);
+		WriteBody(BodyAr, Data, Tables);
+		if (BodyAr.IsError()) return false;
+	}
+
+	// 2. Payload = Tables + Body
+	TArray<uint8> Payload;
+	Payload.Reserve(Body.Num() + Tables.Guids.Num() * sizeof(FGuid) + 64);
+	{
+		FMemoryWriter PayloadAr(Payload);
+		WriteTables(PayloadAr, Tables);
+		PayloadAr.Serialize(Body.GetData(), Body.Num());
+		if (PayloadAr.IsError()) return false;
+	}
+
+	// 3. Optional compression (kept only if it actually helps, and only within the limits Load accepts)
+	uint16 Flags = 0;
+	int32 RawSize = Payload.Num();
+	TArray<uint8> Compressed;
+	if (bCompress && RawSize > 0 && RawSize <= MaxPayloadSize)
+	{
+		int32 CompressedSize = FCompression::CompressMemoryBound(NAME_Oodle, RawSize);
+		Compressed.SetNumUninitialized(CompressedSize);
+		if (FCompression::CompressMemory(NAME_Oodle, Compressed.GetData(), CompressedSize, Payload.GetData(), RawSize)
+			&& CompressedSize < RawSize
+			&& (int64)CompressedSize * MaxCompressionRatio >= RawSize)
+		{
+			Compressed.SetNum(CompressedSize);
+			Flags |= File_Compressed;
+		}
+	}
+
+	const TArray<uint8>& Stored = (Flags & File_Compressed) ? Compressed : Payload;
+	int32 StoredSize = Stored.Num();
+
+	// 4. Header + stored payload
+	OutBytes.Reset(StoredSize + 16);
+	FMemoryWriter Ar(OutBytes);
+
+	uint32 FileMagic = Magic;
+	uint16 Version = FormatVersion;
+	Ar << FileMagic;
+	Ar << Version;
+	Ar << Flags;
+	Ar << RawSize;
+	Ar << StoredSize;
+	Ar.Serialize(const_cast<uint8*>(Stored.GetData()), StoredSize);
+
+	return !Ar.IsError();
+}
+
+bool FRTPlanBinarySerializer::Load(const TArray<uint8>& Bytes, FRTPlanData& OutData)
+{
+	using namespace RTPlanBinary;
+
+	FMemoryReader Ar(Bytes);
+
+	uint32 FileMagic = 0;
+	uint16 Version = 0;
+	uint16 Flags = 0;
+	int32 RawSize = 0;
+	int32 StoredSize = 0;
+	Ar << FileMagic;
+	Ar << Version;
+	Ar << Flags;
+	Ar << RawSize;
+	Ar << StoredSize;
+
+	if (Ar.IsError() || FileMagic != Magic || Version == 0 || Version > FormatVersion)
+	{
+		return false;
+	}
+	if (RawSize < 0 || StoredSize < 0 || StoredSize != Bytes.Num() - Ar.Tell())
+	{
+		return false;
+	}
+
+	const uint8* StoredData = Bytes.GetData() + Ar.Tell();
+
+	TArray<uint8> Payload;
+	if (Flags & File_Compressed)
+	{
+		// RawSize comes from the file: bound it before allocating
+		if (RawSize > MaxPayloadSize || (int64)RawSize > (int64)StoredSize * MaxCompressionRatio)
+		{
+			return false;
+		}
+		Payload.SetNumUninitialized(RawSize);
+		if (!FCompression::UncompressMemory(NAME_Oodle, Payload.GetData(), RawSize, StoredData, StoredSize))
+		{
+			return false;
+		}
+	}
+	else
+	{
+		if (RawSize != StoredSize)
+		{
+			return false;
+		}
+		Payload.Append(StoredData, StoredSize);
+	}
+
+	FMemoryReader PayloadAr(Payload);
+
+	FTables Tables;
+	if (!ReadTables(PayloadAr, Tables))
+	{
+		return false;
+	}
+
+	FRTPlanData NewData;
+	if (!ReadBody(PayloadAr, Tables, Version, NewData))
+	{
+		return false;
+	}
+
+	OutData = MoveTemp(NewData);
+	return true;
+}
@@ -0,0 +1,56 @@
+﻿#include "RTPlanChangeLog.h"
+#include "Algo/BinarySearch.h"
+
+void FRTPlanChangeLog::Record(uint64 Revision, ERTPlanEntityKind Kind, const FGuid& Id, ERTPlanChangeType Type)
+{
+	if (Type == ERTPlanChangeType::Removed)
+	{
+		EntityRevisions.Remove(Id);
+	}
+	else
+	{
+		EntityRevisions.Add(Id, Revision);
+	}
+
+	Records.Add({ Revision, Id, Kind, Type });
+
+	// Drop the older half in one go so trimming stays amortized O(1)
+	if (Records.Num() > MaxRecords)
+	{
+		const int32 NumToDrop = Records.Num() / 2;
+		BaseRevision = Records[NumToDrop - 1].Revision;
+		Records.RemoveAt(0, NumToDrop, EAllowShrinking::No);
+	}
+}
+
+void FRTPlanChangeLog::Invalidate(uint64 Revision)
+{
+	Records.Reset();
+	EntityRevisions.Reset();
+	BaseRevision = Revision;
+}
+
+FRTPlanDelta FRTPlanChangeLog::GetChangedSince(uint64 SinceRevision) const
+{
+	if (SinceRevision < BaseRevision)
+	{
+		return FRTPlanDelta::MakeFullRebuild();
+	}
+
+	// First record newer than SinceRevision
+	const int32 First = Algo::UpperBoundBy(Records, SinceRevision, &FRTPlanChangeRecord::Revision);
+
+	FRTPlanDelta Delta;
+	for (int32 i = First; i < Records.Num(); ++i)
+	{
+		const FRTPlanChangeRecord& Change = Records[i];
+		Delta.Get(Change.Kind).Mark(Change.Type, Change.Id);
+	}
+	return Delta;
+}
+
+uint64 FRTPlanChangeLog::GetEntityRevision(const FGuid& Id) const
+{
+	const uint64* Revision = EntityRevisions.Find(Id);
+	return Revision ? *Revision : 0;
+}
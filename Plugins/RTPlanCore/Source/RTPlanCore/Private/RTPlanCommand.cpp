@@ -1,13 +1,20 @@
 ﻿#include "RTPlanCommand.h"
 #include "RTPlanDocument.h"
 
+// --- URTCommand ---
+
+SIZE_T URTCommand::GetAllocatedSize() const
+{
+	return GetClass()->GetStructureSize();
+}
+
 // --- URTCmdAddVertex ---
 
 bool URTCmdAddVertex::Execute()
 {
 	if (!Document) return false;
 
-	FRTPlanData& Data = Document->GetDataMutable();
+	const FRTPlanData& Data = Document->GetData();
 
 	if (Data.Vertices.Contains(Vertex.Id))
 	{
@@ -19,7 +26,7 @@ bool URTCmdAddVertex::Execute()
 		bIsNew = true;
 	}
 
-	Data.Vertices.Add(Vertex.Id, Vertex);
+	Document->SetVertex(Vertex);
 	return true;
 }
 
@@ -27,25 +34,35 @@ void URTCmdAddVertex::Undo()
 {
 	if (!Document) return;
 
-	FRTPlanData& Data = Document->GetDataMutable();
-
 	if (bIsNew)
 	{
-		Data.Vertices.Remove(Vertex.Id);
+		Document->RemoveVertex(Vertex.Id);
 	}
 	else
 	{
-		Data.Vertices.Add(PreviousVertex.Id, PreviousVertex);
+		Document->SetVertex(PreviousVertex);
 	}
 }
 
+bool URTCmdAddVertex::CanMergeWith(const URTCommand* Next) const
+{
+	// Only follow-up updates of the same vertex; the first command keeps the original state for Undo
+	const URTCmdAddVertex* NextCmd = Cast<URTCmdAddVertex>(Next);
+	return NextCmd && NextCmd->Vertex.Id == Vertex.Id && !NextCmd->bIsNew;
+}
+
+void URTCmdAddVertex::MergeWith(const URTCommand* Next)
+{
+	Vertex = CastChecked<URTCmdAddVertex>(Next)->Vertex;
+}
+
 // --- URTCmdAddWall ---
 
 bool URTCmdAddWall::Execute()
 {
 	if (!Document) return false;
 
-	FRTPlanData& Data = Document->GetDataMutable();
+	const FRTPlanData& Data = Document->GetData();
 
 	if (Data.Walls.Contains(Wall.Id))
 	{
@@ -57,7 +74,7 @@ bool URTCmdAddWall::Execute()
 		bIsNew = true;
 	}
 
-	Data.Walls.Add(Wall.Id, Wall);
+	Document->SetWall(Wall);
 	return true;
 }
 
@@ -65,42 +82,72 @@ void URTCmdAddWall::Undo()
 {
 	if (!Document) return;
 
-	FRTPlanData& Data = Document->GetDataMutable();
-
 	if (bIsNew)
 	{
-		Data.Walls.Remove(Wall.Id);
+		Document->RemoveWall(Wall.Id);
 	}
 	else
 	{
-		Data.Walls.Add(PreviousWall.Id, PreviousWall);
+		Document->SetWall(PreviousWall);
 	}
 }
 
+bool URTCmdAddWall::CanMergeWith(const URTCommand* Next) const
+{
+	const URTCmdAddWall* NextCmd = Cast<URTCmdAddWall>(Next);
+	return NextCmd && NextCmd->Wall.Id == Wall.Id && !NextCmd->bIsNew;
+}
+
+void URTCmdAddWall::MergeWith(const URTCommand* Next)
+{
+	Wall = CastChecked<URTCmdAddWall>(Next)->Wall;
+}
+
 // --- URTCmdDeleteWall ---
 
 bool URTCmdDeleteWall::Execute()
 {
 	if (!Document) return false;
 
-	FRTPlanData& Data = Document->GetDataMutable();
+	const FRTPlanData& Data = Document->GetData();
 
 	if (Data.Walls.Contains(WallId))
 	{
 		DeletedWall = Data.Walls[WallId];
-		Data.Walls.Remove(WallId);
+
+		// Cascade to hosted openings (copy the IDs, removal edits the index)
+		DeletedOpenings.Reset();
+		const TArray<FGuid> OpeningIds(Document->GetOpeningsOnWall(WallId));
+		for (const FGuid& OpeningId : OpeningIds)
+		{
+			if (const FRTOpening* Opening = Data.Openings.Find(OpeningId))
+			{
+				DeletedOpenings.Add(*Opening);
+				Document->RemoveOpening(OpeningId);
+			}
+		}
+
+		Document->RemoveWall(WallId);
 		return true;
 	}
 
 	return false;
 }
 
+SIZE_T URTCmdDeleteWall::GetAllocatedSize() const
+{
+	return Super::GetAllocatedSize() + DeletedOpenings.GetAllocatedSize();
+}
+
 void URTCmdDeleteWall::Undo()
 {
 	if (!Document) return;
 
-	FRTPlanData& Data = Document->GetDataMutable();
-	Data.Walls.Add(DeletedWall.Id, DeletedWall);
+	Document->SetWall(DeletedWall);
+	for (const FRTOpening& Opening : DeletedOpenings)
+	{
+		Document->SetOpening(Opening);
+	}
 }
 
 // --- URTCmdDeleteVertex ---
@@ -109,12 +156,12 @@ bool URTCmdDeleteVertex::Execute()
 {
 	if (!Document) return false;
 
-	FRTPlanData& Data = Document->GetDataMutable();
+	const FRTPlanData& Data = Document->GetData();
 
 	if (Data.Vertices.Contains(VertexId))
 	{
 		DeletedVertex = Data.Vertices[VertexId];
-		Data.Vertices.Remove(VertexId);
+		Document->RemoveVertex(VertexId);
 		return true;
 	}
 
@@ -125,8 +172,7 @@ void URTCmdDeleteVertex::Undo()
 {
 	if (!Document) return;
 
-	FRTPlanData& Data = Document->GetDataMutable();
-	Data.Vertices.Add(DeletedVertex.Id, DeletedVertex);
+	Document->SetVertex(DeletedVertex);
 }
 
 // --- URTCmdMacro ---
@@ -136,15 +182,22 @@ bool URTCmdMacro::Execute()
 	if (!Document) return false;
 
 	// Execute all commands in order
-	for (URTCommand* Cmd : Commands)
+	for (int32 i = 0; i < Commands.Num(); ++i)
 	{
+		URTCommand* Cmd = Commands[i];
 		if (Cmd)
 		{
 			Cmd->Document = Document;
 			if (!Cmd->Execute())
 			{
-				// If any command fails, we should probably rollback the ones that succeeded
-				// But for now, we'll just return false and leave it in a partial state (TODO: fix this)
+				// Roll back the ones that succeeded so the document is left untouched
+				for (int32 j = i - 1; j >= 0; --j)
+				{
+					if (Commands[j])
+					{
+						Commands[j]->Undo();
+					}
+				}
 				return false;
 			}
 		}
@@ -165,3 +218,38 @@ void URTCmdMacro::Undo()
 		}
 	}
 }
+
+SIZE_T URTCmdMacro::GetAllocatedSize() const
+{
+	SIZE_T Size = Super::GetAllocatedSize() + Commands.GetAllocatedSize() + Description.GetAllocatedSize();
+	for (const URTCommand* Cmd : Commands)
+	{
+		if (Cmd)
+		{
+			Size += Cmd->GetAllocatedSize();
+		}
+	}
+	return Size;
+}
+
+// --- URTCmdBatch ---
+
+bool URTCmdBatch::Execute()
+{
+	if (!Document || Edits.IsEmpty()) return false;
+
+	Edits.Apply(*Document);
+	return true;
+}
+
+void URTCmdBatch::Undo()
+{
+	if (!Document) return;
+
+	Edits.Revert(*Document);
+}
+
+SIZE_T URTCmdBatch::GetAllocatedSize() const
+{
+	return Super::GetAllocatedSize() + Edits.GetAllocatedSize() + Description.GetAllocatedSize();
+}
@@ -1,6 +1,9 @@
 ﻿#include "RTPlanCoreTests.h"
 #include "RTPlanDocument.h"
 #include "RTPlanCommand.h"
+#include "RTPlanBinarySerializer.h"
+#include "RTPlanSnapshot.h"
+#include "Async/Async.h"
 #include "Misc/AutomationTest.h"
 
 IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRTPlanCoreSerializationTest, "ArchVis.RTPlanCore.Serialization", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
@@ -71,3 +74,771 @@ bool FRTPlanCoreCommandTest::RunTest(const FString& Parameters)
 
 	return true;
 }
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRTPlanCoreDeltaTest, "ArchVis.RTPlanCore.Delta", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FRTPlanCoreDeltaTest::RunTest(const FString& Parameters)
+{
+	// 1. Coalescing rules
+	const FGuid IdA = FGuid::NewGuid();
+	const FGuid IdB = FGuid::NewGuid();
+
+	FRTPlanEntityChanges Changes;
+	Changes.MarkAdded(IdA);
+	Changes.MarkModified(IdA);
+	TestTrue("Add + Modify stays Added", Changes.Added.Contains(IdA) && Changes.Modified.Num() == 0);
+
+	Changes.MarkRemoved(IdA);
+	TestTrue("Add + Remove cancels out", Changes.IsEmpty());
+
+	Changes.MarkModified(IdB);
+	Changes.MarkRemoved(IdB);
+	TestTrue("Modify + Remove becomes Removed", Changes.Removed.Contains(IdB) && Changes.Modified.Num() == 0);
+
+	Changes.MarkAdded(IdB);
+	TestTrue("Remove + Add becomes Modified", Changes.Modified.Contains(IdB) && Changes.Removed.Num() == 0 && Changes.Added.Num() == 0);
+
+	// 2. Document records mutations and resets after broadcast
+	URTPlanDocument* Doc = NewObject<URTPlanDocument>();
+
+	FRTVertex V1;
+	V1.Id = FGuid::NewGuid();
+	Doc->SetVertex(V1);
+	TestTrue("Pending delta has added vertex", Doc->GetPendingDelta().Vertices.Added.Contains(V1.Id));
+	TestTrue("Vertex change does not affect objects", Doc->GetPendingDelta().Objects.IsEmpty());
+
+	Doc->BroadcastPendingChanges();
+	TestTrue("Pending delta reset after broadcast", Doc->GetPendingDelta().IsEmpty());
+
+	URTCmdDeleteVertex* Cmd = NewObject<URTCmdDeleteVertex>();
+	Cmd->VertexId = V1.Id;
+	Doc->SubmitCommand(Cmd);
+	TestTrue("Pending delta reset after command", Doc->GetPendingDelta().IsEmpty());
+	TestFalse("Vertex removed", Doc->GetData().Vertices.Contains(V1.Id));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRTPlanCoreBinarySerializationTest, "ArchVis.RTPlanCore.BinarySerialization", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FRTPlanCoreBinarySerializationTest::RunTest(const FString& Parameters)
+{
+	URTPlanDocument* Doc = NewObject<URTPlanDocument>();
+	FRTPlanData& Data = Doc->GetDataMutable();
+
+	FRTVertex V1;
+	V1.Id = FGuid::NewGuid();
+	V1.Position = FVector2D(100, 250.5);
+	FRTVertex V2;
+	V2.Id = FGuid::NewGuid();
+	V2.Position = FVector2D(600, 250.5);
+	Data.Vertices.Add(V1.Id, V1);
+	Data.Vertices.Add(V2.Id, V2);
+
+	FRTWall W1;
+	W1.Id = FGuid::NewGuid();
+	W1.VertexAId = V1.Id;
+	W1.VertexBId = V2.Id;
+	W1.ThicknessCm = 25.0f;
+	W1.bIsArc = true;
+	W1.ArcCenter = FVector2D(350, 0);
+	W1.ArcSweepAngle = -90.0f;
+	W1.ArcNumSegments = 24;
+	W1.bHasCapSkirting = false;
+	W1.FinishLeftId = FName("Paint_White");
+	W1.FinishRightId = FName("Paint_White");
+	Data.Walls.Add(W1.Id, W1);
+
+	FRTOpening O1;
+	O1.Id = FGuid::NewGuid();
+	O1.WallId = W1.Id;
+	O1.OffsetCm = 120.0f;
+	O1.Type = ERTOpeningType::Window;
+	O1.bFlip = true;
+	Data.Openings.Add(O1.Id, O1);
+
+	FRTInteriorInstance Obj;
+	Obj.Id = FGuid::NewGuid();
+	Obj.ProductTypeId = FName("Sofa");
+	Obj.Transform = FTransform(FRotator(0, 45, 0), FVector(10, 20, 0), FVector(1, 2, 1));
+	Obj.Params.Add(FName("Color"), TEXT("Blue"));
+	Data.Objects.Add(Obj.Id, Obj);
+
+	// Round-trip (compressed and raw)
+	for (const bool bCompress : { true, false })
+	{
+		const TArray<uint8> Bytes = Doc->ToBinary(bCompress);
+		TestTrue("Binary not empty", Bytes.Num() > 0);
+
+		URTPlanDocument* Doc2 = NewObject<URTPlanDocument>();
+		TestTrue("FromBinary returned true", Doc2->FromBinary(Bytes));
+
+		const FRTPlanData& Loaded = Doc2->GetData();
+		TestEqual("Vertex count", Loaded.Vertices.Num(), 2);
+		TestEqual("Wall count", Loaded.Walls.Num(), 1);
+		TestEqual("Opening count", Loaded.Openings.Num(), 1);
+		TestEqual("Object count", Loaded.Objects.Num(), 1);
+
+		if (const FRTVertex* LV = Loaded.Vertices.Find(V1.Id))
+		{
+			TestTrue("Vertex position", LV->Position.Equals(V1.Position, 0.01));
+		}
+
+		if (const FRTWall* LW = Loaded.Walls.Find(W1.Id))
+		{
+			TestEqual("Wall VertexB", LW->VertexBId, V2.Id);
+			TestTrue("Wall is arc", LW->bIsArc);
+			TestEqual("Wall sweep", LW->ArcSweepAngle, -90.0f);
+			TestEqual("Wall segments", LW->ArcNumSegments, 24);
+			TestFalse("Cap skirting flag", LW->bHasCapSkirting);
+			TestTrue("Left skirting flag", LW->bHasLeftSkirting);
+			TestEqual("Finish", LW->FinishLeftId, FName("Paint_White"));
+			TestTrue("Empty finish stays None", LW->FinishCapsId.IsNone());
+		}
+		else
+		{
+			AddError("Wall ID not found in deserialized data");
+		}
+
+		if (const FRTOpening* LO = Loaded.Openings.Find(O1.Id))
+		{
+			TestEqual("Opening host", LO->WallId, W1.Id);
+			TestEqual("Opening type", LO->Type, ERTOpeningType::Window);
+			TestTrue("Opening flip", LO->bFlip);
+		}
+
+		if (const FRTInteriorInstance* LObj = Loaded.Objects.Find(Obj.Id))
+		{
+			TestTrue("Object transform", LObj->Transform.Equals(Obj.Transform, 0.01));
+			TestEqual("Object param", LObj->Params.FindRef(FName("Color")), FString(TEXT("Blue")));
+			TestFalse("Manual object has no run", LObj->GeneratedByRunId.IsValid());
+		}
+	}
+
+	// Must be smaller than the JSON representation
+	TestTrue("Binary smaller than JSON", Doc->ToBinary().Num() < Doc->ToJson().Len());
+
+	// Garbage / truncated input is rejected and leaves the document untouched
+	TArray<uint8> Garbage = { 1, 2, 3, 4, 5, 6, 7, 8 };
+	TestFalse("Garbage rejected", Doc->FromBinary(Garbage));
+
+	TArray<uint8> Truncated = Doc->ToBinary(false);
+	Truncated.SetNum(Truncated.Num() / 2);
+	TestFalse("Truncated rejected", Doc->FromBinary(Truncated));
+
+	// Header cut off before the sizes
+	TArray<uint8> TruncatedHeader = Doc->ToBinary();
+	TruncatedHeader.SetNum(10);
+	TestFalse("Truncated header rejected", Doc->FromBinary(TruncatedHeader));
+
+	// Corrupt raw size (bytes 8..11): rejected before the payload buffer is allocated
+	TArray<uint8> HugeRawSize = Doc->ToBinary(true);
+	const int32 Huge = MAX_int32;
+	FMemory::Memcpy(HugeRawSize.GetData() + 8, &Huge, sizeof(Huge));
+	TestFalse("Oversized raw size rejected", Doc->FromBinary(HugeRawSize));
+
+	TestEqual("Document untouched", Doc->GetData().Walls.Num(), 1);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRTPlanCoreBinarySerializationBenchmarkTest, "ArchVis.RTPlanCore.BinarySerializationBenchmark", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FRTPlanCoreBinarySerializationBenchmarkTest::RunTest(const FString& Parameters)
+{
+	// 50k entities: 20k vertices chained by 20k walls, 5k openings, 5k objects
+	const int32 NumVertices = 20000;
+	const int32 NumOpenings = 5000;
+	const int32 NumObjects = 5000;
+	const double TargetSeconds = 0.1;
+
+	URTPlanDocument* Doc = NewObject<URTPlanDocument>();
+	FRTPlanData& Data = Doc->GetDataMutable();
+	FRandomStream Random(NumVertices);
+
+	TArray<FGuid> VertexIds;
+	for (int32 i = 0; i < NumVertices; ++i)
+	{
+		FRTVertex V;
+		V.Id = FGuid::NewGuid();
+		V.Position = FVector2D(Random.FRandRange(0.0f, 100000.0f), Random.FRandRange(0.0f, 100000.0f));
+		Data.Vertices.Add(V.Id, V);
+		VertexIds.Add(V.Id);
+	}
+
+	TArray<FGuid> WallIds;
+	for (int32 i = 0; i < NumVertices; ++i)
+	{
+		FRTWall W;
+		W.Id = FGuid::NewGuid();
+		W.VertexAId = VertexIds[i];
+		W.VertexBId = VertexIds[(i + 1) % NumVertices];
+		W.ThicknessCm = i % 3 ? 20.0f : 12.5f;
+		W.FinishLeftId = FName("Paint_White");
+		if (i % 10 == 0)
+		{
+			W.bIsArc = true;
+			W.ArcCenter = Data.Vertices[W.VertexAId].Position + FVector2D(100, 100);
+			W.ArcSweepAngle = 45.0f;
+		}
+		Data.Walls.Add(W.Id, W);
+		WallIds.Add(W.Id);
+	}
+
+	for (int32 i = 0; i < NumOpenings; ++i)
+	{
+		FRTOpening O;
+		O.Id = FGuid::NewGuid();
+		O.WallId = WallIds[i * 4];
+		O.OffsetCm = Random.FRandRange(0.0f, 300.0f);
+		O.Type = i % 2 ? ERTOpeningType::Window : ERTOpeningType::Door;
+		Data.Openings.Add(O.Id, O);
+	}
+
+	for (int32 i = 0; i < NumObjects; ++i)
+	{
+		FRTInteriorInstance Obj;
+		Obj.Id = FGuid::NewGuid();
+		Obj.ProductTypeId = i % 2 ? FName("Chair") : FName("Table");
+		Obj.Transform = FTransform(FRotator(0, Random.FRandRange(0.0f, 360.0f), 0), FVector(Random.FRandRange(0.0f, 100000.0f), Random.FRandRange(0.0f, 100000.0f), 0));
+		Data.Objects.Add(Obj.Id, Obj);
+	}
+	Doc->MarkFullRebuild();
+
+	URTPlanDocument* Loaded = NewObject<URTPlanDocument>();
+	for (const bool bCompress : { false, true })
+	{
+		// Best of a few runs keeps a busy machine from failing the target
+		double SaveSeconds = TNumericLimits<double>::Max();
+		double LoadSeconds = TNumericLimits<double>::Max();
+		TArray<uint8> Bytes;
+		for (int32 Run = 0; Run < 3; ++Run)
+		{
+			const double SaveStart = FPlatformTime::Seconds();
+			Bytes = Doc->ToBinary(bCompress);
+			SaveSeconds = FMath::Min(SaveSeconds, FPlatformTime::Seconds() - SaveStart);
+
+			const double LoadStart = FPlatformTime::Seconds();
+			TestTrue("FromBinary returned true", Loaded->FromBinary(Bytes));
+			LoadSeconds = FMath::Min(LoadSeconds, FPlatformTime::Seconds() - LoadStart);
+		}
+
+		AddInfo(FString::Printf(TEXT("%s: %d bytes, save %.2f ms, load %.2f ms"),
+			bCompress ? TEXT("Compressed") : TEXT("Raw"), Bytes.Num(), SaveSeconds * 1000.0, LoadSeconds * 1000.0));
+		TestEqual("Loaded entity count", Loaded->GetData().Vertices.Num() + Loaded->GetData().Walls.Num()
+			+ Loaded->GetData().Openings.Num() + Loaded->GetData().Objects.Num(), 2 * NumVertices + NumOpenings + NumObjects);
+
+#if !UE_BUILD_DEBUG
+		// Unoptimized builds only report the timings
+		TestTrue(FString::Printf(TEXT("%s save under %.0f ms"), bCompress ? TEXT("Compressed") : TEXT("Raw"), TargetSeconds * 1000.0), SaveSeconds < TargetSeconds);
+		TestTrue(FString::Printf(TEXT("%s load under %.0f ms"), bCompress ? TEXT("Compressed") : TEXT("Raw"), TargetSeconds * 1000.0), LoadSeconds < TargetSeconds);
+#endif
+	}
+
+	// Several times smaller than JSON even without compression
+	const double JsonStart = FPlatformTime::Seconds();
+	const FString Json = Doc->ToJson();
+	const double JsonSeconds = FPlatformTime::Seconds() - JsonStart;
+	const int32 RawSize = Doc->ToBinary(false).Num();
+	AddInfo(FString::Printf(TEXT("JSON: %d chars, save %.2f ms"), Json.Len(), JsonSeconds * 1000.0));
+	TestTrue("Raw binary at least 3x smaller than JSON", RawSize * 3 < Json.Len());
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRTPlanCoreDenseStoreTest, "ArchVis.RTPlanCore.DenseStore", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FRTPlanCoreDenseStoreTest::RunTest(const FString& Parameters)
+{
+	// 1. Slot map handles
+	TRTSlotMap<FRTVertex> Map;
+	FRTVertex V1; V1.Id = FGuid::NewGuid(); V1.Position = FVector2D(1, 0);
+	FRTVertex V2; V2.Id = FGuid::NewGuid(); V2.Position = FVector2D(2, 0);
+	FRTVertex V3; V3.Id = FGuid::NewGuid(); V3.Position = FVector2D(3, 0);
+
+	const FRTPlanHandle H1 = Map.Set(V1.Id, V1);
+	const FRTPlanHandle H2 = Map.Set(V2.Id, V2);
+	const FRTPlanHandle H3 = Map.Set(V3.Id, V3);
+	TestEqual("Slot map count", Map.Num(), 3);
+
+	Map.Remove(V1.Id);
+	TestEqual("Count after remove", Map.Num(), 2);
+	TestNull("Stale handle rejected", Map.Find(H1));
+	TestTrue("Swapped element still reachable", Map.Find(H3) && Map.Find(H3)->Position.X == 3.0);
+	TestTrue("Other handle unaffected", Map.Find(H2) && Map.Find(H2)->Position.X == 2.0);
+
+	const FRTPlanHandle H1b = Map.Set(V1.Id, V1);
+	TestTrue("Reused slot gets new generation", H1b != H1);
+	TestEqual("Overwrite keeps handle", Map.Set(V1.Id, V1), H1b);
+
+	// 2. Document keeps the store in sync
+	URTPlanDocument* Doc = NewObject<URTPlanDocument>();
+	Doc->SetVertex(V1);
+	Doc->SetVertex(V2);
+
+	FRTWall W1;
+	W1.Id = FGuid::NewGuid();
+	W1.VertexAId = V1.Id;
+	W1.VertexBId = V2.Id;
+	Doc->SetWall(W1);
+
+	int32 NumVisited = 0;
+	Doc->GetDenseStore().ForEachWall([&](const FRTWall& Wall, const FVector2D& A, const FVector2D& B)
+	{
+		++NumVisited;
+		TestEqual("Resolved A", A.X, 1.0);
+		TestEqual("Resolved B", B.X, 2.0);
+	});
+	TestEqual("One wall visited", NumVisited, 1);
+
+	// Vertex removed and re-added: wall re-resolves its endpoint
+	Doc->RemoveVertex(V2.Id);
+	NumVisited = 0;
+	Doc->GetDenseStore().ForEachWall([&](const FRTWall&, const FVector2D&, const FVector2D&) { ++NumVisited; });
+	TestEqual("Dangling wall skipped", NumVisited, 0);
+
+	Doc->SetVertex(V2);
+	NumVisited = 0;
+	Doc->GetDenseStore().ForEachWall([&](const FRTWall&, const FVector2D&, const FVector2D&) { ++NumVisited; });
+	TestEqual("Wall resolved again", NumVisited, 1);
+
+	// Wall added before its endpoint: resolved when the vertex arrives
+	FRTWall W2;
+	W2.Id = FGuid::NewGuid();
+	W2.VertexAId = V2.Id;
+	W2.VertexBId = V3.Id;
+	Doc->SetWall(W2);
+	NumVisited = 0;
+	Doc->GetDenseStore().ForEachWall([&](const FRTWall&, const FVector2D&, const FVector2D&) { ++NumVisited; });
+	TestEqual("Wall waiting for its vertex skipped", NumVisited, 1);
+
+	Doc->SetVertex(V3);
+	NumVisited = 0;
+	Doc->GetDenseStore().ForEachWall([&](const FRTWall&, const FVector2D&, const FVector2D&) { ++NumVisited; });
+	TestEqual("Waiting wall resolved", NumVisited, 2);
+
+	// Raw edits rebuild lazily
+	Doc->GetDataMutable().Walls.Remove(W1.Id);
+	TestEqual("Raw edit picked up", Doc->GetDenseStore().GetWalls().Num(), 1);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRTPlanCoreReverseIndexTest, "ArchVis.RTPlanCore.ReverseIndex", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FRTPlanCoreReverseIndexTest::RunTest(const FString& Parameters)
+{
+	URTPlanDocument* Doc = NewObject<URTPlanDocument>();
+
+	// Two walls sharing the corner vertex V2
+	FRTVertex V1; V1.Id = FGuid::NewGuid(); V1.Position = FVector2D(0, 0);
+	FRTVertex V2; V2.Id = FGuid::NewGuid(); V2.Position = FVector2D(500, 0);
+	FRTVertex V3; V3.Id = FGuid::NewGuid(); V3.Position = FVector2D(500, 500);
+	Doc->SetVertex(V1);
+	Doc->SetVertex(V2);
+	Doc->SetVertex(V3);
+
+	FRTWall W1; W1.Id = FGuid::NewGuid(); W1.VertexAId = V1.Id; W1.VertexBId = V2.Id;
+	FRTWall W2; W2.Id = FGuid::NewGuid(); W2.VertexAId = V2.Id; W2.VertexBId = V3.Id;
+	Doc->SetWall(W1);
+	Doc->SetWall(W2);
+
+	FRTOpening O1; O1.Id = FGuid::NewGuid(); O1.WallId = W1.Id;
+	Doc->SetOpening(O1);
+
+	TestEqual("Corner vertex has two walls", Doc->GetWallsAtVertex(V2.Id).Num(), 2);
+	TestEqual("End vertex has one wall", Doc->GetWallsAtVertex(V1.Id).Num(), 1);
+	TestEqual("Wall hosts one opening", Doc->GetOpeningsOnWall(W1.Id).Num(), 1);
+
+	// Re-pointing a wall moves it in the index
+	FRTWall W2Moved = W2;
+	W2Moved.VertexAId = V1.Id;
+	Doc->SetWall(W2Moved);
+	TestEqual("Corner vertex lost a wall", Doc->GetWallsAtVertex(V2.Id).Num(), 1);
+	TestEqual("Start vertex gained a wall", Doc->GetWallsAtVertex(V1.Id).Num(), 2);
+	Doc->SetWall(W2);
+
+	// Deleting a wall cascades to its openings; undo restores them
+	URTCmdDeleteWall* DelCmd = NewObject<URTCmdDeleteWall>();
+	DelCmd->WallId = W1.Id;
+	TestTrue("Delete wall", Doc->SubmitCommand(DelCmd));
+	TestFalse("Hosted opening deleted", Doc->GetData().Openings.Contains(O1.Id));
+	TestEqual("Index updated after delete", Doc->GetWallsAtVertex(V2.Id).Num(), 1);
+
+	Doc->Undo();
+	TestTrue("Opening restored", Doc->GetData().Openings.Contains(O1.Id));
+	TestEqual("Index restored after undo", Doc->GetOpeningsOnWall(W1.Id).Num(), 1);
+
+	// Raw edits rebuild the index lazily
+	Doc->GetDataMutable().Openings.Remove(O1.Id);
+	TestEqual("Raw edit picked up", Doc->GetOpeningsOnWall(W1.Id).Num(), 0);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRTPlanCoreTransactionTest, "ArchVis.RTPlanCore.Transactions", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FRTPlanCoreTransactionTest::RunTest(const FString& Parameters)
+{
+	URTPlanDocument* Doc = NewObject<URTPlanDocument>();
+
+	// 1. Wall + vertices commit as one undo step with one notification
+	FRTVertex V1; V1.Id = FGuid::NewGuid(); V1.Position = FVector2D(0, 0);
+	FRTVertex V2; V2.Id = FGuid::NewGuid(); V2.Position = FVector2D(500, 0);
+	FRTWall W1; W1.Id = FGuid::NewGuid(); W1.VertexAId = V1.Id; W1.VertexBId = V2.Id;
+	{
+		FRTPlanScopedTransaction Transaction(Doc, TEXT("Add Wall"));
+		URTCmdAddVertex* CmdV1 = NewObject<URTCmdAddVertex>(); CmdV1->Vertex = V1; Doc->SubmitCommand(CmdV1);
+		URTCmdAddVertex* CmdV2 = NewObject<URTCmdAddVertex>(); CmdV2->Vertex = V2; Doc->SubmitCommand(CmdV2);
+		TestTrue("Changes held until commit", Doc->GetPendingDelta().Vertices.Num() == 2);
+		URTCmdAddWall* CmdWall = NewObject<URTCmdAddWall>(); CmdWall->Wall = W1; Doc->SubmitCommand(CmdWall);
+		TestTrue("Commit", Transaction.Commit());
+	}
+	TestTrue("Delta broadcast on commit", Doc->GetPendingDelta().IsEmpty());
+	TestTrue("Wall exists", Doc->GetData().Walls.Contains(W1.Id));
+
+	Doc->Undo();
+	TestFalse("Single undo removes wall", Doc->GetData().Walls.Contains(W1.Id));
+	TestFalse("Single undo removes vertices", Doc->GetData().Vertices.Contains(V1.Id) || Doc->GetData().Vertices.Contains(V2.Id));
+	TestFalse("Nothing left to undo", Doc->CanUndo());
+
+	Doc->Redo();
+	TestTrue("Redo restores wall", Doc->GetData().Walls.Contains(W1.Id));
+
+	// 2. A failing command rolls back the whole (nested) transaction
+	FRTVertex V3; V3.Id = FGuid::NewGuid();
+	Doc->BeginTransaction(TEXT("Outer"));
+	{
+		URTCmdAddVertex* CmdV3 = NewObject<URTCmdAddVertex>(); CmdV3->Vertex = V3; Doc->SubmitCommand(CmdV3);
+
+		Doc->BeginTransaction(TEXT("Inner"));
+		URTCmdDeleteWall* BadCmd = NewObject<URTCmdDeleteWall>();
+		BadCmd->WallId = FGuid::NewGuid();
+		TestFalse("Deleting a missing wall fails", Doc->SubmitCommand(BadCmd));
+		TestFalse("Inner transaction reports failure", Doc->EndTransaction());
+		TestTrue("Still inside outer transaction", Doc->IsInTransaction());
+	}
+	TestFalse("Outer transaction rolled back", Doc->EndTransaction());
+	TestFalse("Rolled back vertex is gone", Doc->GetData().Vertices.Contains(V3.Id));
+	TestTrue("Earlier history intact", Doc->GetData().Walls.Contains(W1.Id));
+
+	// 2b. The failing command's own edits are reverted too
+	FRTVertex V4; V4.Id = FGuid::NewGuid();
+	Doc->BeginTransaction(TEXT("Partial Failure"));
+	{
+		URTCmdAddVertex* CmdV3 = NewObject<URTCmdAddVertex>(); CmdV3->Vertex = V3; Doc->SubmitCommand(CmdV3);
+
+		URTCmdTestFailAfterEdits* PartialCmd = NewObject<URTCmdTestFailAfterEdits>();
+		FRTVertex MovedV1 = V1; MovedV1.Position = FVector2D(-100, 50);
+		PartialCmd->Edits.SetVertex(MovedV1);
+		PartialCmd->Edits.SetVertex(V4);
+		PartialCmd->Edits.RemoveWall(W1.Id);
+		MovedV1.Position = FVector2D(-200, 50);
+		PartialCmd->Edits.SetVertex(MovedV1); // touched twice: the state before the first touch comes back
+		TestFalse("Partial command fails", Doc->SubmitCommand(PartialCmd));
+
+		TestTrue("Moved vertex restored right away", Doc->GetData().Vertices[V1.Id].Position.Equals(V1.Position));
+		TestFalse("Added vertex removed right away", Doc->GetData().Vertices.Contains(V4.Id));
+		TestTrue("Removed wall restored right away", Doc->GetData().Walls.Contains(W1.Id));
+		TestTrue("Earlier command of the transaction still applied", Doc->GetData().Vertices.Contains(V3.Id));
+	}
+	TestFalse("Transaction with partial failure rolled back", Doc->EndTransaction());
+	TestFalse("Earlier command rolled back", Doc->GetData().Vertices.Contains(V3.Id));
+	TestTrue("Vertex position intact", Doc->GetData().Vertices[V1.Id].Position.Equals(V1.Position));
+	TestFalse("No added vertex", Doc->GetData().Vertices.Contains(V4.Id));
+	TestTrue("Wall intact", Doc->GetData().Walls.Contains(W1.Id));
+	TestTrue("Topology intact", Doc->GetWallsAtVertex(V1.Id).Contains(W1.Id));
+	TestTrue("Dense store intact", Doc->GetDenseStore().GetWalls().Find(W1.Id) != nullptr);
+
+	// 3. Cancel
+	{
+		FRTPlanScopedTransaction Transaction(Doc, TEXT("Cancelled"));
+		URTCmdAddVertex* CmdV3 = NewObject<URTCmdAddVertex>(); CmdV3->Vertex = V3; Doc->SubmitCommand(CmdV3);
+		Transaction.Cancel();
+	}
+	TestFalse("Cancelled vertex is gone", Doc->GetData().Vertices.Contains(V3.Id));
+	TestFalse("Transaction closed", Doc->IsInTransaction());
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRTPlanCoreUndoHistoryTest, "ArchVis.RTPlanCore.UndoHistory", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FRTPlanCoreUndoHistoryTest::RunTest(const FString& Parameters)
+{
+	// 1. Ring buffer keeps order across growth and wrap-around
+	const int64 CommandSize = (int64)NewObject<URTCmdAddVertex>()->GetAllocatedSize();
+	TestTrue("Commands report a size", CommandSize > 0);
+
+	FRTPlanUndoHistory History;
+	History.SetMaxBytes(CommandSize * 10);
+
+	TArray<URTCommand*> Pushed;
+	for (int32 i = 0; i < 40; ++i)
+	{
+		URTCmdAddVertex* Cmd = NewObject<URTCmdAddVertex>();
+		Pushed.Add(Cmd);
+		History.Push(Cmd);
+	}
+	TestEqual("Evicted down to budget", History.Num(), 10);
+	TestEqual("Used bytes tracked", History.GetUsedBytes(), CommandSize * 10);
+	TestTrue("Newest first", History.GetFromNewest(0) == Pushed.Last());
+	TestTrue("Oldest kept is the 30th", History.GetFromNewest(9) == Pushed[30]);
+
+	TestTrue("Pop returns newest", History.Pop() == Pushed.Last());
+	TestEqual("Pop releases bytes", History.GetUsedBytes(), CommandSize * 9);
+
+	History.SetMaxBytes(CommandSize * 4);
+	TestEqual("Shrinking the budget evicts", History.Num(), 4);
+
+	History.SetMaxBytes(0);
+	TestEqual("Newest step always kept", History.Num(), 1);
+
+	// 2. Document uses the budget and keeps many steps
+	URTPlanDocument* Doc = NewObject<URTPlanDocument>();
+	for (int32 i = 0; i < 1000; ++i)
+	{
+		URTCmdAddVertex* Cmd = NewObject<URTCmdAddVertex>();
+		Cmd->Vertex.Id = FGuid::NewGuid();
+		Doc->SubmitCommand(Cmd);
+	}
+	TestEqual("Default budget keeps 1000 steps", Doc->GetNumUndoSteps(), 1000);
+
+	Doc->SetUndoMemoryBudget(CommandSize * 100);
+	TestEqual("Budget applied to document", Doc->GetNumUndoSteps(), 100);
+	TestTrue("Usage within budget", Doc->GetUndoMemoryUsage() <= CommandSize * 100);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRTPlanCoreGestureTest, "ArchVis.RTPlanCore.Gestures", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FRTPlanCoreGestureTest::RunTest(const FString& Parameters)
+{
+	URTPlanDocument* Doc = NewObject<URTPlanDocument>();
+
+	FRTVertex V1; V1.Id = FGuid::NewGuid(); V1.Position = FVector2D(0, 0);
+	URTCmdAddVertex* AddCmd = NewObject<URTCmdAddVertex>();
+	AddCmd->Vertex = V1;
+	Doc->SubmitCommand(AddCmd);
+	const int32 StepsBefore = Doc->GetNumUndoSteps();
+
+	// 1. A drag of 20 moves collapses into one history entry
+	Doc->BeginGesture(TEXT("Move Vertex"));
+	TestTrue("In gesture", Doc->IsInGesture());
+	for (int32 i = 1; i <= 20; ++i)
+	{
+		URTCmdAddVertex* MoveCmd = NewObject<URTCmdAddVertex>();
+		MoveCmd->Vertex = V1;
+		MoveCmd->Vertex.Position = FVector2D(i * 10.0f, 0);
+		Doc->SubmitCommand(MoveCmd);
+
+		TestTrue("Live update applied", Doc->GetData().Vertices[V1.Id].Position.Equals(FVector2D(i * 10.0f, 0)));
+		TestTrue("Live update broadcast immediately", Doc->GetPendingDelta().IsEmpty());
+	}
+	TestTrue("Gesture committed", Doc->EndGesture());
+	TestFalse("Gesture closed", Doc->IsInGesture());
+	TestEqual("Single undo entry", Doc->GetNumUndoSteps(), StepsBefore + 1);
+
+	Doc->Undo();
+	TestTrue("Undo restores position before drag", Doc->GetData().Vertices[V1.Id].Position.Equals(FVector2D(0, 0)));
+	Doc->Redo();
+	TestTrue("Redo applies final position", Doc->GetData().Vertices[V1.Id].Position.Equals(FVector2D(200, 0)));
+
+	// 2. Different entities are not merged
+	URTCmdAddVertex* MoveCmd = NewObject<URTCmdAddVertex>();
+	MoveCmd->Vertex = V1;
+	URTCmdAddVertex* OtherCmd = NewObject<URTCmdAddVertex>();
+	OtherCmd->Vertex.Id = FGuid::NewGuid();
+	OtherCmd->bIsNew = false;
+	TestFalse("Different IDs do not merge", MoveCmd->CanMergeWith(OtherCmd));
+
+	// 3. Cancelling reverts the drag without touching history
+	const int32 StepsAfter = Doc->GetNumUndoSteps();
+	Doc->BeginGesture(TEXT("Move Vertex"));
+	URTCmdAddVertex* CancelledCmd = NewObject<URTCmdAddVertex>();
+	CancelledCmd->Vertex = V1;
+	CancelledCmd->Vertex.Position = FVector2D(999, 999);
+	Doc->SubmitCommand(CancelledCmd);
+	Doc->CancelGesture();
+	TestTrue("Cancel reverts drag", Doc->GetData().Vertices[V1.Id].Position.Equals(FVector2D(200, 0)));
+	TestEqual("Cancel adds no history", Doc->GetNumUndoSteps(), StepsAfter);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRTPlanCoreEditListTest, "ArchVis.RTPlanCore.EditList", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FRTPlanCoreEditListTest::RunTest(const FString& Parameters)
+{
+	URTPlanDocument* Doc = NewObject<URTPlanDocument>();
+
+	// 1. 10k edits submit as one command / one undo step
+	const int32 NumVertices = 10000;
+	FRTPlanEditList Edits;
+	Edits.Reserve(NumVertices);
+	for (int32 i = 0; i < NumVertices; ++i)
+	{
+		FRTVertex V; V.Id = FGuid::NewGuid(); V.Position = FVector2D(i, 0);
+		Edits.SetVertex(V);
+	}
+	TestEqual("Edits recorded", Edits.Num(), NumVertices);
+
+	TestTrue("Submit batch", Doc->SubmitEdits(MoveTemp(Edits), TEXT("Import")));
+	TestEqual("All vertices added", Doc->GetData().Vertices.Num(), NumVertices);
+	TestEqual("One undo step", Doc->GetNumUndoSteps(), 1);
+
+	Doc->Undo();
+	TestEqual("Undo removes the batch", Doc->GetData().Vertices.Num(), 0);
+	Doc->Redo();
+	TestEqual("Redo re-applies the batch", Doc->GetData().Vertices.Num(), NumVertices);
+
+	// 2. Updates restore previous values; wall removal cascades to openings
+	FRTVertex A; A.Id = FGuid::NewGuid(); A.Position = FVector2D(0, 0);
+	FRTVertex B; B.Id = FGuid::NewGuid(); B.Position = FVector2D(100, 0);
+	FRTWall W; W.Id = FGuid::NewGuid(); W.VertexAId = A.Id; W.VertexBId = B.Id;
+	FRTOpening O; O.Id = FGuid::NewGuid(); O.WallId = W.Id;
+	Doc->SetVertex(A);
+	Doc->SetVertex(B);
+	Doc->SetWall(W);
+	Doc->SetOpening(O);
+	Doc->BroadcastPendingChanges();
+
+	FRTPlanEditList Edit2;
+	FRTVertex AMoved = A; AMoved.Position = FVector2D(-50, 0);
+	Edit2.SetVertex(AMoved);
+	Edit2.RemoveWall(W.Id);
+	Edit2.RemoveVertex(FGuid::NewGuid()); // Missing: ignored
+	TestTrue("Submit second batch", Doc->SubmitEdits(MoveTemp(Edit2), TEXT("Edit")));
+	TestFalse("Wall removed", Doc->GetData().Walls.Contains(W.Id));
+	TestFalse("Hosted opening removed", Doc->GetData().Openings.Contains(O.Id));
+
+	Doc->Undo();
+	TestTrue("Wall restored", Doc->GetData().Walls.Contains(W.Id));
+	TestTrue("Opening restored", Doc->GetData().Openings.Contains(O.Id));
+	TestTrue("Vertex position restored", Doc->GetData().Vertices[A.Id].Position.Equals(A.Position));
+	TestEqual("Reverse index restored", Doc->GetOpeningsOnWall(W.Id).Num(), 1);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRTPlanCoreSnapshotTest, "ArchVis.RTPlanCore.Snapshots", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FRTPlanCoreSnapshotTest::RunTest(const FString& Parameters)
+{
+	URTPlanDocument* Doc = NewObject<URTPlanDocument>();
+
+	FRTVertex V1; V1.Id = FGuid::NewGuid(); V1.Position = FVector2D(0, 0);
+	FRTVertex V2; V2.Id = FGuid::NewGuid(); V2.Position = FVector2D(100, 0);
+	Doc->SetVertex(V1);
+	Doc->SetVertex(V2);
+
+	const uint64 Rev1 = Doc->GetRevision();
+	FRTPlanSnapshotRef Snap1 = Doc->GetSnapshot();
+	TestEqual("Snapshot revision", Snap1->Revision, Rev1);
+	TestEqual("Snapshot content", Snap1->Vertices.Num(), 2);
+	TestTrue("Unchanged document reuses snapshot", &Doc->GetSnapshot().Get() == &Snap1.Get());
+
+	// Edit after the snapshot: old snapshot is unaffected, unchanged entities are shared
+	FRTVertex V1Moved = V1; V1Moved.Position = FVector2D(50, 50);
+	Doc->SetVertex(V1Moved);
+	Doc->BroadcastPendingChanges();
+	TestTrue("Revision increases", Doc->GetRevision() > Rev1);
+
+	FRTPlanSnapshotRef Snap2 = Doc->GetSnapshot();
+	TestTrue("Old snapshot immutable", Snap1->FindVertex(V1.Id)->Position.Equals(FVector2D(0, 0)));
+	TestTrue("New snapshot sees edit", Snap2->FindVertex(V1.Id)->Position.Equals(FVector2D(50, 50)));
+	TestTrue("Unchanged entity shared", Snap1->FindVertex(V2.Id) == Snap2->FindVertex(V2.Id));
+
+	// Pending (not yet broadcast) edits and removals are included
+	Doc->RemoveVertex(V2.Id);
+	FRTPlanSnapshotRef Snap3 = Doc->GetSnapshot();
+	TestNull("Removed entity gone", Snap3->FindVertex(V2.Id));
+	TestNotNull("Old snapshot keeps it", Snap2->FindVertex(V2.Id));
+
+	// Snapshot -> add -> snapshot -> remove -> snapshot: every change is applied exactly once
+	FRTWall Wall; Wall.Id = FGuid::NewGuid(); Wall.VertexAId = V1.Id; Wall.VertexBId = V2.Id;
+	Doc->SetWall(Wall);
+	TestNotNull("Added wall in snapshot", Doc->GetSnapshot()->FindWall(Wall.Id));
+	Doc->BroadcastPendingChanges();
+	Doc->RemoveWall(Wall.Id);
+	Doc->BroadcastPendingChanges();
+	TestNull("Removed wall gone from snapshot", Doc->GetSnapshot()->FindWall(Wall.Id));
+
+	// A gesture broadcasts every step and then the net change; the snapshot still sees each change once
+	Doc->GetSnapshot();
+	Doc->BeginGesture(TEXT("Add Wall"));
+	URTCmdAddWall* AddWallCmd = NewObject<URTCmdAddWall>();
+	AddWallCmd->Wall = Wall;
+	Doc->SubmitCommand(AddWallCmd);
+	TestTrue("Gesture committed", Doc->EndGesture());
+	TestNotNull("Gesture wall in snapshot", Doc->GetSnapshot()->FindWall(Wall.Id));
+	Doc->RemoveWall(Wall.Id);
+	Doc->BroadcastPendingChanges();
+	TestNull("Wall removed after the gesture gone from snapshot", Doc->GetSnapshot()->FindWall(Wall.Id));
+
+	// Raw edits force a full copy
+	Doc->GetDataMutable().Vertices.Empty();
+	TestEqual("Raw edit picked up", Doc->GetSnapshot()->Vertices.Num(), 0);
+
+	// Readable from a worker thread while the document keeps changing
+	TFuture<int32> Future = Async(EAsyncExecution::ThreadPool, [Snap2]()
+	{
+		return Snap2->ToData().Vertices.Num();
+	});
+	Doc->SetVertex(V1);
+	TestEqual("Worker reads snapshot", Future.Get(), 2);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRTPlanCoreChangeTrackingTest, "ArchVis.RTPlanCore.ChangeTracking", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FRTPlanCoreChangeTrackingTest::RunTest(const FString& Parameters)
+{
+	URTPlanDocument* Doc = NewObject<URTPlanDocument>();
+
+	FRTVertex V1; V1.Id = FGuid::NewGuid();
+	FRTVertex V2; V2.Id = FGuid::NewGuid();
+	Doc->SetVertex(V1);
+	const uint64 RevAfterV1 = Doc->GetRevision();
+	Doc->SetVertex(V2);
+	Doc->BroadcastPendingChanges();
+
+	TestEqual("Entity revision of V1", Doc->GetEntityRevision(V1.Id), RevAfterV1);
+	TestTrue("V2 modified later", Doc->GetEntityRevision(V2.Id) > RevAfterV1);
+	TestEqual("Unknown entity", Doc->GetEntityRevision(FGuid::NewGuid()), (uint64)0);
+
+	// A cache synced at RevAfterV1 catches up on everything after it, even across broadcasts
+	const uint64 Synced = RevAfterV1;
+	FRTWall W; W.Id = FGuid::NewGuid(); W.VertexAId = V1.Id; W.VertexBId = V2.Id;
+	Doc->SetWall(W);
+	Doc->BroadcastPendingChanges();
+	Doc->RemoveVertex(V2.Id);
+
+	FRTPlanDelta Changes = Doc->GetChangedSince(Synced);
+	TestFalse("Not a full rebuild", Changes.bFullRebuild);
+	TestTrue("Wall added", Changes.Walls.Added.Contains(W.Id));
+	TestTrue("Add + Remove cancels out", !Changes.Vertices.Contains(V2.Id));
+	TestFalse("V1 unchanged since sync", Changes.Vertices.Contains(V1.Id));
+	TestTrue("Nothing changed since now", Doc->GetChangedSince(Doc->GetRevision()).IsEmpty());
+
+	// Untracked raw edits invalidate older history
+	const uint64 BeforeRaw = Doc->GetRevision();
+	Doc->GetDataMutable();
+	TestTrue("Raw edit forces full rebuild", Doc->GetChangedSince(BeforeRaw).bFullRebuild);
+	TestEqual("Untouched entity reports base revision", Doc->GetEntityRevision(V1.Id), Doc->GetRevision());
+
+	// Trimming old history
+	FRTPlanChangeLog Log;
+	Log.SetMaxRecords(8);
+	for (uint64 Rev = 1; Rev <= 20; ++Rev)
+	{
+		Log.Record(Rev, ERTPlanEntityKind::Vertex, FGuid::NewGuid(), ERTPlanChangeType::Added);
+	}
+	TestTrue("Log bounded", Log.Num() <= 8);
+	TestTrue("Trimmed history forces full rebuild", Log.GetChangedSince(1).bFullRebuild);
+	TestEqual("Recent history incremental", Log.GetChangedSince(18).Vertices.Added.Num(), 2);
+
+	return true;
+}
@@ -0,0 +1,137 @@
+﻿#include "RTPlanDelta.h"
+
+// --- FRTPlanEntityChanges ---
+
+void FRTPlanEntityChanges::MarkAdded(const FGuid& Id)
+{
+	// Removed then re-added in the same change-set is a modification
+	if (Removed.Remove(Id) > 0)
+	{
+		Modified.Add(Id);
+		return;
+	}
+
+	Added.Add(Id);
+}
+
+void FRTPlanEntityChanges::MarkModified(const FGuid& Id)
+{
+	// New entities stay "Added" no matter how often they are edited afterwards
+	if (Added.Contains(Id))
+	{
+		return;
+	}
+
+	Modified.Add(Id);
+}
+
+void FRTPlanEntityChanges::MarkRemoved(const FGuid& Id)
+{
+	// Added then removed in the same change-set: net effect is nothing
+	if (Added.Remove(Id) > 0)
+	{
+		return;
+	}
+
+	Modified.Remove(Id);
+	Removed.Add(Id);
+}
+
+void FRTPlanEntityChanges::Mark(ERTPlanChangeType Type, const FGuid& Id)
+{
+	switch (Type)
+	{
+	case ERTPlanChangeType::Added:    MarkAdded(Id); break;
+	case ERTPlanChangeType::Modified: MarkModified(Id); break;
+	case ERTPlanChangeType::Removed:  MarkRemoved(Id); break;
+	}
+}
+
+void FRTPlanEntityChanges::Append(const FRTPlanEntityChanges& Other)
+{
+	for (const FGuid& Id : Other.Removed)
+	{
+		MarkRemoved(Id);
+	}
+	for (const FGuid& Id : Other.Added)
+	{
+		MarkAdded(Id);
+	}
+	for (const FGuid& Id : Other.Modified)
+	{
+		MarkModified(Id);
+	}
+}
+
+void FRTPlanEntityChanges::Reset()
+{
+	Added.Reset();
+	Modified.Reset();
+	Removed.Reset();
+}
+
+// --- FRTPlanDelta ---
+
+FRTPlanEntityChanges& FRTPlanDelta::Get(ERTPlanEntityKind Kind)
+{
+	switch (Kind)
+	{
+	case ERTPlanEntityKind::Vertex:  return Vertices;
+	case ERTPlanEntityKind::Wall:    return Walls;
+	case ERTPlanEntityKind::Opening: return Openings;
+	case ERTPlanEntityKind::Object:  return Objects;
+	case ERTPlanEntityKind::Run:
+	default:                         return Runs;
+	}
+}
+
+const FRTPlanEntityChanges& FRTPlanDelta::Get(ERTPlanEntityKind Kind) const
+{
+	return const_cast<FRTPlanDelta*>(this)->Get(Kind);
+}
+
+void FRTPlanDelta::Append(const FRTPlanDelta& Other)
+{
+	Vertices.Append(Other.Vertices);
+	Walls.Append(Other.Walls);
+	Openings.Append(Other.Openings);
+	Objects.Append(Other.Objects);
+	Runs.Append(Other.Runs);
+	bFullRebuild |= Other.bFullRebuild;
+}
+
+bool FRTPlanDelta::IsEmpty() const
+{
+	return !bFullRebuild
+		&& Vertices.IsEmpty()
+		&& Walls.IsEmpty()
+		&& Openings.IsEmpty()
+		&& Objects.IsEmpty()
+		&& Runs.IsEmpty();
+}
+
+bool FRTPlanDelta::AffectsWallGeometry() const
+{
+	return bFullRebuild
+		|| !Vertices.IsEmpty()
+		|| !Walls.IsEmpty()
+		|| !Openings.IsEmpty();
+}
+
+void FRTPlanDelta::Reset()
+{
+	Vertices.Reset();
+	Walls.Reset();
+	Openings.Reset();
+	Objects.Reset();
+	Runs.Reset();
+	bFullRebuild = false;
+	bInteractive = false;
+}
+
+FRTPlanDelta FRTPlanDelta::MakeFullRebuild()
+{
+	FRTPlanDelta Delta;
+	Delta.bFullRebuild = true;
+	return Delta;
+}
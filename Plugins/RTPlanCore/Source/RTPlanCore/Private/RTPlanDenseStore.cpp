@@ -0,0 +1,124 @@
+﻿#include "RTPlanDenseStore.h"
+
+void FRTPlanDenseStore::Rebuild(const FRTPlanData& Data)
+{
+	Reset();
+
+	Vertices.Reserve(Data.Vertices.Num());
+	Walls.Reserve(Data.Walls.Num());
+	Openings.Reserve(Data.Openings.Num());
+	Objects.Reserve(Data.Objects.Num());
+	Runs.Reserve(Data.Runs.Num());
+
+	// Vertices first so walls resolve their handles directly
+	for (const auto& Pair : Data.Vertices)
+	{
+		Vertices.Set(Pair.Key, Pair.Value);
+	}
+	for (const auto& Pair : Data.Walls)
+	{
+		SetWall(Pair.Value);
+	}
+	for (const auto& Pair : Data.Openings)
+	{
+		Openings.Set(Pair.Key, Pair.Value);
+	}
+	for (const auto& Pair : Data.Objects)
+	{
+		Objects.Set(Pair.Key, Pair.Value);
+	}
+	for (const auto& Pair : Data.Runs)
+	{
+		Runs.Set(Pair.Key, Pair.Value);
+	}
+}
+
+void FRTPlanDenseStore::Reset()
+{
+	Vertices.Reset();
+	Walls.Reset();
+	Openings.Reset();
+	Objects.Reset();
+	Runs.Reset();
+	WallsAwaitingVertex.Reset();
+}
+
+void FRTPlanDenseStore::SetVertex(const FRTVertex& Vertex)
+{
+	const FRTPlanHandle Handle = Vertices.Set(Vertex.Id, Vertex);
+
+	// A new vertex may be the missing endpoint of existing walls
+	TArray<FGuid, TInlineAllocator<4>> Waiting;
+	if (WallsAwaitingVertex.RemoveAndCopyValue(Vertex.Id, Waiting))
+	{
+		for (const FGuid& WallId : Waiting)
+		{
+			if (FRTPlanDenseWall* Entry = Walls.Find(WallId))
+			{
+				if (Entry->Wall.VertexAId == Vertex.Id)
+				{
+					Entry->VertexA = Handle;
+				}
+				if (Entry->Wall.VertexBId == Vertex.Id)
+				{
+					Entry->VertexB = Handle;
+				}
+			}
+		}
+	}
+}
+
+void FRTPlanDenseStore::RemoveVertex(const FGuid& Id, TConstArrayView<FGuid> WallsAtVertex)
+{
+	if (!Vertices.Remove(Id))
+	{
+		return;
+	}
+
+	// Drop the handles explicitly: the slot's generation may wrap around and make them look valid again
+	for (const FGuid& WallId : WallsAtVertex)
+	{
+		if (FRTPlanDenseWall* Entry = Walls.Find(WallId))
+		{
+			if (Entry->Wall.VertexAId == Id)
+			{
+				Entry->VertexA = FRTPlanHandle();
+			}
+			if (Entry->Wall.VertexBId == Id)
+			{
+				Entry->VertexB = FRTPlanHandle();
+			}
+			AwaitVertex(Id, WallId);
+		}
+	}
+}
+
+void FRTPlanDenseStore::SetWall(const FRTWall& Wall)
+{
+	FRTPlanDenseWall Entry;
+	Entry.Wall = Wall;
+	Entry.VertexA = Vertices.GetHandle(Wall.VertexAId);
+	Entry.VertexB = Vertices.GetHandle(Wall.VertexBId);
+
+	if (!Entry.VertexA.IsValid())
+	{
+		AwaitVertex(Wall.VertexAId, Wall.Id);
+	}
+	if (!Entry.VertexB.IsValid() && Wall.VertexBId != Wall.VertexAId)
+	{
+		AwaitVertex(Wall.VertexBId, Wall.Id);
+	}
+
+	Walls.Set(Wall.Id, Entry);
+}
+
+void FRTPlanDenseStore::RemoveWall(const FGuid& Id)
+{
+	Walls.Remove(Id);
+}
+
+void FRTPlanDenseStore::AwaitVertex(const FGuid& VertexId, const FGuid& WallId)
+{
+	TArray<FGuid, TInlineAllocator<4>>& Waiting = WallsAwaitingVertex.FindOrAdd(VertexId);
+	Waiting.AddUnique(WallId);
+}
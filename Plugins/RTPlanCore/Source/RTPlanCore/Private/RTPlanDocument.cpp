@@ -1,5 +1,7 @@
 ﻿#include "RTPlanDocument.h"
 #include "RTPlanCommand.h"
+#include "RTPlanBinarySerializer.h"
+#include "RTPlanSnapshot.h"
 #include "JsonObjectConverter.h"
 
 URTPlanDocument::URTPlanDocument()
@@ -15,58 +17,542 @@ bool URTPlanDocument::SubmitCommand(URTCommand* Command)
 
 	Command->Document = this;
 
-	if (Command->Execute())
+	// Inside a transaction: execute now, record in the transaction macro, notify on commit
+	if (ActiveTransaction)
 	{
-		UndoStack.Add(Command);
-		
-		// Clear redo stack on new action
-		RedoStack.Empty();
+		// Journal the command's edits; the transaction only records commands that succeeded
+		ResetCommandJournal();
+		bJournalCommand = true;
+		const bool bExecuted = Command->Execute();
+		bJournalCommand = false;
 
-		// Limit stack size
-		if (UndoStack.Num() > MaxUndoSteps)
+		if (bExecuted)
 		{
-			UndoStack.RemoveAt(0);
+			ResetCommandJournal();
+
+			// Coalesce repeated edits of the same entity into one history entry
+			URTCommand* Last = ActiveTransaction->Commands.Num() > 0 ? ActiveTransaction->Commands.Last().Get() : nullptr;
+			if (Last && Last->CanMergeWith(Command))
+			{
+				Last->MergeWith(Command);
+			}
+			else
+			{
+				ActiveTransaction->Commands.Add(Command);
+			}
+
+			if (bLiveGesture)
+			{
+				// Lightweight live notification; the net change is re-sent when the gesture ends
+				GestureDelta.Append(PendingDelta);
+				PendingDelta.bInteractive = true;
+				BroadcastPendingChanges();
+			}
+			return true;
 		}
 
-		OnPlanChanged.Broadcast();
+		// Revert whatever the failed command applied before giving up, then poison the transaction;
+		// the commands before it are rolled back when the outermost scope ends
+		RevertCommandJournal();
+		bTransactionFailed = true;
+		return false;
+	}
+
+	if (Command->Execute())
+	{
+		PushUndo(Command);
+		BroadcastPendingChanges();
 		return true;
 	}
 
+	// A failed command may still have applied part of its work
+	BroadcastPendingChanges();
 	return false;
 }
 
+bool URTPlanDocument::SubmitEdits(FRTPlanEditList&& Edits, const FString& Description)
+{
+	URTCmdBatch* Batch = NewObject<URTCmdBatch>(this);
+	Batch->Edits = MoveTemp(Edits);
+	Batch->Description = Description;
+	return SubmitCommand(Batch);
+}
+
+void URTPlanDocument::PushUndo(URTCommand* Command)
+{
+	UndoHistory.Push(Command);
+	
+	// Clear redo stack on new action
+	RedoStack.Empty();
+}
+
+void URTPlanDocument::SetUndoMemoryBudget(int64 MaxBytes)
+{
+	UndoHistory.SetMaxBytes(MaxBytes);
+}
+
+// --- Transactions ---
+
+void URTPlanDocument::BeginTransaction(const FString& Description)
+{
+	if (TransactionDepth++ > 0)
+	{
+		// Nested: everything folds into the outermost transaction
+		return;
+	}
+
+	ActiveTransaction = NewObject<URTCmdMacro>(this);
+	ActiveTransaction->Document = this;
+	ActiveTransaction->Description = Description;
+	bTransactionFailed = false;
+}
+
+void URTPlanDocument::BeginGesture(const FString& Description)
+{
+	const bool bOutermost = TransactionDepth == 0;
+	BeginTransaction(Description);
+
+	// Nested in another transaction: behaves as a plain nested transaction
+	if (bOutermost)
+	{
+		bLiveGesture = true;
+		GestureDelta.Reset();
+	}
+}
+
+bool URTPlanDocument::EndTransaction()
+{
+	if (!ensureMsgf(TransactionDepth > 0, TEXT("EndTransaction without matching BeginTransaction")))
+	{
+		return false;
+	}
+
+	if (--TransactionDepth > 0)
+	{
+		return !bTransactionFailed;
+	}
+
+	URTCmdMacro* Transaction = ActiveTransaction;
+	ActiveTransaction = nullptr;
+
+	const bool bCommitted = !bTransactionFailed;
+	bTransactionFailed = false;
+
+	if (!bCommitted)
+	{
+		// Roll back everything that did execute, newest first
+		Transaction->Undo();
+	}
+	else if (Transaction->Commands.Num() == 1)
+	{
+		// No need for a macro around a single (possibly coalesced) command
+		PushUndo(Transaction->Commands[0]);
+	}
+	else if (Transaction->Commands.Num() > 0)
+	{
+		PushUndo(Transaction);
+	}
+
+	if (bLiveGesture)
+	{
+		// Final notification carries the net change of the whole gesture
+		bLiveGesture = false;
+		FRTPlanDelta NetDelta = MoveTemp(GestureDelta);
+		GestureDelta.Reset();
+		NetDelta.Append(PendingDelta);
+		PendingDelta = MoveTemp(NetDelta);
+	}
+
+	// One notification for the whole transaction
+	BroadcastPendingChanges();
+	return bCommitted;
+}
+
+void URTPlanDocument::CancelTransaction()
+{
+	if (TransactionDepth > 0)
+	{
+		bTransactionFailed = true;
+		EndTransaction();
+	}
+}
+
 void URTPlanDocument::Undo()
 {
-	if (UndoStack.Num() > 0)
+	// History can't move while a transaction is open
+	if (ActiveTransaction)
+	{
+		return;
+	}
+
+	if (URTCommand* Command = UndoHistory.Pop())
 	{
-		URTCommand* Command = UndoStack.Pop();
 		Command->Undo();
 		RedoStack.Add(Command);
-		OnPlanChanged.Broadcast();
+		BroadcastPendingChanges();
 	}
 }
 
 void URTPlanDocument::Redo()
 {
+	if (ActiveTransaction)
+	{
+		return;
+	}
+
 	if (RedoStack.Num() > 0)
 	{
 		URTCommand* Command = RedoStack.Pop();
 		if (Command->Execute())
 		{
-			UndoStack.Add(Command);
-			OnPlanChanged.Broadcast();
+			UndoHistory.Push(Command);
 		}
 		else
 		{
 			// If redo fails, we might be in an inconsistent state.
 			// For now, just drop it.
 		}
+
+		BroadcastPendingChanges();
+	}
+}
+
+// --- Mutation API ---
+
+namespace RTPlanDocumentPrivate
+{
+	// Returns true if the entity was added, false if it replaced an existing one
+	template<typename T>
+	bool SetEntity(TMap<FGuid, T>& Map, const T& Entity)
+	{
+		if (T* Existing = Map.Find(Entity.Id))
+		{
+			*Existing = Entity;
+			return false;
+		}
+		Map.Add(Entity.Id, Entity);
+		return true;
+	}
+
+	template<typename T>
+	void CopyEntity(const TMap<FGuid, T>& From, TMap<FGuid, T>& To, const FGuid& Id)
+	{
+		if (const T* Existing = From.Find(Id))
+		{
+			To.Add(Id, *Existing);
+		}
+	}
+}
+
+void URTPlanDocument::RecordChange(ERTPlanEntityKind Kind, const FGuid& Id, ERTPlanChangeType Type)
+{
+	++Revision;
+	PendingDelta.Get(Kind).Mark(Type, Id);
+	ChangeLog.Record(Revision, Kind, Id, Type);
+}
+
+void URTPlanDocument::RecordSet(ERTPlanEntityKind Kind, const FGuid& Id, bool bAdded)
+{
+	RecordChange(Kind, Id, bAdded ? ERTPlanChangeType::Added : ERTPlanChangeType::Modified);
+}
+
+void URTPlanDocument::JournalEntity(ERTPlanEntityKind Kind, const FGuid& Id)
+{
+	if (!bJournalCommand)
+	{
+		return;
+	}
+
+	// First touch wins: that is the state to go back to
+	bool bAlreadyTouched = false;
+	JournalTouchedIds.Add(Id, &bAlreadyTouched);
+	if (bAlreadyTouched)
+	{
+		return;
+	}
+	JournalTouched.Emplace(Kind, Id);
+
+	switch (Kind)
+	{
+	case ERTPlanEntityKind::Vertex: RTPlanDocumentPrivate::CopyEntity(Data.Vertices, JournalPrevious.Vertices, Id); break;
+	case ERTPlanEntityKind::Wall: RTPlanDocumentPrivate::CopyEntity(Data.Walls, JournalPrevious.Walls, Id); break;
+	case ERTPlanEntityKind::Opening: RTPlanDocumentPrivate::CopyEntity(Data.Openings, JournalPrevious.Openings, Id); break;
+	case ERTPlanEntityKind::Object: RTPlanDocumentPrivate::CopyEntity(Data.Objects, JournalPrevious.Objects, Id); break;
+	case ERTPlanEntityKind::Run: RTPlanDocumentPrivate::CopyEntity(Data.Runs, JournalPrevious.Runs, Id); break;
+	}
+}
+
+void URTPlanDocument::RevertCommandJournal()
+{
+	// Through the mutation API so derived data and the pending delta follow
+	for (int32 i = JournalTouched.Num() - 1; i >= 0; --i)
+	{
+		const ERTPlanEntityKind Kind = JournalTouched[i].Key;
+		const FGuid& Id = JournalTouched[i].Value;
+		switch (Kind)
+		{
+		case ERTPlanEntityKind::Vertex:
+			if (const FRTVertex* Previous = JournalPrevious.Vertices.Find(Id)) { SetVertex(*Previous); } else { RemoveVertex(Id); }
+			break;
+		case ERTPlanEntityKind::Wall:
+			if (const FRTWall* Previous = JournalPrevious.Walls.Find(Id)) { SetWall(*Previous); } else { RemoveWall(Id); }
+			break;
+		case ERTPlanEntityKind::Opening:
+			if (const FRTOpening* Previous = JournalPrevious.Openings.Find(Id)) { SetOpening(*Previous); } else { RemoveOpening(Id); }
+			break;
+		case ERTPlanEntityKind::Object:
+			if (const FRTInteriorInstance* Previous = JournalPrevious.Objects.Find(Id)) { SetObject(*Previous); } else { RemoveObject(Id); }
+			break;
+		case ERTPlanEntityKind::Run:
+			if (const FRTCabinetRun* Previous = JournalPrevious.Runs.Find(Id)) { SetRun(*Previous); } else { RemoveRun(Id); }
+			break;
+		}
+	}
+
+	ResetCommandJournal();
+}
+
+void URTPlanDocument::ResetCommandJournal()
+{
+	// Reset keeps the allocations for the next command
+	JournalPrevious.Vertices.Reset();
+	JournalPrevious.Walls.Reset();
+	JournalPrevious.Openings.Reset();
+	JournalPrevious.Objects.Reset();
+	JournalPrevious.Runs.Reset();
+	JournalTouched.Reset();
+	JournalTouchedIds.Reset();
+}
+
+void URTPlanDocument::SetVertex(const FRTVertex& Vertex)
+{
+	JournalEntity(ERTPlanEntityKind::Vertex, Vertex.Id);
+	if (!bDerivedDataDirty)
+	{
+		DenseStore.SetVertex(Vertex);
 	}
+	RecordSet(ERTPlanEntityKind::Vertex, Vertex.Id, RTPlanDocumentPrivate::SetEntity(Data.Vertices, Vertex));
+}
+
+bool URTPlanDocument::RemoveVertex(const FGuid& Id)
+{
+	JournalEntity(ERTPlanEntityKind::Vertex, Id);
+	if (!Data.Vertices.Contains(Id))
+	{
+		return false;
+	}
+	if (!bDerivedDataDirty)
+	{
+		DenseStore.RemoveVertex(Id, ReverseIndex.GetWallsAtVertex(Id));
+	}
+	Data.Vertices.Remove(Id);
+	RecordChange(ERTPlanEntityKind::Vertex, Id, ERTPlanChangeType::Removed);
+	return true;
+}
+
+void URTPlanDocument::SetWall(const FRTWall& Wall)
+{
+	JournalEntity(ERTPlanEntityKind::Wall, Wall.Id);
+	if (!bDerivedDataDirty)
+	{
+		ReverseIndex.OnWallSet(Data.Walls.Find(Wall.Id), Wall);
+		DenseStore.SetWall(Wall);
+	}
+	RecordSet(ERTPlanEntityKind::Wall, Wall.Id, RTPlanDocumentPrivate::SetEntity(Data.Walls, Wall));
+}
+
+bool URTPlanDocument::RemoveWall(const FGuid& Id)
+{
+	JournalEntity(ERTPlanEntityKind::Wall, Id);
+	const FRTWall* Existing = Data.Walls.Find(Id);
+	if (!Existing)
+	{
+		return false;
+	}
+	if (!bDerivedDataDirty)
+	{
+		ReverseIndex.OnWallRemoved(*Existing);
+		DenseStore.RemoveWall(Id);
+	}
+	Data.Walls.Remove(Id);
+	RecordChange(ERTPlanEntityKind::Wall, Id, ERTPlanChangeType::Removed);
+	return true;
+}
+
+void URTPlanDocument::SetOpening(const FRTOpening& Opening)
+{
+	JournalEntity(ERTPlanEntityKind::Opening, Opening.Id);
+	if (!bDerivedDataDirty)
+	{
+		ReverseIndex.OnOpeningSet(Data.Openings.Find(Opening.Id), Opening);
+		DenseStore.SetOpening(Opening);
+	}
+	RecordSet(ERTPlanEntityKind::Opening, Opening.Id, RTPlanDocumentPrivate::SetEntity(Data.Openings, Opening));
+}
+
+bool URTPlanDocument::RemoveOpening(const FGuid& Id)
+{
+	JournalEntity(ERTPlanEntityKind::Opening, Id);
+	const FRTOpening* Existing = Data.Openings.Find(Id);
+	if (!Existing)
+	{
+		return false;
+	}
+	if (!bDerivedDataDirty)
+	{
+		ReverseIndex.OnOpeningRemoved(*Existing);
+		DenseStore.RemoveOpening(Id);
+	}
+	Data.Openings.Remove(Id);
+	RecordChange(ERTPlanEntityKind::Opening, Id, ERTPlanChangeType::Removed);
+	return true;
+}
+
+void URTPlanDocument::SetObject(const FRTInteriorInstance& Object)
+{
+	JournalEntity(ERTPlanEntityKind::Object, Object.Id);
+	if (!bDerivedDataDirty)
+	{
+		ReverseIndex.OnObjectSet(Data.Objects.Find(Object.Id), Object);
+		DenseStore.SetObject(Object);
+	}
+	RecordSet(ERTPlanEntityKind::Object, Object.Id, RTPlanDocumentPrivate::SetEntity(Data.Objects, Object));
+}
+
+bool URTPlanDocument::RemoveObject(const FGuid& Id)
+{
+	JournalEntity(ERTPlanEntityKind::Object, Id);
+	const FRTInteriorInstance* Existing = Data.Objects.Find(Id);
+	if (!Existing)
+	{
+		return false;
+	}
+	if (!bDerivedDataDirty)
+	{
+		ReverseIndex.OnObjectRemoved(*Existing);
+		DenseStore.RemoveObject(Id);
+	}
+	Data.Objects.Remove(Id);
+	RecordChange(ERTPlanEntityKind::Object, Id, ERTPlanChangeType::Removed);
+	return true;
+}
+
+void URTPlanDocument::SetRun(const FRTCabinetRun& Run)
+{
+	JournalEntity(ERTPlanEntityKind::Run, Run.Id);
+	if (!bDerivedDataDirty)
+	{
+		ReverseIndex.OnRunSet(Data.Runs.Find(Run.Id), Run);
+		DenseStore.SetRun(Run);
+	}
+	RecordSet(ERTPlanEntityKind::Run, Run.Id, RTPlanDocumentPrivate::SetEntity(Data.Runs, Run));
+}
+
+bool URTPlanDocument::RemoveRun(const FGuid& Id)
+{
+	JournalEntity(ERTPlanEntityKind::Run, Id);
+	const FRTCabinetRun* Existing = Data.Runs.Find(Id);
+	if (!Existing)
+	{
+		return false;
+	}
+	if (!bDerivedDataDirty)
+	{
+		ReverseIndex.OnRunRemoved(*Existing);
+		DenseStore.RemoveRun(Id);
+	}
+	Data.Runs.Remove(Id);
+	RecordChange(ERTPlanEntityKind::Run, Id, ERTPlanChangeType::Removed);
+	return true;
+}
+
+// --- Derived Data ---
+
+void URTPlanDocument::UpdateDerivedData() const
+{
+	if (bDerivedDataDirty)
+	{
+		DenseStore.Rebuild(Data);
+		ReverseIndex.Rebuild(Data);
+		bDerivedDataDirty = false;
+	}
+}
+
+const FRTPlanDenseStore& URTPlanDocument::GetDenseStore() const
+{
+	UpdateDerivedData();
+	return DenseStore;
+}
+
+const FRTPlanReverseIndex& URTPlanDocument::GetReverseIndex() const
+{
+	UpdateDerivedData();
+	return ReverseIndex;
+}
+
+FRTPlanData& URTPlanDocument::GetDataMutable()
+{
+	// Untracked edits: derived data, snapshots and per-entity history can't be patched
+	bDerivedDataDirty = true;
+	bSnapshotStale = true;
+	ChangeLog.Invalidate(++Revision);
+	return Data;
+}
+
+void URTPlanDocument::MarkFullRebuild()
+{
+	PendingDelta.bFullRebuild = true;
+	ChangeLog.Invalidate(++Revision);
+}
+
+uint64 URTPlanDocument::GetEntityRevision(const FGuid& Id) const
+{
+	if (const uint64 EntityRevision = ChangeLog.GetEntityRevision(Id))
+	{
+		return EntityRevision;
+	}
+
+	// Not changed since the last full rebuild: it is at least that old
+	const bool bExists = Data.Vertices.Contains(Id) || Data.Walls.Contains(Id) || Data.Openings.Contains(Id)
+		|| Data.Objects.Contains(Id) || Data.Runs.Contains(Id);
+	return bExists ? ChangeLog.GetBaseRevision() : 0;
+}
+
+FRTPlanSnapshotRef URTPlanDocument::GetSnapshot() const
+{
+	if (LastSnapshot.IsValid() && LastSnapshot->Revision == Revision && !bSnapshotStale)
+	{
+		return LastSnapshot.ToSharedRef();
+	}
+
+	// Net changes since the last snapshot, straight from the change log (broadcast or not, each change counted once).
+	// Falls back to a full copy if the log no longer reaches back that far.
+	FRTPlanDelta Changes = LastSnapshot.IsValid() ? ChangeLog.GetChangedSince(LastSnapshot->Revision) : FRTPlanDelta::MakeFullRebuild();
+	Changes.bFullRebuild |= bSnapshotStale;
+
+	const FRTPlanSnapshotRef Snapshot = FRTPlanSnapshot::Create(Data, Revision, LastSnapshot.Get(), &Changes);
+	LastSnapshot = Snapshot;
+	bSnapshotStale = false;
+	return Snapshot;
+}
+
+void URTPlanDocument::BroadcastPendingChanges()
+{
+	if (PendingDelta.IsEmpty())
+	{
+		return;
+	}
+
+	// Move out first so listeners that edit the document start a fresh delta
+	const FRTPlanDelta Delta = MoveTemp(PendingDelta);
+	PendingDelta.Reset();
+
+	OnPlanChanged.Broadcast(Delta);
 }
 
 bool URTPlanDocument::CanUndo() const
 {
-	return UndoStack.Num() > 0;
+	return !UndoHistory.IsEmpty();
 }
 
 bool URTPlanDocument::CanRedo() const
@@ -87,9 +573,37 @@ bool URTPlanDocument::FromJson(const FString& JsonString)
 	if (FJsonObjectConverter::JsonObjectStringToUStruct(JsonString, &NewData, 0, 0))
 	{
 		Data = NewData;
-		UndoStack.Empty();
+		bDerivedDataDirty = true;
+		UndoHistory.Reset();
+		RedoStack.Empty();
+		MarkFullRebuild();
+		BroadcastPendingChanges();
+		return true;
+	}
+	return false;
+}
+
+TArray<uint8> URTPlanDocument::ToBinary(bool bCompress) const
+{
+	TArray<uint8> Bytes;
+	if (!FRTPlanBinarySerializer::Save(Data, Bytes, bCompress))
+	{
+		Bytes.Reset();
+	}
+	return Bytes;
+}
+
+bool URTPlanDocument::FromBinary(const TArray<uint8>& Bytes)
+{
+	FRTPlanData NewData;
+	if (FRTPlanBinarySerializer::Load(Bytes, NewData))
+	{
+		Data = MoveTemp(NewData);
+		bDerivedDataDirty = true;
+		UndoHistory.Reset();
 		RedoStack.Empty();
-		OnPlanChanged.Broadcast();
+		MarkFullRebuild();
+		BroadcastPendingChanges();
 		return true;
 	}
 	return false;
@@ -0,0 +1,243 @@
+﻿#include "RTPlanEditList.h"
+#include "RTPlanDocument.h"
+
+namespace RTPlanEditListPrivate
+{
+	// Per-type access to the document, the edit storage and the entity kind
+	template<typename T> struct TEditTraits;
+
+	template<> struct TEditTraits<FRTVertex>
+	{
+		static constexpr ERTPlanEntityKind Kind = ERTPlanEntityKind::Vertex;
+		static const TMap<FGuid, FRTVertex>& Map(const FRTPlanData& Data) { return Data.Vertices; }
+		static TArray<FRTVertex>& Array(FRTPlanEditValues& Values) { return Values.Vertices; }
+		static const TArray<FRTVertex>& Array(const FRTPlanEditValues& Values) { return Values.Vertices; }
+		static void Set(URTPlanDocument& Document, const FRTVertex& Value) { Document.SetVertex(Value); }
+		static void Remove(URTPlanDocument& Document, const FGuid& Id) { Document.RemoveVertex(Id); }
+	};
+
+	template<> struct TEditTraits<FRTWall>
+	{
+		static constexpr ERTPlanEntityKind Kind = ERTPlanEntityKind::Wall;
+		static const TMap<FGuid, FRTWall>& Map(const FRTPlanData& Data) { return Data.Walls; }
+		static TArray<FRTWall>& Array(FRTPlanEditValues& Values) { return Values.Walls; }
+		static const TArray<FRTWall>& Array(const FRTPlanEditValues& Values) { return Values.Walls; }
+		static void Set(URTPlanDocument& Document, const FRTWall& Value) { Document.SetWall(Value); }
+		static void Remove(URTPlanDocument& Document, const FGuid& Id) { Document.RemoveWall(Id); }
+	};
+
+	template<> struct TEditTraits<FRTOpening>
+	{
+		static constexpr ERTPlanEntityKind Kind = ERTPlanEntityKind::Opening;
+		static const TMap<FGuid, FRTOpening>& Map(const FRTPlanData& Data) { return Data.Openings; }
+		static TArray<FRTOpening>& Array(FRTPlanEditValues& Values) { return Values.Openings; }
+		static const TArray<FRTOpening>& Array(const FRTPlanEditValues& Values) { return Values.Openings; }
+		static void Set(URTPlanDocument& Document, const FRTOpening& Value) { Document.SetOpening(Value); }
+		static void Remove(URTPlanDocument& Document, const FGuid& Id) { Document.RemoveOpening(Id); }
+	};
+
+	template<> struct TEditTraits<FRTInteriorInstance>
+	{
+		static constexpr ERTPlanEntityKind Kind = ERTPlanEntityKind::Object;
+		static const TMap<FGuid, FRTInteriorInstance>& Map(const FRTPlanData& Data) { return Data.Objects; }
+		static TArray<FRTInteriorInstance>& Array(FRTPlanEditValues& Values) { return Values.Objects; }
+		static const TArray<FRTInteriorInstance>& Array(const FRTPlanEditValues& Values) { return Values.Objects; }
+		static void Set(URTPlanDocument& Document, const FRTInteriorInstance& Value) { Document.SetObject(Value); }
+		static void Remove(URTPlanDocument& Document, const FGuid& Id) { Document.RemoveObject(Id); }
+	};
+
+	template<> struct TEditTraits<FRTCabinetRun>
+	{
+		static constexpr ERTPlanEntityKind Kind = ERTPlanEntityKind::Run;
+		static const TMap<FGuid, FRTCabinetRun>& Map(const FRTPlanData& Data) { return Data.Runs; }
+		static TArray<FRTCabinetRun>& Array(FRTPlanEditValues& Values) { return Values.Runs; }
+		static const TArray<FRTCabinetRun>& Array(const FRTPlanEditValues& Values) { return Values.Runs; }
+		static void Set(URTPlanDocument& Document, const FRTCabinetRun& Value) { Document.SetRun(Value); }
+		static void Remove(URTPlanDocument& Document, const FGuid& Id) { Document.RemoveRun(Id); }
+	};
+}
+
+using namespace RTPlanEditListPrivate;
+
+// --- FRTPlanEditValues ---
+
+void FRTPlanEditValues::Reset()
+{
+	Vertices.Reset();
+	Walls.Reset();
+	Openings.Reset();
+	Objects.Reset();
+	Runs.Reset();
+}
+
+SIZE_T FRTPlanEditValues::GetAllocatedSize() const
+{
+	return Vertices.GetAllocatedSize()
+		+ Walls.GetAllocatedSize()
+		+ Openings.GetAllocatedSize()
+		+ Objects.GetAllocatedSize()
+		+ Runs.GetAllocatedSize();
+}
+
+// --- Building ---
+
+void FRTPlanEditList::SetVertex(const FRTVertex& Vertex)
+{
+	Edits.Add({ Vertex.Id, Values.Vertices.Add(Vertex), ERTPlanEntityKind::Vertex });
+}
+
+void FRTPlanEditList::RemoveVertex(const FGuid& Id)
+{
+	Edits.Add({ Id, INDEX_NONE, ERTPlanEntityKind::Vertex });
+}
+
+void FRTPlanEditList::SetWall(const FRTWall& Wall)
+{
+	Edits.Add({ Wall.Id, Values.Walls.Add(Wall), ERTPlanEntityKind::Wall });
+}
+
+void FRTPlanEditList::RemoveWall(const FGuid& Id)
+{
+	Edits.Add({ Id, INDEX_NONE, ERTPlanEntityKind::Wall });
+}
+
+void FRTPlanEditList::SetOpening(const FRTOpening& Opening)
+{
+	Edits.Add({ Opening.Id, Values.Openings.Add(Opening), ERTPlanEntityKind::Opening });
+}
+
+void FRTPlanEditList::RemoveOpening(const FGuid& Id)
+{
+	Edits.Add({ Id, INDEX_NONE, ERTPlanEntityKind::Opening });
+}
+
+void FRTPlanEditList::SetObject(const FRTInteriorInstance& Object)
+{
+	Edits.Add({ Object.Id, Values.Objects.Add(Object), ERTPlanEntityKind::Object });
+}
+
+void FRTPlanEditList::RemoveObject(const FGuid& Id)
+{
+	Edits.Add({ Id, INDEX_NONE, ERTPlanEntityKind::Object });
+}
+
+void FRTPlanEditList::SetRun(const FRTCabinetRun& Run)
+{
+	Edits.Add({ Run.Id, Values.Runs.Add(Run), ERTPlanEntityKind::Run });
+}
+
+void FRTPlanEditList::RemoveRun(const FGuid& Id)
+{
+	Edits.Add({ Id, INDEX_NONE, ERTPlanEntityKind::Run });
+}
+
+void FRTPlanEditList::Reserve(int32 NumEdits)
+{
+	Edits.Reserve(NumEdits);
+	UndoEdits.Reserve(NumEdits);
+}
+
+void FRTPlanEditList::Reset()
+{
+	Edits.Reset();
+	Values.Reset();
+	UndoEdits.Reset();
+	UndoValues.Reset();
+}
+
+// --- Applying ---
+
+template<typename T>
+void FRTPlanEditList::ApplyEdit(URTPlanDocument& Document, const FEdit& Edit, const FRTPlanEditValues& Source, bool bRecordUndo)
+{
+	using FTraits = TEditTraits<T>;
+
+	const T* Previous = FTraits::Map(Document.GetData()).Find(Edit.Id);
+
+	// Removing something that is not there is a no-op (and needs no undo record)
+	if (Edit.ValueIndex == INDEX_NONE && !Previous)
+	{
+		return;
+	}
+
+	if (bRecordUndo)
+	{
+		// Inverse: restore the previous value, or remove the entity if it was added
+		const int32 UndoIndex = Previous ? FTraits::Array(UndoValues).Add(*Previous) : INDEX_NONE;
+		UndoEdits.Add({ Edit.Id, UndoIndex, FTraits::Kind });
+	}
+
+	if (Edit.ValueIndex != INDEX_NONE)
+	{
+		FTraits::Set(Document, FTraits::Array(Source)[Edit.ValueIndex]);
+	}
+	else
+	{
+		FTraits::Remove(Document, Edit.Id);
+	}
+}
+
+void FRTPlanEditList::Apply(URTPlanDocument& Document)
+{
+	UndoEdits.Reset();
+	UndoValues.Reset();
+
+	for (const FEdit& Edit : Edits)
+	{
+		switch (Edit.Kind)
+		{
+		case ERTPlanEntityKind::Vertex:
+			ApplyEdit<FRTVertex>(Document, Edit, Values, true);
+			break;
+		case ERTPlanEntityKind::Wall:
+			if (Edit.ValueIndex == INDEX_NONE)
+			{
+				// Cascade to hosted openings (copy the IDs, removal edits the index)
+				const TArray<FGuid> OpeningIds(Document.GetOpeningsOnWall(Edit.Id));
+				for (const FGuid& OpeningId : OpeningIds)
+				{
+					ApplyEdit<FRTOpening>(Document, { OpeningId, INDEX_NONE, ERTPlanEntityKind::Opening }, Values, true);
+				}
+			}
+			ApplyEdit<FRTWall>(Document, Edit, Values, true);
+			break;
+		case ERTPlanEntityKind::Opening:
+			ApplyEdit<FRTOpening>(Document, Edit, Values, true);
+			break;
+		case ERTPlanEntityKind::Object:
+			ApplyEdit<FRTInteriorInstance>(Document, Edit, Values, true);
+			break;
+		case ERTPlanEntityKind::Run:
+			ApplyEdit<FRTCabinetRun>(Document, Edit, Values, true);
+			break;
+		}
+	}
+}
+
+void FRTPlanEditList::Revert(URTPlanDocument& Document)
+{
+	for (int32 i = UndoEdits.Num() - 1; i >= 0; --i)
+	{
+		const FEdit& Edit = UndoEdits[i];
+		switch (Edit.Kind)
+		{
+		case ERTPlanEntityKind::Vertex:  ApplyEdit<FRTVertex>(Document, Edit, UndoValues, false); break;
+		case ERTPlanEntityKind::Wall:    ApplyEdit<FRTWall>(Document, Edit, UndoValues, false); break;
+		case ERTPlanEntityKind::Opening: ApplyEdit<FRTOpening>(Document, Edit, UndoValues, false); break;
+		case ERTPlanEntityKind::Object:  ApplyEdit<FRTInteriorInstance>(Document, Edit, UndoValues, false); break;
+		case ERTPlanEntityKind::Run:     ApplyEdit<FRTCabinetRun>(Document, Edit, UndoValues, false); break;
+		}
+	}
+
+	// Re-recorded by the next Apply (Redo); keep the capacity
+	UndoEdits.Reset();
+	UndoValues.Reset();
+}
+
+SIZE_T FRTPlanEditList::GetAllocatedSize() const
+{
+	return Edits.GetAllocatedSize()
+		+ Values.GetAllocatedSize()
+		+ UndoEdits.GetAllocatedSize()
+		+ UndoValues.GetAllocatedSize();
+}
@@ -0,0 +1,159 @@
+﻿#include "RTPlanReverseIndex.h"
+
+void FRTPlanReverseIndex::Rebuild(const FRTPlanData& Data)
+{
+	Reset();
+
+	VertexToWalls.Reserve(Data.Vertices.Num());
+	for (const auto& Pair : Data.Walls)
+	{
+		OnWallSet(nullptr, Pair.Value);
+	}
+	for (const auto& Pair : Data.Openings)
+	{
+		OnOpeningSet(nullptr, Pair.Value);
+	}
+	for (const auto& Pair : Data.Objects)
+	{
+		OnObjectSet(nullptr, Pair.Value);
+	}
+	for (const auto& Pair : Data.Runs)
+	{
+		OnRunSet(nullptr, Pair.Value);
+	}
+}
+
+void FRTPlanReverseIndex::Reset()
+{
+	VertexToWalls.Reset();
+	WallToOpenings.Reset();
+	WallToRuns.Reset();
+	WallToObjects.Reset();
+	RunToObjects.Reset();
+}
+
+// --- Walls ---
+
+void FRTPlanReverseIndex::OnWallSet(const FRTWall* OldWall, const FRTWall& NewWall)
+{
+	if (OldWall)
+	{
+		// Endpoints unchanged (the common case for property edits): nothing to do
+		if (OldWall->VertexAId == NewWall.VertexAId && OldWall->VertexBId == NewWall.VertexBId)
+		{
+			return;
+		}
+		OnWallRemoved(*OldWall);
+	}
+
+	Link(VertexToWalls, NewWall.VertexAId, NewWall.Id);
+	Link(VertexToWalls, NewWall.VertexBId, NewWall.Id);
+}
+
+void FRTPlanReverseIndex::OnWallRemoved(const FRTWall& Wall)
+{
+	Unlink(VertexToWalls, Wall.VertexAId, Wall.Id);
+	Unlink(VertexToWalls, Wall.VertexBId, Wall.Id);
+}
+
+// --- Openings ---
+
+void FRTPlanReverseIndex::OnOpeningSet(const FRTOpening* OldOpening, const FRTOpening& NewOpening)
+{
+	if (OldOpening)
+	{
+		if (OldOpening->WallId == NewOpening.WallId)
+		{
+			return;
+		}
+		OnOpeningRemoved(*OldOpening);
+	}
+
+	Link(WallToOpenings, NewOpening.WallId, NewOpening.Id);
+}
+
+void FRTPlanReverseIndex::OnOpeningRemoved(const FRTOpening& Opening)
+{
+	Unlink(WallToOpenings, Opening.WallId, Opening.Id);
+}
+
+// --- Objects ---
+
+void FRTPlanReverseIndex::OnObjectSet(const FRTInteriorInstance* OldObject, const FRTInteriorInstance& NewObject)
+{
+	if (OldObject)
+	{
+		if (OldObject->HostWallId == NewObject.HostWallId && OldObject->GeneratedByRunId == NewObject.GeneratedByRunId)
+		{
+			return;
+		}
+		OnObjectRemoved(*OldObject);
+	}
+
+	Link(WallToObjects, NewObject.HostWallId, NewObject.Id);
+	Link(RunToObjects, NewObject.GeneratedByRunId, NewObject.Id);
+}
+
+void FRTPlanReverseIndex::OnObjectRemoved(const FRTInteriorInstance& Object)
+{
+	Unlink(WallToObjects, Object.HostWallId, Object.Id);
+	Unlink(RunToObjects, Object.GeneratedByRunId, Object.Id);
+}
+
+// --- Runs ---
+
+void FRTPlanReverseIndex::OnRunSet(const FRTCabinetRun* OldRun, const FRTCabinetRun& NewRun)
+{
+	if (OldRun)
+	{
+		if (OldRun->HostWallId == NewRun.HostWallId)
+		{
+			return;
+		}
+		OnRunRemoved(*OldRun);
+	}
+
+	Link(WallToRuns, NewRun.HostWallId, NewRun.Id);
+}
+
+void FRTPlanReverseIndex::OnRunRemoved(const FRTCabinetRun& Run)
+{
+	Unlink(WallToRuns, Run.HostWallId, Run.Id);
+}
+
+// --- Helpers ---
+
+void FRTPlanReverseIndex::Link(TMap<FGuid, FRTPlanIdList>& Map, const FGuid& Key, const FGuid& Id)
+{
+	// Unhosted / manual entities have no key
+	if (!Key.IsValid())
+	{
+		return;
+	}
+	Map.FindOrAdd(Key).AddUnique(Id);
+}
+
+void FRTPlanReverseIndex::Unlink(TMap<FGuid, FRTPlanIdList>& Map, const FGuid& Key, const FGuid& Id)
+{
+	if (!Key.IsValid())
+	{
+		return;
+	}
+	if (FRTPlanIdList* List = Map.Find(Key))
+	{
+		List->RemoveSingleSwap(Id, EAllowShrinking::No);
+		if (List->Num() == 0)
+		{
+			Map.Remove(Key);
+		}
+	}
+}
+
+TConstArrayView<FGuid> FRTPlanReverseIndex::Lookup(const TMap<FGuid, FRTPlanIdList>& Map, const FGuid& Key)
+{
+	if (const FRTPlanIdList* List = Map.Find(Key))
+	{
+		return *List;
+	}
+	return TConstArrayView<FGuid>();
+}
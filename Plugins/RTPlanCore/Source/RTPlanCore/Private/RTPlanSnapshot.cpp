@@ -0,0 +1,102 @@
+﻿#include "RTPlanSnapshot.h"
+
+namespace RTPlanSnapshotPrivate
+{
+	template<typename T>
+	void CopyAll(TRTPlanSnapshotMap<T>& Out, const TMap<FGuid, T>& Source)
+	{
+		Out.Reserve(Source.Num());
+		for (const auto& Pair : Source)
+		{
+			Out.Add(Pair.Key, MakeShared<T, ESPMode::ThreadSafe>(Pair.Value));
+		}
+	}
+
+	// Re-copy only the entities listed in Changes, sharing the rest with the previous snapshot
+	template<typename T>
+	void Patch(TRTPlanSnapshotMap<T>& Out, const TMap<FGuid, T>& Source, const FRTPlanEntityChanges& Changes)
+	{
+		for (const FGuid& Id : Changes.Removed)
+		{
+			Out.Remove(Id);
+		}
+
+		auto CopyOne = [&Out, &Source](const FGuid& Id)
+		{
+			if (const T* Value = Source.Find(Id))
+			{
+				Out.Add(Id, MakeShared<T, ESPMode::ThreadSafe>(*Value));
+			}
+			else
+			{
+				Out.Remove(Id);
+			}
+		};
+
+		for (const FGuid& Id : Changes.Added)
+		{
+			CopyOne(Id);
+		}
+		for (const FGuid& Id : Changes.Modified)
+		{
+			CopyOne(Id);
+		}
+	}
+
+	template<typename T>
+	void Materialize(TMap<FGuid, T>& Out, const TRTPlanSnapshotMap<T>& Source)
+	{
+		Out.Reserve(Source.Num());
+		for (const auto& Pair : Source)
+		{
+			Out.Add(Pair.Key, Pair.Value.Get());
+		}
+	}
+}
+
+FRTPlanSnapshotRef FRTPlanSnapshot::Create(const FRTPlanData& Data, uint64 Revision, const FRTPlanSnapshot* Previous, const FRTPlanDelta* Changes)
+{
+	using namespace RTPlanSnapshotPrivate;
+
+	TSharedRef<FRTPlanSnapshot, ESPMode::ThreadSafe> Snapshot = MakeShared<FRTPlanSnapshot, ESPMode::ThreadSafe>();
+	Snapshot->Revision = Revision;
+	Snapshot->Version = Data.Version;
+
+	if (!Previous || !Changes || Changes->bFullRebuild)
+	{
+		CopyAll(Snapshot->Vertices, Data.Vertices);
+		CopyAll(Snapshot->Walls, Data.Walls);
+		CopyAll(Snapshot->Openings, Data.Openings);
+		CopyAll(Snapshot->Objects, Data.Objects);
+		CopyAll(Snapshot->Runs, Data.Runs);
+		return Snapshot;
+	}
+
+	// Structural sharing: copy the maps of references, then replace what changed
+	Snapshot->Vertices = Previous->Vertices;
+	Snapshot->Walls = Previous->Walls;
+	Snapshot->Openings = Previous->Openings;
+	Snapshot->Objects = Previous->Objects;
+	Snapshot->Runs = Previous->Runs;
+
+	Patch(Snapshot->Vertices, Data.Vertices, Changes->Vertices);
+	Patch(Snapshot->Walls, Data.Walls, Changes->Walls);
+	Patch(Snapshot->Openings, Data.Openings, Changes->Openings);
+	Patch(Snapshot->Objects, Data.Objects, Changes->Objects);
+	Patch(Snapshot->Runs, Data.Runs, Changes->Runs);
+	return Snapshot;
+}
+
+FRTPlanData FRTPlanSnapshot::ToData() const
+{
+	using namespace RTPlanSnapshotPrivate;
+
+	FRTPlanData Data;
+	Materialize(Data.Vertices, Vertices);
+	Materialize(Data.Walls, Walls);
+	Materialize(Data.Openings, Openings);
+	Materialize(Data.Objects, Objects);
+	Materialize(Data.Runs, Runs);
+	Data.Version = Version;
+	return Data;
+}
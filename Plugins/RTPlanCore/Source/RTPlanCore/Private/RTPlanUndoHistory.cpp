@@ -0,0 +1,97 @@
+﻿#include "RTPlanUndoHistory.h"
+#include "RTPlanCommand.h"
+
+void FRTPlanUndoHistory::Push(URTCommand* Command)
+{
+	if (!Command)
+	{
+		return;
+	}
+
+	if (Count == GetCapacity())
+	{
+		Grow();
+	}
+
+	const int32 Index = ToRingIndex(Count);
+	const int64 Size = (int64)Command->GetAllocatedSize();
+	Ring[Index] = Command;
+	Sizes[Index] = Size;
+	UsedBytes += Size;
+	++Count;
+
+	EvictToBudget();
+}
+
+URTCommand* FRTPlanUndoHistory::Pop()
+{
+	if (Count == 0)
+	{
+		return nullptr;
+	}
+
+	--Count;
+	const int32 Index = ToRingIndex(Count);
+	URTCommand* Command = Ring[Index];
+	UsedBytes -= Sizes[Index];
+	Ring[Index] = nullptr;
+	Sizes[Index] = 0;
+	return Command;
+}
+
+URTCommand* FRTPlanUndoHistory::GetFromNewest(int32 Index) const
+{
+	if (Index < 0 || Index >= Count)
+	{
+		return nullptr;
+	}
+	return Ring[ToRingIndex(Count - 1 - Index)];
+}
+
+void FRTPlanUndoHistory::SetMaxBytes(int64 InMaxBytes)
+{
+	MaxBytes = FMath::Max<int64>(InMaxBytes, 0);
+	EvictToBudget();
+}
+
+void FRTPlanUndoHistory::Reset()
+{
+	Ring.Reset();
+	Sizes.Reset();
+	Head = 0;
+	Count = 0;
+	UsedBytes = 0;
+}
+
+void FRTPlanUndoHistory::Grow()
+{
+	const int32 NewCapacity = FMath::Max(16, GetCapacity() * 2);
+
+	TArray<TObjectPtr<URTCommand>> NewRing;
+	TArray<int64> NewSizes;
+	NewRing.SetNum(NewCapacity);
+	NewSizes.SetNumZeroed(NewCapacity);
+
+	for (int32 i = 0; i < Count; ++i)
+	{
+		const int32 Index = ToRingIndex(i);
+		NewRing[i] = Ring[Index];
+		NewSizes[i] = Sizes[Index];
+	}
+
+	Ring = MoveTemp(NewRing);
+	Sizes = MoveTemp(NewSizes);
+	Head = 0;
+}
+
+void FRTPlanUndoHistory::EvictToBudget()
+{
+	while (Count > 1 && UsedBytes > MaxBytes)
+	{
+		UsedBytes -= Sizes[Head];
+		Ring[Head] = nullptr;
+		Sizes[Head] = 0;
+		Head = (Head + 1) % GetCapacity();
+		--Count;
+	}
+}
@@ -0,0 +1,36 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "RTPlanSchema.h"
+
+/**
+ * RTPlanBinarySerializer.h
+ * Compact, versioned binary format for FRTPlanData (save/load of large plans).
+ * JSON stays the interchange format; this is the fast path.
+ *
+ * Layout:
+ *   Header  : Magic, FormatVersion, Flags, RawPayloadSize, StoredPayloadSize
+ *   Payload : (optionally Oodle-compressed)
+ *     GUID table  - every FGuid is written once, entities reference it by packed index (0 = invalid)
+ *     FName table - same for finish / product IDs (0 = NAME_None)
+ *     Sections    - Vertices, Walls, Openings, Objects, Runs; floats packed as float32, bools as bit flags
+ */
+struct RTPLANCORE_API FRTPlanBinarySerializer
+{
+	// 'RTPB'
+	static constexpr uint32 Magic = 0x42505452;
+
+	// Bump when the layout changes; older versions must stay loadable.
+	static constexpr uint16 FormatVersion = 1;
+
+	// Load rejects headers claiming a larger decompressed payload than this, or more than MaxCompressionRatio times
+	// the stored size, before allocating anything
+	static constexpr int32 MaxPayloadSize = 256 * 1024 * 1024;
+	static constexpr int32 MaxCompressionRatio = 64;
+
+	// Serialize Data into OutBytes. Returns false on archive error.
+	static bool Save(const FRTPlanData& Data, TArray<uint8>& OutBytes, bool bCompress = true);
+
+	// Deserialize Bytes into OutData. OutData is left untouched on failure.
+	static bool Load(const TArray<uint8>& Bytes, FRTPlanData& OutData);
+};
@@ -0,0 +1,58 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "RTPlanDelta.h"
+
+/**
+ * RTPlanChangeLog.h
+ * Per-entity last-modified revisions plus an ordered log of recent changes, maintained by the document.
+ * Lets a downstream cache (mesher, spatial index, ...) remember the revision it last synced to and
+ * catch up with GetChangedSince, even if it missed OnPlanChanged notifications.
+ */
+
+struct FRTPlanChangeRecord
+{
+	uint64 Revision = 0;
+	FGuid Id;
+	ERTPlanEntityKind Kind = ERTPlanEntityKind::Vertex;
+	ERTPlanChangeType Type = ERTPlanChangeType::Modified;
+};
+
+class RTPLANCORE_API FRTPlanChangeLog
+{
+public:
+	// Older records are dropped past this; queries from before them report a full rebuild
+	static constexpr int32 DefaultMaxRecords = 64 * 1024;
+
+	void Record(uint64 Revision, ERTPlanEntityKind Kind, const FGuid& Id, ERTPlanChangeType Type);
+
+	// Per-entity history is unknown from here on (raw edits / load); older queries get a full rebuild.
+	void Invalidate(uint64 Revision);
+
+	/**
+	 * Net changes made after SinceRevision (coalesced like OnPlanChanged deltas).
+	 * Returns a full-rebuild delta if that revision is older than the tracked history.
+	 */
+	FRTPlanDelta GetChangedSince(uint64 SinceRevision) const;
+
+	// Revision of the last change to the entity.
+	// Returns 0 if it has not changed since the last invalidation, or does not exist.
+	uint64 GetEntityRevision(const FGuid& Id) const;
+
+	// Oldest revision GetChangedSince can answer incrementally
+	uint64 GetBaseRevision() const { return BaseRevision; }
+
+	int32 Num() const { return Records.Num(); }
+
+	void SetMaxRecords(int32 InMaxRecords) { MaxRecords = FMath::Max(1, InMaxRecords); }
+
+private:
+	// Ascending by revision
+	TArray<FRTPlanChangeRecord> Records;
+
+	// Last-modified revision of every live entity changed since BaseRevision
+	TMap<FGuid, uint64> EntityRevisions;
+
+	uint64 BaseRevision = 0;
+	int32 MaxRecords = DefaultMaxRecords;
+};
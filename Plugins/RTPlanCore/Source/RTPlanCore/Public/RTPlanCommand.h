@@ -3,6 +3,7 @@
 #include "CoreMinimal.h"
 #include "UObject/NoExportTypes.h"
 #include "RTPlanSchema.h"
+#include "RTPlanEditList.h"
 #include "RTPlanCommand.generated.h"
 
 class URTPlanDocument;
@@ -29,6 +30,16 @@ public:
 
 	// Returns a description for the Undo history UI (e.g. "Add Wall")
 	virtual FString GetDescription() const { return TEXT("Unknown Command"); }
+
+	// Approximate memory held by this command, used for the undo history budget.
+	// Override to add heap allocations owned by the command (arrays of stored state, child commands).
+	virtual SIZE_T GetAllocatedSize() const;
+
+	// Coalescing: inside a transaction / gesture, a command that can absorb the next one
+	// (e.g. repeated moves of the same vertex) is merged so history keeps a single entry.
+	// Both commands have already executed when MergeWith is called.
+	virtual bool CanMergeWith(const URTCommand* Next) const { return false; }
+	virtual void MergeWith(const URTCommand* Next) {}
 };
 
 /**
@@ -47,6 +58,8 @@ public:
 	virtual bool Execute() override;
 	virtual void Undo() override;
 	virtual FString GetDescription() const override { return bIsNew ? TEXT("Add Vertex") : TEXT("Move Vertex"); }
+	virtual bool CanMergeWith(const URTCommand* Next) const override;
+	virtual void MergeWith(const URTCommand* Next) override;
 };
 
 /**
@@ -65,10 +78,13 @@ public:
 	virtual bool Execute() override;
 	virtual void Undo() override;
 	virtual FString GetDescription() const override { return bIsNew ? TEXT("Add Wall") : TEXT("Edit Wall"); }
+	virtual bool CanMergeWith(const URTCommand* Next) const override;
+	virtual void MergeWith(const URTCommand* Next) override;
 };
 
 /**
  * Command to Delete a Wall.
+ * Openings hosted on the wall are deleted with it (and restored on Undo).
  */
 UCLASS()
 class RTPLANCORE_API URTCmdDeleteWall : public URTCommand
@@ -78,10 +94,12 @@ class RTPLANCORE_API URTCmdDeleteWall : public URTCommand
 public:
 	FGuid WallId;
 	FRTWall DeletedWall; // Stored for Undo
+	TArray<FRTOpening> DeletedOpenings; // Hosted openings, stored for Undo
 
 	virtual bool Execute() override;
 	virtual void Undo() override;
 	virtual FString GetDescription() const override { return TEXT("Delete Wall"); }
+	virtual SIZE_T GetAllocatedSize() const override;
 };
 
 /**
@@ -120,6 +138,7 @@ public:
 	virtual bool Execute() override;
 	virtual void Undo() override;
 	virtual FString GetDescription() const override { return Description; }
+	virtual SIZE_T GetAllocatedSize() const override;
 
 	void AddCommand(URTCommand* Cmd)
 	{
@@ -131,4 +150,26 @@ public:
 	}
 };
 
+/**
+ * Batch Command
+ * Applies an FRTPlanEditList: any number of entity edits in one lightweight object.
+ * Prefer this over a macro of per-entity commands for bulk edits (imports, copies, trims).
+ */
+UCLASS()
+class RTPLANCORE_API URTCmdBatch : public URTCommand
+{
+	GENERATED_BODY()
+
+public:
+	FRTPlanEditList Edits;
+
+	UPROPERTY()
+	FString Description = TEXT("Edit");
+
+	virtual bool Execute() override;
+	virtual void Undo() override;
+	virtual FString GetDescription() const override { return Description; }
+	virtual SIZE_T GetAllocatedSize() const override;
+};
+
 // TODO: Add commands for Openings, Objects, Runs as we implement those features.
@@ -2,6 +2,31 @@
 
 #include "CoreMinimal.h"
 #include "Misc/AutomationTest.h"
+#include "RTPlanCommand.h"
+#include "RTPlanEditList.h"
+#include "RTPlanCoreTests.generated.h"
 
-// This header is just a placeholder if we want to expose test helpers later.
+// Test helpers shared by the automation tests.
 // The actual tests will be in the Private folder.
+
+/**
+ * Test command that applies its edits and then reports failure,
+ * like a command giving up partway through Execute.
+ */
+UCLASS(Transient)
+class RTPLANCORE_API URTCmdTestFailAfterEdits : public URTCommand
+{
+	GENERATED_BODY()
+
+public:
+	FRTPlanEditList Edits;
+
+	virtual bool Execute() override
+	{
+		if (Document)
+		{
+			Edits.Apply(*Document);
+		}
+		return false;
+	}
+};
@@ -0,0 +1,111 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "RTPlanDelta.generated.h"
+
+/**
+ * RTPlanDelta.h
+ * Change-set payload broadcast by URTPlanDocument::OnPlanChanged.
+ * Commands record which entities they touched so listeners can update O(changed) instead of O(plan).
+ */
+
+UENUM(BlueprintType)
+enum class ERTPlanEntityKind : uint8
+{
+	Vertex,
+	Wall,
+	Opening,
+	Object,
+	Run
+};
+
+UENUM(BlueprintType)
+enum class ERTPlanChangeType : uint8
+{
+	Added,
+	Modified,
+	Removed
+};
+
+/**
+ * Added / Modified / Removed IDs for a single entity kind.
+ * The three sets are kept disjoint and describe the net effect of all recorded edits
+ * (e.g. Add followed by Remove cancels out, Remove followed by Add becomes Modified).
+ */
+USTRUCT(BlueprintType)
+struct RTPLANCORE_API FRTPlanEntityChanges
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "RTPlan|Delta")
+	TSet<FGuid> Added;
+
+	UPROPERTY(BlueprintReadOnly, Category = "RTPlan|Delta")
+	TSet<FGuid> Modified;
+
+	UPROPERTY(BlueprintReadOnly, Category = "RTPlan|Delta")
+	TSet<FGuid> Removed;
+
+	void MarkAdded(const FGuid& Id);
+	void MarkModified(const FGuid& Id);
+	void MarkRemoved(const FGuid& Id);
+	void Mark(ERTPlanChangeType Type, const FGuid& Id);
+
+	// Fold a later change-set into this one.
+	void Append(const FRTPlanEntityChanges& Other);
+
+	bool IsEmpty() const { return Added.Num() == 0 && Modified.Num() == 0 && Removed.Num() == 0; }
+	int32 Num() const { return Added.Num() + Modified.Num() + Removed.Num(); }
+	bool Contains(const FGuid& Id) const { return Added.Contains(Id) || Modified.Contains(Id) || Removed.Contains(Id); }
+
+	void Reset();
+};
+
+/**
+ * Net change-set for one document notification.
+ */
+USTRUCT(BlueprintType)
+struct RTPLANCORE_API FRTPlanDelta
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "RTPlan|Delta")
+	FRTPlanEntityChanges Vertices;
+
+	UPROPERTY(BlueprintReadOnly, Category = "RTPlan|Delta")
+	FRTPlanEntityChanges Walls;
+
+	UPROPERTY(BlueprintReadOnly, Category = "RTPlan|Delta")
+	FRTPlanEntityChanges Openings;
+
+	UPROPERTY(BlueprintReadOnly, Category = "RTPlan|Delta")
+	FRTPlanEntityChanges Objects;
+
+	UPROPERTY(BlueprintReadOnly, Category = "RTPlan|Delta")
+	FRTPlanEntityChanges Runs;
+
+	// Set when the change could not be tracked per entity (load, raw data edits).
+	// Listeners must treat the whole plan as changed.
+	UPROPERTY(BlueprintReadOnly, Category = "RTPlan|Delta")
+	bool bFullRebuild = false;
+
+	// Set for live updates broadcast during a gesture (URTPlanDocument::BeginGesture).
+	// The gesture ends with a regular broadcast covering everything it changed,
+	// so expensive listeners may skip interactive deltas.
+	UPROPERTY(BlueprintReadOnly, Category = "RTPlan|Delta")
+	bool bInteractive = false;
+
+	FRTPlanEntityChanges& Get(ERTPlanEntityKind Kind);
+	const FRTPlanEntityChanges& Get(ERTPlanEntityKind Kind) const;
+
+	void Append(const FRTPlanDelta& Other);
+
+	bool IsEmpty() const;
+
+	// True if walls need to be re-meshed / re-indexed (vertices, walls or openings changed).
+	bool AffectsWallGeometry() const;
+
+	void Reset();
+
+	static FRTPlanDelta MakeFullRebuild();
+};
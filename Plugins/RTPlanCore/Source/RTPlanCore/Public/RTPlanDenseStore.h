@@ -0,0 +1,94 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "RTPlanSchema.h"
+#include "RTPlanSlotMap.h"
+
+/**
+ * RTPlanDenseStore.h
+ * In-memory mirror of FRTPlanData in packed slot maps.
+ * FRTPlanData's GUID maps remain the serialized / replicated form; hot loops iterate this instead.
+ */
+
+/** Wall plus cached handles of its endpoints (invalid while the vertex is missing, resolved again when it is re-added). */
+struct FRTPlanDenseWall
+{
+	FRTWall Wall;
+	FRTPlanHandle VertexA;
+	FRTPlanHandle VertexB;
+};
+
+class RTPLANCORE_API FRTPlanDenseStore
+{
+public:
+	void Rebuild(const FRTPlanData& Data);
+	void Reset();
+
+	void SetVertex(const FRTVertex& Vertex);
+
+	// WallsAtVertex: the walls referencing the vertex (from the reverse index), whose handles to it are invalidated
+	void RemoveVertex(const FGuid& Id, TConstArrayView<FGuid> WallsAtVertex);
+
+	void SetWall(const FRTWall& Wall);
+	void RemoveWall(const FGuid& Id);
+
+	void SetOpening(const FRTOpening& Opening) { Openings.Set(Opening.Id, Opening); }
+	void RemoveOpening(const FGuid& Id) { Openings.Remove(Id); }
+
+	void SetObject(const FRTInteriorInstance& Object) { Objects.Set(Object.Id, Object); }
+	void RemoveObject(const FGuid& Id) { Objects.Remove(Id); }
+
+	void SetRun(const FRTCabinetRun& Run) { Runs.Set(Run.Id, Run); }
+	void RemoveRun(const FGuid& Id) { Runs.Remove(Id); }
+
+	const TRTSlotMap<FRTVertex>& GetVertices() const { return Vertices; }
+	const TRTSlotMap<FRTPlanDenseWall>& GetWalls() const { return Walls; }
+	const TRTSlotMap<FRTOpening>& GetOpenings() const { return Openings; }
+	const TRTSlotMap<FRTInteriorInstance>& GetObjects() const { return Objects; }
+	const TRTSlotMap<FRTCabinetRun>& GetRuns() const { return Runs; }
+
+	// Resolve a wall's endpoint positions. Returns false if either vertex is missing.
+	bool GetWallEndpoints(const FRTPlanDenseWall& Entry, FVector2D& OutA, FVector2D& OutB) const
+	{
+		const FRTVertex* A = Vertices.Find(Entry.VertexA);
+		const FRTVertex* B = Vertices.Find(Entry.VertexB);
+		if (!A || !B)
+		{
+			return false;
+		}
+		OutA = A->Position;
+		OutB = B->Position;
+		return true;
+	}
+
+	/**
+	 * Linear scan over all walls with resolved endpoint positions.
+	 * Func(const FRTWall& Wall, const FVector2D& A, const FVector2D& B). Walls with missing vertices are skipped.
+	 */
+	template<typename FuncType>
+	void ForEachWall(FuncType&& Func) const
+	{
+		FVector2D A, B;
+		for (const FRTPlanDenseWall& Entry : Walls)
+		{
+			if (GetWallEndpoints(Entry, A, B))
+			{
+				Func(Entry.Wall, A, B);
+			}
+		}
+	}
+
+private:
+	// Remember that WallId references the missing vertex VertexId
+	void AwaitVertex(const FGuid& VertexId, const FGuid& WallId);
+
+	TRTSlotMap<FRTVertex> Vertices;
+	TRTSlotMap<FRTPlanDenseWall> Walls;
+	TRTSlotMap<FRTOpening> Openings;
+	TRTSlotMap<FRTInteriorInstance> Objects;
+	TRTSlotMap<FRTCabinetRun> Runs;
+
+	// Missing vertex -> walls with an unresolved handle to it, so re-adding a vertex only touches its own walls.
+	// Entries may be stale (wall removed or reconnected since); they are checked when the vertex comes back.
+	TMap<FGuid, TArray<FGuid, TInlineAllocator<4>>> WallsAwaitingVertex;
+};
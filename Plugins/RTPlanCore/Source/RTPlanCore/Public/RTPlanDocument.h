@@ -3,11 +3,19 @@
 #include "CoreMinimal.h"
 #include "UObject/NoExportTypes.h"
 #include "RTPlanSchema.h"
+#include "RTPlanDelta.h"
+#include "RTPlanDenseStore.h"
+#include "RTPlanReverseIndex.h"
+#include "RTPlanUndoHistory.h"
+#include "RTPlanSnapshot.h"
+#include "RTPlanChangeLog.h"
 #include "RTPlanDocument.generated.h"
 
 class URTCommand;
+class URTCmdMacro;
+class FRTPlanEditList;
 
-DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnPlanChanged);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnPlanChanged, const FRTPlanDelta&, Delta);
 
 /**
  * The authoritative container for the interior plan.
@@ -26,8 +34,69 @@ public:
 	// Read-only access to the plan data.
 	const FRTPlanData& GetData() const { return Data; }
 
-	// Direct access for Commands (friend-like access via public for simplicity in plugins)
-	FRTPlanData& GetDataMutable() { return Data; }
+	// Raw access to the data. Edits made here are not tracked per entity;
+	// call MarkFullRebuild() so the next notification tells listeners to rebuild everything.
+	FRTPlanData& GetDataMutable();
+
+	// Monotonically increasing counter, bumped by every edit.
+	uint64 GetRevision() const { return Revision; }
+
+	// --- Change tracking (see FRTPlanChangeLog) ---
+
+	// Net changes made after SinceRevision. Caches store GetRevision() when they sync and
+	// call this to catch up, even if they missed notifications. Full rebuild if history is too old.
+	FRTPlanDelta GetChangedSince(uint64 SinceRevision) const { return ChangeLog.GetChangedSince(SinceRevision); }
+
+	// Revision at which an entity was last added / modified (0 if it does not exist).
+	uint64 GetEntityRevision(const FGuid& Id) const;
+
+	// Immutable, thread-safe copy of the plan at the current revision, for worker threads.
+	// Returns the cached snapshot if nothing changed; otherwise shares unchanged entities with it.
+	// Must be called on the game thread (like all document access); the returned snapshot can go anywhere.
+	FRTPlanSnapshotRef GetSnapshot() const;
+
+	// Packed mirror of the data for hot loops (linear scans, resolved wall endpoints).
+	// Kept in sync by the mutation API; rebuilt lazily after raw edits.
+	const FRTPlanDenseStore& GetDenseStore() const;
+
+	// --- Topology (reverse references, same lifetime as the dense store) ---
+
+	const FRTPlanReverseIndex& GetReverseIndex() const;
+
+	TConstArrayView<FGuid> GetWallsAtVertex(const FGuid& VertexId) const { return GetReverseIndex().GetWallsAtVertex(VertexId); }
+	TConstArrayView<FGuid> GetOpeningsOnWall(const FGuid& WallId) const { return GetReverseIndex().GetOpeningsOnWall(WallId); }
+	TConstArrayView<FGuid> GetRunsOnWall(const FGuid& WallId) const { return GetReverseIndex().GetRunsOnWall(WallId); }
+	TConstArrayView<FGuid> GetObjectsOnWall(const FGuid& WallId) const { return GetReverseIndex().GetObjectsOnWall(WallId); }
+	TConstArrayView<FGuid> GetObjectsGeneratedByRun(const FGuid& RunId) const { return GetReverseIndex().GetObjectsGeneratedByRun(RunId); }
+
+	// --- Mutation API (used by Commands) ---
+	// Add-or-update / remove a single entity and record it in the pending delta.
+	// Remove* returns false if the entity did not exist.
+
+	void SetVertex(const FRTVertex& Vertex);
+	bool RemoveVertex(const FGuid& Id);
+
+	void SetWall(const FRTWall& Wall);
+	bool RemoveWall(const FGuid& Id);
+
+	void SetOpening(const FRTOpening& Opening);
+	bool RemoveOpening(const FGuid& Id);
+
+	void SetObject(const FRTInteriorInstance& Object);
+	bool RemoveObject(const FGuid& Id);
+
+	void SetRun(const FRTCabinetRun& Run);
+	bool RemoveRun(const FGuid& Id);
+
+	// Flag the pending delta as a full rebuild (after raw edits via GetDataMutable).
+	void MarkFullRebuild();
+
+	// Changes recorded since the last notification.
+	const FRTPlanDelta& GetPendingDelta() const { return PendingDelta; }
+
+	// Broadcast OnPlanChanged with the pending delta (if anything changed) and reset it.
+	// Called automatically by SubmitCommand / Undo / Redo; only needed for edits made outside commands.
+	void BroadcastPendingChanges();
 
 	// --- Command Stack ---
 
@@ -35,6 +104,9 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "RTPlan|Commands")
 	bool SubmitCommand(URTCommand* Command);
 
+	// Submit a bulk edit as one URTCmdBatch (one undo step, one UObject).
+	bool SubmitEdits(FRTPlanEditList&& Edits, const FString& Description);
+
 	UFUNCTION(BlueprintCallable, Category = "RTPlan|Commands")
 	void Undo();
 
@@ -47,6 +119,55 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "RTPlan|Commands")
 	bool CanRedo() const;
 
+	// Undo history is bounded by memory, not step count (oldest steps are dropped first).
+	UFUNCTION(BlueprintCallable, Category = "RTPlan|Commands")
+	void SetUndoMemoryBudget(int64 MaxBytes);
+
+	UFUNCTION(BlueprintCallable, Category = "RTPlan|Commands")
+	int64 GetUndoMemoryUsage() const { return UndoHistory.GetUsedBytes(); }
+
+	UFUNCTION(BlueprintCallable, Category = "RTPlan|Commands")
+	int32 GetNumUndoSteps() const { return UndoHistory.Num(); }
+
+	// --- Transactions ---
+	// Commands submitted between Begin/EndTransaction execute immediately but are grouped into
+	// one URTCmdMacro (a single undo step) with a single OnPlanChanged broadcast on commit.
+	// Transactions nest; only the outermost EndTransaction commits. If any command fails
+	// (or CancelTransaction is called) everything executed so far is rolled back, including
+	// the edits the failing command applied before it gave up.
+
+	UFUNCTION(BlueprintCallable, Category = "RTPlan|Commands")
+	void BeginTransaction(const FString& Description);
+
+	// Returns false if the transaction was rolled back.
+	UFUNCTION(BlueprintCallable, Category = "RTPlan|Commands")
+	bool EndTransaction();
+
+	UFUNCTION(BlueprintCallable, Category = "RTPlan|Commands")
+	void CancelTransaction();
+
+	UFUNCTION(BlueprintCallable, Category = "RTPlan|Commands")
+	bool IsInTransaction() const { return TransactionDepth > 0; }
+
+	// --- Gestures (live edits) ---
+	// A gesture is a transaction for continuous interaction (dragging a vertex, sliding an opening).
+	// Each submitted command is applied immediately and broadcast as an interactive delta;
+	// repeated edits of the same entity coalesce (URTCommand::CanMergeWith) so EndGesture
+	// pushes a single undo entry and broadcasts the net change of the whole gesture.
+
+	UFUNCTION(BlueprintCallable, Category = "RTPlan|Commands")
+	void BeginGesture(const FString& Description);
+
+	UFUNCTION(BlueprintCallable, Category = "RTPlan|Commands")
+	bool EndGesture() { return EndTransaction(); }
+
+	// Revert everything the gesture changed (e.g. Escape during a drag).
+	UFUNCTION(BlueprintCallable, Category = "RTPlan|Commands")
+	void CancelGesture() { CancelTransaction(); }
+
+	UFUNCTION(BlueprintCallable, Category = "RTPlan|Commands")
+	bool IsInGesture() const { return bLiveGesture; }
+
 	// --- Serialization ---
 
 	UFUNCTION(BlueprintCallable, Category = "RTPlan|IO")
@@ -55,9 +176,17 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "RTPlan|IO")
 	bool FromJson(const FString& JsonString);
 
+	// Compact binary format (see FRTPlanBinarySerializer). Much faster than JSON for large plans.
+	UFUNCTION(BlueprintCallable, Category = "RTPlan|IO")
+	TArray<uint8> ToBinary(bool bCompress = true) const;
+
+	UFUNCTION(BlueprintCallable, Category = "RTPlan|IO")
+	bool FromBinary(const TArray<uint8>& Bytes);
+
 	// --- Events ---
 
 	// Broadcasts whenever the plan changes (after a command or undo/redo).
+	// The delta lists the entities that were added, modified or removed since the last broadcast.
 	UPROPERTY(BlueprintAssignable, Category = "RTPlan|Events")
 	FOnPlanChanged OnPlanChanged;
 
@@ -66,13 +195,111 @@ private:
 	UPROPERTY()
 	FRTPlanData Data;
 
-	// Undo/Redo stacks
+	// Changes accumulated since the last OnPlanChanged broadcast
+	FRTPlanDelta PendingDelta;
+
+	// Bump the revision and record one entity change (pending delta + change log)
+	void RecordChange(ERTPlanEntityKind Kind, const FGuid& Id, ERTPlanChangeType Type);
+	void RecordSet(ERTPlanEntityKind Kind, const FGuid& Id, bool bAdded);
+
+	FRTPlanChangeLog ChangeLog;
+
+	// Rebuild the dense store / reverse index if raw edits invalidated them
+	void UpdateDerivedData() const;
+
+	// Derived data, kept in sync by the mutation API (see GetDenseStore / GetReverseIndex)
+	mutable FRTPlanDenseStore DenseStore;
+	mutable FRTPlanReverseIndex ReverseIndex;
+	mutable bool bDerivedDataDirty = true;
+
+	uint64 Revision = 0;
+
+	// Last snapshot handed out; the next one is patched from it with ChangeLog (see GetSnapshot)
+	mutable FRTPlanSnapshotPtr LastSnapshot;
+	mutable bool bSnapshotStale = false;
+
+	// Undo history (ring buffer with a byte budget) and redo stack
 	UPROPERTY()
-	TArray<TObjectPtr<URTCommand>> UndoStack;
+	FRTPlanUndoHistory UndoHistory;
 
 	UPROPERTY()
 	TArray<TObjectPtr<URTCommand>> RedoStack;
 
-	// Max undo steps
-	int32 MaxUndoSteps = 50;
+	// Push an executed command to the undo history (clears redo, evicts over budget)
+	void PushUndo(URTCommand* Command);
+
+	// Open transaction (outermost), collects the executed commands
+	UPROPERTY(Transient)
+	TObjectPtr<URTCmdMacro> ActiveTransaction;
+
+	int32 TransactionDepth = 0;
+	bool bTransactionFailed = false;
+
+	// State of the entities touched by the command executing inside a transaction, from before
+	// its first touch, so a command that fails partway through Execute can be reverted.
+	// Touched lists every entity in order; Previous only holds the ones that already existed.
+	bool bJournalCommand = false;
+	FRTPlanData JournalPrevious;
+	TArray<TPair<ERTPlanEntityKind, FGuid>> JournalTouched;
+	TSet<FGuid> JournalTouchedIds;
+
+	// Called by the mutation API before an entity changes
+	void JournalEntity(ERTPlanEntityKind Kind, const FGuid& Id);
+	// Restore the journaled state (newest first) and clear the journal
+	void RevertCommandJournal();
+	void ResetCommandJournal();
+
+	// Outermost transaction is a gesture: broadcast live, accumulate the net change in GestureDelta
+	bool bLiveGesture = false;
+	FRTPlanDelta GestureDelta;
+};
+
+/**
+ * RAII helper for URTPlanDocument transactions.
+ * Commits on scope exit unless Cancel() or Commit() was called first.
+ */
+class RTPLANCORE_API FRTPlanScopedTransaction
+{
+public:
+	FRTPlanScopedTransaction(URTPlanDocument* InDocument, const FString& Description)
+		: Document(InDocument)
+	{
+		if (Document)
+		{
+			Document->BeginTransaction(Description);
+		}
+	}
+
+	~FRTPlanScopedTransaction()
+	{
+		Commit();
+	}
+
+	// End the transaction now. Returns false if it was rolled back.
+	bool Commit()
+	{
+		if (!Document || bEnded)
+		{
+			return false;
+		}
+		bEnded = true;
+		return Document->EndTransaction();
+	}
+
+	// Roll back everything submitted in this transaction.
+	void Cancel()
+	{
+		if (Document && !bEnded)
+		{
+			bEnded = true;
+			Document->CancelTransaction();
+		}
+	}
+
+	FRTPlanScopedTransaction(const FRTPlanScopedTransaction&) = delete;
+	FRTPlanScopedTransaction& operator=(const FRTPlanScopedTransaction&) = delete;
+
+private:
+	URTPlanDocument* Document = nullptr;
+	bool bEnded = false;
 };
@@ -0,0 +1,86 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "RTPlanSchema.h"
+#include "RTPlanDelta.h"
+
+class URTPlanDocument;
+
+/**
+ * RTPlanEditList.h
+ * Plain-struct list of entity edits applied as a single command (see URTCmdBatch).
+ * Values live in contiguous per-kind arrays, so a bulk edit of N entities costs a handful of
+ * allocations and one UObject instead of N command objects for the GC to create and trace.
+ */
+
+/** Contiguous per-kind value storage used by FRTPlanEditList. */
+struct RTPLANCORE_API FRTPlanEditValues
+{
+	TArray<FRTVertex> Vertices;
+	TArray<FRTWall> Walls;
+	TArray<FRTOpening> Openings;
+	TArray<FRTInteriorInstance> Objects;
+	TArray<FRTCabinetRun> Runs;
+
+	void Reset();
+	SIZE_T GetAllocatedSize() const;
+};
+
+class RTPLANCORE_API FRTPlanEditList
+{
+public:
+	// --- Building ---
+	// Edits are applied in the order they are added.
+	// Removing a wall also removes the openings it hosts (matching URTCmdDeleteWall).
+
+	void SetVertex(const FRTVertex& Vertex);
+	void RemoveVertex(const FGuid& Id);
+
+	void SetWall(const FRTWall& Wall);
+	void RemoveWall(const FGuid& Id);
+
+	void SetOpening(const FRTOpening& Opening);
+	void RemoveOpening(const FGuid& Id);
+
+	void SetObject(const FRTInteriorInstance& Object);
+	void RemoveObject(const FGuid& Id);
+
+	void SetRun(const FRTCabinetRun& Run);
+	void RemoveRun(const FGuid& Id);
+
+	void Reserve(int32 NumEdits);
+	void Reset();
+
+	int32 Num() const { return Edits.Num(); }
+	bool IsEmpty() const { return Edits.Num() == 0; }
+
+	// --- Applying ---
+
+	// Apply all edits through the document mutation API, recording the previous state for Revert.
+	void Apply(URTPlanDocument& Document);
+
+	// Restore the state recorded by the last Apply (in reverse order).
+	void Revert(URTPlanDocument& Document);
+
+	SIZE_T GetAllocatedSize() const;
+
+private:
+	struct FEdit
+	{
+		FGuid Id;
+		// Index into the matching FRTPlanEditValues array, INDEX_NONE for a removal
+		int32 ValueIndex = INDEX_NONE;
+		ERTPlanEntityKind Kind = ERTPlanEntityKind::Vertex;
+	};
+
+	template<typename T>
+	void ApplyEdit(URTPlanDocument& Document, const FEdit& Edit, const FRTPlanEditValues& Source, bool bRecordUndo);
+
+	// Requested edits
+	TArray<FEdit> Edits;
+	FRTPlanEditValues Values;
+
+	// Inverse of the last Apply (including cascaded opening removals)
+	TArray<FEdit> UndoEdits;
+	FRTPlanEditValues UndoValues;
+};
@@ -0,0 +1,55 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "RTPlanSchema.h"
+
+/**
+ * RTPlanReverseIndex.h
+ * Adjacency / back-references between plan entities, maintained incrementally by the document.
+ * Turns topology queries (walls at a vertex, openings on a wall, ...) into O(degree) lookups.
+ */
+
+// Most vertices join 1-4 walls and most walls host a handful of openings
+using FRTPlanIdList = TArray<FGuid, TInlineAllocator<4>>;
+
+class RTPLANCORE_API FRTPlanReverseIndex
+{
+public:
+	void Rebuild(const FRTPlanData& Data);
+	void Reset();
+
+	// OldX is the previous value when overwriting, nullptr when adding
+	void OnWallSet(const FRTWall* OldWall, const FRTWall& NewWall);
+	void OnWallRemoved(const FRTWall& Wall);
+
+	void OnOpeningSet(const FRTOpening* OldOpening, const FRTOpening& NewOpening);
+	void OnOpeningRemoved(const FRTOpening& Opening);
+
+	void OnObjectSet(const FRTInteriorInstance* OldObject, const FRTInteriorInstance& NewObject);
+	void OnObjectRemoved(const FRTInteriorInstance& Object);
+
+	void OnRunSet(const FRTCabinetRun* OldRun, const FRTCabinetRun& NewRun);
+	void OnRunRemoved(const FRTCabinetRun& Run);
+
+	// --- Queries ---
+
+	TConstArrayView<FGuid> GetWallsAtVertex(const FGuid& VertexId) const { return Lookup(VertexToWalls, VertexId); }
+	TConstArrayView<FGuid> GetOpeningsOnWall(const FGuid& WallId) const { return Lookup(WallToOpenings, WallId); }
+	TConstArrayView<FGuid> GetRunsOnWall(const FGuid& WallId) const { return Lookup(WallToRuns, WallId); }
+	TConstArrayView<FGuid> GetObjectsOnWall(const FGuid& WallId) const { return Lookup(WallToObjects, WallId); }
+	TConstArrayView<FGuid> GetObjectsGeneratedByRun(const FGuid& RunId) const { return Lookup(RunToObjects, RunId); }
+
+	// All runs that currently own generated objects (including runs that no longer exist)
+	const TMap<FGuid, FRTPlanIdList>& GetRunToObjects() const { return RunToObjects; }
+
+private:
+	static void Link(TMap<FGuid, FRTPlanIdList>& Map, const FGuid& Key, const FGuid& Id);
+	static void Unlink(TMap<FGuid, FRTPlanIdList>& Map, const FGuid& Key, const FGuid& Id);
+	static TConstArrayView<FGuid> Lookup(const TMap<FGuid, FRTPlanIdList>& Map, const FGuid& Key);
+
+	TMap<FGuid, FRTPlanIdList> VertexToWalls;
+	TMap<FGuid, FRTPlanIdList> WallToOpenings;
+	TMap<FGuid, FRTPlanIdList> WallToRuns;
+	TMap<FGuid, FRTPlanIdList> WallToObjects;
+	TMap<FGuid, FRTPlanIdList> RunToObjects;
+};
@@ -0,0 +1,194 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * RTPlanSlotMap.h
+ * Dense, cache-friendly entity storage with stable 32-bit handles.
+ * Values live contiguously (swap-remove keeps them packed); handles stay valid until the entity is removed.
+ */
+
+/**
+ * Stable handle into a TRTSlotMap.
+ * Low 24 bits = slot index, high 8 bits = generation (detects reuse of a freed slot).
+ */
+struct FRTPlanHandle
+{
+	static constexpr uint32 IndexBits = 24;
+	static constexpr uint32 IndexMask = (1u << IndexBits) - 1;
+	static constexpr uint32 GenerationMask = 0xFF;
+
+	uint32 Value = MAX_uint32;
+
+	FRTPlanHandle() = default;
+	FRTPlanHandle(uint32 Index, uint32 Generation)
+		: Value(((Generation & GenerationMask) << IndexBits) | (Index & IndexMask))
+	{
+	}
+
+	bool IsValid() const { return Value != MAX_uint32; }
+	uint32 GetIndex() const { return Value & IndexMask; }
+	uint32 GetGeneration() const { return Value >> IndexBits; }
+
+	bool operator==(const FRTPlanHandle& Other) const { return Value == Other.Value; }
+	bool operator!=(const FRTPlanHandle& Other) const { return Value != Other.Value; }
+
+	friend uint32 GetTypeHash(const FRTPlanHandle& Handle) { return Handle.Value; }
+};
+
+template<typename T>
+class TRTSlotMap
+{
+public:
+	// Add or overwrite. Overwriting keeps the existing handle.
+	FRTPlanHandle Set(const FGuid& Id, const T& Value)
+	{
+		if (const FRTPlanHandle* Existing = IdToHandle.Find(Id))
+		{
+			Dense[Slots[Existing->GetIndex()].DenseIndex] = Value;
+			return *Existing;
+		}
+
+		uint32 SlotIndex;
+		if (FreeSlots.Num() > 0)
+		{
+			SlotIndex = FreeSlots.Pop(EAllowShrinking::No);
+		}
+		else
+		{
+			SlotIndex = Slots.AddDefaulted();
+			check(SlotIndex < FRTPlanHandle::IndexMask);
+		}
+
+		FSlot& Slot = Slots[SlotIndex];
+		Slot.DenseIndex = Dense.Add(Value);
+		DenseIds.Add(Id);
+		DenseSlots.Add(SlotIndex);
+
+		const FRTPlanHandle Handle(SlotIndex, Slot.Generation);
+		IdToHandle.Add(Id, Handle);
+		return Handle;
+	}
+
+	bool Remove(const FGuid& Id)
+	{
+		FRTPlanHandle Handle;
+		if (!IdToHandle.RemoveAndCopyValue(Id, Handle))
+		{
+			return false;
+		}
+
+		FSlot& Slot = Slots[Handle.GetIndex()];
+		const int32 DenseIndex = Slot.DenseIndex;
+		const int32 LastIndex = Dense.Num() - 1;
+
+		// Swap-remove: the last element moves into the hole, patch its slot
+		if (DenseIndex != LastIndex)
+		{
+			Slots[DenseSlots[LastIndex]].DenseIndex = DenseIndex;
+		}
+		Dense.RemoveAtSwap(DenseIndex, 1, EAllowShrinking::No);
+		DenseIds.RemoveAtSwap(DenseIndex, 1, EAllowShrinking::No);
+		DenseSlots.RemoveAtSwap(DenseIndex, 1, EAllowShrinking::No);
+
+		Slot.DenseIndex = INDEX_NONE;
+		Slot.Generation = (Slot.Generation + 1) & FRTPlanHandle::GenerationMask;
+		FreeSlots.Add(Handle.GetIndex());
+		return true;
+	}
+
+	FRTPlanHandle GetHandle(const FGuid& Id) const
+	{
+		const FRTPlanHandle* Handle = IdToHandle.Find(Id);
+		return Handle ? *Handle : FRTPlanHandle();
+	}
+
+	bool Contains(const FGuid& Id) const { return IdToHandle.Contains(Id); }
+
+	// Returns nullptr for stale / invalid handles
+	const T* Find(FRTPlanHandle Handle) const
+	{
+		const int32 DenseIndex = GetDenseIndex(Handle);
+		return DenseIndex != INDEX_NONE ? &Dense[DenseIndex] : nullptr;
+	}
+
+	T* Find(FRTPlanHandle Handle)
+	{
+		const int32 DenseIndex = GetDenseIndex(Handle);
+		return DenseIndex != INDEX_NONE ? &Dense[DenseIndex] : nullptr;
+	}
+
+	const T* Find(const FGuid& Id) const
+	{
+		const FRTPlanHandle* Handle = IdToHandle.Find(Id);
+		return Handle ? &Dense[Slots[Handle->GetIndex()].DenseIndex] : nullptr;
+	}
+
+	T* Find(const FGuid& Id)
+	{
+		const FRTPlanHandle* Handle = IdToHandle.Find(Id);
+		return Handle ? &Dense[Slots[Handle->GetIndex()].DenseIndex] : nullptr;
+	}
+
+	int32 GetDenseIndex(FRTPlanHandle Handle) const
+	{
+		if (!Handle.IsValid() || !Slots.IsValidIndex(Handle.GetIndex()))
+		{
+			return INDEX_NONE;
+		}
+		const FSlot& Slot = Slots[Handle.GetIndex()];
+		return Slot.Generation == Handle.GetGeneration() ? Slot.DenseIndex : INDEX_NONE;
+	}
+
+	FRTPlanHandle GetHandleAt(int32 DenseIndex) const
+	{
+		const uint32 SlotIndex = DenseSlots[DenseIndex];
+		return FRTPlanHandle(SlotIndex, Slots[SlotIndex].Generation);
+	}
+
+	// Packed values / IDs (same order). Iterate these for linear scans.
+	TConstArrayView<T> GetValues() const { return Dense; }
+	TArrayView<T> GetValuesMutable() { return Dense; }
+	TConstArrayView<FGuid> GetIds() const { return DenseIds; }
+
+	int32 Num() const { return Dense.Num(); }
+
+	void Reserve(int32 Count)
+	{
+		Dense.Reserve(Count);
+		DenseIds.Reserve(Count);
+		DenseSlots.Reserve(Count);
+		Slots.Reserve(Count);
+		IdToHandle.Reserve(Count);
+	}
+
+	void Reset()
+	{
+		Dense.Reset();
+		DenseIds.Reset();
+		DenseSlots.Reset();
+		Slots.Reset();
+		FreeSlots.Reset();
+		IdToHandle.Reset();
+	}
+
+	// Ranged-for over packed values
+	auto begin() const { return Dense.begin(); }
+	auto end() const { return Dense.end(); }
+
+private:
+	struct FSlot
+	{
+		int32 DenseIndex = INDEX_NONE;
+		uint32 Generation = 0;
+	};
+
+	TArray<T> Dense;
+	TArray<FGuid> DenseIds;
+	TArray<uint32> DenseSlots;
+
+	TArray<FSlot> Slots;
+	TArray<uint32> FreeSlots;
+
+	TMap<FGuid, FRTPlanHandle> IdToHandle;
+};
@@ -0,0 +1,60 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "RTPlanSchema.h"
+#include "RTPlanDelta.h"
+
+/**
+ * RTPlanSnapshot.h
+ * Immutable, reference-counted view of FRTPlanData at one document revision.
+ * Safe to hand to worker threads (meshing, indexing, serialization) while the game thread keeps editing.
+ * Entities are shared between consecutive snapshots; only the ones that changed are copied.
+ */
+
+template<typename T>
+using TRTPlanSharedEntity = TSharedRef<const T, ESPMode::ThreadSafe>;
+
+template<typename T>
+using TRTPlanSnapshotMap = TMap<FGuid, TRTPlanSharedEntity<T>>;
+
+struct FRTPlanSnapshot;
+using FRTPlanSnapshotRef = TSharedRef<const FRTPlanSnapshot, ESPMode::ThreadSafe>;
+using FRTPlanSnapshotPtr = TSharedPtr<const FRTPlanSnapshot, ESPMode::ThreadSafe>;
+
+struct RTPLANCORE_API FRTPlanSnapshot
+{
+	// Document revision this snapshot was taken at
+	uint64 Revision = 0;
+
+	TRTPlanSnapshotMap<FRTVertex> Vertices;
+	TRTPlanSnapshotMap<FRTWall> Walls;
+	TRTPlanSnapshotMap<FRTOpening> Openings;
+	TRTPlanSnapshotMap<FRTInteriorInstance> Objects;
+	TRTPlanSnapshotMap<FRTCabinetRun> Runs;
+
+	int32 Version = 1;
+
+	const FRTVertex* FindVertex(const FGuid& Id) const { return FindEntity(Vertices, Id); }
+	const FRTWall* FindWall(const FGuid& Id) const { return FindEntity(Walls, Id); }
+	const FRTOpening* FindOpening(const FGuid& Id) const { return FindEntity(Openings, Id); }
+	const FRTInteriorInstance* FindObject(const FGuid& Id) const { return FindEntity(Objects, Id); }
+	const FRTCabinetRun* FindRun(const FGuid& Id) const { return FindEntity(Runs, Id); }
+
+	// Materialize a plain copy (e.g. to serialize on a worker thread)
+	FRTPlanData ToData() const;
+
+	/**
+	 * Build a snapshot of Data.
+	 * With a Previous snapshot and the Changes made since it, only changed entities are copied;
+	 * everything else is shared. Without one (or on a full rebuild) every entity is copied.
+	 */
+	static FRTPlanSnapshotRef Create(const FRTPlanData& Data, uint64 Revision, const FRTPlanSnapshot* Previous = nullptr, const FRTPlanDelta* Changes = nullptr);
+
+private:
+	template<typename T>
+	static const T* FindEntity(const TRTPlanSnapshotMap<T>& Map, const FGuid& Id)
+	{
+		const TRTPlanSharedEntity<T>* Entity = Map.Find(Id);
+		return Entity ? &Entity->Get() : nullptr;
+	}
+};
@@ -0,0 +1,63 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "RTPlanUndoHistory.generated.h"
+
+class URTCommand;
+
+/**
+ * RTPlanUndoHistory.h
+ * Undo history stored in a ring buffer and bounded by memory rather than step count.
+ * Pushing is amortized O(1); the oldest commands are evicted once the byte budget is exceeded.
+ */
+USTRUCT()
+struct RTPLANCORE_API FRTPlanUndoHistory
+{
+	GENERATED_BODY()
+
+	// 64 MB keeps thousands of typical edit steps
+	static constexpr int64 DefaultMaxBytes = 64ll * 1024 * 1024;
+
+	// Add the newest command, evicting the oldest ones until the budget fits.
+	// The newest command is always kept, even if it alone exceeds the budget.
+	void Push(URTCommand* Command);
+
+	// Remove and return the newest command (nullptr if empty).
+	URTCommand* Pop();
+
+	// Newest-first access, Index 0 = next command to undo.
+	URTCommand* GetFromNewest(int32 Index) const;
+
+	int32 Num() const { return Count; }
+	bool IsEmpty() const { return Count == 0; }
+
+	// Bytes accounted for the commands currently held (see URTCommand::GetAllocatedSize)
+	int64 GetUsedBytes() const { return UsedBytes; }
+
+	int64 GetMaxBytes() const { return MaxBytes; }
+	void SetMaxBytes(int64 InMaxBytes);
+
+	void Reset();
+
+private:
+	int32 GetCapacity() const { return Ring.Num(); }
+	int32 ToRingIndex(int32 LogicalIndex) const { return (Head + LogicalIndex) % GetCapacity(); }
+
+	// Double the ring capacity, unwrapping the contents to start at 0
+	void Grow();
+
+	// Drop the oldest commands while over budget (keeps at least one)
+	void EvictToBudget();
+
+	// Slot storage, referenced for GC. Logical order starts at Head and wraps.
+	UPROPERTY()
+	TArray<TObjectPtr<URTCommand>> Ring;
+
+	// Accounted size of each slot (same indexing as Ring)
+	TArray<int64> Sizes;
+
+	int32 Head = 0;
+	int32 Count = 0;
+	int64 UsedBytes = 0;
+	int64 MaxBytes = DefaultMaxBytes;
+};
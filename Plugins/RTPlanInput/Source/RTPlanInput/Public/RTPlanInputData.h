@@ -59,6 +59,24 @@ enum class ERTArithmeticOp : uint8
 	Divide
 };
 
+/**
+ * Alignment guide for HUD visualization: drawn as a dashed line from the geometry
+ * the cursor aligns with to the aligned cursor position.
+ */
+USTRUCT(BlueprintType)
+struct RTPLANINPUT_API FRTDraftingGuide
+{
+	GENERATED_BODY()
+
+	// Vertex / wall point the guide comes from (world space)
+	UPROPERTY(BlueprintReadOnly)
+	FVector2D Source = FVector2D::ZeroVector;
+
+	// Aligned cursor position (world space)
+	UPROPERTY(BlueprintReadOnly)
+	FVector2D Target = FVector2D::ZeroVector;
+};
+
 /**
  * Drafting state exposed by tools for HUD visualization.
  * Contains preview line endpoints, current length/angle, and input buffer state.
@@ -116,6 +134,11 @@ struct RTPLANINPUT_API FRTDraftingState
 	// Third point (cursor position) for arc - used for line drafting visualization from EndPoint to cursor
 	UPROPERTY(BlueprintReadOnly)
 	FVector2D ArcThirdPoint = FVector2D::ZeroVector;
+
+	// --- Alignment Guides ---
+	// Guides the cursor is currently aligned to (also set while not drafting)
+	UPROPERTY(BlueprintReadOnly)
+	TArray<FRTDraftingGuide> AlignmentGuides;
 };
 
 /**
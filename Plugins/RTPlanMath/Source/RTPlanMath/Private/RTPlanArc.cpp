@@ -0,0 +1,223 @@
+﻿#include "RTPlanArc.h"
+
+namespace RTPlanArcPrivate
+{
+	// Slack on the swept range so endpoints hit exactly on the boundary count as inside
+	constexpr double AngleTolerance = 1e-9;
+}
+
+FRTPlanArc FRTPlanArc::FromCenterStartSweep(const FVector2D& InCenter, const FVector2D& Start, float SweepDegrees)
+{
+	const FVector2D ToStart = Start - InCenter;
+	return FRTPlanArc(InCenter, ToStart.Size(), FMath::Atan2(ToStart.Y, ToStart.X), FMath::DegreesToRadians((double)SweepDegrees));
+}
+
+FVector2D FRTPlanArc::GetPoint(double T) const
+{
+	const double Angle = StartAngle + Sweep * T;
+	return Center + FVector2D(FMath::Cos(Angle), FMath::Sin(Angle)) * Radius;
+}
+
+bool FRTPlanArc::ContainsAngle(double AngleRadians, double* OutT) const
+{
+	const double AbsSweep = FMath::Abs(Sweep);
+
+	// Angular distance from the start, measured in the sweep direction, in [0, 2pi)
+	double Delta = (Sweep >= 0.0) ? (AngleRadians - StartAngle) : (StartAngle - AngleRadians);
+	Delta = FMath::Fmod(Delta, UE_DOUBLE_TWO_PI);
+	if (Delta < 0.0)
+	{
+		Delta += UE_DOUBLE_TWO_PI;
+	}
+
+	// Just below the start wraps to almost 2pi
+	if (Delta > UE_DOUBLE_TWO_PI - RTPlanArcPrivate::AngleTolerance)
+	{
+		Delta = 0.0;
+	}
+
+	// Full circles contain every direction
+	if (Delta > AbsSweep + RTPlanArcPrivate::AngleTolerance && AbsSweep < UE_DOUBLE_TWO_PI)
+	{
+		return false;
+	}
+
+	if (OutT)
+	{
+		*OutT = AbsSweep > 0.0 ? FMath::Min(Delta / AbsSweep, 1.0) : 0.0;
+	}
+	return true;
+}
+
+FVector2D FRTPlanArc::ClosestPoint(const FVector2D& P) const
+{
+	const FVector2D ToP = P - Center;
+	const double DistSq = ToP.SizeSquared();
+
+	// At the center every arc point is equally close
+	if (DistSq < UE_DOUBLE_SMALL_NUMBER)
+	{
+		return GetStart();
+	}
+
+	if (ContainsAngle(FMath::Atan2(ToP.Y, ToP.X)))
+	{
+		return Center + ToP * (Radius / FMath::Sqrt(DistSq));
+	}
+
+	const FVector2D Start = GetStart();
+	const FVector2D End = GetEnd();
+	return FVector2D::DistSquared(P, Start) <= FVector2D::DistSquared(P, End) ? Start : End;
+}
+
+int32 FRTPlanArc::IntersectCircle(const FVector2D& Origin, const FVector2D& Direction, double OutT[2]) const
+{
+	// |Origin + t * Direction - Center|^2 = Radius^2
+	const FVector2D F = Origin - Center;
+	const double A = Direction | Direction;
+	const double B = 2.0 * (F | Direction);
+	const double C = (F | F) - Radius * Radius;
+
+	if (A < UE_DOUBLE_SMALL_NUMBER)
+	{
+		return 0;
+	}
+
+	const double Discriminant = B * B - 4.0 * A * C;
+	if (Discriminant < 0.0)
+	{
+		return 0;
+	}
+
+	const double Root = FMath::Sqrt(Discriminant);
+	OutT[0] = (-B - Root) / (2.0 * A);
+	OutT[1] = (-B + Root) / (2.0 * A);
+	return Root > 0.0 ? 2 : 1;
+}
+
+int32 FRTPlanArc::IntersectSegment(const FVector2D& A, const FVector2D& B, FVector2D OutPoints[2]) const
+{
+	double T[2];
+	const int32 NumRoots = IntersectCircle(A, B - A, T);
+
+	int32 NumHits = 0;
+	for (int32 i = 0; i < NumRoots; ++i)
+	{
+		if (T[i] < -UE_DOUBLE_KINDA_SMALL_NUMBER || T[i] > 1.0 + UE_DOUBLE_KINDA_SMALL_NUMBER)
+		{
+			continue;
+		}
+
+		const FVector2D Hit = A + (B - A) * T[i];
+		const FVector2D ToHit = Hit - Center;
+		if (ContainsAngle(FMath::Atan2(ToHit.Y, ToHit.X)))
+		{
+			OutPoints[NumHits++] = Hit;
+		}
+	}
+	return NumHits;
+}
+
+int32 FRTPlanArc::IntersectArc(const FRTPlanArc& Other, FVector2D OutPoints[2]) const
+{
+	// Circle / circle: the hits lie on the radical line at distance X from Center along the center line
+	const FVector2D Offset = Other.Center - Center;
+	const double D = Offset.Size();
+	if (D < UE_DOUBLE_KINDA_SMALL_NUMBER || D > Radius + Other.Radius + UE_DOUBLE_KINDA_SMALL_NUMBER
+		|| D < FMath::Abs(Radius - Other.Radius) - UE_DOUBLE_KINDA_SMALL_NUMBER)
+	{
+		return 0;
+	}
+
+	const double X = (D * D + Radius * Radius - Other.Radius * Other.Radius) / (2.0 * D);
+	const double H = FMath::Sqrt(FMath::Max(Radius * Radius - X * X, 0.0));
+	const FVector2D Dir = Offset / D;
+	const FVector2D Base = Center + Dir * X;
+	const FVector2D Perp(-Dir.Y, Dir.X);
+
+	const FVector2D Candidates[2] = { Base + Perp * H, Base - Perp * H };
+	const int32 NumCandidates = H > UE_DOUBLE_KINDA_SMALL_NUMBER ? 2 : 1;
+
+	int32 NumHits = 0;
+	for (int32 i = 0; i < NumCandidates; ++i)
+	{
+		const FVector2D ToHit = Candidates[i] - Center;
+		const FVector2D ToOtherHit = Candidates[i] - Other.Center;
+		if (ContainsAngle(FMath::Atan2(ToHit.Y, ToHit.X)) && Other.ContainsAngle(FMath::Atan2(ToOtherHit.Y, ToOtherHit.X)))
+		{
+			OutPoints[NumHits++] = Candidates[i];
+		}
+	}
+	return NumHits;
+}
+
+bool FRTPlanArc::IntersectRay(const FVector2D& Origin, const FVector2D& Direction, double& OutT) const
+{
+	double T[2];
+	const int32 NumRoots = IntersectCircle(Origin, Direction, T);
+
+	// Roots are ascending: the first valid one is the nearest hit
+	for (int32 i = 0; i < NumRoots; ++i)
+	{
+		if (T[i] < 0.0)
+		{
+			continue;
+		}
+
+		const FVector2D ToHit = Origin + Direction * T[i] - Center;
+		if (ContainsAngle(FMath::Atan2(ToHit.Y, ToHit.X)))
+		{
+			OutT = T[i];
+			return true;
+		}
+	}
+	return false;
+}
+
+bool FRTPlanArc::IntersectsRect(const FVector2D& RectMin, const FVector2D& RectMax) const
+{
+	auto IsInside = [&RectMin, &RectMax](const FVector2D& P)
+	{
+		return P.X >= RectMin.X && P.X <= RectMax.X && P.Y >= RectMin.Y && P.Y <= RectMax.Y;
+	};
+
+	// An arc fully inside has its endpoints inside; otherwise it must cross an edge
+	if (IsInside(GetStart()) || IsInside(GetEnd()))
+	{
+		return true;
+	}
+
+	if (!GetBounds().Intersect(FBox2D(RectMin, RectMax)))
+	{
+		return false;
+	}
+
+	const FVector2D Corners[4] = { RectMin, FVector2D(RectMax.X, RectMin.Y), RectMax, FVector2D(RectMin.X, RectMax.Y) };
+	FVector2D Hits[2];
+	for (int32 i = 0; i < 4; ++i)
+	{
+		if (IntersectSegment(Corners[i], Corners[(i + 1) % 4], Hits) > 0)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+FBox2D FRTPlanArc::GetBounds() const
+{
+	FBox2D Bounds(ForceInit);
+	Bounds += GetStart();
+	Bounds += GetEnd();
+
+	// Axis extremes (0, 90, 180, 270 degrees) reached within the sweep
+	for (int32 Quadrant = 0; Quadrant < 4; ++Quadrant)
+	{
+		const double Angle = Quadrant * UE_DOUBLE_HALF_PI;
+		if (ContainsAngle(Angle))
+		{
+			Bounds += Center + FVector2D(FMath::Cos(Angle), FMath::Sin(Angle)) * Radius;
+		}
+	}
+	return Bounds;
+}
@@ -41,6 +41,41 @@ FVector2D FRTPlanGeometryUtils::ClosestPointOnSegment(const FVector2D& P, const
 	return A + AB * T;
 }
 
+double FRTPlanGeometryUtils::DistanceSquaredPointToSegment(const FVector2D& P, const FVector2D& A, const FVector2D& B)
+{
+	const FVector2D AB = B - A;
+	const double LengthSquared = AB.SizeSquared();
+	const double T = LengthSquared > UE_DOUBLE_SMALL_NUMBER ? FMath::Clamp(((P - A) | AB) / LengthSquared, 0.0, 1.0) : 0.0;
+	return FVector2D::DistSquared(P, A + AB * T);
+}
+
+bool FRTPlanGeometryUtils::SegmentIntersectsRect(const FVector2D& A, const FVector2D& B, const FVector2D& RectMin, const FVector2D& RectMax)
+{
+	// Clip the segment's parameter range [0, 1] against the X and Y slabs of the rectangle
+	double TEnter = 0.0;
+	double TExit = 1.0;
+	for (int32 Axis = 0; Axis < 2; ++Axis)
+	{
+		const double Start = A[Axis];
+		const double Delta = B[Axis] - A[Axis];
+		if (FMath::Abs(Delta) < UE_DOUBLE_SMALL_NUMBER)
+		{
+			// Parallel to the slab: inside it or never
+			if (Start < RectMin[Axis] || Start > RectMax[Axis])
+			{
+				return false;
+			}
+			continue;
+		}
+
+		const double T1 = (RectMin[Axis] - Start) / Delta;
+		const double T2 = (RectMax[Axis] - Start) / Delta;
+		TEnter = FMath::Max(TEnter, FMath::Min(T1, T2));
+		TExit = FMath::Min(TExit, FMath::Max(T1, T2));
+	}
+	return TEnter <= TExit;
+}
+
 void FRTPlanGeometryUtils::GetWallNormals(const FVector2D& A, const FVector2D& B, FVector2D& OutLeft, FVector2D& OutRight)
 {
 	FVector2D Direction = (B - A).GetSafeNormal();
@@ -0,0 +1,154 @@
+﻿#include "RTPlanJunctionSolver.h"
+
+namespace RTPlanJunctionSolverPrivate
+{
+	FVector2D LeftNormal(const FVector2D& Direction)
+	{
+		return FVector2D(-Direction.Y, Direction.X);
+	}
+
+	// Counter-clockwise angle from Direction to Other, in (0, 2pi]
+	double AngleTo(const FVector2D& Direction, const FVector2D& Other)
+	{
+		double Angle = FMath::Atan2(FVector2D::CrossProduct(Direction, Other), FVector2D::DotProduct(Direction, Other));
+		if (Angle <= UE_DOUBLE_KINDA_SMALL_NUMBER)
+		{
+			Angle += UE_DOUBLE_TWO_PI;
+		}
+		return Angle;
+	}
+
+	/**
+	 * Distance along Arm from the vertex to where its side (SideSign +1 left, -1 right) meets Neighbour's opposite side.
+	 * Parallel sides (a straight run, or overlapping walls) are cut square at the vertex.
+	 */
+	double CutOffset(const FRTPlanJunctionArm& Arm, const FRTPlanJunctionArm& Neighbour, double SideSign)
+	{
+		const double Denominator = FVector2D::CrossProduct(Arm.Direction, Neighbour.Direction);
+		if (FMath::Abs(Denominator) < 1e-4)
+		{
+			return 0.0;
+		}
+
+		// Arm side:       SideSign * N_a * h_a + D_a * t
+		// Neighbour side: -SideSign * N_n * h_n + D_n * s
+		const FVector2D Gap = -SideSign * (LeftNormal(Neighbour.Direction) * Neighbour.HalfThickness + LeftNormal(Arm.Direction) * Arm.HalfThickness);
+		const double Offset = FVector2D::CrossProduct(Gap, Neighbour.Direction) / Denominator;
+
+		const double Limit = FRTPlanJunctionSolver::MitreLimit * FMath::Max(Arm.HalfThickness, Neighbour.HalfThickness);
+		return FMath::Clamp(Offset, -Limit, Limit);
+	}
+
+	FRTPlanWallEnd SolveEndAt(const FRTWall& Wall, const FVector2D& A, const FVector2D& B, bool bAtStart,
+		TConstArrayView<FGuid> WallsAtVertex, FRTPlanJunctionSolver::FResolveWall ResolveWall)
+	{
+		const FGuid& VertexId = bAtStart ? Wall.VertexAId : Wall.VertexBId;
+
+		TArray<FRTPlanJunctionArm, TInlineAllocator<8>> Arms;
+		for (const FGuid& WallId : WallsAtVertex)
+		{
+			if (WallId == Wall.Id)
+			{
+				continue;
+			}
+
+			FVector2D OtherA, OtherB;
+			const FRTWall* Other = ResolveWall(WallId, OtherA, OtherB);
+			if (Other && FRTPlanJunctionSolver::IsSolid(*Other, OtherA, OtherB))
+			{
+				Arms.Add(FRTPlanJunctionSolver::MakeArm(*Other, OtherA, OtherB, Other->VertexAId == VertexId));
+			}
+		}
+
+		const int32 Self = Arms.Add(FRTPlanJunctionSolver::MakeArm(Wall, A, B, bAtStart));
+		return FRTPlanJunctionSolver::SolveEnd(Arms, Self, bAtStart);
+	}
+}
+
+void FRTPlanJunctionSolver::SolveEnds(const FRTWall& Wall, const FVector2D& A, const FVector2D& B, TConstArrayView<FGuid> WallsAtA, TConstArrayView<FGuid> WallsAtB,
+	FResolveWall ResolveWall, FRTPlanWallEnd& OutStart, FRTPlanWallEnd& OutEnd)
+{
+	using namespace RTPlanJunctionSolverPrivate;
+
+	OutStart = FRTPlanWallEnd();
+	OutEnd = FRTPlanWallEnd();
+	if (!IsSolid(Wall, A, B))
+	{
+		return;
+	}
+
+	OutStart = SolveEndAt(Wall, A, B, true, WallsAtA, ResolveWall);
+	OutEnd = SolveEndAt(Wall, A, B, false, WallsAtB, ResolveWall);
+}
+
+bool FRTPlanJunctionSolver::IsSolid(const FRTWall& Wall, const FVector2D& A, const FVector2D& B)
+{
+	return Wall.VertexAId != Wall.VertexBId && FVector2D::Distance(A, B) >= 1.0f;
+}
+
+FRTPlanJunctionArm FRTPlanJunctionSolver::MakeArm(const FRTWall& Wall, const FVector2D& A, const FVector2D& B, bool bAtStart)
+{
+	FRTPlanJunctionArm Arm;
+	Arm.HalfThickness = Wall.ThicknessCm * 0.5f;
+
+	if (Wall.bIsArc && FMath::Abs(Wall.ArcSweepAngle) > 0.1f)
+	{
+		// Tangent of travel at the end, turned to point away from the vertex
+		const FVector2D Radial = ((bAtStart ? A : B) - Wall.ArcCenter).GetSafeNormal();
+		const FVector2D Travel = Wall.ArcSweepAngle > 0 ? FVector2D(-Radial.Y, Radial.X) : FVector2D(Radial.Y, -Radial.X);
+		Arm.Direction = bAtStart ? Travel : -Travel;
+	}
+	else
+	{
+		Arm.Direction = (bAtStart ? B - A : A - B).GetSafeNormal();
+	}
+	return Arm;
+}
+
+FRTPlanWallEnd FRTPlanJunctionSolver::SolveEnd(TConstArrayView<FRTPlanJunctionArm> Arms, int32 Self, bool bAtStart)
+{
+	using namespace RTPlanJunctionSolverPrivate;
+
+	FRTPlanWallEnd End;
+	if (!Arms.IsValidIndex(Self) || Arms.Num() < 2)
+	{
+		return End;
+	}
+
+	// Nearest arms counter-clockwise (on this arm's left) and clockwise (on its right)
+	const FRTPlanJunctionArm& Arm = Arms[Self];
+	int32 LeftNeighbour = INDEX_NONE;
+	int32 RightNeighbour = INDEX_NONE;
+	double LeftAngle = TNumericLimits<double>::Max();
+	double RightAngle = TNumericLimits<double>::Max();
+	for (int32 Index = 0; Index < Arms.Num(); ++Index)
+	{
+		if (Index == Self)
+		{
+			continue;
+		}
+
+		const double CounterClockwise = AngleTo(Arm.Direction, Arms[Index].Direction);
+		const double Clockwise = AngleTo(Arms[Index].Direction, Arm.Direction);
+		if (CounterClockwise < LeftAngle)
+		{
+			LeftAngle = CounterClockwise;
+			LeftNeighbour = Index;
+		}
+		if (Clockwise < RightAngle)
+		{
+			RightAngle = Clockwise;
+			RightNeighbour = Index;
+		}
+	}
+
+	// Offsets along the arm, away from the vertex, for the arm's own left / right
+	const double ArmLeft = CutOffset(Arm, Arms[LeftNeighbour], 1.0);
+	const double ArmRight = CutOffset(Arm, Arms[RightNeighbour], -1.0);
+
+	// At the B end the arm runs backwards along the wall, so its left is the wall's right
+	End.bCapped = false;
+	End.LeftOffset = bAtStart ? ArmLeft : -ArmRight;
+	End.RightOffset = bAtStart ? ArmRight : -ArmLeft;
+	return End;
+}
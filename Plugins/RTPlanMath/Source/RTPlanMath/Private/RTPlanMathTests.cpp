@@ -1,6 +1,8 @@
 ﻿#include "CoreMinimal.h"
 #include "Misc/AutomationTest.h"
 #include "RTPlanGeometryUtils.h"
+#include "RTPlanArc.h"
+#include "RTPlanSegmentBatch.h"
 
 IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRTPlanMathGeometryTest, "ArchVis.RTPlanMath.Geometry", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
 
@@ -41,3 +43,225 @@ bool FRTPlanMathGeometryTest::RunTest(const FString& Parameters)
 
 	return true;
 }
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRTPlanMathArcTest, "ArchVis.RTPlanMath.Arc", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FRTPlanMathArcTest::RunTest(const FString& Parameters)
+{
+	// Quarter circle of radius 100 from (100, 0) CCW to (0, 100)
+	const FRTPlanArc Arc = FRTPlanArc::FromCenterStartSweep(FVector2D(0, 0), FVector2D(100, 0), 90.0f);
+
+	TestTrue("End point", Arc.GetEnd().Equals(FVector2D(0, 100), 0.001));
+	TestEqual("Length", Arc.GetLength(), UE_DOUBLE_HALF_PI * 100.0, 0.001);
+
+	// Closest point is exact on the curve, not on a chord
+	const FVector2D OnCurve = Arc.ClosestPoint(FVector2D(200, 200));
+	TestTrue("Closest point on curve", OnCurve.Equals(FVector2D(70.7107, 70.7107), 0.001));
+	TestEqual("Distance to curve", Arc.Distance(FVector2D(50, 50)), 100.0 - FMath::Sqrt(5000.0), 0.001);
+
+	// Outside the sweep the nearest endpoint wins
+	TestTrue("Closest clamps to start", Arc.ClosestPoint(FVector2D(100, -50)).Equals(FVector2D(100, 0), 0.001));
+	TestTrue("Closest clamps to end", Arc.ClosestPoint(FVector2D(-50, 100)).Equals(FVector2D(0, 100), 0.001));
+
+	// Clockwise sweep covers the other side
+	const FRTPlanArc Clockwise = FRTPlanArc::FromCenterStartSweep(FVector2D(0, 0), FVector2D(100, 0), -90.0f);
+	TestTrue("CW contains -45", Clockwise.ContainsAngle(FMath::DegreesToRadians(-45.0)));
+	TestFalse("CW excludes +45", Clockwise.ContainsAngle(FMath::DegreesToRadians(45.0)));
+
+	// Segment through the arc: one hit inside the sweep (the other circle hit is outside it)
+	FVector2D Hits[2];
+	TestEqual("Segment hits", Arc.IntersectSegment(FVector2D(-200, 50), FVector2D(200, 50), Hits), 1);
+	TestTrue("Segment hit point", Hits[0].Equals(FVector2D(FMath::Sqrt(7500.0), 50), 0.001));
+
+	// Arc through the first one: of the two circle crossings (50, +-86.6) only one lies on both sweeps
+	const FRTPlanArc Crossing = FRTPlanArc::FromCenterStartSweep(FVector2D(100, 0), FVector2D(100, 100), 90.0f);
+	TestEqual("Arc hits", Arc.IntersectArc(Crossing, Hits), 1);
+	TestTrue("Arc hit point", Hits[0].Equals(FVector2D(50, FMath::Sqrt(7500.0)), 0.001));
+	TestEqual("Concentric arcs do not cross", Arc.IntersectArc(FRTPlanArc(FVector2D(0, 0), 50.0, 0.0, 1.0), Hits), 0);
+
+	// Ray from the center hits at the radius; ray pointing away from the sweep misses
+	double T = 0.0;
+	TestTrue("Ray hit", Arc.IntersectRay(FVector2D(0, 0), FVector2D(1, 1).GetSafeNormal(), T));
+	TestEqual("Ray distance", T, 100.0, 0.001);
+	TestFalse("Ray miss", Arc.IntersectRay(FVector2D(0, 0), FVector2D(-1, -1).GetSafeNormal(), T));
+
+	// Rect crossing the middle of the curve (no endpoint inside)
+	TestTrue("Rect crosses arc", Arc.IntersectsRect(FVector2D(60, 60), FVector2D(80, 80)));
+	TestFalse("Rect inside the chord", Arc.IntersectsRect(FVector2D(10, 10), FVector2D(40, 40)));
+
+	const FBox2D Bounds = Arc.GetBounds();
+	TestTrue("Bounds", Bounds.Min.Equals(FVector2D(0, 0), 0.001) && Bounds.Max.Equals(FVector2D(100, 100), 0.001));
+
+	return true;
+}
+
+namespace RTPlanMathTestsPrivate
+{
+	// Random segments in [0, Extent]^2, with a few degenerate and axis-parallel ones mixed in
+	FRTPlanSegmentSoA MakeRandomSegments(int32 Num, double Extent, int32 Seed)
+	{
+		FRandomStream Random(Seed);
+		FRTPlanSegmentSoA Segments;
+		Segments.Reset(Num);
+		for (int32 i = 0; i < Num; ++i)
+		{
+			const FVector2D A(Random.FRandRange(0.0, Extent), Random.FRandRange(0.0, Extent));
+			FVector2D B(Random.FRandRange(0.0, Extent), Random.FRandRange(0.0, Extent));
+			switch (i % 7)
+			{
+			case 0: B = A; break;
+			case 1: B.X = A.X; break;
+			case 2: B.Y = A.Y; break;
+			default: break;
+			}
+			Segments.Add(A, B);
+		}
+		return Segments;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRTPlanMathSegmentBatchTest, "ArchVis.RTPlanMath.SegmentBatch", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FRTPlanMathSegmentBatchTest::RunTest(const FString& Parameters)
+{
+	// Scalar reference helpers
+	TestEqual("Scalar distance squared", FRTPlanGeometryUtils::DistanceSquaredPointToSegment(FVector2D(50, 50), FVector2D(0, 0), FVector2D(100, 0)), 2500.0);
+	TestEqual("Scalar distance squared past the end", FRTPlanGeometryUtils::DistanceSquaredPointToSegment(FVector2D(103, 4), FVector2D(0, 0), FVector2D(100, 0)), 25.0);
+	TestTrue("Scalar rect: crossing without endpoints inside", FRTPlanGeometryUtils::SegmentIntersectsRect(FVector2D(-10, 5), FVector2D(20, 5), FVector2D(0, 0), FVector2D(10, 10)));
+	TestTrue("Scalar rect: touching a corner", FRTPlanGeometryUtils::SegmentIntersectsRect(FVector2D(-10, 20), FVector2D(10, 0), FVector2D(0, 0), FVector2D(10, 10)));
+	TestFalse("Scalar rect: diagonal past a corner", FRTPlanGeometryUtils::SegmentIntersectsRect(FVector2D(-10, 5), FVector2D(5, -10), FVector2D(0, 0), FVector2D(10, 10)));
+	TestFalse("Scalar rect: parallel outside", FRTPlanGeometryUtils::SegmentIntersectsRect(FVector2D(-10, 11), FVector2D(20, 11), FVector2D(0, 0), FVector2D(10, 10)));
+
+	// Odd count so the scalar tail runs too
+	const FRTPlanSegmentSoA Segments = RTPlanMathTestsPrivate::MakeRandomSegments(1003, 1000.0, 11);
+	const int32 Num = Segments.Num();
+
+	TArray<double> OutX, OutY, OutDistSq;
+	OutX.SetNumUninitialized(Num);
+	OutY.SetNumUninitialized(Num);
+	OutDistSq.SetNumUninitialized(Num);
+
+	FRandomStream Random(3);
+	for (int32 Query = 0; Query < 20; ++Query)
+	{
+		const FVector2D P(Random.FRandRange(-100.0f, 1100.0f), Random.FRandRange(-100.0f, 1100.0f));
+		FRTPlanSegmentBatch::ClosestPoints(P, Segments, OutX, OutY);
+		FRTPlanSegmentBatch::DistancesSquared(P, Segments, OutDistSq);
+
+		int32 NumClosestMismatches = 0;
+		int32 NumDistanceMismatches = 0;
+		int32 ScalarNearest = INDEX_NONE;
+		double ScalarNearestDistSq = UE_DOUBLE_BIG_NUMBER;
+		for (int32 i = 0; i < Num; ++i)
+		{
+			const FVector2D A = Segments.GetA(i);
+			const FVector2D B = Segments.GetB(i);
+			const FVector2D Closest = FRTPlanGeometryUtils::ClosestPointOnSegment(P, A, B);
+			const double DistSq = FRTPlanGeometryUtils::DistanceSquaredPointToSegment(P, A, B);
+
+			NumClosestMismatches += Closest.Equals(FVector2D(OutX[i], OutY[i]), 1e-6) ? 0 : 1;
+			NumDistanceMismatches += FMath::IsNearlyEqual(DistSq, OutDistSq[i], 1e-6 * FMath::Max(1.0, DistSq)) ? 0 : 1;
+			if (DistSq < ScalarNearestDistSq)
+			{
+				ScalarNearestDistSq = DistSq;
+				ScalarNearest = i;
+			}
+		}
+		TestEqual("Batched closest points match the scalar version", NumClosestMismatches, 0);
+		TestEqual("Batched distances match the scalar version", NumDistanceMismatches, 0);
+
+		double NearestDistSq = 0.0;
+		TestEqual("Nearest segment matches a scalar scan", FRTPlanSegmentBatch::FindNearest(P, Segments, NearestDistSq), ScalarNearest);
+		TestEqual("Nearest distance matches a scalar scan", NearestDistSq, ScalarNearestDistSq, 1e-6);
+
+		const FVector2D RectMin = P - FVector2D(Random.FRandRange(1.0f, 150.0f), Random.FRandRange(1.0f, 150.0f));
+		const FVector2D RectMax = P + FVector2D(Random.FRandRange(1.0f, 150.0f), Random.FRandRange(1.0f, 150.0f));
+		TArray<int32> BatchHits;
+		FRTPlanSegmentBatch::IntersectsRect(Segments, RectMin, RectMax, BatchHits);
+		TArray<int32> ScalarHits;
+		for (int32 i = 0; i < Num; ++i)
+		{
+			if (FRTPlanGeometryUtils::SegmentIntersectsRect(Segments.GetA(i), Segments.GetB(i), RectMin, RectMax))
+			{
+				ScalarHits.Add(i);
+			}
+		}
+		TestTrue("Batched rect hits match the scalar version", BatchHits == ScalarHits);
+	}
+
+	// Ties resolve to the lowest index, across lanes and the tail
+	FRTPlanSegmentSoA Ties;
+	for (int32 i = 0; i < 9; ++i)
+	{
+		Ties.Add(FVector2D(0, i % 2 ? 10 : 20), FVector2D(100, i % 2 ? 10 : 20));
+	}
+	double TieDistSq = 0.0;
+	TestEqual("Tie picks the lowest index", FRTPlanSegmentBatch::FindNearest(FVector2D(50, 0), Ties, TieDistSq), 1);
+	TestEqual("Empty batch has no nearest", FRTPlanSegmentBatch::FindNearest(FVector2D(50, 0), FRTPlanSegmentSoA(), TieDistSq), INDEX_NONE);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRTPlanMathSegmentBatchBenchmarkTest, "ArchVis.RTPlanMath.SegmentBatchBenchmark", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FRTPlanMathSegmentBatchBenchmarkTest::RunTest(const FString& Parameters)
+{
+	// Batched vs one-at-a-time over the same segments; the checksums keep both loops from being optimized away
+	const int32 Counts[] = { 64, 1024, 16384 };
+	const int32 NumQueries = 200;
+
+	for (const int32 Count : Counts)
+	{
+		const FRTPlanSegmentSoA Segments = RTPlanMathTestsPrivate::MakeRandomSegments(Count, 10000.0, Count);
+		TArray<double> OutDistSq;
+		OutDistSq.SetNumUninitialized(Count);
+
+		FRandomStream Random(Count);
+		TArray<FVector2D> Queries;
+		for (int32 i = 0; i < NumQueries; ++i)
+		{
+			Queries.Add(FVector2D(Random.FRandRange(0.0f, 10000.0f), Random.FRandRange(0.0f, 10000.0f)));
+		}
+
+		double ScalarChecksum = 0.0;
+		const double ScalarStart = FPlatformTime::Seconds();
+		for (const FVector2D& P : Queries)
+		{
+			for (int32 i = 0; i < Count; ++i)
+			{
+				ScalarChecksum += FRTPlanGeometryUtils::DistanceSquaredPointToSegment(P, Segments.GetA(i), Segments.GetB(i));
+			}
+		}
+		const double ScalarElapsed = FPlatformTime::Seconds() - ScalarStart;
+
+		double BatchChecksum = 0.0;
+		const double BatchStart = FPlatformTime::Seconds();
+		for (const FVector2D& P : Queries)
+		{
+			FRTPlanSegmentBatch::DistancesSquared(P, Segments, OutDistSq);
+			for (const double DistSq : OutDistSq)
+			{
+				BatchChecksum += DistSq;
+			}
+		}
+		const double BatchElapsed = FPlatformTime::Seconds() - BatchStart;
+
+		int32 NumRectHits = 0;
+		const double RectStart = FPlatformTime::Seconds();
+		TArray<int32> Hits;
+		for (const FVector2D& P : Queries)
+		{
+			Hits.Reset();
+			FRTPlanSegmentBatch::IntersectsRect(Segments, P - FVector2D(500, 500), P + FVector2D(500, 500), Hits);
+			NumRectHits += Hits.Num();
+		}
+		const double RectElapsed = FPlatformTime::Seconds() - RectStart;
+
+		const double NsPerSegment = 1e9 / (double(NumQueries) * Count);
+		AddInfo(FString::Printf(TEXT("%6d segments: distance %.2f ns scalar, %.2f ns batched; rect %.2f ns batched (%d hits)"),
+			Count, ScalarElapsed * NsPerSegment, BatchElapsed * NsPerSegment, RectElapsed * NsPerSegment, NumRectHits));
+		TestEqual(TEXT("Checksums agree"), BatchChecksum, ScalarChecksum, 1e-6 * FMath::Max(1.0, ScalarChecksum));
+	}
+
+	return true;
+}
@@ -0,0 +1,205 @@
+﻿#include "RTPlanSegmentBatch.h"
+#include "RTPlanGeometryUtils.h"
+#include "Math/VectorRegister.h"
+
+namespace RTPlanSegmentBatchPrivate
+{
+	// Same operations as FRTPlanGeometryUtils::DistanceSquaredPointToSegment, four segments at a time
+	struct FClosest4
+	{
+		VectorRegister4Double X;
+		VectorRegister4Double Y;
+		VectorRegister4Double DistSq;
+	};
+
+	FORCEINLINE FClosest4 ClosestPoints4(const VectorRegister4Double& PX, const VectorRegister4Double& PY, const FRTPlanSegmentSoA& Segments, int32 Index)
+	{
+		const VectorRegister4Double AX = VectorLoad(&Segments.AX[Index]);
+		const VectorRegister4Double AY = VectorLoad(&Segments.AY[Index]);
+		const VectorRegister4Double ABX = VectorSubtract(VectorLoad(&Segments.BX[Index]), AX);
+		const VectorRegister4Double ABY = VectorSubtract(VectorLoad(&Segments.BY[Index]), AY);
+
+		const VectorRegister4Double LengthSq = VectorAdd(VectorMultiply(ABX, ABX), VectorMultiply(ABY, ABY));
+		const VectorRegister4Double Dot = VectorAdd(VectorMultiply(VectorSubtract(PX, AX), ABX), VectorMultiply(VectorSubtract(PY, AY), ABY));
+
+		// Degenerate segments take their start point (the division result is discarded)
+		const VectorRegister4Double NonDegenerate = VectorCompareGT(LengthSq, VectorSetFloat1(UE_DOUBLE_SMALL_NUMBER));
+		const VectorRegister4Double SafeLengthSq = VectorSelect(NonDegenerate, LengthSq, VectorOneDouble());
+		VectorRegister4Double T = VectorDivide(Dot, SafeLengthSq);
+		T = VectorMin(VectorMax(T, VectorZeroDouble()), VectorOneDouble());
+		T = VectorSelect(NonDegenerate, T, VectorZeroDouble());
+
+		FClosest4 Result;
+		Result.X = VectorAdd(AX, VectorMultiply(ABX, T));
+		Result.Y = VectorAdd(AY, VectorMultiply(ABY, T));
+		const VectorRegister4Double DX = VectorSubtract(PX, Result.X);
+		const VectorRegister4Double DY = VectorSubtract(PY, Result.Y);
+		Result.DistSq = VectorAdd(VectorMultiply(DX, DX), VectorMultiply(DY, DY));
+		return Result;
+	}
+
+	FORCEINLINE FVector2D ClosestPoint1(const FVector2D& P, const FRTPlanSegmentSoA& Segments, int32 Index)
+	{
+		const FVector2D A = Segments.GetA(Index);
+		const FVector2D AB = Segments.GetB(Index) - A;
+		const double LengthSq = AB.SizeSquared();
+		const double T = LengthSq > UE_DOUBLE_SMALL_NUMBER ? FMath::Clamp(((P - A) | AB) / LengthSq, 0.0, 1.0) : 0.0;
+		return A + AB * T;
+	}
+
+	// Slab bounds of one axis for four segments: [OutEnter, OutExit] in segment parameter space.
+	// Parallel segments get (-inf, +inf) when inside the slab and an empty range otherwise.
+	FORCEINLINE void ClipAxis4(const VectorRegister4Double& Start, const VectorRegister4Double& End, double Min, double Max,
+		VectorRegister4Double& InOutEnter, VectorRegister4Double& InOutExit)
+	{
+		const VectorRegister4Double Delta = VectorSubtract(End, Start);
+		const VectorRegister4Double MinV = VectorSetFloat1(Min);
+		const VectorRegister4Double MaxV = VectorSetFloat1(Max);
+		const VectorRegister4Double Big = VectorSetFloat1(UE_DOUBLE_BIG_NUMBER);
+
+		const VectorRegister4Double Parallel = VectorCompareLT(VectorAbs(Delta), VectorSetFloat1(UE_DOUBLE_SMALL_NUMBER));
+		const VectorRegister4Double Inside = VectorBitwiseAnd(VectorCompareGE(Start, MinV), VectorCompareLE(Start, MaxV));
+
+		const VectorRegister4Double SafeDelta = VectorSelect(Parallel, VectorOneDouble(), Delta);
+		const VectorRegister4Double T1 = VectorDivide(VectorSubtract(MinV, Start), SafeDelta);
+		const VectorRegister4Double T2 = VectorDivide(VectorSubtract(MaxV, Start), SafeDelta);
+
+		const VectorRegister4Double ParallelEnter = VectorSelect(Inside, VectorNegate(Big), Big);
+		const VectorRegister4Double ParallelExit = VectorSelect(Inside, Big, VectorNegate(Big));
+
+		InOutEnter = VectorMax(InOutEnter, VectorSelect(Parallel, ParallelEnter, VectorMin(T1, T2)));
+		InOutExit = VectorMin(InOutExit, VectorSelect(Parallel, ParallelExit, VectorMax(T1, T2)));
+	}
+}
+
+void FRTPlanSegmentBatch::ClosestPoints(const FVector2D& P, const FRTPlanSegmentSoA& Segments, TArrayView<double> OutX, TArrayView<double> OutY)
+{
+	using namespace RTPlanSegmentBatchPrivate;
+
+	const int32 Num = Segments.Num();
+	check(OutX.Num() >= Num && OutY.Num() >= Num);
+
+	const VectorRegister4Double PX = VectorSetFloat1(P.X);
+	const VectorRegister4Double PY = VectorSetFloat1(P.Y);
+
+	int32 Index = 0;
+	for (; Index + 4 <= Num; Index += 4)
+	{
+		const FClosest4 Closest = ClosestPoints4(PX, PY, Segments, Index);
+		VectorStore(Closest.X, &OutX[Index]);
+		VectorStore(Closest.Y, &OutY[Index]);
+	}
+	for (; Index < Num; ++Index)
+	{
+		const FVector2D Closest = ClosestPoint1(P, Segments, Index);
+		OutX[Index] = Closest.X;
+		OutY[Index] = Closest.Y;
+	}
+}
+
+void FRTPlanSegmentBatch::DistancesSquared(const FVector2D& P, const FRTPlanSegmentSoA& Segments, TArrayView<double> OutDistSq)
+{
+	using namespace RTPlanSegmentBatchPrivate;
+
+	const int32 Num = Segments.Num();
+	check(OutDistSq.Num() >= Num);
+
+	const VectorRegister4Double PX = VectorSetFloat1(P.X);
+	const VectorRegister4Double PY = VectorSetFloat1(P.Y);
+
+	int32 Index = 0;
+	for (; Index + 4 <= Num; Index += 4)
+	{
+		VectorStore(ClosestPoints4(PX, PY, Segments, Index).DistSq, &OutDistSq[Index]);
+	}
+	for (; Index < Num; ++Index)
+	{
+		OutDistSq[Index] = FVector2D::DistSquared(P, ClosestPoint1(P, Segments, Index));
+	}
+}
+
+int32 FRTPlanSegmentBatch::FindNearest(const FVector2D& P, const FRTPlanSegmentSoA& Segments, double& OutDistSq)
+{
+	using namespace RTPlanSegmentBatchPrivate;
+
+	const int32 Num = Segments.Num();
+	const VectorRegister4Double PX = VectorSetFloat1(P.X);
+	const VectorRegister4Double PY = VectorSetFloat1(P.Y);
+
+	// Keep the per-lane minimum and where it came from; reduce across lanes once at the end
+	VectorRegister4Double BestDistSq = VectorSetFloat1(UE_DOUBLE_BIG_NUMBER);
+	alignas(32) double LaneDistSq[4];
+	int32 LaneBest[4] = { INDEX_NONE, INDEX_NONE, INDEX_NONE, INDEX_NONE };
+
+	int32 Index = 0;
+	for (; Index + 4 <= Num; Index += 4)
+	{
+		const VectorRegister4Double DistSq = ClosestPoints4(PX, PY, Segments, Index).DistSq;
+		const int32 Closer = VectorMaskBits(VectorCompareLT(DistSq, BestDistSq));
+		if (Closer)
+		{
+			BestDistSq = VectorMin(BestDistSq, DistSq);
+			for (int32 Lane = 0; Lane < 4; ++Lane)
+			{
+				if (Closer & (1 << Lane))
+				{
+					LaneBest[Lane] = Index + Lane;
+				}
+			}
+		}
+	}
+	VectorStore(BestDistSq, LaneDistSq);
+
+	int32 BestIndex = INDEX_NONE;
+	OutDistSq = UE_DOUBLE_BIG_NUMBER;
+	for (int32 Lane = 0; Lane < 4; ++Lane)
+	{
+		if (LaneBest[Lane] != INDEX_NONE && (LaneDistSq[Lane] < OutDistSq || (LaneDistSq[Lane] == OutDistSq && LaneBest[Lane] < BestIndex)))
+		{
+			OutDistSq = LaneDistSq[Lane];
+			BestIndex = LaneBest[Lane];
+		}
+	}
+	for (; Index < Num; ++Index)
+	{
+		const double DistSq = FVector2D::DistSquared(P, ClosestPoint1(P, Segments, Index));
+		if (DistSq < OutDistSq)
+		{
+			OutDistSq = DistSq;
+			BestIndex = Index;
+		}
+	}
+	return BestIndex;
+}
+
+void FRTPlanSegmentBatch::IntersectsRect(const FRTPlanSegmentSoA& Segments, const FVector2D& RectMin, const FVector2D& RectMax, TArray<int32>& OutIndices)
+{
+	using namespace RTPlanSegmentBatchPrivate;
+
+	const int32 Num = Segments.Num();
+
+	int32 Index = 0;
+	for (; Index + 4 <= Num; Index += 4)
+	{
+		VectorRegister4Double Enter = VectorZeroDouble();
+		VectorRegister4Double Exit = VectorOneDouble();
+		ClipAxis4(VectorLoad(&Segments.AX[Index]), VectorLoad(&Segments.BX[Index]), RectMin.X, RectMax.X, Enter, Exit);
+		ClipAxis4(VectorLoad(&Segments.AY[Index]), VectorLoad(&Segments.BY[Index]), RectMin.Y, RectMax.Y, Enter, Exit);
+
+		const int32 Hits = VectorMaskBits(VectorCompareLE(Enter, Exit));
+		for (int32 Lane = 0; Lane < 4; ++Lane)
+		{
+			if (Hits & (1 << Lane))
+			{
+				OutIndices.Add(Index + Lane);
+			}
+		}
+	}
+	for (; Index < Num; ++Index)
+	{
+		if (FRTPlanGeometryUtils::SegmentIntersectsRect(Segments.GetA(Index), Segments.GetB(Index), RectMin, RectMax))
+		{
+			OutIndices.Add(Index);
+		}
+	}
+}
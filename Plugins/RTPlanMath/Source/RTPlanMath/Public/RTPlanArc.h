@@ -0,0 +1,61 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * RTPlanArc.h
+ * Exact circular arc primitive (center, radius, signed angle range) with analytic queries,
+ * so arc walls can be snapped to / hit tested without tessellating them.
+ * Angles are in radians, 0 is +X, positive sweep is CCW (matching FRTWall::ArcSweepAngle).
+ */
+struct RTPLANMATH_API FRTPlanArc
+{
+	FVector2D Center = FVector2D::ZeroVector;
+	double Radius = 0.0;
+	double StartAngle = 0.0;
+	double Sweep = 0.0;
+
+	FRTPlanArc() = default;
+	FRTPlanArc(const FVector2D& InCenter, double InRadius, double InStartAngle, double InSweep)
+		: Center(InCenter), Radius(InRadius), StartAngle(InStartAngle), Sweep(InSweep)
+	{
+	}
+
+	// Arc of a wall: from Start around Center by SweepDegrees (the wall's ArcCenter / VertexA / ArcSweepAngle)
+	static FRTPlanArc FromCenterStartSweep(const FVector2D& InCenter, const FVector2D& Start, float SweepDegrees);
+
+	// Point at parameter T in [0, 1] along the sweep
+	FVector2D GetPoint(double T) const;
+	FVector2D GetStart() const { return GetPoint(0.0); }
+	FVector2D GetEnd() const { return GetPoint(1.0); }
+	FVector2D GetMidpoint() const { return GetPoint(0.5); }
+
+	double GetLength() const { return FMath::Abs(Sweep) * Radius; }
+
+	// True if the direction at AngleRadians (from the center) lies within the swept range.
+	// OutT (optional) receives the parameter of that direction along the arc.
+	bool ContainsAngle(double AngleRadians, double* OutT = nullptr) const;
+
+	// Exact closest point on the arc (an endpoint if P's direction is outside the sweep)
+	FVector2D ClosestPoint(const FVector2D& P) const;
+	double Distance(const FVector2D& P) const { return FVector2D::Distance(P, ClosestPoint(P)); }
+
+	// Intersections with segment AB, ordered along AB. Returns the count (0-2).
+	int32 IntersectSegment(const FVector2D& A, const FVector2D& B, FVector2D OutPoints[2]) const;
+
+	// Intersections with another arc. Returns the count (0-2); overlapping arcs of the same circle report none.
+	int32 IntersectArc(const FRTPlanArc& Other, FVector2D OutPoints[2]) const;
+
+	// Nearest hit along a ray (Direction need not be normalized). OutT is in units of Direction.
+	bool IntersectRay(const FVector2D& Origin, const FVector2D& Direction, double& OutT) const;
+
+	// True if any part of the arc lies inside the axis-aligned rectangle
+	bool IntersectsRect(const FVector2D& RectMin, const FVector2D& RectMax) const;
+
+	// Tight bounds: endpoints plus the axis extremes within the sweep
+	FBox2D GetBounds() const;
+
+private:
+	// Line parameters t (along Origin + t * Direction) where the line meets the full circle
+	int32 IntersectCircle(const FVector2D& Origin, const FVector2D& Direction, double OutT[2]) const;
+};
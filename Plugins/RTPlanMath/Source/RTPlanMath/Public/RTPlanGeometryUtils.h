@@ -17,6 +17,12 @@ public:
 	// Get the closest point on Segment AB to Point P
 	static FVector2D ClosestPointOnSegment(const FVector2D& P, const FVector2D& A, const FVector2D& B);
 
+	// Squared distance from P to Segment AB, in double precision (scalar reference for FRTPlanSegmentBatch)
+	static double DistanceSquaredPointToSegment(const FVector2D& P, const FVector2D& A, const FVector2D& B);
+
+	// True if Segment AB touches the closed rectangle [RectMin, RectMax] (endpoint inside or crossing an edge)
+	static bool SegmentIntersectsRect(const FVector2D& A, const FVector2D& B, const FVector2D& RectMin, const FVector2D& RectMax);
+
 	// Calculate Left and Right normal vectors for a wall from A to B.
 	// Left is +90 degrees (CCW), Right is -90 degrees (CW).
 	static void GetWallNormals(const FVector2D& A, const FVector2D& B, FVector2D& OutLeft, FVector2D& OutRight);
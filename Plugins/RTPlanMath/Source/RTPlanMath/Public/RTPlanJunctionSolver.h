@@ -0,0 +1,65 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "RTPlanSchema.h"
+
+/**
+ * RTPlanJunctionSolver.h
+ * Cuts wall ends where walls meet, so every wall is meshed to its exact footprint.
+ * Each side face of a wall is cut where it meets the facing side of the angularly adjacent wall at the vertex;
+ * the end then runs left corner -> vertex -> right corner. Around a vertex the walls tile the junction without
+ * overlap: two walls get a mitre, T and X junctions get a hub of wedges meeting at the vertex.
+ * Shared by the wall mesher and the spatial index's ray picking, so both see the same wall volumes.
+ */
+
+/**
+ * How one end of a wall is cut.
+ * Offsets run along the wall (A -> B positive) from the end point, to where the left / right face ends.
+ * Points between the faces follow the polyline left corner -> end point -> right corner, and skirting extends it.
+ */
+struct FRTPlanWallEnd
+{
+	float LeftOffset = 0.0f;
+	float RightOffset = 0.0f;
+
+	// Free ends get a cap (and cap skirting). Ends inside a junction are covered by the neighbouring walls,
+	// so only skirting that runs into them is closed off.
+	bool bCapped = true;
+};
+
+// One wall leaving a junction vertex
+struct FRTPlanJunctionArm
+{
+	// Unit direction away from the vertex (the end tangent for arcs)
+	FVector2D Direction = FVector2D(1.0, 0.0);
+	float HalfThickness = 0.0f;
+};
+
+class RTPLANMATH_API FRTPlanJunctionSolver
+{
+public:
+	// Resolves another wall and its endpoint positions, or returns nullptr if it is gone / disconnected
+	using FResolveWall = TFunctionRef<const FRTWall*(const FGuid& WallId, FVector2D& OutA, FVector2D& OutB)>;
+
+	/**
+	 * Cut both ends of Wall (A -> B) against the walls meeting at its endpoints (Wall itself may be listed).
+	 * Walls too short or degenerate to mesh take no part in junctions and get free ends.
+	 */
+	static void SolveEnds(const FRTWall& Wall, const FVector2D& A, const FVector2D& B, TConstArrayView<FGuid> WallsAtA, TConstArrayView<FGuid> WallsAtB,
+		FResolveWall ResolveWall, FRTPlanWallEnd& OutStart, FRTPlanWallEnd& OutEnd);
+
+	// False for walls under 1 cm or with both ends on one vertex: they have no volume and take no part in junctions
+	static bool IsSolid(const FRTWall& Wall, const FVector2D& A, const FVector2D& B);
+
+	// Arm of a wall at its A (bAtStart) or B end
+	static FRTPlanJunctionArm MakeArm(const FRTWall& Wall, const FVector2D& A, const FVector2D& B, bool bAtStart);
+
+	/**
+	 * End of the wall owning Arms[Self] (its A end if bAtStart, else its B end), given every arm meeting at that vertex.
+	 * A lone arm is a free end: uncut and capped.
+	 */
+	static FRTPlanWallEnd SolveEnd(TConstArrayView<FRTPlanJunctionArm> Arms, int32 Self, bool bAtStart);
+
+	// Cuts of very sharp corners reach at most this many half-thicknesses from the vertex
+	static constexpr float MitreLimit = 4.0f;
+};
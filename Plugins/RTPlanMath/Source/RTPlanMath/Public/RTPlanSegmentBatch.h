@@ -0,0 +1,59 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * RTPlanSegmentBatch.h
+ * Batched point / segment kernels over segments stored structure-of-arrays.
+ * Four segments are processed per step with UE's vector registers (VectorRegister4Double: AVX / SSE /
+ * NEON, or the FPU fallback when vector intrinsics are disabled); a scalar loop handles the tail.
+ * Results match the scalar FRTPlanGeometryUtils versions (DistanceSquaredPointToSegment, SegmentIntersectsRect).
+ * Worth it for bulk passes over many segments (the spatial index clips marquee candidates with IntersectsRect);
+ * a handful of grid candidates is cheaper to test one by one.
+ */
+
+// Segments as separate coordinate arrays (A.X, A.Y, B.X, B.Y), all Num() long
+struct FRTPlanSegmentSoA
+{
+	TArray<double> AX;
+	TArray<double> AY;
+	TArray<double> BX;
+	TArray<double> BY;
+
+	int32 Num() const { return AX.Num(); }
+
+	void Reset(int32 NewCapacity = 0)
+	{
+		AX.Reset(NewCapacity);
+		AY.Reset(NewCapacity);
+		BX.Reset(NewCapacity);
+		BY.Reset(NewCapacity);
+	}
+
+	int32 Add(const FVector2D& A, const FVector2D& B)
+	{
+		AY.Add(A.Y);
+		BX.Add(B.X);
+		BY.Add(B.Y);
+		return AX.Add(A.X);
+	}
+
+	FVector2D GetA(int32 Index) const { return FVector2D(AX[Index], AY[Index]); }
+	FVector2D GetB(int32 Index) const { return FVector2D(BX[Index], BY[Index]); }
+};
+
+class RTPLANMATH_API FRTPlanSegmentBatch
+{
+public:
+	// Closest point on every segment to P. OutX / OutY must hold Segments.Num() values.
+	static void ClosestPoints(const FVector2D& P, const FRTPlanSegmentSoA& Segments, TArrayView<double> OutX, TArrayView<double> OutY);
+
+	// Squared distance from P to every segment. OutDistSq must hold Segments.Num() values.
+	static void DistancesSquared(const FVector2D& P, const FRTPlanSegmentSoA& Segments, TArrayView<double> OutDistSq);
+
+	// Index of the segment nearest to P (lowest index on ties), INDEX_NONE if there are none
+	static int32 FindNearest(const FVector2D& P, const FRTPlanSegmentSoA& Segments, double& OutDistSq);
+
+	// Appends the indices (ascending) of the segments touching the closed rectangle [RectMin, RectMax]
+	static void IntersectsRect(const FRTPlanSegmentSoA& Segments, const FVector2D& RectMin, const FVector2D& RectMax, TArray<int32>& OutIndices);
+};
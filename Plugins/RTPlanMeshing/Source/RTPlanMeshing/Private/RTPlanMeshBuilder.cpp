@@ -1,49 +1,449 @@
 #include "RTPlanMeshBuilder.h"
+#include "RTPlanMeshWriter.h"
 #include "GeometryScript/MeshPrimitiveFunctions.h"
-#include "GeometryScript/MeshMaterialFunctions.h"
-#include "GeometryScript/MeshTransformFunctions.h"
-#include "GeometryScript/MeshNormalsFunctions.h"
 #include "UDynamicMesh.h"
 #include "DynamicMesh/DynamicMesh3.h"
-#include "DynamicMesh/MeshNormals.h"
-#include "DynamicMesh/DynamicMeshAttributeSet.h"
+#include "Algo/Reverse.h"
 
-// Helper to add a quad with proper UVs, Normals, and MaterialID
-void AddQuad(
-	FDynamicMesh3& Mesh,
-	const FVector3d& P0, const FVector3d& P1, const FVector3d& P2, const FVector3d& P3,
-	const FVector2f& UV0, const FVector2f& UV1, const FVector2f& UV2, const FVector2f& UV3,
-	const FVector3f& Normal,
-	int32 MaterialID)
+using UE::Geometry::FIndex3i;
+using UE::Geometry::FIndex4i;
+
+namespace RTPlanMeshBuilderPrivate
 {
-	UE::Geometry::FDynamicMeshUVOverlay* UVs = Mesh.Attributes()->PrimaryUV();
-	UE::Geometry::FDynamicMeshNormalOverlay* Normals = Mesh.Attributes()->PrimaryNormals();
+	static constexpr double UVScale = 0.01;
 
-	int32 V0 = Mesh.AppendVertex(P0);
-	int32 V1 = Mesh.AppendVertex(P1);
-	int32 V2 = Mesh.AppendVertex(P2);
-	int32 V3 = Mesh.AppendVertex(P3);
+	// What closes off one end of a sweep
+	enum class EEndCap : uint8
+	{
+		None,
+		// Only the skirting cap triangles (a junction end: the wall body is covered by its neighbours)
+		SkirtingOnly,
+		Full
+	};
 
-	int32 T0 = Mesh.AppendTriangle(V0, V1, V3, MaterialID);
-	int32 T1 = Mesh.AppendTriangle(V1, V2, V3, MaterialID);
+	EEndCap GetEndCap(const FRTPlanWallEnd& End)
+	{
+		return End.bCapped ? EEndCap::Full : EEndCap::SkirtingOnly;
+	}
 
-	if (T0 >= 0 && T1 >= 0)
+	// One corner of a wall cross-section, in (Y = towards the wall's left side, Z = up)
+	struct FProfilePoint
 	{
-		if (UVs)
+		FVector2d YZ;
+		// Group of the side face between this point and the next one around the ring. INDEX_NONE leaves that face out.
+		int32 EdgeGroup = INDEX_NONE;
+	};
+
+	// Closed cross-section that is swept along a wall.
+	// Points run clockwise seen from the wall start, so swept side faces face outwards.
+	// Cap triangles index Points and are counter-clockwise in (Y, Z) (the start cap winding);
+	// the first NumBodyCapTriangles cover the wall body, the rest the skirting.
+	struct FWallProfile
+	{
+		TArray<FProfilePoint, TInlineAllocator<12>> Points;
+		TArray<FIndex3i, TInlineAllocator<12>> CapTriangles;
+		TArray<int32, TInlineAllocator<12>> CapGroups;
+		int32 NumBodyCapTriangles = 0;
+		double HalfThickness = 0.0;
+		double BaseZ = 0.0;
+
+		int32 AddPoint(double Y, double Z, int32 EdgeGroup)
+		{
+			Points.Add({ FVector2d(Y, Z), EdgeGroup });
+			return Points.Num() - 1;
+		}
+
+		void AddCapTriangle(int32 A, int32 B, int32 C, int32 Group)
 		{
-			int32 UV_ID0 = UVs->AppendElement(UV0);
-			int32 UV_ID1 = UVs->AppendElement(UV1);
-			int32 UV_ID2 = UVs->AppendElement(UV2);
-			int32 UV_ID3 = UVs->AppendElement(UV3);
-			UVs->SetTriangle(T0, UE::Geometry::FIndex3i(UV_ID0, UV_ID1, UV_ID3));
-			UVs->SetTriangle(T1, UE::Geometry::FIndex3i(UV_ID1, UV_ID2, UV_ID3));
+			CapTriangles.Add(FIndex3i(A, B, C));
+			CapGroups.Add(Group);
 		}
-		if (Normals)
+
+		// Triangulate the strip between the right (Y = -HalfThickness) and left (Y = +HalfThickness) chains, both bottom to top
+		void AddLadderCaps(TConstArrayView<int32> Right, TConstArrayView<int32> Left, int32 Group)
 		{
-			int32 N_ID = Normals->AppendElement(Normal);
-			Normals->SetTriangle(T0, UE::Geometry::FIndex3i(N_ID, N_ID, N_ID));
-			Normals->SetTriangle(T1, UE::Geometry::FIndex3i(N_ID, N_ID, N_ID));
+			int32 R = 0;
+			int32 L = 0;
+			while (R < Right.Num() - 1 || L < Left.Num() - 1)
+			{
+				const bool bStepLeft = L < Left.Num() - 1
+					&& (R == Right.Num() - 1 || Points[Left[L + 1]].YZ.Y <= Points[Right[R + 1]].YZ.Y);
+				if (bStepLeft)
+				{
+					AddCapTriangle(Right[R], Left[L], Left[L + 1], Group);
+					++L;
+				}
+				else
+				{
+					AddCapTriangle(Right[R], Left[L], Right[R + 1], Group);
+					++R;
+				}
+			}
 		}
+
+		// Split the cap triangle on edge A-B at Mid (a point inserted into the ring between them)
+		void SplitCapEdge(int32 A, int32 B, int32 Mid)
+		{
+			for (int32 Index = 0; Index < CapTriangles.Num(); ++Index)
+			{
+				const FIndex3i Tri = CapTriangles[Index];
+				for (int32 Corner = 0; Corner < 3; ++Corner)
+				{
+					const int32 From = Tri[Corner];
+					const int32 To = Tri[(Corner + 1) % 3];
+					if ((From == A && To == B) || (From == B && To == A))
+					{
+						const int32 Other = Tri[(Corner + 2) % 3];
+						CapTriangles[Index] = FIndex3i(From, Mid, Other);
+						AddCapTriangle(Mid, To, Other, CapGroups[Index]);
+						return;
+					}
+				}
+			}
+		}
+
+		int32 NumCapTriangles(EEndCap Cap) const
+		{
+			switch (Cap)
+			{
+			case EEndCap::Full: return CapTriangles.Num();
+			case EEndCap::SkirtingOnly: return CapTriangles.Num() - NumBodyCapTriangles;
+			default: return 0;
+			}
+		}
+
+		int32 NumSideFaces() const
+		{
+			int32 Num = 0;
+			for (const FProfilePoint& Point : Points)
+			{
+				Num += Point.EdgeGroup != INDEX_NONE ? 1 : 0;
+			}
+			return Num;
+		}
+	};
+
+	// Wall body plus the left / right skirting, as one ring. Faces hidden behind the skirting are not part of it.
+	// bCentrePoints adds points in the middle of the top and bottom, for ends cut as a bent polyline through the wall axis.
+	FWallProfile MakeWallProfile(
+		double HalfThickness, double Height, double BaseZ,
+		double SkirtingHeight_Left, double SkirtingThickness_Left,
+		double SkirtingHeight_Right, double SkirtingThickness_Right,
+		int32 MaterialID_Left, int32 MaterialID_Right, int32 MaterialID_Caps,
+		int32 MaterialID_Skirting_Left, int32 MaterialID_Skirting_Right,
+		bool bCentrePoints)
+	{
+		FWallProfile Profile;
+		Profile.HalfThickness = HalfThickness;
+		Profile.BaseZ = BaseZ;
+
+		const double TopZ = BaseZ + Height;
+		const bool bSkirtingRight = SkirtingHeight_Right > 0 && SkirtingThickness_Right > 0;
+		const bool bSkirtingLeft = SkirtingHeight_Left > 0 && SkirtingThickness_Left > 0;
+		const double SkirtingZ_Right = BaseZ + FMath::Min(SkirtingHeight_Right, Height);
+		const double SkirtingZ_Left = BaseZ + FMath::Min(SkirtingHeight_Left, Height);
+		const double OuterY_Right = -HalfThickness - SkirtingThickness_Right;
+		const double OuterY_Left = HalfThickness + SkirtingThickness_Left;
+
+		TArray<int32, TInlineAllocator<3>> RightChain;
+		TArray<int32, TInlineAllocator<3>> LeftChain;
+
+		// Up the right side
+		const int32 RightBottom = Profile.AddPoint(-HalfThickness, BaseZ, bSkirtingRight ? MaterialID_Caps : MaterialID_Right);
+		RightChain.Add(RightBottom);
+		int32 RightOut = INDEX_NONE;
+		int32 RightOutTop = INDEX_NONE;
+		if (bSkirtingRight)
+		{
+			RightOut = Profile.AddPoint(OuterY_Right, BaseZ, MaterialID_Skirting_Right);
+			RightOutTop = Profile.AddPoint(OuterY_Right, SkirtingZ_Right, MaterialID_Skirting_Right);
+			if (SkirtingZ_Right < TopZ)
+			{
+				RightChain.Add(Profile.AddPoint(-HalfThickness, SkirtingZ_Right, MaterialID_Right));
+			}
+		}
+		const int32 RightTop = Profile.AddPoint(-HalfThickness, TopZ, MaterialID_Caps);
+		RightChain.Add(RightTop);
+		const int32 TopCentre = bCentrePoints ? Profile.AddPoint(0.0, TopZ, MaterialID_Caps) : INDEX_NONE;
+
+		// Down the left side
+		const bool bLeftSkirtingBelowTop = bSkirtingLeft && SkirtingZ_Left < TopZ;
+		const int32 LeftTop = Profile.AddPoint(HalfThickness, TopZ, bSkirtingLeft && !bLeftSkirtingBelowTop ? MaterialID_Skirting_Left : MaterialID_Left);
+		LeftChain.Add(LeftTop);
+		int32 LeftOut = INDEX_NONE;
+		int32 LeftOutTop = INDEX_NONE;
+		if (bSkirtingLeft)
+		{
+			if (bLeftSkirtingBelowTop)
+			{
+				LeftChain.Add(Profile.AddPoint(HalfThickness, SkirtingZ_Left, MaterialID_Skirting_Left));
+			}
+			LeftOutTop = Profile.AddPoint(OuterY_Left, SkirtingZ_Left, MaterialID_Skirting_Left);
+			LeftOut = Profile.AddPoint(OuterY_Left, BaseZ, MaterialID_Caps);
+		}
+		const int32 LeftBottom = Profile.AddPoint(HalfThickness, BaseZ, MaterialID_Caps);
+		LeftChain.Add(LeftBottom);
+		Algo::Reverse(LeftChain);
+		const int32 BottomCentre = bCentrePoints ? Profile.AddPoint(0.0, BaseZ, MaterialID_Caps) : INDEX_NONE;
+
+		// End caps: the wall body, then the skirting blocks
+		Profile.AddLadderCaps(RightChain, LeftChain, MaterialID_Caps);
+		if (bCentrePoints)
+		{
+			Profile.SplitCapEdge(RightTop, LeftTop, TopCentre);
+			Profile.SplitCapEdge(LeftBottom, RightBottom, BottomCentre);
+		}
+		Profile.NumBodyCapTriangles = Profile.CapTriangles.Num();
+		if (bSkirtingRight)
+		{
+			const int32 RightInnerTop = RightChain[1];
+			Profile.AddCapTriangle(RightOut, RightBottom, RightInnerTop, MaterialID_Skirting_Right);
+			Profile.AddCapTriangle(RightOut, RightInnerTop, RightOutTop, MaterialID_Skirting_Right);
+		}
+		if (bSkirtingLeft)
+		{
+			const int32 LeftInnerTop = LeftChain[1];
+			Profile.AddCapTriangle(LeftBottom, LeftOut, LeftOutTop, MaterialID_Skirting_Left);
+			Profile.AddCapTriangle(LeftBottom, LeftOutTop, LeftInnerTop, MaterialID_Skirting_Left);
+		}
+
+		return Profile;
+	}
+
+	// Plain block across the wall footprint (cap skirting). It stands on the floor, so there is no bottom face.
+	FWallProfile MakeBlockProfile(double HalfThickness, double Height, double BaseZ, int32 MaterialID)
+	{
+		FWallProfile Profile;
+		Profile.HalfThickness = HalfThickness;
+		Profile.BaseZ = BaseZ;
+
+		const int32 RightBottom = Profile.AddPoint(-HalfThickness, BaseZ, MaterialID);
+		const int32 RightTop = Profile.AddPoint(-HalfThickness, BaseZ + Height, MaterialID);
+		const int32 LeftTop = Profile.AddPoint(HalfThickness, BaseZ + Height, MaterialID);
+		const int32 LeftBottom = Profile.AddPoint(HalfThickness, BaseZ, INDEX_NONE);
+
+		const int32 Right[] = { RightBottom, RightTop };
+		const int32 Left[] = { LeftBottom, LeftTop };
+		Profile.AddLadderCaps(Right, Left, MaterialID);
+		Profile.NumBodyCapTriangles = Profile.CapTriangles.Num();
+		return Profile;
+	}
+
+	// Where the profile sits along the sweep: profile (Y, Z) maps to Origin + Left * Y + Up * Z,
+	// moved along the tangent by the end cut (see FRTPlanWallEnd) at the first / last station
+	struct FSweepStation
+	{
+		FVector3d Origin = FVector3d::ZeroVector;
+		FVector3d Left = FVector3d::UnitY();
+		FVector3d Up = FVector3d::UnitZ();
+		// Texture U at this station (distance along the wall, scaled)
+		double U = 0.0;
+		// Along-tangent offset of the left (Y = +HalfThickness) and right (Y = -HalfThickness) faces
+		double TrimLeft = 0.0;
+		double TrimRight = 0.0;
+
+		FVector3d GetTangent() const { return FVector3d::CrossProduct(Left, Up).GetSafeNormal(); }
+
+		double GetTrim(double Y, double HalfThickness) const
+		{
+			return Y >= 0.0 ? TrimLeft * (Y / HalfThickness) : TrimRight * (-Y / HalfThickness);
+		}
+
+		void SetTrim(const FRTPlanWallEnd& End, double Length)
+		{
+			// Never cut more than half the wall away from one end
+			TrimLeft = FMath::Clamp((double)End.LeftOffset, -Length * 0.5, Length * 0.5);
+			TrimRight = FMath::Clamp((double)End.RightOffset, -Length * 0.5, Length * 0.5);
+		}
+	};
+
+	int32 NumSweepVertices(const FWallProfile& Profile, int32 NumStations)
+	{
+		return Profile.Points.Num() * NumStations;
+	}
+
+	int32 NumSweepTriangles(const FWallProfile& Profile, int32 NumStations, EEndCap StartCap, EEndCap EndCap)
+	{
+		return 2 * Profile.NumSideFaces() * (NumStations - 1) + Profile.NumCapTriangles(StartCap) + Profile.NumCapTriangles(EndCap);
+	}
+
+	// Sweep Profile through Stations. Each ring vertex is shared by all faces meeting there; hard edges get
+	// separate normal / UV elements instead. Along the sweep, elements are shared between segments, so arcs shade smoothly.
+	void SweepProfile(FRTPlanMeshWriter& Writer, const FWallProfile& Profile, TConstArrayView<FSweepStation> Stations, EEndCap StartCap, EEndCap EndCap)
+	{
+		const int32 NumPoints = Profile.Points.Num();
+		const int32 NumStations = Stations.Num();
+		const double HalfThickness = Profile.HalfThickness;
+		const double BaseZ = Profile.BaseZ;
+
+		TArray<int32, TInlineAllocator<64>> Vertices;
+		TArray<FVector3d, TInlineAllocator<64>> Positions;
+		Vertices.SetNumUninitialized(NumPoints * NumStations);
+		Positions.SetNumUninitialized(NumPoints * NumStations);
+		for (int32 Station = 0; Station < NumStations; ++Station)
+		{
+			const FSweepStation& S = Stations[Station];
+			const FVector3d Tangent = S.GetTangent();
+			for (int32 Point = 0; Point < NumPoints; ++Point)
+			{
+				const FVector2d& YZ = Profile.Points[Point].YZ;
+				const int32 Index = Station * NumPoints + Point;
+				Positions[Index] = S.Origin + S.Left * YZ.X + S.Up * YZ.Y + Tangent * S.GetTrim(YZ.X, HalfThickness);
+				Vertices[Index] = Writer.AddVertex(Positions[Index]);
+			}
+		}
+
+		// Side faces, one per profile edge
+		for (int32 PointA = 0; PointA < NumPoints; ++PointA)
+		{
+			const int32 Group = Profile.Points[PointA].EdgeGroup;
+			if (Group == INDEX_NONE)
+			{
+				continue;
+			}
+
+			const int32 PointB = (PointA + 1) % NumPoints;
+			const FVector2d& YZA = Profile.Points[PointA].YZ;
+			const FVector2d& YZB = Profile.Points[PointB].YZ;
+			const FVector2d Edge = YZB - YZA;
+			const FVector2d Outward = FVector2d(-Edge.Y, Edge.X).GetSafeNormal();
+
+			// V runs up vertical faces and across horizontal ones
+			const bool bVertical = FMath::Abs(Edge.Y) >= FMath::Abs(Edge.X);
+			const float VA = (float)(bVertical ? (YZA.Y - BaseZ) * UVScale : (YZA.X + HalfThickness) * UVScale);
+			const float VB = (float)(bVertical ? (YZB.Y - BaseZ) * UVScale : (YZB.X + HalfThickness) * UVScale);
+
+			int32 PrevNormal = INDEX_NONE;
+			int32 PrevUVA = INDEX_NONE;
+			int32 PrevUVB = INDEX_NONE;
+			FVector3f PrevNormalValue = FVector3f::ZeroVector;
+			for (int32 Station = 0; Station < NumStations; ++Station)
+			{
+				const FSweepStation& S = Stations[Station];
+
+				// Straight runs keep one normal element for the whole face
+				const FVector3f NormalValue = FVector3f(S.Left * Outward.X + S.Up * Outward.Y).GetSafeNormal();
+				const int32 Normal = (PrevNormal != INDEX_NONE && NormalValue.Equals(PrevNormalValue))
+					? PrevNormal : Writer.AddNormal(NormalValue);
+				const int32 UVA = Writer.AddUV(FVector2f((float)(S.U + S.GetTrim(YZA.X, HalfThickness) * UVScale), VA));
+				const int32 UVB = Writer.AddUV(FVector2f((float)(S.U + S.GetTrim(YZB.X, HalfThickness) * UVScale), VB));
+
+				if (Station > 0)
+				{
+					const int32 Prev = (Station - 1) * NumPoints;
+					const int32 Curr = Station * NumPoints;
+					Writer.AddQuad(
+						FIndex4i(Vertices[Prev + PointA], Vertices[Prev + PointB], Vertices[Curr + PointB], Vertices[Curr + PointA]),
+						FIndex4i(PrevUVA, PrevUVB, UVB, UVA),
+						FIndex4i(PrevNormal, PrevNormal, Normal, Normal),
+						Group);
+				}
+
+				PrevNormal = Normal;
+				PrevNormalValue = NormalValue;
+				PrevUVA = UVA;
+				PrevUVB = UVB;
+			}
+		}
+
+		// End caps, UVs in profile space. A cut end is no longer square to the wall, so normals come from
+		// the triangles themselves (coplanar triangles share one element).
+		auto AddCap = [&](int32 Station, bool bEnd, EEndCap Cap)
+		{
+			if (Cap == EEndCap::None)
+			{
+				return;
+			}
+
+			const FVector3d Tangent = Stations[Station].GetTangent();
+			const FVector3f FallbackNormal(bEnd ? Tangent : -Tangent);
+
+			TArray<int32, TInlineAllocator<12>> UVs;
+			UVs.Init(INDEX_NONE, NumPoints);
+
+			int32 Normal = INDEX_NONE;
+			FVector3f NormalValue = FVector3f::ZeroVector;
+			const int32 Base = Station * NumPoints;
+			const int32 FirstTriangle = Cap == EEndCap::Full ? 0 : Profile.NumBodyCapTriangles;
+			for (int32 Index = FirstTriangle; Index < Profile.CapTriangles.Num(); ++Index)
+			{
+				FIndex3i Tri = Profile.CapTriangles[Index];
+				if (bEnd)
+				{
+					Swap(Tri.B, Tri.C);
+				}
+
+				for (int32 Corner = 0; Corner < 3; ++Corner)
+				{
+					int32& UV = UVs[Tri[Corner]];
+					if (UV == INDEX_NONE)
+					{
+						const FVector2d& YZ = Profile.Points[Tri[Corner]].YZ;
+						UV = Writer.AddUV(FVector2f((float)((YZ.X + HalfThickness) * UVScale), (float)((YZ.Y - BaseZ) * UVScale)));
+					}
+				}
+
+				const FVector3d& PA = Positions[Base + Tri.A];
+				const FVector3d& PB = Positions[Base + Tri.B];
+				const FVector3d& PC = Positions[Base + Tri.C];
+				FVector3f TriangleNormal = FVector3f(FVector3d::CrossProduct(PC - PA, PB - PA).GetSafeNormal());
+				if (TriangleNormal.IsZero())
+				{
+					TriangleNormal = FallbackNormal;
+				}
+				if (Normal == INDEX_NONE || !TriangleNormal.Equals(NormalValue))
+				{
+					Normal = Writer.AddNormal(TriangleNormal);
+					NormalValue = TriangleNormal;
+				}
+
+				Writer.AddTriangle(
+					FIndex3i(Vertices[Base + Tri.A], Vertices[Base + Tri.B], Vertices[Base + Tri.C]),
+					FIndex3i(UVs[Tri.A], UVs[Tri.B], UVs[Tri.C]),
+					FIndex3i(Normal, Normal, Normal),
+					Profile.CapGroups[Index]);
+			}
+		};
+
+		AddCap(0, false, StartCap);
+		AddCap(NumStations - 1, true, EndCap);
+	}
+
+	// Cap skirting blocks project Thickness_Cap beyond a capped (uncut) first / last station, continuing the wall's direction
+	void SweepCapSkirting(FRTPlanMeshWriter& Writer, const FWallProfile& Block, const FSweepStation& First, const FSweepStation& Last,
+		double Thickness_Cap, bool bStart, bool bEnd)
+	{
+		if (bStart)
+		{
+			FSweepStation StartBlock[2] = { First, First };
+			StartBlock[0].Origin -= First.GetTangent() * Thickness_Cap;
+			StartBlock[0].U -= Thickness_Cap * UVScale;
+			SweepProfile(Writer, Block, StartBlock, EEndCap::Full, EEndCap::None);
+		}
+		if (bEnd)
+		{
+			FSweepStation EndBlock[2] = { Last, Last };
+			EndBlock[1].Origin += Last.GetTangent() * Thickness_Cap;
+			EndBlock[1].U += Thickness_Cap * UVScale;
+			SweepProfile(Writer, Block, EndBlock, EEndCap::None, EEndCap::Full);
+		}
+	}
+
+	int32 NumCapSkirtingVertices(const FWallProfile& Block, bool bStart, bool bEnd)
+	{
+		return ((bStart ? 1 : 0) + (bEnd ? 1 : 0)) * NumSweepVertices(Block, 2);
+	}
+
+	int32 NumCapSkirtingTriangles(const FWallProfile& Block, bool bStart, bool bEnd)
+	{
+		return (bStart ? NumSweepTriangles(Block, 2, EEndCap::Full, EEndCap::None) : 0)
+			+ (bEnd ? NumSweepTriangles(Block, 2, EEndCap::None, EEndCap::Full) : 0);
+	}
+
+	// Ends cut as a bent polyline (left corner -> axis -> right corner not in line) need the centre points in the profile
+	bool NeedsCentrePoints(const FRTPlanWallEnd& End)
+	{
+		return !End.bCapped && !FMath::IsNearlyEqual(End.LeftOffset, -End.RightOffset, 0.01f);
 	}
 }
 
@@ -66,255 +466,80 @@ void FRTPlanMeshBuilder::AppendWallMesh(
 	int32 MaterialID_Caps,
 	int32 MaterialID_Skirting_Left,
 	int32 MaterialID_Skirting_Right,
-	int32 MaterialID_Skirting_Cap
+	int32 MaterialID_Skirting_Cap,
+	const FRTPlanWallEnd& StartEnd,
+	const FRTPlanWallEnd& EndEnd
 )
 {
-	if (!TargetMesh || Length <= 0 || Thickness <= 0 || Height <= 0) return;
+	if (!TargetMesh) return;
 
 	TargetMesh->EditMesh([&](FDynamicMesh3& Mesh)
 	{
-		if (!Mesh.HasAttributes())
-		{
-			Mesh.EnableAttributes();
-		}
+		AppendWallMesh(Mesh, Transform, Length, Thickness, Height, BaseZ,
+			SkirtingHeight_Left, SkirtingThickness_Left, SkirtingHeight_Right, SkirtingThickness_Right, SkirtingHeight_Cap, SkirtingThickness_Cap,
+			MaterialID_Left, MaterialID_Right, MaterialID_Caps, MaterialID_Skirting_Left, MaterialID_Skirting_Right, MaterialID_Skirting_Cap,
+			StartEnd, EndEnd);
+	}, EDynamicMeshChangeType::GeneralEdit, EDynamicMeshAttributeChangeFlags::Unknown, false);
+}
 
-		float HalfThickness = Thickness * 0.5f;
-		float UVScale = 0.01f;
-
-		// Define corner points of the wall cross-section profile
-		// Using Y+ as Left, Y- as Right
-		FVector3d P_RB(0, -HalfThickness, BaseZ); // Right-Bottom
-		FVector3d P_RT(0, -HalfThickness, BaseZ + Height); // Right-Top
-		FVector3d P_LT(0, HalfThickness, BaseZ + Height); // Left-Top
-		FVector3d P_LB(0, HalfThickness, BaseZ); // Left-Bottom
-
-		// Skirting points
-		FVector3d P_RS_Out(0, -HalfThickness - SkirtingThickness_Right, BaseZ);
-		FVector3d P_RS_Top(0, -HalfThickness - SkirtingThickness_Right, BaseZ + SkirtingHeight_Right);
-		FVector3d P_LS_Out(0, HalfThickness + SkirtingThickness_Left, BaseZ);
-		FVector3d P_LS_Top(0, HalfThickness + SkirtingThickness_Left, BaseZ + SkirtingHeight_Left);
-
-		// Points at the other end of the wall
-		FVector3d P_RB_End = P_RB + FVector3d(Length, 0, 0);
-		FVector3d P_RT_End = P_RT + FVector3d(Length, 0, 0);
-		FVector3d P_LT_End = P_LT + FVector3d(Length, 0, 0);
-		FVector3d P_LB_End = P_LB + FVector3d(Length, 0, 0);
-		FVector3d P_RS_Out_End = P_RS_Out + FVector3d(Length, 0, 0);
-		FVector3d P_RS_Top_End = P_RS_Top + FVector3d(Length, 0, 0);
-		FVector3d P_LS_Out_End = P_LS_Out + FVector3d(Length, 0, 0);
-		FVector3d P_LS_Top_End = P_LS_Top + FVector3d(Length, 0, 0);
-
-		// --- Main Wall Faces ---
-		// Right Wall Face (above skirting)
-		// Reversed winding for CCW
-		AddQuad(Mesh, P_RB, P_RT, P_RT_End, P_RB_End,
-			FVector2f(0, 0), FVector2f(0, Height * UVScale),
-			FVector2f(Length * UVScale, Height * UVScale), FVector2f(Length * UVScale, 0),
-			FVector3f(0, -1, 0), MaterialID_Right);
-
-		// Left Wall Face (above skirting)
-		// Reversed winding for CCW
-		AddQuad(Mesh, P_LB_End, P_LT_End, P_LT, P_LB,
-			FVector2f(Length * UVScale, 0), FVector2f(Length * UVScale, Height * UVScale),
-			FVector2f(0, Height * UVScale), FVector2f(0, 0),
-			FVector3f(0, 1, 0), MaterialID_Left);
-
-		// --- Skirting Faces ---
-		if (SkirtingHeight_Right > 0 && SkirtingThickness_Right > 0)
-		{
-			// Right Skirting Face
-			// Reversed winding
-			AddQuad(Mesh, P_RS_Out, P_RS_Top, P_RS_Top_End, P_RS_Out_End,
-				FVector2f(0, 0), FVector2f(0, SkirtingHeight_Right * UVScale),
-				FVector2f(Length * UVScale, SkirtingHeight_Right * UVScale), FVector2f(Length * UVScale, 0),
-				FVector3f(0, -1, 0), MaterialID_Skirting_Right);
-			
-			// Right Skirting Top
-			// Connects Skirting Top Outer Edge to Wall Surface at Skirting Height
-			FVector3d P_RW_SkirtTop_Start(0, -HalfThickness, BaseZ + SkirtingHeight_Right);
-			FVector3d P_RW_SkirtTop_End(Length, -HalfThickness, BaseZ + SkirtingHeight_Right);
-			
-			// Normal Up (0,0,1)
-			// Winding: Outer Start -> Wall Start -> Wall End -> Outer End
-			// P_RS_Top -> P_RW_SkirtTop_Start -> P_RW_SkirtTop_End -> P_RS_Top_End
-			// UVs: U -> Length, V -> SkirtThickness
-			AddQuad(Mesh, P_RS_Top, P_RW_SkirtTop_Start, P_RW_SkirtTop_End, P_RS_Top_End,
-				FVector2f(0, 0), FVector2f(0, SkirtingThickness_Right * UVScale),
-				FVector2f(Length * UVScale, SkirtingThickness_Right * UVScale), FVector2f(Length * UVScale, 0),
-				FVector3f(0, 0, 1), MaterialID_Skirting_Right);
-		}
-		if (SkirtingHeight_Left > 0 && SkirtingThickness_Left > 0)
-		{
-			// Left Skirting Face
-			// Reversed winding
-			AddQuad(Mesh, P_LS_Out_End, P_LS_Top_End, P_LS_Top, P_LS_Out,
-				FVector2f(Length * UVScale, 0), FVector2f(Length * UVScale, SkirtingHeight_Left * UVScale),
-				FVector2f(0, SkirtingHeight_Left * UVScale), FVector2f(0, 0),
-				FVector3f(0, 1, 0), MaterialID_Skirting_Left);
-			
-			// Left Skirting Top
-			// Connects Skirting Top Outer Edge to Wall Surface at Skirting Height
-			FVector3d P_LW_SkirtTop_Start(0, HalfThickness, BaseZ + SkirtingHeight_Left);
-			FVector3d P_LW_SkirtTop_End(Length, HalfThickness, BaseZ + SkirtingHeight_Left);
-			
-			// Normal Up (0,0,1)
-			// Winding: Outer Start -> Outer End -> Wall End -> Wall Start
-			// P_LS_Top -> P_LS_Top_End -> P_LW_SkirtTop_End -> P_LW_SkirtTop_Start
-			// UVs: U -> Length, V -> SkirtThickness
-			AddQuad(Mesh, P_LS_Top, P_LS_Top_End, P_LW_SkirtTop_End, P_LW_SkirtTop_Start,
-				FVector2f(0, 0), FVector2f(Length * UVScale, 0),
-				FVector2f(Length * UVScale, SkirtingThickness_Left * UVScale), FVector2f(0, SkirtingThickness_Left * UVScale),
-				FVector3f(0, 0, 1), MaterialID_Skirting_Left);
-		}
+void FRTPlanMeshBuilder::AppendWallMesh(
+	FDynamicMesh3& Mesh,
+	const FTransform& Transform,
+	float Length,
+	float Thickness,
+	float Height,
+	float BaseZ,
+	float SkirtingHeight_Left,
+	float SkirtingThickness_Left,
+	float SkirtingHeight_Right,
+	float SkirtingThickness_Right,
+	float SkirtingHeight_Cap,
+	float SkirtingThickness_Cap,
+	int32 MaterialID_Left,
+	int32 MaterialID_Right,
+	int32 MaterialID_Caps,
+	int32 MaterialID_Skirting_Left,
+	int32 MaterialID_Skirting_Right,
+	int32 MaterialID_Skirting_Cap,
+	const FRTPlanWallEnd& StartEnd,
+	const FRTPlanWallEnd& EndEnd
+)
+{
+	using namespace RTPlanMeshBuilderPrivate;
 
-		// --- Caps and Bottom/Top Faces ---
-		// Top Cap
-		// Reversed winding
-		// UVs: U -> Length, V -> Thickness
-		AddQuad(Mesh, P_RT, P_LT, P_LT_End, P_RT_End,
-			FVector2f(0, 0), FVector2f(0, Thickness * UVScale),
-			FVector2f(Length * UVScale, Thickness * UVScale), FVector2f(Length * UVScale, 0),
-			FVector3f(0, 0, 1), MaterialID_Caps);
-		
-		// Bottom Cap (might be covered by floor, but good to have)
-		// This is now more complex due to skirting. We build it from 3 parts.
-		// Keeping these as is for now, assuming bottom is not visible or winding is less critical
-		AddQuad(Mesh, P_RS_Out_End, P_RB_End, P_RB, P_RS_Out, FVector2f(), FVector2f(), FVector2f(), FVector2f(), FVector3f(0, 0, -1), MaterialID_Caps);
-		AddQuad(Mesh, P_LB_End, P_LS_Out_End, P_LS_Out, P_LB, FVector2f(), FVector2f(), FVector2f(), FVector2f(), FVector3f(0, 0, -1), MaterialID_Caps);
-		AddQuad(Mesh, P_RB_End, P_LB_End, P_LB, P_RB, FVector2f(), FVector2f(), FVector2f(), FVector2f(), FVector3f(0, 0, -1), MaterialID_Caps);
-
-
-		// Start Cap
-		// Reversed winding
-		// UVs: U -> Thickness, V -> Height
-		AddQuad(Mesh, P_RB, P_LB, P_LT, P_RT, 
-			FVector2f(0, 0), FVector2f(Thickness * UVScale, 0), 
-			FVector2f(Thickness * UVScale, Height * UVScale), FVector2f(0, Height * UVScale), 
-			FVector3f(-1, 0, 0), MaterialID_Caps);
-		
-		if (SkirtingHeight_Right > 0) AddQuad(Mesh, P_RS_Out, P_RB, P_RS_Top, P_RS_Out, FVector2f(), FVector2f(), FVector2f(), FVector2f(), FVector3f(-1, 0, 0), MaterialID_Caps); // Triangulated quad? No, P_RS_Out twice?
-		
-		// End Cap
-		// Reversed winding
-		// UVs: U -> Thickness, V -> Height
-		AddQuad(Mesh, P_RT_End, P_LT_End, P_LB_End, P_RB_End, 
-			FVector2f(0, Height * UVScale), FVector2f(Thickness * UVScale, Height * UVScale), 
-			FVector2f(Thickness * UVScale, 0), FVector2f(0, 0), 
-			FVector3f(1, 0, 0), MaterialID_Caps);
-		
-		// --- Cap Skirting ---
-		if (SkirtingHeight_Cap > 0 && SkirtingThickness_Cap > 0)
-		{
-			// Start Cap Skirting
-			// Extends from Start Cap in -X direction
-			FVector3d P_SC_Out_RB(-SkirtingThickness_Cap, -HalfThickness, BaseZ);
-			FVector3d P_SC_Out_RT(-SkirtingThickness_Cap, -HalfThickness, BaseZ + SkirtingHeight_Cap);
-			FVector3d P_SC_Out_LT(-SkirtingThickness_Cap, HalfThickness, BaseZ + SkirtingHeight_Cap);
-			FVector3d P_SC_Out_LB(-SkirtingThickness_Cap, HalfThickness, BaseZ);
-
-			// Face
-			// Reversed winding (LB, LT, RT, RB)
-			AddQuad(Mesh, P_SC_Out_LB, P_SC_Out_LT, P_SC_Out_RT, P_SC_Out_RB,
-				FVector2f(0, 0), FVector2f(0, SkirtingHeight_Cap * UVScale),
-				FVector2f(Thickness * UVScale, SkirtingHeight_Cap * UVScale), FVector2f(Thickness * UVScale, 0),
-				FVector3f(-1, 0, 0), MaterialID_Skirting_Cap);
-			
-			// Top
-			// Connects Skirting Top Outer Edge to Wall Cap Surface at Skirting Height
-			FVector3d P_SC_Wall_RT(0, -HalfThickness, BaseZ + SkirtingHeight_Cap);
-			FVector3d P_SC_Wall_LT(0, HalfThickness, BaseZ + SkirtingHeight_Cap);
-			
-			// Normal Up (0,0,1)
-			// Winding: Outer RT -> Outer LT -> Wall LT -> Wall RT
-			// P_SC_Out_RT -> P_SC_Out_LT -> P_SC_Wall_LT -> P_SC_Wall_RT
-			// UVs: U -> Thickness, V -> SkirtThickness
-			AddQuad(Mesh, P_SC_Out_RT, P_SC_Out_LT, P_SC_Wall_LT, P_SC_Wall_RT,
-				FVector2f(0, SkirtingThickness_Cap * UVScale), FVector2f(Thickness * UVScale, SkirtingThickness_Cap * UVScale),
-				FVector2f(Thickness * UVScale, 0), FVector2f(0, 0),
-				FVector3f(0, 0, 1), MaterialID_Skirting_Cap);
-
-			// Sides (connecting to Left/Right skirting if present, or wall)
-			// Left Side of Start Cap Skirting
-			if (SkirtingHeight_Left > 0)
-			{
-				// Connect to Left Skirting
-				// P_SC_Out_LB -> P_LS_Out (at start)
-				// Side face at Y=HalfThickness
-				AddQuad(Mesh, P_SC_Out_LT, P_SC_Out_LB, P_LB, P_LB, // Degenerate? No, P_LB is at X=0.
-					FVector2f(), FVector2f(), FVector2f(), FVector2f(),
-					FVector3f(0, 1, 0), MaterialID_Skirting_Cap);
-			}
-			else
-			{
-				// P_LB is (0, HalfThickness, BaseZ)
-				// P_SC_Out_LB is (-SkirtTCap, HalfThickness, BaseZ)
-				// P_SC_Out_LT is (-SkirtTCap, HalfThickness, BaseZ+H)
-				// We need point at (0, HalfThickness, BaseZ+H) which is P_LT (if H matches)
-				// Let's use P_LT_Cap equivalent
-				FVector3d P_LT_Cap(0, HalfThickness, BaseZ + SkirtingHeight_Cap);
-				AddQuad(Mesh, P_SC_Out_LT, P_SC_Out_LB, P_LB, P_LT_Cap,
-					FVector2f(), FVector2f(), FVector2f(), FVector2f(),
-					FVector3f(0, 1, 0), MaterialID_Skirting_Cap);
-			}
-			
-			// Right Side of Start Cap Skirting
-			{
-				FVector3d P_RT_Cap(0, -HalfThickness, BaseZ + SkirtingHeight_Cap);
-				AddQuad(Mesh, P_SC_Out_RB, P_SC_Out_RT, P_RT_Cap, P_RB,
-					FVector2f(), FVector2f(), FVector2f(), FVector2f(),
-					FVector3f(0, -1, 0), MaterialID_Skirting_Cap);
-			}
+	if (Length <= 0 || Thickness <= 0 || Height <= 0) return;
 
+	const double HalfThickness = Thickness * 0.5;
+	const FWallProfile Profile = MakeWallProfile(HalfThickness, Height, BaseZ,
+		SkirtingHeight_Left, SkirtingThickness_Left, SkirtingHeight_Right, SkirtingThickness_Right,
+		MaterialID_Left, MaterialID_Right, MaterialID_Caps, MaterialID_Skirting_Left, MaterialID_Skirting_Right,
+		NeedsCentrePoints(StartEnd) || NeedsCentrePoints(EndEnd));
 
-			// End Cap Skirting
-			// Extends from End Cap in +X direction
-			FVector3d P_EC_Out_RB(Length + SkirtingThickness_Cap, -HalfThickness, BaseZ);
-			FVector3d P_EC_Out_RT(Length + SkirtingThickness_Cap, -HalfThickness, BaseZ + SkirtingHeight_Cap);
-			FVector3d P_EC_Out_LT(Length + SkirtingThickness_Cap, HalfThickness, BaseZ + SkirtingHeight_Cap);
-			FVector3d P_EC_Out_LB(Length + SkirtingThickness_Cap, HalfThickness, BaseZ);
-
-			// Face
-			// Reversed winding (RB, RT, LT, LB)
-			AddQuad(Mesh, P_EC_Out_RB, P_EC_Out_RT, P_EC_Out_LT, P_EC_Out_LB,
-				FVector2f(0, 0), FVector2f(0, SkirtingHeight_Cap * UVScale),
-				FVector2f(Thickness * UVScale, SkirtingHeight_Cap * UVScale), FVector2f(Thickness * UVScale, 0),
-				FVector3f(1, 0, 0), MaterialID_Skirting_Cap);
-
-			// Top
-			// Connects Skirting Top Outer Edge to Wall Cap Surface at Skirting Height
-			FVector3d P_EC_Wall_RT(Length, -HalfThickness, BaseZ + SkirtingHeight_Cap);
-			FVector3d P_EC_Wall_LT(Length, HalfThickness, BaseZ + SkirtingHeight_Cap);
-			
-			// Normal Up (0,0,1)
-			// Winding: Outer LT -> Outer RT -> Wall RT -> Wall LT
-			// P_EC_Out_LT -> P_EC_Out_RT -> P_EC_Wall_RT -> P_EC_Wall_LT
-			// UVs: U -> Thickness, V -> SkirtThickness
-			AddQuad(Mesh, P_EC_Out_LT, P_EC_Out_RT, P_EC_Wall_RT, P_EC_Wall_LT,
-				FVector2f(Thickness * UVScale, SkirtingThickness_Cap * UVScale), FVector2f(0, SkirtingThickness_Cap * UVScale),
-				FVector2f(0, 0), FVector2f(Thickness * UVScale, 0),
-				FVector3f(0, 0, 1), MaterialID_Skirting_Cap);
-
-			// Sides
-			// Left Side of End Cap Skirting
-			{
-				FVector3d P_LT_End_Cap(Length, HalfThickness, BaseZ + SkirtingHeight_Cap);
-				AddQuad(Mesh, P_EC_Out_LB, P_EC_Out_LT, P_LT_End_Cap, P_LB_End,
-					FVector2f(), FVector2f(), FVector2f(), FVector2f(),
-					FVector3f(0, 1, 0), MaterialID_Skirting_Cap);
-			}
-			// Right Side of End Cap Skirting
-			{
-				FVector3d P_RT_End_Cap(Length, -HalfThickness, BaseZ + SkirtingHeight_Cap);
-				AddQuad(Mesh, P_EC_Out_RT, P_EC_Out_RB, P_RB_End, P_RT_End_Cap,
-					FVector2f(), FVector2f(), FVector2f(), FVector2f(),
-					FVector3f(0, -1, 0), MaterialID_Skirting_Cap);
-			}
-		}
+	const bool bCapSkirting = SkirtingHeight_Cap > 0 && SkirtingThickness_Cap > 0;
+	const FWallProfile Block = bCapSkirting ? MakeBlockProfile(HalfThickness, SkirtingHeight_Cap, BaseZ, MaterialID_Skirting_Cap) : FWallProfile();
 
-		// Transform the entire mesh
-		UGeometryScriptLibrary_MeshTransformFunctions::TransformMesh(TargetMesh, Transform);
+	// Wall-local X runs along the wall, Y to its left. Stations are placed in world space up front,
+	// so positions are written once and never revisited.
+	FSweepStation Stations[2];
+	for (int32 Index = 0; Index < 2; ++Index)
+	{
+		const double X = Index == 0 ? 0.0 : Length;
+		Stations[Index].Origin = Transform.TransformPosition(FVector(X, 0, 0));
+		Stations[Index].Left = Transform.TransformVector(FVector::YAxisVector);
+		Stations[Index].Up = Transform.TransformVector(FVector::ZAxisVector);
+		Stations[Index].U = X * UVScale;
+	}
+	Stations[0].SetTrim(StartEnd, Length);
+	Stations[1].SetTrim(EndEnd, Length);
 
-	}, EDynamicMeshChangeType::GeneralEdit, EDynamicMeshAttributeChangeFlags::Unknown, false);
+	const bool bStartSkirting = bCapSkirting && StartEnd.bCapped;
+	const bool bEndSkirting = bCapSkirting && EndEnd.bCapped;
+	const int32 NumVertices = NumSweepVertices(Profile, 2) + NumCapSkirtingVertices(Block, bStartSkirting, bEndSkirting);
+	const int32 NumTriangles = NumSweepTriangles(Profile, 2, GetEndCap(StartEnd), GetEndCap(EndEnd)) + NumCapSkirtingTriangles(Block, bStartSkirting, bEndSkirting);
+	FRTPlanMeshWriter Writer(Mesh, NumVertices, NumTriangles);
+
+	SweepProfile(Writer, Profile, Stations, GetEndCap(StartEnd), GetEndCap(EndEnd));
+	SweepCapSkirting(Writer, Block, Stations[0], Stations[1], SkirtingThickness_Cap, bStartSkirting, bEndSkirting);
 }
 
 void FRTPlanMeshBuilder::AppendCurvedWallMesh(
@@ -338,386 +563,103 @@ void FRTPlanMeshBuilder::AppendCurvedWallMesh(
 	int32 MaterialID_Caps,
 	int32 MaterialID_Skirting_Left,
 	int32 MaterialID_Skirting_Right,
-	int32 MaterialID_Skirting_Cap
+	int32 MaterialID_Skirting_Cap,
+	const FRTPlanWallEnd& StartEnd,
+	const FRTPlanWallEnd& EndEnd
 )
 {
-	if (!TargetMesh || FMath::Abs(SweepAngleDeg) < 0.1f) return;
+	if (!TargetMesh) return;
 
-	float CenterRadius = FVector2D::Distance(ArcCenter, StartPoint);
-	if (CenterRadius < 0.1f) return;
+	TargetMesh->EditMesh([&](FDynamicMesh3& Mesh)
+	{
+		AppendCurvedWallMesh(Mesh, StartPoint, EndPoint, ArcCenter, SweepAngleDeg, Thickness, Height, BaseZ, NumSegments,
+			SkirtingHeight_Left, SkirtingThickness_Left, SkirtingHeight_Right, SkirtingThickness_Right, SkirtingHeight_Cap, SkirtingThickness_Cap,
+			MaterialID_Left, MaterialID_Right, MaterialID_Caps, MaterialID_Skirting_Left, MaterialID_Skirting_Right, MaterialID_Skirting_Cap,
+			StartEnd, EndEnd);
+	}, EDynamicMeshChangeType::GeneralEdit, EDynamicMeshAttributeChangeFlags::Unknown, false);
+}
+
+void FRTPlanMeshBuilder::AppendCurvedWallMesh(
+	FDynamicMesh3& Mesh,
+	const FVector2D& StartPoint,
+	const FVector2D& EndPoint,
+	const FVector2D& ArcCenter,
+	float SweepAngleDeg,
+	float Thickness,
+	float Height,
+	float BaseZ,
+	int32 NumSegments,
+	float SkirtingHeight_Left,
+	float SkirtingThickness_Left,
+	float SkirtingHeight_Right,
+	float SkirtingThickness_Right,
+	float SkirtingHeight_Cap,
+	float SkirtingThickness_Cap,
+	int32 MaterialID_Left,
+	int32 MaterialID_Right,
+	int32 MaterialID_Caps,
+	int32 MaterialID_Skirting_Left,
+	int32 MaterialID_Skirting_Right,
+	int32 MaterialID_Skirting_Cap,
+	const FRTPlanWallEnd& StartEnd,
+	const FRTPlanWallEnd& EndEnd
+)
+{
+	using namespace RTPlanMeshBuilderPrivate;
 
-	float HalfThickness = Thickness * 0.5f;
-	float InnerRadius = CenterRadius - HalfThickness;
-	float OuterRadius = CenterRadius + HalfThickness;
+	if (FMath::Abs(SweepAngleDeg) < 0.1f) return;
+	if (Thickness <= 0 || Height <= 0) return;
 
-	if (InnerRadius < 0.1f) InnerRadius = 0.1f;
+	const double CenterRadius = FVector2D::Distance(ArcCenter, StartPoint);
+	if (CenterRadius < 0.1) return;
 
-	FVector2D ToStart = StartPoint - ArcCenter;
-	float StartAngleRad = FMath::Atan2(ToStart.Y, ToStart.X);
+	const FVector2D ToStart = StartPoint - ArcCenter;
+	const double StartAngleRad = FMath::Atan2(ToStart.Y, ToStart.X);
 
 	NumSegments = FMath::Max(NumSegments, FMath::CeilToInt(FMath::Abs(SweepAngleDeg) / 15.0f));
 	NumSegments = FMath::Clamp(NumSegments, 4, 128);
-	
-	float SweepRad = FMath::DegreesToRadians(SweepAngleDeg);
-	float StepAngle = SweepRad / (float)NumSegments;
 
-	float TopZ = BaseZ + Height;
-	float UVScale = 0.01f;
+	const double StepAngle = FMath::DegreesToRadians((double)SweepAngleDeg) / NumSegments;
 
-	TargetMesh->EditMesh([&](FDynamicMesh3& Mesh)
-	{
-		if (!Mesh.HasAttributes()) Mesh.EnableAttributes();
+	// The left side of a counter-clockwise arc faces the centre, the left side of a clockwise one faces away
+	const double LeftSign = SweepAngleDeg > 0 ? -1.0 : 1.0;
 
-		for (int32 i = 0; i < NumSegments; ++i)
-		{
-			float Angle0 = StartAngleRad + StepAngle * i;
-			float Angle1 = StartAngleRad + StepAngle * (i + 1);
-			float CosA0 = FMath::Cos(Angle0), SinA0 = FMath::Sin(Angle0);
-			float CosA1 = FMath::Cos(Angle1), SinA1 = FMath::Sin(Angle1);
-
-			// Determine which side is Left/Right based on sweep direction
-			// If Sweep > 0 (CCW): Inner is Left, Outer is Right.
-			// If Sweep < 0 (CW): Inner is Right, Outer is Left.
-			int32 InnerMat = SweepAngleDeg > 0 ? MaterialID_Left : MaterialID_Right;
-			int32 OuterMat = SweepAngleDeg > 0 ? MaterialID_Right : MaterialID_Left;
-			int32 SkirtInnerMat = SweepAngleDeg > 0 ? MaterialID_Skirting_Left : MaterialID_Skirting_Right;
-			int32 SkirtOuterMat = SweepAngleDeg > 0 ? MaterialID_Skirting_Right : MaterialID_Skirting_Left;
-			
-			float SkirtHInner = SweepAngleDeg > 0 ? SkirtingHeight_Left : SkirtingHeight_Right;
-			float SkirtHOuter = SweepAngleDeg > 0 ? SkirtingHeight_Right : SkirtingHeight_Left;
-			float SkirtTInner = SweepAngleDeg > 0 ? SkirtingThickness_Left : SkirtingThickness_Right;
-			float SkirtTOuter = SweepAngleDeg > 0 ? SkirtingThickness_Right : SkirtingThickness_Left;
-
-			// Define profile points for segment start (0) and end (1)
-			FVector2D P_Inner0 = ArcCenter + FVector2D(CosA0, SinA0) * InnerRadius;
-			FVector2D P_Outer0 = ArcCenter + FVector2D(CosA0, SinA0) * OuterRadius;
-			FVector2D P_Inner1 = ArcCenter + FVector2D(CosA1, SinA1) * InnerRadius;
-			FVector2D P_Outer1 = ArcCenter + FVector2D(CosA1, SinA1) * OuterRadius;
-
-			// Skirting profile points
-			FVector2D P_Skirting_Inner0 = ArcCenter + FVector2D(CosA0, SinA0) * (InnerRadius - SkirtTInner);
-			FVector2D P_Skirting_Outer0 = ArcCenter + FVector2D(CosA0, SinA0) * (OuterRadius + SkirtTOuter);
-			FVector2D P_Skirting_Inner1 = ArcCenter + FVector2D(CosA1, SinA1) * (InnerRadius - SkirtTInner);
-			FVector2D P_Skirting_Outer1 = ArcCenter + FVector2D(CosA1, SinA1) * (OuterRadius + SkirtTOuter);
-
-			// UVs
-			float U0 = CenterRadius * StepAngle * i * UVScale;
-			float U1 = CenterRadius * StepAngle * (i + 1) * UVScale;
-
-			// Main Wall Faces
-			FVector3d P_IRB0(P_Inner0, BaseZ), P_IRT0(P_Inner0, TopZ);
-			FVector3d P_IRB1(P_Inner1, BaseZ), P_IRT1(P_Inner1, TopZ);
-			
-			// Inner Face
-			if (SweepAngleDeg > 0)
-			{
-				// CCW: 1->0 (Flipped from previous 0->1)
-				AddQuad(Mesh, P_IRB1, P_IRT1, P_IRT0, P_IRB0, 
-					FVector2f(U1, 0), FVector2f(U1, Height * UVScale), FVector2f(U0, Height * UVScale), FVector2f(U0, 0), 
-					FVector3f(-CosA0, -SinA0, 0), InnerMat);
-			}
-			else
-			{
-				// CW: 0->1 (Flipped from previous 1->0)
-				AddQuad(Mesh, P_IRB0, P_IRT0, P_IRT1, P_IRB1, 
-					FVector2f(U0, 0), FVector2f(U0, Height * UVScale), FVector2f(U1, Height * UVScale), FVector2f(U1, 0), 
-					FVector3f(-CosA0, -SinA0, 0), InnerMat);
-			}
+	TArray<FSweepStation, TInlineAllocator<33>> Stations;
+	Stations.SetNum(NumSegments + 1);
+	for (int32 Index = 0; Index <= NumSegments; ++Index)
+	{
+		double Sin, Cos;
+		FMath::SinCos(&Sin, &Cos, StartAngleRad + StepAngle * Index);
+		const FVector3d Radial(Cos, Sin, 0.0);
+
+		FSweepStation& Station = Stations[Index];
+		Station.Origin = FVector3d(ArcCenter.X, ArcCenter.Y, 0.0) + Radial * CenterRadius;
+		Station.Left = Radial * LeftSign;
+		Station.Up = FVector3d::UnitZ();
+		Station.U = CenterRadius * FMath::Abs(StepAngle) * Index * UVScale;
+	}
 
-			FVector3d P_OLB0(P_Outer0, BaseZ), P_OLT0(P_Outer0, TopZ);
-			FVector3d P_OLB1(P_Outer1, BaseZ), P_OLT1(P_Outer1, TopZ);
-			
-			// Outer Face
-			if (SweepAngleDeg > 0)
-			{
-				// CCW: 0->1 (Flipped from previous 1->0)
-				AddQuad(Mesh, P_OLB0, P_OLT0, P_OLT1, P_OLB1, 
-					FVector2f(U0, 0), FVector2f(U0, Height * UVScale), FVector2f(U1, Height * UVScale), FVector2f(U1, 0), 
-					FVector3f(CosA0, SinA0, 0), OuterMat);
-			}
-			else
-			{
-				// CW: 1->0 (Flipped from previous 0->1)
-				AddQuad(Mesh, P_OLB1, P_OLT1, P_OLT0, P_OLB0, 
-					FVector2f(U1, 0), FVector2f(U1, Height * UVScale), FVector2f(U0, Height * UVScale), FVector2f(U0, 0), 
-					FVector3f(CosA0, SinA0, 0), OuterMat);
-			}
+	const double HalfThickness = Thickness * 0.5;
+	const FWallProfile Profile = MakeWallProfile(HalfThickness, Height, BaseZ,
+		SkirtingHeight_Left, SkirtingThickness_Left, SkirtingHeight_Right, SkirtingThickness_Right,
+		MaterialID_Left, MaterialID_Right, MaterialID_Caps, MaterialID_Skirting_Left, MaterialID_Skirting_Right,
+		NeedsCentrePoints(StartEnd) || NeedsCentrePoints(EndEnd));
 
-			// Skirting
-			if (SkirtHInner > 0)
-			{
-				FVector3d P_SIB0(P_Skirting_Inner0, BaseZ), P_SIT0(P_Skirting_Inner0, BaseZ + SkirtHInner);
-				FVector3d P_SIB1(P_Skirting_Inner1, BaseZ), P_SIT1(P_Skirting_Inner1, BaseZ + SkirtHInner);
-				
-				// Inner Skirting Face
-				if (SweepAngleDeg > 0)
-				{
-					// CCW: 1->0 (Flipped)
-					AddQuad(Mesh, P_SIB1, P_SIT1, P_SIT0, P_SIB0, 
-						FVector2f(U1, 0), FVector2f(U1, SkirtHInner * UVScale), FVector2f(U0, SkirtHInner * UVScale), FVector2f(U0, 0), 
-						FVector3f(-CosA0, -SinA0, 0), SkirtInnerMat);
-				}
-				else
-				{
-					// CW: 0->1 (Flipped)
-					AddQuad(Mesh, P_SIB0, P_SIT0, P_SIT1, P_SIB1, 
-						FVector2f(U0, 0), FVector2f(U0, SkirtHInner * UVScale), FVector2f(U1, SkirtHInner * UVScale), FVector2f(U1, 0), 
-						FVector3f(-CosA0, -SinA0, 0), SkirtInnerMat);
-				}
-					
-				// Inner Skirting Top
-				// Connect Skirting Top to Wall Inner Surface at Skirting Height
-				FVector3d P_Wall_IB0(P_Inner0, BaseZ + SkirtHInner);
-				FVector3d P_Wall_IB1(P_Inner1, BaseZ + SkirtHInner);
-				
-				// Normal Up (0,0,1)
-				// Winding depends on sweep direction
-				if (SweepAngleDeg > 0)
-				{
-					// CCW: S0, S1, W1, W0
-					// UVs: U -> Arc Length, V -> SkirtThickness
-					AddQuad(Mesh, P_SIT0, P_SIT1, P_Wall_IB1, P_Wall_IB0, 
-						FVector2f(U0, 0), FVector2f(U1, 0), 
-						FVector2f(U1, SkirtTInner * UVScale), FVector2f(U0, SkirtTInner * UVScale), 
-						FVector3f(0,0,1), SkirtInnerMat);
-				}
-				else
-				{
-					// CW: S1, S0, W0, W1
-					AddQuad(Mesh, P_SIT1, P_SIT0, P_Wall_IB0, P_Wall_IB1, 
-						FVector2f(U1, 0), FVector2f(U0, 0), 
-						FVector2f(U0, SkirtTInner * UVScale), FVector2f(U1, SkirtTInner * UVScale), 
-						FVector3f(0,0,1), SkirtInnerMat);
-				}
-			}
-			
-			if (SkirtHOuter > 0)
-			{
-				FVector3d P_SOB0(P_Skirting_Outer0, BaseZ), P_SOT0(P_Skirting_Outer0, BaseZ + SkirtHOuter);
-				FVector3d P_SOB1(P_Skirting_Outer1, BaseZ), P_SOT1(P_Skirting_Outer1, BaseZ + SkirtHOuter);
-				
-				// Outer Skirting Face
-				if (SweepAngleDeg > 0)
-				{
-					// CCW: 0->1 (Flipped)
-					AddQuad(Mesh, P_SOB0, P_SOT0, P_SOT1, P_SOB1, 
-						FVector2f(U0, 0), FVector2f(U0, SkirtHOuter * UVScale), FVector2f(U1, SkirtHOuter * UVScale), FVector2f(U1, 0), 
-						FVector3f(CosA0, SinA0, 0), SkirtOuterMat);
-				}
-				else
-				{
-					// CW: 1->0 (Flipped)
-					AddQuad(Mesh, P_SOB1, P_SOT1, P_SOT0, P_SOB0, 
-						FVector2f(U1, 0), FVector2f(U1, SkirtHOuter * UVScale), FVector2f(U0, SkirtHOuter * UVScale), FVector2f(U0, 0), 
-						FVector3f(CosA0, SinA0, 0), SkirtOuterMat);
-				}
-					
-				// Outer Skirting Top
-				// Connect Skirting Top to Wall Outer Surface at Skirting Height
-				FVector3d P_Wall_OB0(P_Outer0, BaseZ + SkirtHOuter);
-				FVector3d P_Wall_OB1(P_Outer1, BaseZ + SkirtHOuter);
-				
-				// Normal Up (0,0,1)
-				// Winding depends on sweep direction
-				if (SweepAngleDeg > 0)
-				{
-					// CCW: S0, W0, W1, S1 (Flipped from S0, S1, W1, W0)
-					// UVs: U -> Arc Length, V -> SkirtThickness
-					AddQuad(Mesh, P_SOT0, P_Wall_OB0, P_Wall_OB1, P_SOT1, 
-						FVector2f(U0, 0), FVector2f(U0, SkirtTOuter * UVScale), 
-						FVector2f(U1, SkirtTOuter * UVScale), FVector2f(U1, 0), 
-						FVector3f(0,0,1), SkirtOuterMat);
-				}
-				else
-				{
-					// CW: S0, S1, W1, W0 (Flipped from S1, S0, W0, W1)
-					// Wait, previous was S1, S0, W0, W1.
-					// Flipped is S0, S1, W1, W0.
-					// S0 (Left Bottom). S1 (Right Bottom). W1 (Right Top). W0 (Left Top).
-					// S0 -> S1 -> W1 -> W0.
-					// LB -> RB -> RT -> LT.
-					// CCW.
-					// So S0, S1, W1, W0 is correct for CW.
-					AddQuad(Mesh, P_SOT0, P_SOT1, P_Wall_OB1, P_Wall_OB0, 
-						FVector2f(U0, 0), FVector2f(U1, 0), 
-						FVector2f(U1, SkirtTOuter * UVScale), FVector2f(U0, SkirtTOuter * UVScale), 
-						FVector3f(0,0,1), SkirtOuterMat);
-				}
-			}
+	const bool bCapSkirting = SkirtingHeight_Cap > 0 && SkirtingThickness_Cap > 0;
+	const FWallProfile Block = bCapSkirting ? MakeBlockProfile(HalfThickness, SkirtingHeight_Cap, BaseZ, MaterialID_Skirting_Cap) : FWallProfile();
 
-			// Top Cap
-			if (SweepAngleDeg > 0)
-			{
-				// CCW: Inner->Inner (0->1)
-				// P_IRT0, P_IRT1, P_OLT1, P_OLT0
-				AddQuad(Mesh, P_IRT0, P_IRT1, P_OLT1, P_OLT0, 
-					FVector2f(U0, 0), FVector2f(U1, 0), 
-					FVector2f(U1, Thickness * UVScale), FVector2f(U0, Thickness * UVScale), 
-					FVector3f(0,0,1), MaterialID_Caps);
-			}
-			else
-			{
-				// CW: Inner->Outer (0->1)
-				// P_IRT0, P_OLT0, P_OLT1, P_IRT1
-				AddQuad(Mesh, P_IRT0, P_OLT0, P_OLT1, P_IRT1, 
-					FVector2f(U0, 0), FVector2f(U0, Thickness * UVScale), 
-					FVector2f(U1, Thickness * UVScale), FVector2f(U1, 0), 
-					FVector3f(0,0,1), MaterialID_Caps);
-			}
-			
-			// Start Cap (at i=0)
-			if (i == 0)
-			{
-				// Wall Start Cap
-				if (SweepAngleDeg > 0)
-				{
-					// CCW
-					AddQuad(Mesh, P_IRB0, P_IRT0, P_OLT0, P_OLB0, 
-						FVector2f(0, 0), FVector2f(0, Height * UVScale), 
-						FVector2f(Thickness * UVScale, Height * UVScale), FVector2f(Thickness * UVScale, 0), 
-						FVector3f(FMath::Sin(Angle0), -FMath::Cos(Angle0), 0), MaterialID_Caps);
-						
-					// Inner Skirting Start Cap
-					if (SkirtHInner > 0)
-					{
-						FVector3d P_SIT0(P_Skirting_Inner0, BaseZ + SkirtHInner);
-						FVector3d P_SIB0(P_Skirting_Inner0, BaseZ);
-						FVector3d P_W_IB_H(P_Inner0, BaseZ + SkirtHInner);
-						// P_SIT0, P_W_IB_H, P_IRB0, P_SIB0
-						AddQuad(Mesh, P_SIT0, P_W_IB_H, P_IRB0, P_SIB0, 
-							FVector2f(SkirtTInner * UVScale, SkirtHInner * UVScale), FVector2f(0, SkirtHInner * UVScale), 
-							FVector2f(0, 0), FVector2f(SkirtTInner * UVScale, 0), 
-							FVector3f(FMath::Sin(Angle0), -FMath::Cos(Angle0), 0), SkirtInnerMat);
-					}
-					
-					// Outer Skirting Start Cap
-					if (SkirtHOuter > 0)
-					{
-						FVector3d P_SOT0(P_Skirting_Outer0, BaseZ + SkirtHOuter);
-						FVector3d P_SOB0(P_Skirting_Outer0, BaseZ);
-						FVector3d P_W_OB_H(P_Outer0, BaseZ + SkirtHOuter);
-						// P_SOT0, P_SOB0, P_OLB0, P_W_OB_H
-						AddQuad(Mesh, P_SOT0, P_SOB0, P_OLB0, P_W_OB_H, 
-							FVector2f(SkirtTOuter * UVScale, SkirtHOuter * UVScale), FVector2f(SkirtTOuter * UVScale, 0), 
-							FVector2f(0, 0), FVector2f(0, SkirtHOuter * UVScale), 
-							FVector3f(FMath::Sin(Angle0), -FMath::Cos(Angle0), 0), SkirtOuterMat);
-					}
-				}
-				else
-				{
-					// CW
-					AddQuad(Mesh, P_OLB0, P_OLT0, P_IRT0, P_IRB0, 
-						FVector2f(0, 0), FVector2f(0, Height * UVScale), 
-						FVector2f(Thickness * UVScale, Height * UVScale), FVector2f(Thickness * UVScale, 0), 
-						FVector3f(-FMath::Sin(Angle0), FMath::Cos(Angle0), 0), MaterialID_Caps);
-						
-					// Inner Skirting Start Cap (CW)
-					if (SkirtHInner > 0)
-					{
-						FVector3d P_SIT0(P_Skirting_Inner0, BaseZ + SkirtHInner);
-						FVector3d P_SIB0(P_Skirting_Inner0, BaseZ);
-						FVector3d P_W_IB_H(P_Inner0, BaseZ + SkirtHInner);
-						// Reverse of CCW: P_SIB0, P_IRB0, P_W_IB_H, P_SIT0
-						AddQuad(Mesh, P_SIB0, P_IRB0, P_W_IB_H, P_SIT0, 
-							FVector2f(SkirtTInner * UVScale, 0), FVector2f(0, 0), 
-							FVector2f(0, SkirtHInner * UVScale), FVector2f(SkirtTInner * UVScale, SkirtHInner * UVScale), 
-							FVector3f(-FMath::Sin(Angle0), FMath::Cos(Angle0), 0), SkirtInnerMat);
-					}
-					
-					// Outer Skirting Start Cap (CW)
-					if (SkirtHOuter > 0)
-					{
-						FVector3d P_SOT0(P_Skirting_Outer0, BaseZ + SkirtHOuter);
-						FVector3d P_SOB0(P_Skirting_Outer0, BaseZ);
-						FVector3d P_W_OB_H(P_Outer0, BaseZ + SkirtHOuter);
-						// Reverse of CCW: P_W_OB_H, P_OLB0, P_SOB0, P_SOT0
-						AddQuad(Mesh, P_W_OB_H, P_OLB0, P_SOB0, P_SOT0, 
-							FVector2f(0, SkirtHOuter * UVScale), FVector2f(0, 0), 
-							FVector2f(SkirtTOuter * UVScale, 0), FVector2f(SkirtTOuter * UVScale, SkirtHOuter * UVScale), 
-							FVector3f(-FMath::Sin(Angle0), FMath::Cos(Angle0), 0), SkirtOuterMat);
-					}
-				}
-			}
-			
-			// End Cap (at i=NumSegments-1)
-			if (i == NumSegments - 1)
-			{
-				// Wall End Cap
-				if (SweepAngleDeg > 0)
-				{
-					// CCW
-					AddQuad(Mesh, P_OLB1, P_OLT1, P_IRT1, P_IRB1, 
-						FVector2f(0, 0), FVector2f(0, Height * UVScale), 
-						FVector2f(Thickness * UVScale, Height * UVScale), FVector2f(Thickness * UVScale, 0), 
-						FVector3f(-FMath::Sin(Angle1), FMath::Cos(Angle1), 0), MaterialID_Caps);
-						
-					// Inner Skirting End Cap
-					if (SkirtHInner > 0)
-					{
-						FVector3d P_SIT1(P_Skirting_Inner1, BaseZ + SkirtHInner);
-						FVector3d P_SIB1(P_Skirting_Inner1, BaseZ);
-						FVector3d P_W_IB_H(P_Inner1, BaseZ + SkirtHInner);
-						// P_SIT1, P_SIB1, P_IRB1, P_W_IB_H
-						AddQuad(Mesh, P_SIT1, P_SIB1, P_IRB1, P_W_IB_H, 
-							FVector2f(SkirtTInner * UVScale, SkirtHInner * UVScale), FVector2f(SkirtTInner * UVScale, 0), 
-							FVector2f(0, 0), FVector2f(0, SkirtHInner * UVScale), 
-							FVector3f(-FMath::Sin(Angle1), FMath::Cos(Angle1), 0), SkirtInnerMat);
-					}
-					
-					// Outer Skirting End Cap
-					if (SkirtHOuter > 0)
-					{
-						FVector3d P_SOT1(P_Skirting_Outer1, BaseZ + SkirtHOuter);
-						FVector3d P_SOB1(P_Skirting_Outer1, BaseZ);
-						FVector3d P_W_OB_H(P_Outer1, BaseZ + SkirtHOuter);
-						// P_SOT1, P_W_OB_H, P_OLB1, P_SOB1
-						AddQuad(Mesh, P_SOT1, P_W_OB_H, P_OLB1, P_SOB1, 
-							FVector2f(SkirtTOuter * UVScale, SkirtHOuter * UVScale), FVector2f(0, SkirtHOuter * UVScale), 
-							FVector2f(0, 0), FVector2f(SkirtTOuter * UVScale, 0), 
-							FVector3f(-FMath::Sin(Angle1), FMath::Cos(Angle1), 0), SkirtOuterMat);
-					}
-				}
-				else
-				{
-					// CW
-					AddQuad(Mesh, P_IRB1, P_IRT1, P_OLT1, P_OLB1, 
-						FVector2f(0, 0), FVector2f(0, Height * UVScale), 
-						FVector2f(Thickness * UVScale, Height * UVScale), FVector2f(Thickness * UVScale, 0), 
-						FVector3f(FMath::Sin(Angle1), -FMath::Cos(Angle1), 0), MaterialID_Caps);
-						
-					// Inner Skirting End Cap (CW)
-					if (SkirtHInner > 0)
-					{
-						FVector3d P_SIT1(P_Skirting_Inner1, BaseZ + SkirtHInner);
-						FVector3d P_SIB1(P_Skirting_Inner1, BaseZ);
-						FVector3d P_W_IB_H(P_Inner1, BaseZ + SkirtHInner);
-						// Reverse of CCW: P_W_IB_H, P_IRB1, P_SIB1, P_SIT1
-						AddQuad(Mesh, P_W_IB_H, P_IRB1, P_SIB1, P_SIT1, 
-							FVector2f(0, SkirtHInner * UVScale), FVector2f(0, 0), 
-							FVector2f(SkirtTInner * UVScale, 0), FVector2f(SkirtTInner * UVScale, SkirtHInner * UVScale), 
-							FVector3f(FMath::Sin(Angle1), -FMath::Cos(Angle1), 0), SkirtInnerMat);
-					}
-					
-					// Outer Skirting End Cap (CW)
-					if (SkirtHOuter > 0)
-					{
-						FVector3d P_SOT1(P_Skirting_Outer1, BaseZ + SkirtHOuter);
-						FVector3d P_SOB1(P_Skirting_Outer1, BaseZ);
-						FVector3d P_W_OB_H(P_Outer1, BaseZ + SkirtHOuter);
-						// Reverse of CCW: P_SOB1, P_OLB1, P_W_OB_H, P_SOT1
-						AddQuad(Mesh, P_SOB1, P_OLB1, P_W_OB_H, P_SOT1, 
-							FVector2f(SkirtTOuter * UVScale, 0), FVector2f(0, 0), 
-							FVector2f(0, SkirtHOuter * UVScale), FVector2f(SkirtTOuter * UVScale, SkirtHOuter * UVScale), 
-							FVector3f(FMath::Sin(Angle1), -FMath::Cos(Angle1), 0), SkirtOuterMat);
-					}
-				}
-			}
-		}
+	const double ArcLength = CenterRadius * FMath::Abs(StepAngle) * NumSegments;
+	Stations[0].SetTrim(StartEnd, ArcLength);
+	Stations.Last().SetTrim(EndEnd, ArcLength);
 
-		// Caps (simplified for now)
-		// TODO: Add proper caps with skirting profile
+	const bool bStartSkirting = bCapSkirting && StartEnd.bCapped;
+	const bool bEndSkirting = bCapSkirting && EndEnd.bCapped;
+	const int32 NumVertices = NumSweepVertices(Profile, Stations.Num()) + NumCapSkirtingVertices(Block, bStartSkirting, bEndSkirting);
+	const int32 NumTriangles = NumSweepTriangles(Profile, Stations.Num(), GetEndCap(StartEnd), GetEndCap(EndEnd)) + NumCapSkirtingTriangles(Block, bStartSkirting, bEndSkirting);
+	FRTPlanMeshWriter Writer(Mesh, NumVertices, NumTriangles);
 
-	}, EDynamicMeshChangeType::GeneralEdit, EDynamicMeshAttributeChangeFlags::Unknown, false);
+	SweepProfile(Writer, Profile, Stations, GetEndCap(StartEnd), GetEndCap(EndEnd));
+	SweepCapSkirting(Writer, Block, Stations[0], Stations.Last(), SkirtingThickness_Cap, bStartSkirting, bEndSkirting);
 }
 
 void FRTPlanMeshBuilder::AppendFloorMesh(
@@ -0,0 +1,43 @@
+﻿#include "RTPlanMeshWriter.h"
+
+using namespace UE::Geometry;
+
+FRTPlanMeshWriter::FRTPlanMeshWriter(FDynamicMesh3& InMesh, int32 InExpectedVertices, int32 InExpectedTriangles)
+	: Mesh(InMesh)
+	, ExpectedVertices(InExpectedVertices)
+	, ExpectedTriangles(InExpectedTriangles)
+{
+	if (!Mesh.HasAttributes())
+	{
+		Mesh.EnableAttributes();
+	}
+	UVs = Mesh.Attributes()->PrimaryUV();
+	Normals = Mesh.Attributes()->PrimaryNormals();
+}
+
+FRTPlanMeshWriter::~FRTPlanMeshWriter()
+{
+	ensureMsgf(NumVerticesAdded == ExpectedVertices && NumTrianglesAdded == ExpectedTriangles,
+		TEXT("FRTPlanMeshWriter: expected %d vertices / %d triangles, wrote %d / %d"),
+		ExpectedVertices, ExpectedTriangles, NumVerticesAdded, NumTrianglesAdded);
+}
+
+int32 FRTPlanMeshWriter::AddTriangle(const FIndex3i& Vertices, const FIndex3i& UVElements, const FIndex3i& NormalElements, int32 GroupID)
+{
+	const int32 TriangleID = Mesh.AppendTriangle(Vertices, GroupID);
+	if (TriangleID < 0)
+	{
+		return TriangleID;
+	}
+
+	UVs->SetTriangle(TriangleID, UVElements);
+	Normals->SetTriangle(TriangleID, NormalElements);
+	++NumTrianglesAdded;
+	return TriangleID;
+}
+
+void FRTPlanMeshWriter::AddQuad(const FIndex4i& Vertices, const FIndex4i& UVElements, const FIndex4i& NormalElements, int32 GroupID)
+{
+	AddTriangle(FIndex3i(Vertices.A, Vertices.B, Vertices.D), FIndex3i(UVElements.A, UVElements.B, UVElements.D), FIndex3i(NormalElements.A, NormalElements.B, NormalElements.D), GroupID);
+	AddTriangle(FIndex3i(Vertices.B, Vertices.C, Vertices.D), FIndex3i(UVElements.B, UVElements.C, UVElements.D), FIndex3i(NormalElements.B, NormalElements.C, NormalElements.D), GroupID);
+}
@@ -0,0 +1,173 @@
+﻿#include "RTPlanWallMeshCache.h"
+#include "DynamicMesh/DynamicMeshAttributeSet.h"
+#include "Async/ParallelFor.h"
+
+using UE::Geometry::FDynamicMesh3;
+
+namespace RTPlanWallMeshCachePrivate
+{
+	// Move a mesh built at From so it sits at To (both rigid)
+	void MovePlacement(FDynamicMesh3& Mesh, const FTransform& From, const FTransform& To)
+	{
+		const FTransform Delta = From.Inverse() * To;
+		if (Delta.Equals(FTransform::Identity, UE_KINDA_SMALL_NUMBER))
+		{
+			// Same wall in the same place (undo / redo)
+			return;
+		}
+
+		for (int32 VertexID : Mesh.VertexIndicesItr())
+		{
+			Mesh.SetVertex(VertexID, Delta.TransformPosition(Mesh.GetVertex(VertexID)));
+		}
+		if (Mesh.HasAttributes())
+		{
+			UE::Geometry::FDynamicMeshNormalOverlay* Normals = Mesh.Attributes()->PrimaryNormals();
+			for (int32 ElementID : Normals->ElementIndicesItr())
+			{
+				Normals->SetElement(ElementID, FVector3f(Delta.TransformVectorNoScale(FVector3d(Normals->GetElement(ElementID)))));
+			}
+		}
+	}
+
+	EParallelForFlags GetParallelFlags(int32 Num)
+	{
+		return Num < FRTPlanWallMesher::MinWallsForParallel ? EParallelForFlags::ForceSingleThread : EParallelForFlags::Unbalanced;
+	}
+}
+
+FRTPlanWallMeshCache::FRTPlanWallMeshCache(int32 InMaxEntries)
+	: MaxEntries(FMath::Max(InMaxEntries, 1))
+{
+}
+
+void FRTPlanWallMeshCache::BuildWallMeshes(TConstArrayView<FRTPlanWallMeshInput> Inputs, TArray<FDynamicMesh3>& OutMeshes, TArray<bool>& OutBuilt)
+{
+	using namespace RTPlanWallMeshCachePrivate;
+
+	const int32 NumInputs = Inputs.Num();
+	OutMeshes.SetNum(NumInputs);
+	OutBuilt.SetNumZeroed(NumInputs);
+
+	TArray<FRTPlanWallMeshKey> Keys;
+	TArray<FTransform> Placements;
+	TArray<bool> Keyed;
+	Keys.SetNum(NumInputs);
+	Placements.SetNum(NumInputs);
+	Keyed.SetNumZeroed(NumInputs);
+	ParallelFor(NumInputs, [&Inputs, &Keys, &Placements, &Keyed](int32 Index)
+	{
+		Keyed[Index] = FRTPlanWallMesher::ComputeShapeKey(Inputs[Index], Keys[Index], Placements[Index]);
+	}, GetParallelFlags(NumInputs));
+
+	// Where each mesh comes from: a cache entry, the first wall in this batch with the same new shape, or a fresh build
+	++BatchCounter;
+	TArray<const FEntry*> FromCache;
+	TArray<int32> FromBatch;
+	TArray<int32> ToBuild;
+	TMap<FRTPlanWallMeshKey, int32> NewShapes;
+	FromCache.SetNumZeroed(NumInputs);
+	FromBatch.Init(INDEX_NONE, NumInputs);
+
+	for (int32 Index = 0; Index < NumInputs; ++Index)
+	{
+		if (!Keyed[Index])
+		{
+			continue;
+		}
+
+		if (FEntry* Entry = Entries.Find(Keys[Index]))
+		{
+			Entry->LastUsed = BatchCounter;
+			FromCache[Index] = Entry;
+			++NumHits;
+		}
+		else if (const int32* First = NewShapes.Find(Keys[Index]))
+		{
+			FromBatch[Index] = *First;
+			++NumHits;
+		}
+		else
+		{
+			NewShapes.Add(Keys[Index], Index);
+			ToBuild.Add(Index);
+			++NumMisses;
+		}
+	}
+
+	ParallelFor(ToBuild.Num(), [&Inputs, &ToBuild, &OutMeshes, &OutBuilt](int32 BuildIndex)
+	{
+		const int32 Index = ToBuild[BuildIndex];
+		OutBuilt[Index] = FRTPlanWallMesher::BuildWallMesh(Inputs[Index], OutMeshes[Index]);
+	}, GetParallelFlags(ToBuild.Num()));
+
+	// Copies only read the cache and the freshly built meshes, and each writes its own slot
+	ParallelFor(NumInputs, [&FromCache, &FromBatch, &Placements, &OutMeshes, &OutBuilt](int32 Index)
+	{
+		if (const FEntry* Entry = FromCache[Index])
+		{
+			OutMeshes[Index] = Entry->Mesh;
+			MovePlacement(OutMeshes[Index], Entry->Placement, Placements[Index]);
+			OutBuilt[Index] = true;
+		}
+		else if (FromBatch[Index] != INDEX_NONE && OutBuilt[FromBatch[Index]])
+		{
+			const int32 Source = FromBatch[Index];
+			OutMeshes[Index] = OutMeshes[Source];
+			MovePlacement(OutMeshes[Index], Placements[Source], Placements[Index]);
+			OutBuilt[Index] = true;
+		}
+	}, GetParallelFlags(NumInputs));
+
+	for (const int32 Index : ToBuild)
+	{
+		if (OutBuilt[Index])
+		{
+			FEntry& Entry = Entries.Add(MoveTemp(Keys[Index]));
+			Entry.Mesh = OutMeshes[Index];
+			Entry.Placement = Placements[Index];
+			Entry.LastUsed = BatchCounter;
+		}
+	}
+
+	Trim();
+}
+
+void FRTPlanWallMeshCache::Empty()
+{
+	Entries.Empty();
+}
+
+void FRTPlanWallMeshCache::SetMaxEntries(int32 InMaxEntries)
+{
+	MaxEntries = FMath::Max(InMaxEntries, 1);
+	Trim();
+}
+
+void FRTPlanWallMeshCache::Trim()
+{
+	if (Entries.Num() <= MaxEntries)
+	{
+		return;
+	}
+
+	TArray<TPair<uint64, const FRTPlanWallMeshKey*>> ByAge;
+	ByAge.Reserve(Entries.Num());
+	for (const auto& Pair : Entries)
+	{
+		ByAge.Emplace(Pair.Value.LastUsed, &Pair.Key);
+	}
+	ByAge.Sort([](const TPair<uint64, const FRTPlanWallMeshKey*>& A, const TPair<uint64, const FRTPlanWallMeshKey*>& B) { return A.Key < B.Key; });
+
+	const int32 NumToRemove = Entries.Num() - FMath::Max(MaxEntries * 3 / 4, 1);
+	TArray<FRTPlanWallMeshKey> Evicted;
+	Evicted.Reserve(NumToRemove);
+	for (int32 Index = 0; Index < NumToRemove; ++Index)
+	{
+		Evicted.Add(*ByAge[Index].Value);
+	}
+	for (const FRTPlanWallMeshKey& Key : Evicted)
+	{
+		Entries.Remove(Key);
+	}
+}
@@ -0,0 +1,294 @@
+﻿#include "RTPlanWallMesher.h"
+#include "RTPlanMeshBuilder.h"
+#include "RTPlanOpeningUtils.h"
+#include "Async/ParallelFor.h"
+#include "Hash/CityHash.h"
+
+using UE::Geometry::FDynamicMesh3;
+
+namespace RTPlanWallMesherPrivate
+{
+	bool IsArcWall(const FRTWall& Wall)
+	{
+		return Wall.bIsArc && FMath::Abs(Wall.ArcSweepAngle) > 0.1f;
+	}
+
+	// Key resolution: 0.01mm for lengths, 1e-4 degree for angles
+	int64 QuantizeLength(double Cm)
+	{
+		return FMath::RoundToInt64(Cm * 1000.0);
+	}
+
+	int64 QuantizeAngle(double Degrees)
+	{
+		return FMath::RoundToInt64(Degrees * 10000.0);
+	}
+
+}
+
+void FRTPlanWallMesher::SolveEnds(FRTPlanWallMeshInput& Input, TConstArrayView<FGuid> WallsAtA, TConstArrayView<FGuid> WallsAtB, FResolveWall ResolveWall)
+{
+	FRTPlanJunctionSolver::SolveEnds(Input.Wall, Input.A, Input.B, WallsAtA, WallsAtB, ResolveWall, Input.Start, Input.End);
+}
+
+void FRTPlanWallMesher::GatherInputs(const FRTPlanSnapshot& Snapshot, TConstArrayView<FGuid> WallIds, TArray<FRTPlanWallMeshInput>& OutInputs)
+{
+	OutInputs.Reserve(OutInputs.Num() + WallIds.Num());
+
+	// Wall -> index in OutInputs, so openings can be bucketed in one pass over the snapshot
+	TMap<FGuid, int32> InputIndices;
+	InputIndices.Reserve(WallIds.Num());
+
+	for (const FGuid& WallId : WallIds)
+	{
+		const FRTWall* Wall = Snapshot.FindWall(WallId);
+		if (!Wall)
+		{
+			continue;
+		}
+
+		const FRTVertex* VertexA = Snapshot.FindVertex(Wall->VertexAId);
+		const FRTVertex* VertexB = Snapshot.FindVertex(Wall->VertexBId);
+		if (!VertexA || !VertexB)
+		{
+			continue;
+		}
+
+		FRTPlanWallMeshInput& Input = OutInputs.AddDefaulted_GetRef();
+		Input.Wall = *Wall;
+		Input.A = VertexA->Position;
+		Input.B = VertexB->Position;
+		InputIndices.Add(WallId, OutInputs.Num() - 1);
+	}
+
+	if (InputIndices.Num() == 0)
+	{
+		return;
+	}
+
+	for (const auto& Pair : Snapshot.Openings)
+	{
+		const FRTOpening& Opening = Pair.Value.Get();
+		if (const int32* InputIndex = InputIndices.Find(Opening.WallId))
+		{
+			OutInputs[*InputIndex].Openings.Add(Opening);
+		}
+	}
+
+	// Walls at the endpoints of the gathered walls, again in one pass over the snapshot
+	TMap<FGuid, TArray<FGuid, TInlineAllocator<4>>> WallsAtVertex;
+	WallsAtVertex.Reserve(InputIndices.Num() * 2);
+	for (const auto& Pair : InputIndices)
+	{
+		const FRTWall& Wall = OutInputs[Pair.Value].Wall;
+		WallsAtVertex.FindOrAdd(Wall.VertexAId);
+		WallsAtVertex.FindOrAdd(Wall.VertexBId);
+	}
+	for (const auto& Pair : Snapshot.Walls)
+	{
+		const FRTWall& Wall = Pair.Value.Get();
+		if (auto* AtA = WallsAtVertex.Find(Wall.VertexAId))
+		{
+			AtA->Add(Wall.Id);
+		}
+		if (Wall.VertexBId != Wall.VertexAId)
+		{
+			if (auto* AtB = WallsAtVertex.Find(Wall.VertexBId))
+			{
+				AtB->Add(Wall.Id);
+			}
+		}
+	}
+
+	auto ResolveWall = [&Snapshot](const FGuid& WallId, FVector2D& OutA, FVector2D& OutB) -> const FRTWall*
+	{
+		const FRTWall* Wall = Snapshot.FindWall(WallId);
+		const FRTVertex* VertexA = Wall ? Snapshot.FindVertex(Wall->VertexAId) : nullptr;
+		const FRTVertex* VertexB = Wall ? Snapshot.FindVertex(Wall->VertexBId) : nullptr;
+		if (!VertexA || !VertexB)
+		{
+			return nullptr;
+		}
+		OutA = VertexA->Position;
+		OutB = VertexB->Position;
+		return Wall;
+	};
+	for (const auto& Pair : InputIndices)
+	{
+		FRTPlanWallMeshInput& Input = OutInputs[Pair.Value];
+		SolveEnds(Input, WallsAtVertex.FindChecked(Input.Wall.VertexAId), WallsAtVertex.FindChecked(Input.Wall.VertexBId), ResolveWall);
+	}
+}
+
+bool FRTPlanWallMesher::BuildWallMesh(const FRTPlanWallMeshInput& Input, FDynamicMesh3& OutMesh)
+{
+	OutMesh.Clear();
+
+	const FRTWall& Wall = Input.Wall;
+	const FVector2D& A = Input.A;
+	const FVector2D& B = Input.B;
+
+	float Length = FVector2D::Distance(A, B);
+	if (Length < 1.0f) return false;
+
+	OutMesh.EnableAttributes();
+
+	// Handle curved walls (arcs)
+	if (RTPlanWallMesherPrivate::IsArcWall(Wall))
+	{
+		// Use wall's segment count if specified, otherwise use default
+		int32 NumSegments = (Wall.ArcNumSegments > 0) ? Wall.ArcNumSegments : DefaultArcSegments;
+
+		FRTPlanMeshBuilder::AppendCurvedWallMesh(
+			OutMesh,
+			A,  // Start point
+			B,  // End point
+			Wall.ArcCenter,
+			Wall.ArcSweepAngle,
+			Wall.ThicknessCm,
+			Wall.HeightCm,
+			Wall.BaseZCm,
+			NumSegments,
+			Wall.bHasLeftSkirting ? Wall.LeftSkirtingHeightCm : 0.0f,
+			Wall.bHasLeftSkirting ? Wall.LeftSkirtingThicknessCm : 0.0f,
+			Wall.bHasRightSkirting ? Wall.RightSkirtingHeightCm : 0.0f,
+			Wall.bHasRightSkirting ? Wall.RightSkirtingThicknessCm : 0.0f,
+			Wall.bHasCapSkirting ? Wall.CapSkirtingHeightCm : 0.0f,
+			Wall.bHasCapSkirting ? Wall.CapSkirtingThicknessCm : 0.0f,
+			0, 1, 2, 3, 4, 5,  // Material IDs: Left, Right, Caps, SkirtLeft, SkirtRight, SkirtCap
+			Input.Start,
+			Input.End
+		);
+		return true;
+	}
+
+	// Calculate Transform Base for straight wall
+	FVector2D Dir = (B - A).GetSafeNormal();
+	float Angle = FMath::Atan2(Dir.Y, Dir.X);
+	FQuat WallRotation(FVector::UpVector, Angle);
+
+	// Solid stretches between openings (the whole wall if there are none), in original wall distance
+	TArray<FRTPlanOpeningUtils::FInterval> Solids;
+	if (Input.Openings.Num() > 0)
+	{
+		Solids = FRTPlanOpeningUtils::ComputeSolidIntervals(Length, Input.Openings);
+	}
+	else
+	{
+		Solids.Add({ 0.0f, Length });
+	}
+
+	for (int32 i = 0; i < Solids.Num(); ++i)
+	{
+		const auto& Solid = Solids[i];
+		float SegStart = Solid.Start;
+		float SegEnd = Solid.End;
+
+		// Only stretches reaching the wall's endpoints take the junction cuts; jambs stay capped
+		const FRTPlanWallEnd SegStartEnd = FMath::IsNearlyZero(SegStart, 0.01f) ? Input.Start : FRTPlanWallEnd();
+		const FRTPlanWallEnd SegEndEnd = FMath::IsNearlyEqual(SegEnd, Length, 0.01f) ? Input.End : FRTPlanWallEnd();
+
+		float SegLength = SegEnd - SegStart;
+		if (SegLength < 0.1f) continue;
+
+		FVector2D SegStartPos2D = A + Dir * SegStart;
+
+		FTransform SegTransform;
+		SegTransform.SetLocation(FVector(SegStartPos2D.X, SegStartPos2D.Y, 0)); // Z is handled by BaseZ param
+		SegTransform.SetRotation(WallRotation);
+
+		FRTPlanMeshBuilder::AppendWallMesh(
+			OutMesh,
+			SegTransform,
+			SegLength,
+			Wall.ThicknessCm,
+			Wall.HeightCm,
+			Wall.BaseZCm,
+			Wall.bHasLeftSkirting ? Wall.LeftSkirtingHeightCm : 0.0f,
+			Wall.bHasLeftSkirting ? Wall.LeftSkirtingThicknessCm : 0.0f,
+			Wall.bHasRightSkirting ? Wall.RightSkirtingHeightCm : 0.0f,
+			Wall.bHasRightSkirting ? Wall.RightSkirtingThicknessCm : 0.0f,
+			Wall.bHasCapSkirting ? Wall.CapSkirtingHeightCm : 0.0f,
+			Wall.bHasCapSkirting ? Wall.CapSkirtingThicknessCm : 0.0f,
+			0, 1, 2, 3, 4, 5,
+			SegStartEnd,
+			SegEndEnd
+		);
+	}
+
+	return true;
+}
+
+bool FRTPlanWallMesher::ComputeShapeKey(const FRTPlanWallMeshInput& Input, FRTPlanWallMeshKey& OutKey, FTransform& OutPlacement)
+{
+	using namespace RTPlanWallMesherPrivate;
+
+	const FRTWall& Wall = Input.Wall;
+	const float Length = FVector2D::Distance(Input.A, Input.B);
+	if (Length < 1.0f) return false;
+
+	TArray<int64, TInlineAllocator<24>>& Values = OutKey.Values;
+	Values.Reset();
+
+	// Section and skirting, as BuildWallMesh passes them to the builder
+	Values.Add(QuantizeLength(Wall.ThicknessCm));
+	Values.Add(QuantizeLength(Wall.HeightCm));
+	Values.Add(QuantizeLength(Wall.BaseZCm));
+	Values.Add(Wall.bHasLeftSkirting ? QuantizeLength(Wall.LeftSkirtingHeightCm) : 0);
+	Values.Add(Wall.bHasLeftSkirting ? QuantizeLength(Wall.LeftSkirtingThicknessCm) : 0);
+	Values.Add(Wall.bHasRightSkirting ? QuantizeLength(Wall.RightSkirtingHeightCm) : 0);
+	Values.Add(Wall.bHasRightSkirting ? QuantizeLength(Wall.RightSkirtingThicknessCm) : 0);
+	Values.Add(Wall.bHasCapSkirting ? QuantizeLength(Wall.CapSkirtingHeightCm) : 0);
+	Values.Add(Wall.bHasCapSkirting ? QuantizeLength(Wall.CapSkirtingThicknessCm) : 0);
+
+	// End cuts are relative to the wall, so they don't depend on placement either
+	for (const FRTPlanWallEnd* End : { &Input.Start, &Input.End })
+	{
+		Values.Add(End->bCapped ? 1 : 0);
+		Values.Add(QuantizeLength(End->LeftOffset));
+		Values.Add(QuantizeLength(End->RightOffset));
+	}
+
+	if (IsArcWall(Wall))
+	{
+		// Arcs are meshed around their centre, starting at A; openings are not cut into them
+		const FVector2D ToStart = Input.A - Wall.ArcCenter;
+		Values.Add(1);
+		Values.Add(QuantizeLength(ToStart.Size()));
+		Values.Add(QuantizeAngle(Wall.ArcSweepAngle));
+		Values.Add(Wall.ArcNumSegments > 0 ? Wall.ArcNumSegments : DefaultArcSegments);
+
+		OutPlacement = FTransform(FQuat(FVector::UpVector, FMath::Atan2(ToStart.Y, ToStart.X)), FVector(Wall.ArcCenter, 0.0));
+	}
+	else
+	{
+		Values.Add(0);
+		Values.Add(QuantizeLength(Length));
+		if (Input.Openings.Num() > 0)
+		{
+			for (const FRTPlanOpeningUtils::FInterval& Solid : FRTPlanOpeningUtils::ComputeSolidIntervals(Length, Input.Openings))
+			{
+				Values.Add(QuantizeLength(Solid.Start));
+				Values.Add(QuantizeLength(Solid.End));
+			}
+		}
+
+		const FVector2D Dir = (Input.B - Input.A).GetSafeNormal();
+		OutPlacement = FTransform(FQuat(FVector::UpVector, FMath::Atan2(Dir.Y, Dir.X)), FVector(Input.A, 0.0));
+	}
+
+	OutKey.Hash = CityHash64(reinterpret_cast<const char*>(Values.GetData()), Values.Num() * sizeof(int64));
+	return true;
+}
+
+void FRTPlanWallMesher::BuildWallMeshes(TConstArrayView<FRTPlanWallMeshInput> Inputs, TArray<FDynamicMesh3>& OutMeshes, TArray<bool>& OutBuilt)
+{
+	OutMeshes.SetNum(Inputs.Num());
+	OutBuilt.SetNumZeroed(Inputs.Num());
+
+	// Each wall writes only its own slot, so no synchronization is needed
+	ParallelFor(Inputs.Num(), [&Inputs, &OutMeshes, &OutBuilt](int32 Index)
+	{
+		OutBuilt[Index] = BuildWallMesh(Inputs[Index], OutMeshes[Index]);
+	}, Inputs.Num() < MinWallsForParallel ? EParallelForFlags::ForceSingleThread : EParallelForFlags::Unbalanced);
+}
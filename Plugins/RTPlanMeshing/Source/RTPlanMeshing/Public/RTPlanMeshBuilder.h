@@ -4,6 +4,7 @@
 #include "GeometryScript/GeometryScriptTypes.h"
 #include "UDynamicMesh.h" 
 #include "RTPlanSchema.h"
+#include "RTPlanJunctionSolver.h"
 
 class UDynamicMesh;
 
@@ -33,7 +34,33 @@ public:
 		int32 MaterialID_Caps,
 		int32 MaterialID_Skirting_Left,
 		int32 MaterialID_Skirting_Right,
-		int32 MaterialID_Skirting_Cap
+		int32 MaterialID_Skirting_Cap,
+		const FRTPlanWallEnd& StartEnd = FRTPlanWallEnd(),
+		const FRTPlanWallEnd& EndEnd = FRTPlanWallEnd()
+	);
+
+	// Same, appending to a standalone mesh. Touches no UObjects, so it can run on any thread.
+	static void AppendWallMesh(
+		UE::Geometry::FDynamicMesh3& Mesh,
+		const FTransform& Transform,
+		float Length,
+		float Thickness,
+		float Height,
+		float BaseZ,
+		float SkirtingHeight_Left,
+		float SkirtingThickness_Left,
+		float SkirtingHeight_Right,
+		float SkirtingThickness_Right,
+		float SkirtingHeight_Cap,
+		float SkirtingThickness_Cap,
+		int32 MaterialID_Left,
+		int32 MaterialID_Right,
+		int32 MaterialID_Caps,
+		int32 MaterialID_Skirting_Left,
+		int32 MaterialID_Skirting_Right,
+		int32 MaterialID_Skirting_Cap,
+		const FRTPlanWallEnd& StartEnd = FRTPlanWallEnd(),
+		const FRTPlanWallEnd& EndEnd = FRTPlanWallEnd()
 	);
 
 	// Generate a curved wall mesh (arc wall) with skirting
@@ -58,7 +85,36 @@ public:
 		int32 MaterialID_Caps,
 		int32 MaterialID_Skirting_Left,
 		int32 MaterialID_Skirting_Right,
-		int32 MaterialID_Skirting_Cap
+		int32 MaterialID_Skirting_Cap,
+		const FRTPlanWallEnd& StartEnd = FRTPlanWallEnd(),
+		const FRTPlanWallEnd& EndEnd = FRTPlanWallEnd()
+	);
+
+	// Same, appending to a standalone mesh (any thread)
+	static void AppendCurvedWallMesh(
+		UE::Geometry::FDynamicMesh3& Mesh,
+		const FVector2D& StartPoint,
+		const FVector2D& EndPoint,
+		const FVector2D& ArcCenter,
+		float SweepAngleDeg,
+		float Thickness,
+		float Height,
+		float BaseZ,
+		int32 NumSegments,
+		float SkirtingHeight_Left,
+		float SkirtingThickness_Left,
+		float SkirtingHeight_Right,
+		float SkirtingThickness_Right,
+		float SkirtingHeight_Cap,
+		float SkirtingThickness_Cap,
+		int32 MaterialID_Left,
+		int32 MaterialID_Right,
+		int32 MaterialID_Caps,
+		int32 MaterialID_Skirting_Left,
+		int32 MaterialID_Skirting_Right,
+		int32 MaterialID_Skirting_Cap,
+		const FRTPlanWallEnd& StartEnd = FRTPlanWallEnd(),
+		const FRTPlanWallEnd& EndEnd = FRTPlanWallEnd()
 	);
 
 	// Generate a floor mesh from a polygon loop
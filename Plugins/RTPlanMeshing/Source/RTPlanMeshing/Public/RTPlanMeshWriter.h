@@ -0,0 +1,45 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "DynamicMesh/DynamicMesh3.h"
+#include "DynamicMesh/DynamicMeshAttributeSet.h"
+#include "IndexTypes.h"
+
+/**
+ * RTPlanMeshWriter.h
+ * Low-level appender used by the wall builders.
+ * Vertices are appended once, already in their final position, and shared by every face that touches them.
+ * Hard edges are expressed through the overlays (each face gets its own normal / UV elements) rather than
+ * by duplicating vertices, so a closed wall stays one welded shell.
+ */
+class RTPLANMESHING_API FRTPlanMeshWriter
+{
+public:
+	// Enables attributes on Mesh if needed. The expected counts are what the caller computed up front;
+	// the writer checks on destruction that exactly that much geometry was appended.
+	FRTPlanMeshWriter(UE::Geometry::FDynamicMesh3& InMesh, int32 InExpectedVertices, int32 InExpectedTriangles);
+	~FRTPlanMeshWriter();
+
+	int32 AddVertex(const FVector3d& Position) { ++NumVerticesAdded; return Mesh.AppendVertex(Position); }
+	int32 AddNormal(const FVector3f& Normal) { return Normals->AppendElement(Normal); }
+	int32 AddUV(const FVector2f& UV) { return UVs->AppendElement(UV); }
+
+	// Triangle over three vertices with one UV / normal element per corner
+	int32 AddTriangle(const UE::Geometry::FIndex3i& Vertices, const UE::Geometry::FIndex3i& UVElements, const UE::Geometry::FIndex3i& NormalElements, int32 GroupID);
+
+	// Quad split along V1-V3 (V0, V1, V3) + (V1, V2, V3)
+	void AddQuad(const UE::Geometry::FIndex4i& Vertices, const UE::Geometry::FIndex4i& UVElements, const UE::Geometry::FIndex4i& NormalElements, int32 GroupID);
+
+	int32 GetNumVerticesAdded() const { return NumVerticesAdded; }
+	int32 GetNumTrianglesAdded() const { return NumTrianglesAdded; }
+
+private:
+	UE::Geometry::FDynamicMesh3& Mesh;
+	UE::Geometry::FDynamicMeshUVOverlay* UVs = nullptr;
+	UE::Geometry::FDynamicMeshNormalOverlay* Normals = nullptr;
+
+	int32 ExpectedVertices = 0;
+	int32 ExpectedTriangles = 0;
+	int32 NumVerticesAdded = 0;
+	int32 NumTrianglesAdded = 0;
+};
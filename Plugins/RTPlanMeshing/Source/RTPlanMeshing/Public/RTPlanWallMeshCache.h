@@ -0,0 +1,54 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "RTPlanWallMesher.h"
+#include "DynamicMesh/DynamicMesh3.h"
+
+/**
+ * RTPlanWallMeshCache.h
+ * Reuses wall meshes between walls of the same shape.
+ * Walls that are equal up to a rigid placement (same FRTPlanWallMeshKey) share one cached FDynamicMesh3; a hit copies
+ * it and moves it into place instead of meshing the wall again, so repeated layouts and undo / redo are mostly hits.
+ * Entries that go unused are evicted once the cache grows past MaxEntries.
+ * Not thread-safe: call from one thread at a time (the work itself is spread over the task graph).
+ */
+class RTPLANMESHING_API FRTPlanWallMeshCache
+{
+public:
+	explicit FRTPlanWallMeshCache(int32 InMaxEntries = 512);
+
+	// Same contract as FRTPlanWallMesher::BuildWallMeshes. Shapes seen before are copied, new ones are meshed and remembered.
+	void BuildWallMeshes(TConstArrayView<FRTPlanWallMeshInput> Inputs, TArray<UE::Geometry::FDynamicMesh3>& OutMeshes, TArray<bool>& OutBuilt);
+
+	void Empty();
+	int32 Num() const { return Entries.Num(); }
+
+	void SetMaxEntries(int32 InMaxEntries);
+	int32 GetMaxEntries() const { return MaxEntries; }
+
+	// Walls served by a copy (from the cache, or from a wall of the same new shape in the same batch) / meshed from scratch
+	int64 GetNumHits() const { return NumHits; }
+	int64 GetNumMisses() const { return NumMisses; }
+	void ResetStats() { NumHits = 0; NumMisses = 0; }
+
+private:
+	struct FEntry
+	{
+		UE::Geometry::FDynamicMesh3 Mesh;
+
+		// Placement the mesh was built at (see FRTPlanWallMesher::ComputeShapeKey)
+		FTransform Placement;
+
+		// Batch that last used this entry
+		uint64 LastUsed = 0;
+	};
+
+	// Evict least recently used entries once over budget (down to 3/4 of it, so trimming doesn't run every batch)
+	void Trim();
+
+	TMap<FRTPlanWallMeshKey, FEntry> Entries;
+	int32 MaxEntries = 512;
+	uint64 BatchCounter = 0;
+	int64 NumHits = 0;
+	int64 NumMisses = 0;
+};
@@ -0,0 +1,71 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "RTPlanSchema.h"
+#include "RTPlanSnapshot.h"
+#include "RTPlanMeshBuilder.h"
+#include "DynamicMesh/DynamicMesh3.h"
+
+/**
+ * RTPlanWallMesher.h
+ * Builds the shell mesh of individual walls into standalone FDynamicMesh3 buffers.
+ * Inputs are plain copies (resolved from a plan snapshot or the document's dense store), so meshes
+ * are generated on worker threads and only the commit to components has to happen on the game thread.
+ */
+
+// Everything one wall's mesh depends on
+struct FRTPlanWallMeshInput
+{
+	FRTWall Wall;
+	FVector2D A = FVector2D::ZeroVector;
+	FVector2D B = FVector2D::ZeroVector;
+
+	// Openings hosted by the wall
+	TArray<FRTOpening> Openings;
+
+	// Cuts against the walls meeting at A and B (see FRTPlanJunctionSolver); free ends by default
+	FRTPlanWallEnd Start;
+	FRTPlanWallEnd End;
+};
+
+// Everything that decides a wall's shape but not where it stands, quantized so that walls equal up to
+// floating-point noise share a key (see FRTPlanWallMeshCache)
+struct FRTPlanWallMeshKey
+{
+	TArray<int64, TInlineAllocator<24>> Values;
+	uint64 Hash = 0;
+
+	bool operator==(const FRTPlanWallMeshKey& Other) const { return Hash == Other.Hash && Values == Other.Values; }
+	friend uint32 GetTypeHash(const FRTPlanWallMeshKey& Key) { return GetTypeHash(Key.Hash); }
+};
+
+class RTPLANMESHING_API FRTPlanWallMesher
+{
+public:
+	// Resolve inputs for WallIds from a snapshot (any thread). Walls that no longer exist or miss an endpoint are skipped.
+	static void GatherInputs(const FRTPlanSnapshot& Snapshot, TConstArrayView<FGuid> WallIds, TArray<FRTPlanWallMeshInput>& OutInputs);
+
+	using FResolveWall = FRTPlanJunctionSolver::FResolveWall;
+
+	// Cut Input's ends against the walls meeting at its endpoints (Input.Wall included or not), see FRTPlanJunctionSolver::SolveEnds
+	static void SolveEnds(FRTPlanWallMeshInput& Input, TConstArrayView<FGuid> WallsAtA, TConstArrayView<FGuid> WallsAtB, FResolveWall ResolveWall);
+
+	// Mesh one wall into OutMesh (cleared first). Returns false if the wall is too short to mesh.
+	static bool BuildWallMesh(const FRTPlanWallMeshInput& Input, UE::Geometry::FDynamicMesh3& OutMesh);
+
+	/**
+	 * Shape key of a wall (length, section, skirting, solid intervals between openings, arc parameters, end cuts) and the
+	 * rigid placement of its mesh: two walls with equal keys have meshes that differ only by PlacementB * PlacementA^-1.
+	 * Returns false for walls BuildWallMesh would not mesh.
+	 */
+	static bool ComputeShapeKey(const FRTPlanWallMeshInput& Input, FRTPlanWallMeshKey& OutKey, FTransform& OutPlacement);
+
+	// BuildWallMesh for every input, spread over the task graph. OutMeshes / OutBuilt match Inputs by index.
+	static void BuildWallMeshes(TConstArrayView<FRTPlanWallMeshInput> Inputs, TArray<UE::Geometry::FDynamicMesh3>& OutMeshes, TArray<bool>& OutBuilt);
+
+	// Below this many walls BuildWallMeshes stays on the calling thread (task overhead outweighs the work)
+	static constexpr int32 MinWallsForParallel = 8;
+
+	// Arc segments used when a wall doesn't specify ArcNumSegments
+	static constexpr int32 DefaultArcSegments = 32;
+};
@@ -15,7 +15,9 @@ public class RTPlanMeshing : ModuleRules
 				"GeometryCore",
 				"GeometryFramework",
 				"GeometryScriptingCore",
-				"RTPlanCore"
+				"RTPlanCore",
+				"RTPlanMath",
+				"RTPlanOpenings"
 			}
 		);
 
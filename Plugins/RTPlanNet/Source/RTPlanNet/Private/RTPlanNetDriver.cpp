@@ -35,13 +35,19 @@ void ARTPlanNetDriver::SetDocument(URTPlanDocument* InDoc)
 		// Initial Sync (Server -> Client)
 		if (HasAuthority())
 		{
-			OnPlanChanged();
+			OnPlanChanged(FRTPlanDelta::MakeFullRebuild());
 		}
 	}
 }
 
-void ARTPlanNetDriver::OnPlanChanged()
+void ARTPlanNetDriver::OnPlanChanged(const FRTPlanDelta& Delta)
 {
+	// Live gesture steps are not replicated: the gesture ends with a regular broadcast of its net change
+	if (Delta.bInteractive)
+	{
+		return;
+	}
+
 	if (HasAuthority() && Document)
 	{
 		// Serialize and update replicated property
@@ -46,7 +46,7 @@ protected:
 	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 
 	UFUNCTION()
-	void OnPlanChanged();
+	void OnPlanChanged(const FRTPlanDelta& Delta);
 
 	UPROPERTY(Transient)
 	TObjectPtr<URTPlanDocument> Document;
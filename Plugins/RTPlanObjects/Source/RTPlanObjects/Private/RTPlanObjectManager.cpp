@@ -34,9 +34,37 @@ void ARTPlanObjectManager::SetCatalog(URTProductCatalog* InCatalog)
 	RebuildAll();
 }
 
-void ARTPlanObjectManager::OnPlanChanged()
+void ARTPlanObjectManager::OnPlanChanged(const FRTPlanDelta& Delta)
 {
-	RebuildAll();
+	if (Delta.bFullRebuild)
+	{
+		RebuildAll();
+		return;
+	}
+
+	if (Delta.Objects.IsEmpty() || !Document || !Catalog) return;
+
+	// Only touch the objects that actually changed
+	for (const FGuid& Id : Delta.Objects.Removed)
+	{
+		RemoveObjectActor(Id);
+	}
+
+	const FRTPlanData& Data = Document->GetData();
+	for (const FGuid& Id : Delta.Objects.Added)
+	{
+		if (const FRTInteriorInstance* Instance = Data.Objects.Find(Id))
+		{
+			SyncObject(*Instance);
+		}
+	}
+	for (const FGuid& Id : Delta.Objects.Modified)
+	{
+		if (const FRTInteriorInstance* Instance = Data.Objects.Find(Id))
+		{
+			SyncObject(*Instance);
+		}
+	}
 }
 
 void ARTPlanObjectManager::RebuildAll()
@@ -59,47 +87,58 @@ void ARTPlanObjectManager::RebuildAll()
 
 	for (const FGuid& Id : ToRemove)
 	{
-		if (AActor* Actor = SpawnedObjects[Id])
-		{
-			Actor->Destroy();
-		}
-		SpawnedObjects.Remove(Id);
+		RemoveObjectActor(Id);
 	}
 
 	// 2. Create or Update objects
 	for (const auto& Pair : Data.Objects)
 	{
-		const FRTInteriorInstance& Instance = Pair.Value;
-		
-		AActor* ExistingActor = SpawnedObjects.FindRef(Instance.Id);
-		
-		if (ExistingActor)
-		{
-			// Update Transform
-			ExistingActor->SetActorTransform(Instance.Transform);
-		}
-		else
+		SyncObject(Pair.Value);
+	}
+}
+
+void ARTPlanObjectManager::RemoveObjectActor(const FGuid& Id)
+{
+	TObjectPtr<AActor> Actor;
+	if (SpawnedObjects.RemoveAndCopyValue(Id, Actor) && Actor)
+	{
+		Actor->Destroy();
+	}
+}
+
+void ARTPlanObjectManager::SyncObject(const FRTInteriorInstance& Instance)
+{
+	UWorld* World = GetWorld();
+	if (!World || !Catalog) return;
+
+	AActor* ExistingActor = SpawnedObjects.FindRef(Instance.Id);
+	
+	if (ExistingActor)
+	{
+		// Update Transform
+		ExistingActor->SetActorTransform(Instance.Transform);
+	}
+	else
+	{
+		// Spawn New
+		const FRTProductDefinition* Product = Catalog->FindProduct(Instance.ProductTypeId);
+		if (Product)
 		{
-			// Spawn New
-			const FRTProductDefinition* Product = Catalog->FindProduct(Instance.ProductTypeId);
-			if (Product)
+			// For V1, we just spawn a StaticMeshActor.
+			// In a real app, we might use a custom BP class or HISM.
+			AStaticMeshActor* NewActor = World->SpawnActor<AStaticMeshActor>(AStaticMeshActor::StaticClass(), Instance.Transform);
+			
+			if (NewActor)
 			{
-				// For V1, we just spawn a StaticMeshActor.
-				// In a real app, we might use a custom BP class or HISM.
-				AStaticMeshActor* NewActor = World->SpawnActor<AStaticMeshActor>(AStaticMeshActor::StaticClass(), Instance.Transform);
+				NewActor->SetMobility(EComponentMobility::Movable);
 				
-				if (NewActor)
+				// Load Mesh (Synchronous for V1 prototype, Async recommended for prod)
+				if (UStaticMesh* Mesh = Product->Mesh.LoadSynchronous())
 				{
-					NewActor->SetMobility(EComponentMobility::Movable);
-					
-					// Load Mesh (Synchronous for V1 prototype, Async recommended for prod)
-					if (UStaticMesh* Mesh = Product->Mesh.LoadSynchronous())
-					{
-						NewActor->GetStaticMeshComponent()->SetStaticMesh(Mesh);
-					}
-
-					SpawnedObjects.Add(Instance.Id, NewActor);
+					NewActor->GetStaticMeshComponent()->SetStaticMesh(Mesh);
 				}
+
+				SpawnedObjects.Add(Instance.Id, NewActor);
 			}
 		}
 	}
@@ -30,7 +30,13 @@ protected:
 	virtual void BeginPlay() override;
 
 	UFUNCTION()
-	void OnPlanChanged();
+	void OnPlanChanged(const FRTPlanDelta& Delta);
+
+	// Spawn the actor for an instance, or update its transform if it already exists
+	void SyncObject(const FRTInteriorInstance& Instance);
+
+	// Destroy the actor spawned for an instance (if any)
+	void RemoveObjectActor(const FGuid& Id);
 
 	UPROPERTY(Transient)
 	TObjectPtr<URTPlanDocument> Document;
@@ -24,112 +24,163 @@ void ARTPlanRunManager::SetDocument(URTPlanDocument* InDoc)
 	if (Document)
 	{
 		Document->OnPlanChanged.AddDynamic(this, &ARTPlanRunManager::OnPlanChanged);
-		// Initial generation? 
-		// Note: Regenerating runs modifies the document. 
-		// We must be careful not to cause infinite loops if we listen to OnPlanChanged.
-		// Strategy: Only regenerate if Run definitions changed, or explicit call.
-		// For V1, let's assume explicit call or careful dirty checking.
+		// Note: Regenerating runs modifies the document.
+		// Initial generation and Run definition edits are left to explicit RegenerateRuns() calls;
+		// OnPlanChanged only follows the host walls.
 	}
 }
 
-void ARTPlanRunManager::OnPlanChanged()
+void ARTPlanRunManager::OnPlanChanged(const FRTPlanDelta& Delta)
 {
-	// Check if any Runs are dirty?
-	// For now, we won't auto-regenerate on every change to avoid loops.
-	// The Tool or UI should call RegenerateRuns() when a Run is edited.
+	if (!Document) return;
+
+	// Live gesture steps are followed by a regular broadcast with the net change.
+	// Full rebuilds (load) already carry their generated objects.
+	if (Delta.bInteractive || Delta.bFullRebuild) return;
+
+	// Host walls that changed, directly or through a moved vertex.
+	// Removed walls are included so their runs drop the objects they generated.
+	TSet<FGuid> Walls;
+	Walls.Append(Delta.Walls.Modified);
+	Walls.Append(Delta.Walls.Removed);
+	for (const FGuid& VertexId : Delta.Vertices.Modified)
+	{
+		for (const FGuid& WallId : Document->GetWallsAtVertex(VertexId))
+		{
+			Walls.Add(WallId);
+		}
+	}
+
+	for (const FGuid& WallId : Walls)
+	{
+		RegenerateHostedRuns(WallId);
+	}
+
+	// The regeneration only changes objects, so the nested notification does not come back here with walls
+	Document->BroadcastPendingChanges();
 }
 
 void ARTPlanRunManager::RegenerateRuns()
 {
 	if (!Document) return;
 
-	FRTPlanData& Data = Document->GetDataMutable(); // Direct access for V1 logic
-	
-	// 1. Clear existing generated objects
-	TArray<FGuid> ToRemove;
-	for (const auto& Pair : Data.Objects)
+	// 1. Clear existing generated objects (every run that owns objects, including deleted runs)
+	TArray<FGuid> OwningRuns;
+	Document->GetReverseIndex().GetRunToObjects().GetKeys(OwningRuns);
+	for (const FGuid& RunId : OwningRuns)
 	{
-		if (Pair.Value.GeneratedByRunId.IsValid())
+		ClearRunObjects(RunId);
+	}
+
+	// 2. Solve and Generate new objects
+	for (const FRTCabinetRun& Run : Document->GetDenseStore().GetRuns())
+	{
+		GenerateRun(Run);
+	}
+
+	// Notify change so ObjectManager can spawn actors
+	Document->BroadcastPendingChanges();
+}
+
+void ARTPlanRunManager::RegenerateRunsOnWall(const FGuid& WallId)
+{
+	if (!Document) return;
+
+	RegenerateHostedRuns(WallId);
+	Document->BroadcastPendingChanges();
+}
+
+void ARTPlanRunManager::RegenerateHostedRuns(const FGuid& WallId)
+{
+	const FRTPlanData& Data = Document->GetData();
+
+	// Copy: regenerating edits the reverse index
+	const TArray<FGuid> RunIds(Document->GetRunsOnWall(WallId));
+	for (const FGuid& RunId : RunIds)
+	{
+		if (const FRTCabinetRun* Run = Data.Runs.Find(RunId))
 		{
-			ToRemove.Add(Pair.Key);
+			ClearRunObjects(RunId);
+			GenerateRun(*Run);
 		}
 	}
-	for (const FGuid& Id : ToRemove)
+}
+
+void ARTPlanRunManager::ClearRunObjects(const FGuid& RunId)
+{
+	const TArray<FGuid> ObjectIds(Document->GetObjectsGeneratedByRun(RunId));
+	for (const FGuid& Id : ObjectIds)
 	{
-		Data.Objects.Remove(Id);
+		Document->RemoveObject(Id);
 	}
+}
 
-	// 2. Solve and Generate new objects
-	for (const auto& Pair : Data.Runs)
+void ARTPlanRunManager::GenerateRun(const FRTCabinetRun& Run)
+{
+	const FRTPlanDenseStore& Store = Document->GetDenseStore();
+
+	// Calculate Length
+	// If Wall hosted, we need wall length.
+	// For V1, let's assume Start/End offsets define the run length directly if WallId is invalid,
+	// or relative to wall if valid.
+	
+	float RunLength = 0.0f;
+	FTransform RunStartTransform = FTransform::Identity;
+
+	// Host wall resolved through its handle, endpoints come from the packed vertex array
+	const FRTPlanDenseWall* HostWall = Store.GetWalls().Find(Run.HostWallId);
+	FVector2D A, B;
+	if (HostWall)
 	{
-		const FRTCabinetRun& Run = Pair.Value;
-		
-		// Calculate Length
-		// If Wall hosted, we need wall length.
-		// For V1, let's assume Start/End offsets define the run length directly if WallId is invalid,
-		// or relative to wall if valid.
-		
-		float RunLength = 0.0f;
-		FTransform RunStartTransform = FTransform::Identity;
-
-		if (Data.Walls.Contains(Run.HostWallId))
+		if (Store.GetWallEndpoints(*HostWall, A, B))
 		{
-			const FRTWall& Wall = Data.Walls[Run.HostWallId];
-			if (Data.Vertices.Contains(Wall.VertexAId) && Data.Vertices.Contains(Wall.VertexBId))
+			FVector2D Dir = (B - A).GetSafeNormal();
+			float WallLen = FVector2D::Distance(A, B);
+			
+			// Clamp offsets
+			float Start = FMath::Max(0.0f, Run.StartOffsetCm);
+			float End = FMath::Min(WallLen, WallLen - Run.EndOffsetCm);
+			
+			if (End > Start)
 			{
-				FVector2D A = Data.Vertices[Wall.VertexAId].Position;
-				FVector2D B = Data.Vertices[Wall.VertexBId].Position;
-				FVector2D Dir = (B - A).GetSafeNormal();
-				float WallLen = FVector2D::Distance(A, B);
+				RunLength = End - Start;
 				
-				// Clamp offsets
-				float Start = FMath::Max(0.0f, Run.StartOffsetCm);
-				float End = FMath::Min(WallLen, WallLen - Run.EndOffsetCm);
+				// Calculate Start Transform (Position + Rotation)
+				FVector2D Pos2D = A + Dir * Start;
+				float Angle = FMath::Atan2(Dir.Y, Dir.X);
 				
-				if (End > Start)
-				{
-					RunLength = End - Start;
-					
-					// Calculate Start Transform (Position + Rotation)
-					FVector2D Pos2D = A + Dir * Start;
-					float Angle = FMath::Atan2(Dir.Y, Dir.X);
-					
-					RunStartTransform.SetLocation(FVector(Pos2D.X, Pos2D.Y, 0)); // Floor Z
-					RunStartTransform.SetRotation(FQuat(FVector::UpVector, Angle));
-				}
+				RunStartTransform.SetLocation(FVector(Pos2D.X, Pos2D.Y, 0)); // Floor Z
+				RunStartTransform.SetRotation(FQuat(FVector::UpVector, Angle));
 			}
 		}
+	}
 
-		if (RunLength > 1.0f)
-		{
-			FRTPlanRunSolver::FRunInput Input;
-			Input.TotalLength = RunLength;
-			Input.Depth = Run.DepthCm;
-			Input.Height = Run.HeightCm;
+	if (RunLength > 1.0f)
+	{
+		FRTPlanRunSolver::FRunInput Input;
+		Input.TotalLength = RunLength;
+		Input.Depth = Run.DepthCm;
+		Input.Height = Run.HeightCm;
 
-			auto Modules = FRTPlanRunSolver::Solve(Input);
+		auto Modules = FRTPlanRunSolver::Solve(Input);
 
-			for (const auto& Mod : Modules)
-			{
-				FRTInteriorInstance NewObj;
-				NewObj.Id = FGuid::NewGuid();
-				NewObj.GeneratedByRunId = Run.Id;
-				NewObj.ProductTypeId = Mod.ProductId;
-				NewObj.HostType = ERTHostType::Floor; // Or Wall?
-				
-				// Calculate Transform relative to Run Start
-				// Offset along X (Run direction)
-				// Center of module? Or Pivot at corner?
-				// Assume Pivot is Bottom-Left-Back
-				FVector LocalPos(Mod.Offset, 0, 0); 
-				
-				NewObj.Transform = FTransform(LocalPos) * RunStartTransform;
-				
-				Data.Objects.Add(NewObj.Id, NewObj);
-			}
+		for (const auto& Mod : Modules)
+		{
+			FRTInteriorInstance NewObj;
+			NewObj.Id = FGuid::NewGuid();
+			NewObj.GeneratedByRunId = Run.Id;
+			NewObj.ProductTypeId = Mod.ProductId;
+			NewObj.HostType = ERTHostType::Floor; // Or Wall?
+			
+			// Calculate Transform relative to Run Start
+			// Offset along X (Run direction)
+			// Center of module? Or Pivot at corner?
+			// Assume Pivot is Bottom-Left-Back
+			FVector LocalPos(Mod.Offset, 0, 0); 
+			
+			NewObj.Transform = FTransform(LocalPos) * RunStartTransform;
+			
+			Document->SetObject(NewObj);
 		}
 	}
-
-	// Notify change so ObjectManager can spawn actors
-	Document->OnPlanChanged.Broadcast();
 }
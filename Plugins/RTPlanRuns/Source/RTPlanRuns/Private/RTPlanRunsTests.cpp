@@ -1,6 +1,9 @@
 ﻿#include "CoreMinimal.h"
 #include "Misc/AutomationTest.h"
 #include "RTPlanRunSolver.h"
+#include "RTPlanRunManager.h"
+#include "RTPlanDocument.h"
+#include "RTPlanEditList.h"
 
 IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRTPlanRunsSolverTest, "ArchVis.RTPlanRuns.Solver", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
 
@@ -51,3 +54,56 @@ bool FRTPlanRunsSolverTest::RunTest(const FString& Parameters)
 
 	return true;
 }
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRTPlanRunsFollowHostWallTest, "ArchVis.RTPlanRuns.FollowHostWall", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FRTPlanRunsFollowHostWallTest::RunTest(const FString& Parameters)
+{
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+	URTPlanDocument* Doc = NewObject<URTPlanDocument>();
+
+	// 120cm wall hosting a run over its full length
+	FRTVertex VA; VA.Id = FGuid::NewGuid(); VA.Position = FVector2D(0, 0);
+	FRTVertex VB; VB.Id = FGuid::NewGuid(); VB.Position = FVector2D(120, 0);
+	FRTWall Wall; Wall.Id = FGuid::NewGuid(); Wall.VertexAId = VA.Id; Wall.VertexBId = VB.Id;
+	FRTCabinetRun Run; Run.Id = FGuid::NewGuid(); Run.HostWallId = Wall.Id;
+	{
+		FRTPlanEditList Edits;
+		Edits.SetVertex(VA);
+		Edits.SetVertex(VB);
+		Edits.SetWall(Wall);
+		Edits.SetRun(Run);
+		Doc->SubmitEdits(MoveTemp(Edits), TEXT("Setup"));
+	}
+
+	ARTPlanRunManager* Manager = World->SpawnActor<ARTPlanRunManager>();
+	Manager->SetDocument(Doc);
+	Manager->RegenerateRuns();
+	TestEqual("Initial modules (2x 60cm)", Doc->GetObjectsGeneratedByRun(Run.Id).Num(), 2);
+
+	// Shortening the wall through its vertex re-solves the run without an explicit call
+	{
+		FRTPlanEditList Edits;
+		VB.Position = FVector2D(60, 0);
+		Edits.SetVertex(VB);
+		Doc->SubmitEdits(MoveTemp(Edits), TEXT("Move Vertex"));
+	}
+	TestEqual("Modules after shortening the wall", Doc->GetObjectsGeneratedByRun(Run.Id).Num(), 1);
+
+	// Undo restores the length and the modules
+	Doc->Undo();
+	TestEqual("Modules after undo", Doc->GetObjectsGeneratedByRun(Run.Id).Num(), 2);
+
+	// Removing the host wall drops the generated objects
+	{
+		FRTPlanEditList Edits;
+		Edits.RemoveWall(Wall.Id);
+		Doc->SubmitEdits(MoveTemp(Edits), TEXT("Delete Wall"));
+	}
+	TestEqual("Modules after deleting the wall", Doc->GetObjectsGeneratedByRun(Run.Id).Num(), 0);
+	TestEqual("No generated objects left", Doc->GetData().Objects.Num(), 0);
+
+	World->DestroyWorld(false);
+
+	return true;
+}
@@ -23,11 +23,25 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "RTPlan|Runs")
 	void RegenerateRuns();
 
+	// Regenerate only the runs hosted on one wall (e.g. after the wall was moved / resized).
+	// Called automatically for the walls in each committed plan change.
+	UFUNCTION(BlueprintCallable, Category = "RTPlan|Runs")
+	void RegenerateRunsOnWall(const FGuid& WallId);
+
 protected:
 	virtual void BeginPlay() override;
 
 	UFUNCTION()
-	void OnPlanChanged();
+	void OnPlanChanged(const FRTPlanDelta& Delta);
+
+	// Clear and re-solve the runs hosted on a wall, without notifying
+	void RegenerateHostedRuns(const FGuid& WallId);
+
+	// Remove the objects previously generated by a run
+	void ClearRunObjects(const FGuid& RunId);
+
+	// Solve a run and add its modules as objects
+	void GenerateRun(const FRTCabinetRun& Run);
 
 	UPROPERTY(Transient)
 	TObjectPtr<URTPlanDocument> Document;
@@ -1,9 +1,8 @@
 ﻿#include "RTPlanShellActor.h"
 #include "Components/DynamicMeshComponent.h"
-#include "RTPlanMeshBuilder.h"
-#include "RTPlanGeometryUtils.h"
-#include "RTPlanOpeningUtils.h"
+#include "RTPlanWallMesher.h"
 #include "UDynamicMesh.h"
+#include "HAL/PlatformTime.h"
 
 DEFINE_LOG_CATEGORY(LogRTPlanShell);
 
@@ -51,10 +50,109 @@ void ARTPlanShellActor::SetDocument(URTPlanDocument* InDoc)
 	}
 }
 
-void ARTPlanShellActor::OnPlanChanged()
+void ARTPlanShellActor::OnPlanChanged(const FRTPlanDelta& Delta)
 {
-	UE_LOG(LogRTPlanShell, Log, TEXT("OnPlanChanged triggered"));
-	RebuildAll();
+	// Throttle live gesture steps; whatever is skipped is picked up from MeshedRevision later
+	if (Delta.bInteractive)
+	{
+		const double Now = FPlatformTime::Seconds();
+		if (Now - LastInteractiveRemeshTime < InteractiveRemeshInterval)
+		{
+			return;
+		}
+		LastInteractiveRemeshTime = Now;
+	}
+	else
+	{
+		LastInteractiveRemeshTime = TNumericLimits<double>::Lowest();
+	}
+
+	// Catch up from the last meshed revision rather than trusting this notification alone
+	const FRTPlanDelta Changes = Document->GetChangedSince(MeshedRevision);
+
+	// Objects / Runs don't affect the shell
+	if (!Changes.AffectsWallGeometry())
+	{
+		MeshedRevision = Document->GetRevision();
+		return;
+	}
+
+	if (Changes.bFullRebuild)
+	{
+		UE_LOG(LogRTPlanShell, Log, TEXT("OnPlanChanged: full rebuild"));
+		RebuildAll();
+		return;
+	}
+
+	TSet<FGuid> DirtyWalls;
+	GatherDirtyWalls(Changes, DirtyWalls);
+	for (const FGuid& OpeningId : Changes.Openings.Removed)
+	{
+		MeshedOpeningHosts.Remove(OpeningId);
+	}
+	RebuildWalls(DirtyWalls);
+}
+
+void ARTPlanShellActor::GatherDirtyWalls(const FRTPlanDelta& Delta, TSet<FGuid>& OutWallIds) const
+{
+	const FRTPlanDenseStore& Store = Document->GetDenseStore();
+
+	// Walls meeting at a vertex share a junction, so an edited / added / removed wall dirties its neighbours.
+	// Both the meshed and the current endpoints count (a wall may have been reconnected).
+	auto AddWithNeighbours = [this, &Store, &OutWallIds](const FGuid& WallId)
+	{
+		OutWallIds.Add(WallId);
+		if (const FMeshedWall* Meshed = MeshedWalls.Find(WallId))
+		{
+			OutWallIds.Append(Document->GetWallsAtVertex(Meshed->VertexAId));
+			OutWallIds.Append(Document->GetWallsAtVertex(Meshed->VertexBId));
+		}
+		if (const FRTPlanDenseWall* Entry = Store.GetWalls().Find(WallId))
+		{
+			OutWallIds.Append(Document->GetWallsAtVertex(Entry->Wall.VertexAId));
+			OutWallIds.Append(Document->GetWallsAtVertex(Entry->Wall.VertexBId));
+		}
+	};
+	for (const TSet<FGuid>* WallIds : { &Delta.Walls.Added, &Delta.Walls.Modified, &Delta.Walls.Removed })
+	{
+		for (const FGuid& WallId : *WallIds)
+		{
+			AddWithNeighbours(WallId);
+		}
+	}
+
+	// A moved vertex reshapes the walls ending at it, and turning them changes the junction cuts at their far ends
+	for (const TSet<FGuid>* VertexIds : { &Delta.Vertices.Added, &Delta.Vertices.Modified, &Delta.Vertices.Removed })
+	{
+		for (const FGuid& VertexId : *VertexIds)
+		{
+			for (const FGuid& WallId : Document->GetWallsAtVertex(VertexId))
+			{
+				OutWallIds.Add(WallId);
+				if (const FRTPlanDenseWall* Entry = Store.GetWalls().Find(WallId))
+				{
+					const FGuid& FarVertexId = Entry->Wall.VertexAId == VertexId ? Entry->Wall.VertexBId : Entry->Wall.VertexAId;
+					OutWallIds.Append(Document->GetWallsAtVertex(FarVertexId));
+				}
+			}
+		}
+	}
+
+	// Openings dirty the wall they were cut into and the one now hosting them
+	for (const TSet<FGuid>* OpeningIds : { &Delta.Openings.Added, &Delta.Openings.Modified, &Delta.Openings.Removed })
+	{
+		for (const FGuid& OpeningId : *OpeningIds)
+		{
+			if (const FGuid* OldHost = MeshedOpeningHosts.Find(OpeningId))
+			{
+				OutWallIds.Add(*OldHost);
+			}
+			if (const FRTOpening* Opening = Store.GetOpenings().Find(OpeningId))
+			{
+				OutWallIds.Add(Opening->WallId);
+			}
+		}
+	}
 }
 
 void ARTPlanShellActor::SetSelectedWalls(const TArray<FGuid>& WallIds)
@@ -94,220 +192,171 @@ void ARTPlanShellActor::RebuildAll()
 	if (!Document) return;
 	
 	UE_LOG(LogRTPlanShell, Log, TEXT("RebuildAll started"));
+	MeshedRevision = Document->GetRevision();
+	MeshedOpeningHosts.Reset();
 
-	const FRTPlanData& Data = Document->GetData();
-
-	// Track which walls still exist
-	TSet<FGuid> CurrentWallIds;
-	for (const auto& Pair : Data.Walls)
-	{
-		CurrentWallIds.Add(Pair.Key);
-	}
+	// Iterate the packed store rather than the GUID maps
+	const TRTSlotMap<FRTPlanDenseWall>& Walls = Document->GetDenseStore().GetWalls();
 
 	// Remove mesh components for walls that no longer exist
 	TArray<FGuid> WallsToRemove;
 	for (auto& Pair : WallMeshComponents)
 	{
-		if (!CurrentWallIds.Contains(Pair.Key))
+		if (!Walls.Contains(Pair.Key))
 		{
-			if (UDynamicMeshComponent* MeshComp = Pair.Value.Get())
-			{
-				MeshComp->DestroyComponent();
-			}
 			WallsToRemove.Add(Pair.Key);
 		}
 	}
 	for (const FGuid& Id : WallsToRemove)
 	{
-		WallMeshComponents.Remove(Id);
+		RemoveWall(Id);
 	}
 
-	// Pre-process Openings: Map WallID -> List of Openings
-	TMap<FGuid, TArray<FRTOpening>> WallOpenings;
-	for (const auto& Pair : Data.Openings)
+	// Every wall is meshed from an immutable snapshot, so the work can leave the game thread
+	const FRTPlanSnapshotRef Snapshot = Document->GetSnapshot();
+	TArray<FRTPlanWallMeshInput> Inputs;
+	FRTPlanWallMesher::GatherInputs(*Snapshot, Walls.GetIds(), Inputs);
+	CommitWallMeshes(Inputs, Walls.GetIds());
+
+	// Hide the legacy combined mesh component since we're using per-wall components
+	if (WallMeshComponent)
 	{
-		WallOpenings.FindOrAdd(Pair.Value.WallId).Add(Pair.Value);
+		WallMeshComponent->SetVisibility(false);
 	}
+}
 
-	// Iterate Walls and create/update per-wall mesh components
-	for (const auto& Pair : Data.Walls)
-	{
-		const FRTWall& Wall = Pair.Value;
-		
-		if (!Data.Vertices.Contains(Wall.VertexAId) || !Data.Vertices.Contains(Wall.VertexBId))
-		{
-			continue;
-		}
+void ARTPlanShellActor::RebuildWalls(const TSet<FGuid>& WallIds)
+{
+	if (!Document) return;
 
-		FVector2D A = Data.Vertices[Wall.VertexAId].Position;
-		FVector2D B = Data.Vertices[Wall.VertexBId].Position;
+	MeshedRevision = Document->GetRevision();
 
-		float Length = FVector2D::Distance(A, B);
-		if (Length < 1.0f) continue;
+	// A few dirty walls are cheaper to resolve from the dense store than to snapshot the whole plan
+	const FRTPlanDenseStore& Store = Document->GetDenseStore();
+	const TArray<FGuid> WallIdArray = WallIds.Array();
+	TArray<FRTPlanWallMeshInput> Inputs;
+	Inputs.Reserve(WallIdArray.Num());
 
-		// Get or create mesh component for this wall
-		UDynamicMeshComponent* WallMeshComp = nullptr;
-		if (TObjectPtr<UDynamicMeshComponent>* ExistingPtr = WallMeshComponents.Find(Wall.Id))
+	for (const FGuid& WallId : WallIdArray)
+	{
+		const FRTPlanDenseWall* Entry = Store.GetWalls().Find(WallId);
+		FVector2D A, B;
+		if (!Entry || !Store.GetWallEndpoints(*Entry, A, B))
 		{
-			WallMeshComp = ExistingPtr->Get();
+			continue;
 		}
-		
-		if (!WallMeshComp)
+
+		FRTPlanWallMeshInput& Input = Inputs.AddDefaulted_GetRef();
+		Input.Wall = Entry->Wall;
+		Input.A = A;
+		Input.B = B;
+		for (const FGuid& OpeningId : Document->GetOpeningsOnWall(WallId))
 		{
-			FName CompName = *FString::Printf(TEXT("WallMesh_%s"), *Wall.Id.ToString());
-			WallMeshComp = NewObject<UDynamicMeshComponent>(this, CompName);
-			WallMeshComp->SetupAttachment(RootComponent);
-			WallMeshComp->RegisterComponent();
-			
-			// Configure collision
-			WallMeshComp->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
-			WallMeshComp->SetCollisionProfileName(TEXT("BlockAll"));
-			WallMeshComp->SetComplexAsSimpleCollisionEnabled(true, true);
-			
-			WallMeshComponents.Add(Wall.Id, WallMeshComp);
+			if (const FRTOpening* Opening = Store.GetOpenings().Find(OpeningId))
+			{
+				Input.Openings.Add(*Opening);
+			}
 		}
+	}
 
-		// Clear and rebuild this wall's mesh
-		UDynamicMesh* Mesh = WallMeshComp->GetDynamicMesh();
-		if (!Mesh) continue;
-		Mesh->Reset();
+	auto ResolveWall = [&Store](const FGuid& WallId, FVector2D& OutA, FVector2D& OutB) -> const FRTWall*
+	{
+		const FRTPlanDenseWall* Entry = Store.GetWalls().Find(WallId);
+		return Entry && Store.GetWallEndpoints(*Entry, OutA, OutB) ? &Entry->Wall : nullptr;
+	};
+	for (FRTPlanWallMeshInput& Input : Inputs)
+	{
+		FRTPlanWallMesher::SolveEnds(Input, Document->GetWallsAtVertex(Input.Wall.VertexAId), Document->GetWallsAtVertex(Input.Wall.VertexBId), ResolveWall);
+	}
+
+	CommitWallMeshes(Inputs, WallIdArray);
+
+	UE_LOG(LogRTPlanShell, Verbose, TEXT("RebuildWalls: re-meshed %d of %d walls"), NumWallsRebuiltLastUpdate, Store.GetWalls().Num());
+}
+
+void ARTPlanShellActor::CommitWallMeshes(TConstArrayView<FRTPlanWallMeshInput> Inputs, TConstArrayView<FGuid> WallIds)
+{
+	TArray<UE::Geometry::FDynamicMesh3> Meshes;
+	TArray<bool> Built;
+	WallMeshCache.BuildWallMeshes(Inputs, Meshes, Built);
 
-		// Handle curved walls (arcs)
-		if (Wall.bIsArc && FMath::Abs(Wall.ArcSweepAngle) > 0.1f)
+	// Game thread from here on: components only take finished meshes
+	NumWallsRebuiltLastUpdate = 0;
+	TSet<FGuid> Committed;
+	Committed.Reserve(Inputs.Num());
+
+	for (int32 Index = 0; Index < Inputs.Num(); ++Index)
+	{
+		if (!Built[Index])
 		{
-			// Use wall's segment count if specified, otherwise use default
-			int32 NumSegments = (Wall.ArcNumSegments > 0) ? Wall.ArcNumSegments : 32;
-			
-			FRTPlanMeshBuilder::AppendCurvedWallMesh(
-				Mesh,
-				A,  // Start point
-				B,  // End point
-				Wall.ArcCenter,
-				Wall.ArcSweepAngle,
-				Wall.ThicknessCm,
-				Wall.HeightCm,
-				Wall.BaseZCm,
-				NumSegments,
-				Wall.bHasLeftSkirting ? Wall.LeftSkirtingHeightCm : 0.0f,
-				Wall.bHasLeftSkirting ? Wall.LeftSkirtingThicknessCm : 0.0f,
-				Wall.bHasRightSkirting ? Wall.RightSkirtingHeightCm : 0.0f,
-				Wall.bHasRightSkirting ? Wall.RightSkirtingThicknessCm : 0.0f,
-				Wall.bHasCapSkirting ? Wall.CapSkirtingHeightCm : 0.0f,
-				Wall.bHasCapSkirting ? Wall.CapSkirtingThicknessCm : 0.0f,
-				0, 1, 2, 3, 4, 5  // Material IDs: Left, Right, Caps, SkirtLeft, SkirtRight, SkirtCap
-			);
-			
-			// Apply selection highlight
-			bool bIsSelected = SelectedWallIds.Contains(Wall.Id);
-			WallMeshComp->SetRenderCustomDepth(bIsSelected);
-			WallMeshComp->SetCustomDepthStencilValue(bIsSelected ? SelectionStencilValue : 0);
-			continue;  // Skip straight wall processing
+			continue;
 		}
 
-		// Calculate Transform Base for straight wall
-		FVector2D Dir = (B - A).GetSafeNormal();
-		float Angle = FMath::Atan2(Dir.Y, Dir.X);
-		FQuat WallRotation(FVector::UpVector, Angle);
-		
-		// Extend wall by half thickness at each end to eliminate corner gaps
-		float HalfThickness = Wall.ThicknessCm * 0.5f;
-		FVector2D ExtendedA = A - Dir * HalfThickness;
-		FVector2D ExtendedB = B + Dir * HalfThickness;
-		float ExtendedLength = Length + Wall.ThicknessCm;
-		
-		float ZCenter = Wall.BaseZCm + (Wall.HeightCm * 0.5f);
-
-		// Get Openings for this wall
-		TArray<FRTOpening>* Ops = WallOpenings.Find(Wall.Id);
-		
-		if (Ops && Ops->Num() > 0)
-		{
-			// Split Wall Logic - use original length for opening calculations
-			TArray<FRTPlanOpeningUtils::FInterval> Solids = FRTPlanOpeningUtils::ComputeSolidIntervals(Length, *Ops);
+		const FRTPlanWallMeshInput& Input = Inputs[Index];
+		const FRTWall& Wall = Input.Wall;
+		UDynamicMeshComponent* WallMeshComp = FindOrAddWallComponent(Wall.Id);
+		WallMeshComp->SetMesh(MoveTemp(Meshes[Index]));
 
-			for (int32 i = 0; i < Solids.Num(); ++i)
-			{
-				const auto& Solid = Solids[i];
-				float SegStart = Solid.Start;
-				float SegEnd = Solid.End;
-				
-				// Extend first segment backward and last segment forward
-				if (i == 0)
-				{
-					SegStart -= HalfThickness;
-				}
-				if (i == Solids.Num() - 1)
-				{
-					SegEnd += HalfThickness;
-				}
-				
-				float SegLength = SegEnd - SegStart;
-				if (SegLength < 0.1f) continue;
-
-				float MidDist = (SegStart + SegEnd) * 0.5f;
-				
-				FVector2D SegStartPos2D = A + Dir * SegStart;
-				FVector SegStartPos(SegStartPos2D.X, SegStartPos2D.Y, 0); // Z is handled by BaseZ param
-
-				FTransform SegTransform;
-				SegTransform.SetLocation(SegStartPos);
-				SegTransform.SetRotation(WallRotation);
-
-				FRTPlanMeshBuilder::AppendWallMesh(
-					Mesh,
-					SegTransform,
-					SegLength,
-					Wall.ThicknessCm,
-					Wall.HeightCm,
-					Wall.BaseZCm,
-					Wall.bHasLeftSkirting ? Wall.LeftSkirtingHeightCm : 0.0f,
-					Wall.bHasLeftSkirting ? Wall.LeftSkirtingThicknessCm : 0.0f,
-					Wall.bHasRightSkirting ? Wall.RightSkirtingHeightCm : 0.0f,
-					Wall.bHasRightSkirting ? Wall.RightSkirtingThicknessCm : 0.0f,
-					Wall.bHasCapSkirting ? Wall.CapSkirtingHeightCm : 0.0f,
-					Wall.bHasCapSkirting ? Wall.CapSkirtingThicknessCm : 0.0f,
-					0, 1, 2, 3, 4, 5
-				);
-			}
-		}
-		else
+		// Remember what this mesh was built from (see GatherDirtyWalls)
+		FMeshedWall& Meshed = MeshedWalls.FindOrAdd(Wall.Id);
+		Meshed.VertexAId = Wall.VertexAId;
+		Meshed.VertexBId = Wall.VertexBId;
+		for (const FRTOpening& Opening : Input.Openings)
 		{
-			// Full Wall (No Openings)
-			// Transform at Start (ExtendedA)
-			
-			FTransform WallTransform;
-			WallTransform.SetLocation(FVector(ExtendedA.X, ExtendedA.Y, 0));
-			WallTransform.SetRotation(WallRotation);
-
-			UE_LOG(LogRTPlanShell, Verbose, TEXT("Building Wall: Start=(%s), Height=%f, ExtendedLength=%f"), 
-				*ExtendedA.ToString(), Wall.HeightCm, ExtendedLength);
-
-			FRTPlanMeshBuilder::AppendWallMesh(
-				Mesh,
-				WallTransform,
-				ExtendedLength,
-				Wall.ThicknessCm,
-				Wall.HeightCm,
-				Wall.BaseZCm,
-				Wall.bHasLeftSkirting ? Wall.LeftSkirtingHeightCm : 0.0f,
-				Wall.bHasLeftSkirting ? Wall.LeftSkirtingThicknessCm : 0.0f,
-				Wall.bHasRightSkirting ? Wall.RightSkirtingHeightCm : 0.0f,
-				Wall.bHasRightSkirting ? Wall.RightSkirtingThicknessCm : 0.0f,
-				Wall.bHasCapSkirting ? Wall.CapSkirtingHeightCm : 0.0f,
-				Wall.bHasCapSkirting ? Wall.CapSkirtingThicknessCm : 0.0f,
-				0, 1, 2, 3, 4, 5
-			);
+			MeshedOpeningHosts.Add(Opening.Id, Wall.Id);
 		}
 
 		// Apply selection highlight if this wall is selected
 		bool bIsSelected = SelectedWallIds.Contains(Wall.Id);
 		WallMeshComp->SetRenderCustomDepth(bIsSelected);
 		WallMeshComp->SetCustomDepthStencilValue(bIsSelected ? SelectionStencilValue : 0);
+
+		Committed.Add(Wall.Id);
+		++NumWallsRebuiltLastUpdate;
 	}
 
-	// Hide the legacy combined mesh component since we're using per-wall components
-	if (WallMeshComponent)
+	// Gone, disconnected or too short to mesh
+	for (const FGuid& WallId : WallIds)
 	{
-		WallMeshComponent->SetVisibility(false);
+		if (!Committed.Contains(WallId))
+		{
+			RemoveWall(WallId);
+		}
 	}
 }
+
+UDynamicMeshComponent* ARTPlanShellActor::FindOrAddWallComponent(const FGuid& WallId)
+{
+	if (TObjectPtr<UDynamicMeshComponent>* ExistingPtr = WallMeshComponents.Find(WallId))
+	{
+		if (UDynamicMeshComponent* Existing = ExistingPtr->Get())
+		{
+			return Existing;
+		}
+	}
+
+	FName CompName = *FString::Printf(TEXT("WallMesh_%s"), *WallId.ToString());
+	UDynamicMeshComponent* WallMeshComp = NewObject<UDynamicMeshComponent>(this, CompName);
+	WallMeshComp->SetupAttachment(RootComponent);
+	WallMeshComp->RegisterComponent();
+			
+	// Configure collision
+	WallMeshComp->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
+	WallMeshComp->SetCollisionProfileName(TEXT("BlockAll"));
+	WallMeshComp->SetComplexAsSimpleCollisionEnabled(true, true);
+			
+	WallMeshComponents.Add(WallId, WallMeshComp);
+	return WallMeshComp;
+}
+
+void ARTPlanShellActor::RemoveWall(const FGuid& WallId)
+{
+	TObjectPtr<UDynamicMeshComponent> MeshComp;
+	if (WallMeshComponents.RemoveAndCopyValue(WallId, MeshComp) && MeshComp)
+	{
+		MeshComp->DestroyComponent();
+	}
+
+	// Opening hosts pointing here go stale harmlessly: they only ever dirty a wall that is gone
+	MeshedWalls.Remove(WallId);
+}
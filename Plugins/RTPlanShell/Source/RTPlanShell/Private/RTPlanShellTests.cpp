@@ -2,10 +2,56 @@
 #include "Misc/AutomationTest.h"
 #include "RTPlanShellActor.h"
 #include "RTPlanDocument.h"
+#include "RTPlanEditList.h"
+#include "RTPlanWallMesher.h"
+#include "RTPlanMeshBuilder.h"
+#include "RTPlanWallMeshCache.h"
+#include "HAL/PlatformTime.h"
+#include "Async/TaskGraphInterfaces.h"
 #include "Components/DynamicMeshComponent.h"
 #include "GeometryScript/MeshQueryFunctions.h"
 #include "UDynamicMesh.h"
 
+namespace RTPlanShellTestsPrivate
+{
+	// Square lattice of walls, Side x Side cells of 200cm (2 * Side * (Side + 1) walls).
+	// OutVertexIds is row-major: vertex (X, Y) is at Y * (Side + 1) + X.
+	URTPlanDocument* MakeLatticePlan(int32 Side, TArray<FGuid>& OutVertexIds)
+	{
+		URTPlanDocument* Doc = NewObject<URTPlanDocument>();
+		FRTPlanData& Data = Doc->GetDataMutable();
+
+		OutVertexIds.SetNum((Side + 1) * (Side + 1));
+		for (int32 Y = 0; Y <= Side; ++Y)
+		{
+			for (int32 X = 0; X <= Side; ++X)
+			{
+				FRTVertex V; V.Id = FGuid::NewGuid(); V.Position = FVector2D(X * 200.0f, Y * 200.0f);
+				Data.Vertices.Add(V.Id, V);
+				OutVertexIds[Y * (Side + 1) + X] = V.Id;
+			}
+		}
+
+		auto AddWall = [&Data](const FGuid& A, const FGuid& B)
+		{
+			FRTWall W; W.Id = FGuid::NewGuid(); W.VertexAId = A; W.VertexBId = B;
+			Data.Walls.Add(W.Id, W);
+		};
+
+		for (int32 Y = 0; Y <= Side; ++Y)
+		{
+			for (int32 X = 0; X <= Side; ++X)
+			{
+				if (X < Side) AddWall(OutVertexIds[Y * (Side + 1) + X], OutVertexIds[Y * (Side + 1) + X + 1]);
+				if (Y < Side) AddWall(OutVertexIds[Y * (Side + 1) + X], OutVertexIds[(Y + 1) * (Side + 1) + X]);
+			}
+		}
+
+		Doc->MarkFullRebuild();
+		return Doc;
+	}
+}
+
 IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRTPlanShellGenerationTest, "ArchVis.RTPlanShell.Generation", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
 
 bool FRTPlanShellGenerationTest::RunTest(const FString& Parameters)
@@ -61,3 +107,389 @@ bool FRTPlanShellGenerationTest::RunTest(const FString& Parameters)
 
 	return true;
 }
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRTPlanShellIncrementalTest, "ArchVis.RTPlanShell.Incremental", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FRTPlanShellIncrementalTest::RunTest(const FString& Parameters)
+{
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+
+	// 10 x 10 lattice of 200cm cells: 220 walls, interior vertices join 4 walls
+	const int32 Side = 10;
+	TArray<FGuid> Ids;
+	URTPlanDocument* Doc = RTPlanShellTestsPrivate::MakeLatticePlan(Side, Ids);
+
+	ARTPlanShellActor* ShellActor = World->SpawnActor<ARTPlanShellActor>();
+	ShellActor->SetDocument(Doc);
+	TestEqual("Initial build meshes every wall", ShellActor->GetNumWallsRebuiltLastUpdate(), 220);
+
+	// Move the center vertex: its 4 walls are re-meshed, and the 3 + 3 + 3 + 3 walls cut against them at their far ends
+	FRTVertex Center = Doc->GetData().Vertices.FindChecked(Ids[5 * (Side + 1) + 5]);
+	{
+		FRTPlanEditList Edits;
+		Center.Position += FVector2D(30, -30);
+		Edits.SetVertex(Center);
+		Doc->SubmitEdits(MoveTemp(Edits), TEXT("Move"));
+	}
+	TestEqual("Moving a vertex re-meshes its walls and their far junctions", ShellActor->GetNumWallsRebuiltLastUpdate(), 16);
+
+	// Cut a door into one wall: only that wall is re-meshed
+	const FGuid HostWallId = Doc->GetWallsAtVertex(Ids[0])[0];
+	{
+		FRTOpening Door; Door.Id = FGuid::NewGuid(); Door.WallId = HostWallId; Door.OffsetCm = 100.0f; Door.WidthCm = 80.0f;
+		FRTPlanEditList Edits;
+		Edits.SetOpening(Door);
+		Doc->SubmitEdits(MoveTemp(Edits), TEXT("Door"));
+	}
+	TestEqual("Adding an opening re-meshes its host only", ShellActor->GetNumWallsRebuiltLastUpdate(), 1);
+
+	// Delete a wall between two interior vertices: the 3 + 3 walls sharing its junctions are re-meshed
+	const FGuid RemovedWallId = Doc->GetWallsAtVertex(Ids[3 * (Side + 1) + 3])[0];
+	{
+		FRTPlanEditList Edits;
+		Edits.RemoveWall(RemovedWallId);
+		Doc->SubmitEdits(MoveTemp(Edits), TEXT("Delete"));
+	}
+	TestEqual("Deleting a wall re-meshes its junction neighbours", ShellActor->GetNumWallsRebuiltLastUpdate(), 6);
+
+	TArray<UDynamicMeshComponent*> MeshComps;
+	ShellActor->GetComponents(MeshComps);
+	TestEqual("Deleted wall lost its component (219 walls + legacy mesh)", MeshComps.Num(), 220);
+
+	// Undo the deletion: the wall comes back along with its neighbours
+	Doc->Undo();
+	TestEqual("Undo re-meshes the restored wall and its neighbours", ShellActor->GetNumWallsRebuiltLastUpdate(), 7);
+
+	World->DestroyWorld(false);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRTPlanShellGestureTest, "ArchVis.RTPlanShell.Gesture", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FRTPlanShellGestureTest::RunTest(const FString& Parameters)
+{
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+
+	const int32 Side = 10;
+	TArray<FGuid> Ids;
+	URTPlanDocument* Doc = RTPlanShellTestsPrivate::MakeLatticePlan(Side, Ids);
+
+	ARTPlanShellActor* ShellActor = World->SpawnActor<ARTPlanShellActor>();
+	ShellActor->SetDocument(Doc);
+
+	FRTVertex Center = Doc->GetData().Vertices.FindChecked(Ids[5 * (Side + 1) + 5]);
+	auto DragStep = [Doc, &Center]()
+	{
+		FRTPlanEditList Edits;
+		Center.Position += FVector2D(5, -5);
+		Edits.SetVertex(Center);
+		Doc->SubmitEdits(MoveTemp(Edits), TEXT("Drag"));
+	};
+
+	// Throttled: the first live step re-meshes, the next ones within the interval are skipped
+	ShellActor->InteractiveRemeshInterval = 3600.0f;
+	Doc->BeginGesture(TEXT("Drag Vertex"));
+	DragStep();
+	TestEqual("First live step is meshed", ShellActor->GetMeshedRevision(), Doc->GetRevision());
+	TestEqual("First live step re-meshes the dragged walls", ShellActor->GetNumWallsRebuiltLastUpdate(), 16);
+	const uint64 FirstStepRevision = Doc->GetRevision();
+	DragStep();
+	DragStep();
+	TestEqual("Throttled live steps are not meshed", ShellActor->GetMeshedRevision(), FirstStepRevision);
+	TestTrue("Document moved on", Doc->GetRevision() > FirstStepRevision);
+
+	// The gesture's final (non-interactive) broadcast catches up
+	Doc->EndGesture();
+	TestEqual("End of the gesture is meshed", ShellActor->GetMeshedRevision(), Doc->GetRevision());
+	TestEqual("End of the gesture re-meshes the dragged walls", ShellActor->GetNumWallsRebuiltLastUpdate(), 16);
+
+	// Unthrottled: every live step is meshed
+	ShellActor->InteractiveRemeshInterval = 0.0f;
+	Doc->BeginGesture(TEXT("Drag Vertex"));
+	for (int32 Step = 0; Step < 3; ++Step)
+	{
+		DragStep();
+		TestEqual("Unthrottled live step is meshed", ShellActor->GetMeshedRevision(), Doc->GetRevision());
+	}
+	Doc->EndGesture();
+
+	World->DestroyWorld(false);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRTPlanShellParallelMeshingTest, "ArchVis.RTPlanShell.ParallelMeshing", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FRTPlanShellParallelMeshingTest::RunTest(const FString& Parameters)
+{
+	// Long row of walls, every third one with a door
+	URTPlanDocument* Doc = NewObject<URTPlanDocument>();
+	FRTPlanData& Data = Doc->GetDataMutable();
+
+	const int32 NumWalls = 3000;
+	FGuid PrevId;
+	for (int32 i = 0; i <= NumWalls; ++i)
+	{
+		FRTVertex V; V.Id = FGuid::NewGuid(); V.Position = FVector2D(i * 300.0f, (i % 2) * 50.0f);
+		Data.Vertices.Add(V.Id, V);
+		if (PrevId.IsValid())
+		{
+			FRTWall W; W.Id = FGuid::NewGuid(); W.VertexAId = PrevId; W.VertexBId = V.Id;
+			W.bHasLeftSkirting = true;
+			Data.Walls.Add(W.Id, W);
+			if (i % 3 == 0)
+			{
+				FRTOpening Door; Door.Id = FGuid::NewGuid(); Door.WallId = W.Id; Door.OffsetCm = 150.0f; Door.WidthCm = 90.0f;
+				Data.Openings.Add(Door.Id, Door);
+			}
+		}
+		PrevId = V.Id;
+	}
+	Doc->MarkFullRebuild();
+
+	TArray<FGuid> WallIds;
+	Doc->GetData().Walls.GetKeys(WallIds);
+	TArray<FRTPlanWallMeshInput> Inputs;
+	FRTPlanWallMesher::GatherInputs(*Doc->GetSnapshot(), WallIds, Inputs);
+	TestEqual("Every wall resolved from the snapshot", Inputs.Num(), NumWalls);
+
+	// Serial reference
+	TArray<UE::Geometry::FDynamicMesh3> SerialMeshes;
+	SerialMeshes.SetNum(Inputs.Num());
+	const double SerialStart = FPlatformTime::Seconds();
+	for (int32 i = 0; i < Inputs.Num(); ++i)
+	{
+		FRTPlanWallMesher::BuildWallMesh(Inputs[i], SerialMeshes[i]);
+	}
+	const double SerialElapsed = FPlatformTime::Seconds() - SerialStart;
+
+	TArray<UE::Geometry::FDynamicMesh3> Meshes;
+	TArray<bool> Built;
+	const double ParallelStart = FPlatformTime::Seconds();
+	FRTPlanWallMesher::BuildWallMeshes(Inputs, Meshes, Built);
+	const double ParallelElapsed = FPlatformTime::Seconds() - ParallelStart;
+
+	AddInfo(FString::Printf(TEXT("%d walls: %.2f ms serial, %.2f ms parallel (%d workers)"),
+		NumWalls, SerialElapsed * 1000.0, ParallelElapsed * 1000.0, FTaskGraphInterface::Get().GetNumWorkerThreads()));
+
+	int32 NumMismatches = 0;
+	for (int32 i = 0; i < Inputs.Num(); ++i)
+	{
+		const bool bSame = Built[i]
+			&& Meshes[i].TriangleCount() == SerialMeshes[i].TriangleCount()
+			&& Meshes[i].GetBounds().Max.Equals(SerialMeshes[i].GetBounds().Max, 0.01)
+			&& Meshes[i].GetBounds().Min.Equals(SerialMeshes[i].GetBounds().Min, 0.01);
+		NumMismatches += bSame ? 0 : 1;
+	}
+	TestEqual("Parallel meshes match the serial ones", NumMismatches, 0);
+
+	// A wall split by a door stays in place: both segments lie within the wall's own extent
+	const int32 DoorInput = Inputs.IndexOfByPredicate([](const FRTPlanWallMeshInput& Input) { return Input.Openings.Num() > 0; });
+	if (TestTrue("Found a wall with a door", DoorInput != INDEX_NONE))
+	{
+		const FRTPlanWallMeshInput& Input = Inputs[DoorInput];
+		const UE::Geometry::FAxisAlignedBox3d Bounds = Meshes[DoorInput].GetBounds();
+		const double MinX = FMath::Min(Input.A.X, Input.B.X) - Input.Wall.ThicknessCm;
+		const double MaxX = FMath::Max(Input.A.X, Input.B.X) + Input.Wall.ThicknessCm;
+		TestTrue("Door wall segments stay on the wall", Bounds.Min.X >= MinX && Bounds.Max.X <= MaxX);
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRTPlanShellWeldedWallMeshTest, "ArchVis.RTPlanShell.WeldedWallMesh", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FRTPlanShellWeldedWallMeshTest::RunTest(const FString& Parameters)
+{
+	// Straight wall with skirting on both sides, rotated onto the Y axis: 200 long, 20 thick, 300 high
+	UE::Geometry::FDynamicMesh3 Mesh;
+	Mesh.EnableAttributes();
+	const FTransform Transform(FQuat(FVector::UpVector, UE_HALF_PI), FVector(100, 50, 0));
+	FRTPlanMeshBuilder::AppendWallMesh(Mesh, Transform, 200.0f, 20.0f, 300.0f, 0.0f,
+		10.0f, 2.0f, 8.0f, 1.5f, 0.0f, 0.0f,
+		0, 1, 2, 3, 4, 5);
+
+	// 10-point profile ring at both ends, every vertex shared by the faces meeting there
+	TestEqual("Straight wall vertices", Mesh.VertexCount(), 20);
+	TestEqual("Straight wall triangles", Mesh.TriangleCount(), 36);
+	TestTrue("Straight wall is a closed shell", Mesh.IsClosed());
+
+	// Written straight into world space: the left side (and its 2cm skirting) ends up at -X
+	const UE::Geometry::FAxisAlignedBox3d Bounds = Mesh.GetBounds();
+	TestTrue("Straight wall min", Bounds.Min.Equals(FVector3d(88.0, 50.0, 0.0), 0.01));
+	TestTrue("Straight wall max", Bounds.Max.Equals(FVector3d(111.5, 250.0, 300.0), 0.01));
+
+	// Appending a second wall leaves the first one where it is
+	FRTPlanMeshBuilder::AppendWallMesh(Mesh, FTransform(FVector(1000, 0, 0)), 100.0f, 20.0f, 300.0f, 0.0f,
+		0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f,
+		0, 1, 2, 3, 4, 5);
+	TestEqual("Second wall adds a welded box", Mesh.VertexCount(), 28);
+	TestTrue("First wall untouched", Mesh.GetVertex(0).Equals(FVector3d(110.0, 50.0, 0.0), 0.01));
+
+	// Quarter arc with skirting: one ring per station, shared between neighbouring segments
+	UE::Geometry::FDynamicMesh3 ArcMesh;
+	ArcMesh.EnableAttributes();
+	const int32 NumSegments = 8;
+	FRTPlanMeshBuilder::AppendCurvedWallMesh(ArcMesh, FVector2D(300, 0), FVector2D(0, 300), FVector2D::ZeroVector, 90.0f,
+		20.0f, 300.0f, 0.0f, NumSegments,
+		10.0f, 2.0f, 8.0f, 1.5f, 0.0f, 0.0f,
+		0, 1, 2, 3, 4, 5);
+	TestEqual("Arc vertices", ArcMesh.VertexCount(), 10 * (NumSegments + 1));
+	TestTrue("Arc is a closed shell", ArcMesh.IsClosed());
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRTPlanShellMeshCacheTest, "ArchVis.RTPlanShell.MeshCache", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FRTPlanShellMeshCacheTest::RunTest(const FString& Parameters)
+{
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+
+	// 6 x 6 lattice of 200cm cells: 84 walls, horizontal and vertical; a door in a few of them
+	const int32 Side = 6;
+	TArray<FGuid> Ids;
+	URTPlanDocument* Doc = RTPlanShellTestsPrivate::MakeLatticePlan(Side, Ids);
+	FRTPlanData& Data = Doc->GetDataMutable();
+
+	// Doors in the vertical walls rising from the diagonal vertices
+	for (const TPair<FGuid, FRTWall>& Pair : Data.Walls)
+	{
+		for (int32 I = 0; I < Side; ++I)
+		{
+			if (Pair.Value.VertexAId == Ids[I * (Side + 1) + I] && Pair.Value.VertexBId == Ids[(I + 1) * (Side + 1) + I])
+			{
+				FRTOpening Door; Door.Id = FGuid::NewGuid(); Door.WallId = Pair.Key; Door.OffsetCm = 100.0f; Door.WidthCm = 80.0f;
+				Data.Openings.Add(Door.Id, Door);
+			}
+		}
+	}
+	Doc->MarkFullRebuild();
+
+	// Cached copies land exactly where meshing each wall from scratch would put them
+	TArray<FGuid> WallIds;
+	Doc->GetData().Walls.GetKeys(WallIds);
+	TArray<FRTPlanWallMeshInput> Inputs;
+	FRTPlanWallMesher::GatherInputs(*Doc->GetSnapshot(), WallIds, Inputs);
+
+	FRTPlanWallMeshCache Cache;
+	TArray<UE::Geometry::FDynamicMesh3> Meshes;
+	TArray<bool> Built;
+	Cache.BuildWallMeshes(Inputs, Meshes, Built);
+	// Interior walls with and without a door; along the border three end cuts each for left / top and right / bottom
+	// walls (L, T, L), plus the corner door
+	TestEqual("Nine shapes", Cache.GetNumMisses(), (int64)9);
+	TestEqual("Every other wall is a copy", Cache.GetNumHits(), (int64)(Inputs.Num() - 9));
+
+	int32 NumMismatches = 0;
+	for (int32 i = 0; i < Inputs.Num(); ++i)
+	{
+		UE::Geometry::FDynamicMesh3 Reference;
+		FRTPlanWallMesher::BuildWallMesh(Inputs[i], Reference);
+		const bool bSame = Built[i]
+			&& Meshes[i].VertexCount() == Reference.VertexCount()
+			&& Meshes[i].TriangleCount() == Reference.TriangleCount()
+			&& Meshes[i].GetBounds().Min.Equals(Reference.GetBounds().Min, 0.01)
+			&& Meshes[i].GetBounds().Max.Equals(Reference.GetBounds().Max, 0.01);
+		NumMismatches += bSame ? 0 : 1;
+	}
+	TestEqual("Cached meshes match fresh ones", NumMismatches, 0);
+
+	// Re-meshing the same plan is all hits
+	Cache.ResetStats();
+	Cache.BuildWallMeshes(Inputs, Meshes, Built);
+	TestEqual("Second pass meshes nothing", Cache.GetNumMisses(), (int64)0);
+	TestEqual("Second pass copies every wall", Cache.GetNumHits(), (int64)Inputs.Num());
+
+	// Through the shell actor: an edit creates new shapes once, undo / redo bring back known ones
+	ARTPlanShellActor* ShellActor = World->SpawnActor<ARTPlanShellActor>();
+	ShellActor->SetDocument(Doc);
+	const FRTPlanWallMeshCache& ShellCache = ShellActor->GetWallMeshCache();
+	TestEqual("Initial build: one miss per shape", ShellCache.GetNumMisses(), (int64)9);
+
+	// Moving an interior vertex diagonally reshapes its 4 walls and recuts the 8 walls beside them at the far
+	// junctions; the 4 walls straight across those junctions come back unchanged
+	FRTVertex Center = Doc->GetData().Vertices.FindChecked(Ids[2 * (Side + 1) + 3]);
+	{
+		FRTPlanEditList Edits;
+		Center.Position += FVector2D(30, -30);
+		Edits.SetVertex(Center);
+		Doc->SubmitEdits(MoveTemp(Edits), TEXT("Move"));
+	}
+	TestEqual("Moved vertex re-meshes its walls and their far junctions", ShellActor->GetNumWallsRebuiltLastUpdate(), 16);
+	TestEqual("Twelve new shapes", ShellCache.GetNumMisses(), (int64)21);
+
+	const int64 HitsBeforeUndo = ShellCache.GetNumHits();
+	Doc->Undo();
+	Doc->Redo();
+	TestEqual("Undo / redo mesh nothing new", ShellCache.GetNumMisses(), (int64)21);
+	TestEqual("Undo / redo are served from the cache", ShellCache.GetNumHits(), HitsBeforeUndo + 32);
+
+	World->DestroyWorld(false);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRTPlanShellJunctionTest, "ArchVis.RTPlanShell.Junction", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FRTPlanShellJunctionTest::RunTest(const FString& Parameters)
+{
+	// 20cm walls: an L corner at (400, 0) and a T at (400, 300), where the third wall leaves to the right
+	URTPlanDocument* Doc = NewObject<URTPlanDocument>();
+	FRTPlanData& Data = Doc->GetDataMutable();
+
+	const FVector2D Positions[] = { FVector2D(0, 0), FVector2D(400, 0), FVector2D(400, 300), FVector2D(800, 300), FVector2D(400, 600) };
+	TArray<FGuid> Ids;
+	for (const FVector2D& Position : Positions)
+	{
+		FRTVertex V; V.Id = FGuid::NewGuid(); V.Position = Position;
+		Data.Vertices.Add(V.Id, V);
+		Ids.Add(V.Id);
+	}
+
+	TArray<FGuid> WallIds;
+	for (const TPair<int32, int32>& Ends : { TPair<int32, int32>(0, 1), TPair<int32, int32>(1, 2), TPair<int32, int32>(2, 3), TPair<int32, int32>(2, 4) })
+	{
+		FRTWall W; W.Id = FGuid::NewGuid(); W.VertexAId = Ids[Ends.Key]; W.VertexBId = Ids[Ends.Value];
+		Data.Walls.Add(W.Id, W);
+		WallIds.Add(W.Id);
+	}
+	Doc->MarkFullRebuild();
+
+	TArray<FRTPlanWallMeshInput> Inputs;
+	FRTPlanWallMesher::GatherInputs(*Doc->GetSnapshot(), WallIds, Inputs);
+	if (!TestEqual("Every wall resolved", Inputs.Num(), 4))
+	{
+		return false;
+	}
+
+	auto TestEnd = [this](const TCHAR* What, const FRTPlanWallEnd& End, float Left, float Right)
+	{
+		TestFalse(FString::Printf(TEXT("%s is not capped"), What), End.bCapped);
+		TestTrue(FString::Printf(TEXT("%s left cut"), What), FMath::IsNearlyEqual(End.LeftOffset, Left, 0.01f));
+		TestTrue(FString::Printf(TEXT("%s right cut"), What), FMath::IsNearlyEqual(End.RightOffset, Right, 0.01f));
+	};
+
+	// Free end stays square and capped
+	TestTrue("Free end is capped", Inputs[0].Start.bCapped);
+	TestTrue("Free end is uncut", Inputs[0].Start.LeftOffset == 0.0f && Inputs[0].Start.RightOffset == 0.0f);
+
+	// L corner: a mitre, the inner (left) faces stop short of the vertex, the outer ones run past it
+	TestEnd(TEXT("Corner, first wall"), Inputs[0].End, -10.0f, 10.0f);
+	TestEnd(TEXT("Corner, second wall"), Inputs[1].Start, 10.0f, -10.0f);
+
+	// T: the through walls are cut square on the open side and stop at the stem's faces on the stem side (their right)
+	TestEnd(TEXT("T, lower through wall"), Inputs[1].End, 0.0f, -10.0f);
+	TestEnd(TEXT("T, stem"), Inputs[2].Start, 10.0f, 10.0f);
+	TestEnd(TEXT("T, upper through wall"), Inputs[3].Start, 0.0f, 10.0f);
+
+	// The mitred wall reaches the outer corner (skirting included) and no further
+	UE::Geometry::FDynamicMesh3 Mesh;
+	FRTPlanWallMesher::BuildWallMesh(Inputs[0], Mesh);
+	const UE::Geometry::FAxisAlignedBox3d Bounds = Mesh.GetBounds();
+	TestTrue("Mitred wall min", Bounds.Min.Equals(FVector3d(-1.5, -11.5, 0.0), 0.01));
+	TestTrue("Mitred wall max", Bounds.Max.Equals(FVector3d(411.5, 11.5, 300.0), 0.01));
+
+	return true;
+}
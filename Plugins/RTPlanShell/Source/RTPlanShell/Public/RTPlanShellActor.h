@@ -3,9 +3,11 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
 #include "RTPlanDocument.h"
+#include "RTPlanWallMeshCache.h"
 #include "RTPlanShellActor.generated.h"
 
 class UDynamicMeshComponent;
+struct FRTPlanWallMeshInput;
 
 DECLARE_LOG_CATEGORY_EXTERN(LogRTPlanShell, Log, All);
 
@@ -28,6 +30,25 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "RTPlan|Shell")
 	void RebuildAll();
 
+	/** Re-mesh only the given walls; walls that no longer exist lose their component. Other components are left untouched. */
+	void RebuildWalls(const TSet<FGuid>& WallIds);
+
+	/** Number of walls re-meshed by the last RebuildAll / RebuildWalls */
+	int32 GetNumWallsRebuiltLastUpdate() const { return NumWallsRebuiltLastUpdate; }
+
+	/** Document revision the wall meshes show */
+	uint64 GetMeshedRevision() const { return MeshedRevision; }
+
+	/**
+	 * Live gesture steps (interactive deltas) re-mesh at most once per this many seconds; the steps in between are
+	 * caught up by the next one, and the gesture's final broadcast always re-meshes. 0 re-meshes every step.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "RTPlan|Shell", meta = (ClampMin = "0.0"))
+	float InteractiveRemeshInterval = 0.05f;
+
+	/** Shape cache the wall meshes are served from (hit / miss counters) */
+	const FRTPlanWallMeshCache& GetWallMeshCache() const { return WallMeshCache; }
+
 	// --- Selection Highlighting ---
 
 	/** Set which walls are currently selected (applies stencil value 1) */
@@ -46,11 +67,24 @@ protected:
 	virtual void BeginPlay() override;
 
 	UFUNCTION()
-	void OnPlanChanged();
+	void OnPlanChanged(const FRTPlanDelta& Delta);
 
 	/** Update stencil values on wall mesh components based on selection */
 	void UpdateSelectionHighlight();
 
+	/** Walls whose mesh depends on something in Delta: their own data, endpoint vertices, junction neighbours or hosted openings */
+	void GatherDirtyWalls(const FRTPlanDelta& Delta, TSet<FGuid>& OutWallIds) const;
+
+	/**
+	 * Generate the meshes for Inputs on the task graph (copying walls of a cached shape), then move them into their
+	 * components in one pass (created on first use). Walls listed in WallIds that produced no mesh lose their component.
+	 */
+	void CommitWallMeshes(TConstArrayView<FRTPlanWallMeshInput> Inputs, TConstArrayView<FGuid> WallIds);
+
+	UDynamicMeshComponent* FindOrAddWallComponent(const FGuid& WallId);
+
+	void RemoveWall(const FGuid& WallId);
+
 	// The main combined mesh (for non-selected walls or legacy mode)
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
 	TObjectPtr<UDynamicMeshComponent> WallMeshComponent;
@@ -65,4 +99,28 @@ protected:
 	// Currently selected wall IDs
 	UPROPERTY(Transient)
 	TSet<FGuid> SelectedWallIds;
+
+	// Document revision the meshes were last built from
+	uint64 MeshedRevision = 0;
+
+	// When the last interactive delta was re-meshed (FPlatformTime::Seconds); reset by every regular broadcast,
+	// so the first step of a gesture is always meshed
+	double LastInteractiveRemeshTime = TNumericLimits<double>::Lowest();
+
+	// Inputs each wall component was last meshed from, so edits to vertices / openings that have
+	// since moved or disappeared can still be traced back to the walls showing them
+	struct FMeshedWall
+	{
+		FGuid VertexAId;
+		FGuid VertexBId;
+	};
+	TMap<FGuid, FMeshedWall> MeshedWalls;
+
+	// Opening -> wall it was cut into
+	TMap<FGuid, FGuid> MeshedOpeningHosts;
+
+	int32 NumWallsRebuiltLastUpdate = 0;
+
+	// Meshes by wall shape; kept across rebuilds and documents
+	FRTPlanWallMeshCache WallMeshCache;
 };
@@ -0,0 +1,287 @@
+﻿#include "RTPlanAlignmentIndex.h"
+#include "Algo/BinarySearch.h"
+
+bool FRTAlignmentGuide::Intersect(const FRTAlignmentGuide& A, const FRTAlignmentGuide& B, FVector2D& OutPoint)
+{
+	const double Cross = A.Direction ^ B.Direction;
+	if (FMath::Abs(Cross) < 1e-3)
+	{
+		return false;
+	}
+
+	const double T = ((B.Source - A.Source) ^ B.Direction) / Cross;
+	OutPoint = A.Source + A.Direction * T;
+	return true;
+}
+
+void FRTPlanAlignmentIndex::Reset()
+{
+	Families.Reset();
+	ExtensionFamilies.Reset();
+	PendingSources.Reset();
+	bBulkAdd = false;
+
+	FFamily& Vertical = Families.AddDefaulted_GetRef();
+	Vertical.Type = ERTAlignmentGuideType::Vertical;
+	Vertical.Direction = FVector2D(0.0f, 1.0f);
+	Vertical.Normal = FVector2D(1.0f, 0.0f);
+
+	FFamily& Horizontal = Families.AddDefaulted_GetRef();
+	Horizontal.Type = ERTAlignmentGuideType::Horizontal;
+	Horizontal.Direction = FVector2D(1.0f, 0.0f);
+	Horizontal.Normal = FVector2D(0.0f, 1.0f);
+}
+
+void FRTPlanAlignmentIndex::BeginBulkAdd()
+{
+	bBulkAdd = true;
+}
+
+void FRTPlanAlignmentIndex::EndBulkAdd()
+{
+	if (!bBulkAdd)
+	{
+		return;
+	}
+	bBulkAdd = false;
+
+	// Lines that existed before the bulk load take part in the merge
+	for (int32 FamilyIndex = 0; FamilyIndex < Families.Num(); ++FamilyIndex)
+	{
+		for (FLine& Line : Families[FamilyIndex].Lines)
+		{
+			for (FSource& Source : Line.Sources)
+			{
+				PendingSources.Add({ FamilyIndex, Line.Offset, MoveTemp(Source) });
+			}
+		}
+		Families[FamilyIndex].Lines.Reset();
+	}
+
+	PendingSources.Sort([](const FPendingSource& A, const FPendingSource& B)
+	{
+		return A.Family != B.Family ? A.Family < B.Family : A.Offset < B.Offset;
+	});
+
+	// Equal offsets (within LineTolerance of the line's first source) form one line
+	int32 FamilyIndex = INDEX_NONE;
+	FLine* Line = nullptr;
+	for (FPendingSource& Pending : PendingSources)
+	{
+		if (Pending.Family != FamilyIndex)
+		{
+			FamilyIndex = Pending.Family;
+			Line = nullptr;
+		}
+		if (!Line || Pending.Offset > Line->Offset + LineTolerance)
+		{
+			Line = &Families[FamilyIndex].Lines.AddDefaulted_GetRef();
+			Line->Offset = Pending.Offset;
+		}
+		Line->Sources.Add(MoveTemp(Pending.Source));
+	}
+	PendingSources.Empty();
+
+	for (FFamily& Family : Families)
+	{
+		for (FLine& Line : Family.Lines)
+		{
+			Line.Sources.StableSort([](const FSource& A, const FSource& B) { return A.T < B.T; });
+		}
+	}
+}
+
+void FRTPlanAlignmentIndex::AddPoint(const FVector2D& P, const FGuid& VertexId, const FGuid& WallId)
+{
+	AddSource(0, P | Families[0].Normal, P, VertexId, WallId);
+	AddSource(1, P | Families[1].Normal, P, VertexId, WallId);
+}
+
+void FRTPlanAlignmentIndex::RemovePoint(const FVector2D& P, const FGuid& VertexId, const FGuid& WallId)
+{
+	auto Matches = [&VertexId, &WallId](const FSource& Source)
+	{
+		return Source.VertexId == VertexId && Source.WallId == WallId;
+	};
+	RemoveSources(Families[0], P, Matches);
+	RemoveSources(Families[1], P, Matches);
+}
+
+void FRTPlanAlignmentIndex::AddExtension(const FVector2D& A, const FVector2D& B, const FGuid& VertexAId, const FGuid& VertexBId, const FGuid& WallId)
+{
+	const int32 FamilyIndex = FindExtensionFamily(A, B, true);
+	if (FamilyIndex == INDEX_NONE)
+	{
+		return;
+	}
+
+	// Walls in a family can be off its exact direction by up to half the bucket resolution, which moves B off
+	// A's line by Length * sin(dTheta): keep both endpoints on the line through A so they are removed together
+	const double Offset = A | Families[FamilyIndex].Normal;
+	AddSource(FamilyIndex, Offset, A, VertexAId, WallId);
+	AddSource(FamilyIndex, Offset, B, VertexBId, WallId);
+}
+
+void FRTPlanAlignmentIndex::RemoveExtension(const FVector2D& A, const FVector2D& B, const FGuid& WallId)
+{
+	const int32 FamilyIndex = FindExtensionFamily(A, B, false);
+	if (FamilyIndex == INDEX_NONE)
+	{
+		return;
+	}
+
+	// Both endpoint sources were added to the line through A
+	RemoveSources(Families[FamilyIndex], A, [&WallId](const FSource& Source) { return Source.WallId == WallId; });
+}
+
+void FRTPlanAlignmentIndex::QueryGuides(const FVector2D& Cursor, float Radius, TArray<FRTAlignmentGuide>& OutGuides) const
+{
+	OutGuides.Reset();
+
+	for (const FFamily& Family : Families)
+	{
+		if (Family.Lines.Num() == 0)
+		{
+			continue;
+		}
+
+		// Nearest line is one of the two around the cursor's offset
+		const double CursorOffset = Cursor | Family.Normal;
+		const int32 Upper = Algo::LowerBoundBy(Family.Lines, CursorOffset, &FLine::Offset);
+
+		const FLine* Best = nullptr;
+		double BestDistance = Radius;
+		for (int32 Index = Upper - 1; Index <= Upper; ++Index)
+		{
+			if (Family.Lines.IsValidIndex(Index))
+			{
+				const double Distance = FMath::Abs(Family.Lines[Index].Offset - CursorOffset);
+				if (Distance < BestDistance)
+				{
+					BestDistance = Distance;
+					Best = &Family.Lines[Index];
+				}
+			}
+		}
+
+		if (!Best)
+		{
+			continue;
+		}
+
+		// Nearest source along the line (what the HUD draws the guide from)
+		const double CursorT = Cursor | Family.Direction;
+		const int32 SourceUpper = Algo::LowerBoundBy(Best->Sources, CursorT, &FSource::T);
+		const int32 SourceIndex = (SourceUpper == Best->Sources.Num()
+			|| (SourceUpper > 0 && CursorT - Best->Sources[SourceUpper - 1].T < Best->Sources[SourceUpper].T - CursorT))
+			? SourceUpper - 1
+			: SourceUpper;
+		const FSource& Source = Best->Sources[SourceIndex];
+
+		FRTAlignmentGuide& Guide = OutGuides.AddDefaulted_GetRef();
+		Guide.Type = Family.Type;
+		Guide.Source = Source.Position;
+		Guide.Direction = Family.Direction;
+		Guide.SourceVertexId = Source.VertexId;
+		Guide.SourceWallId = Source.WallId;
+		Guide.Distance = (float)BestDistance;
+	}
+
+	OutGuides.Sort([](const FRTAlignmentGuide& A, const FRTAlignmentGuide& B) { return A.Distance < B.Distance; });
+}
+
+void FRTPlanAlignmentIndex::AddSource(int32 FamilyIndex, double Offset, const FVector2D& P, const FGuid& VertexId, const FGuid& WallId)
+{
+	FFamily& Family = Families[FamilyIndex];
+
+	FSource Source;
+	Source.T = P | Family.Direction;
+	Source.Position = P;
+	Source.VertexId = VertexId;
+	Source.WallId = WallId;
+
+	if (bBulkAdd)
+	{
+		PendingSources.Add({ FamilyIndex, Offset, Source });
+		return;
+	}
+
+	int32 LineIndex = Algo::LowerBoundBy(Family.Lines, Offset - LineTolerance, &FLine::Offset);
+	if (LineIndex == Family.Lines.Num() || Family.Lines[LineIndex].Offset > Offset + LineTolerance)
+	{
+		FLine NewLine;
+		NewLine.Offset = Offset;
+		Family.Lines.Insert(MoveTemp(NewLine), LineIndex);
+	}
+
+	FLine& Line = Family.Lines[LineIndex];
+	Line.Sources.Insert(Source, Algo::UpperBoundBy(Line.Sources, Source.T, &FSource::T));
+}
+
+template<typename PredicateType>
+void FRTPlanAlignmentIndex::RemoveSources(FFamily& Family, const FVector2D& P, PredicateType&& Predicate)
+{
+	ensureMsgf(PendingSources.Num() == 0, TEXT("Alignment sources removed during a bulk load"));
+
+	const double Offset = P | Family.Normal;
+
+	const int32 LineIndex = Algo::LowerBoundBy(Family.Lines, Offset - LineTolerance, &FLine::Offset);
+	if (LineIndex == Family.Lines.Num() || Family.Lines[LineIndex].Offset > Offset + LineTolerance)
+	{
+		return;
+	}
+
+	FLine& Line = Family.Lines[LineIndex];
+	Line.Sources.RemoveAll(Predicate);
+
+	if (Line.Sources.Num() == 0)
+	{
+		Family.Lines.RemoveAt(LineIndex);
+	}
+}
+
+int32 FRTPlanAlignmentIndex::FindExtensionFamily(const FVector2D& A, const FVector2D& B, bool bCreate)
+{
+	const FVector2D Dir = B - A;
+	if (Dir.IsNearlyZero())
+	{
+		return INDEX_NONE;
+	}
+
+	// Undirected angle in [0, 180)
+	double AngleDeg = FMath::RadiansToDegrees(FMath::Atan2(Dir.Y, Dir.X));
+	if (AngleDeg < 0.0)
+	{
+		AngleDeg += 180.0;
+	}
+
+	const int32 NumBuckets = FMath::RoundToInt32(180.0 / DirectionResolution);
+	const int32 Bucket = FMath::RoundToInt32(AngleDeg / DirectionResolution) % NumBuckets;
+	if (Bucket == 0 || Bucket == NumBuckets / 2)
+	{
+		return INDEX_NONE;
+	}
+
+	if (const int32* Existing = ExtensionFamilies.Find(Bucket))
+	{
+		return *Existing;
+	}
+	if (!bCreate)
+	{
+		return INDEX_NONE;
+	}
+
+	// The first wall of a direction defines the family's exact direction
+	const int32 FamilyIndex = Families.Num();
+	FFamily& Family = Families.AddDefaulted_GetRef();
+	Family.Type = ERTAlignmentGuideType::Extension;
+	Family.Direction = Dir.GetSafeNormal();
+	if (Family.Direction.Y < 0.0 || (Family.Direction.Y == 0.0 && Family.Direction.X < 0.0))
+	{
+		Family.Direction = -Family.Direction;
+	}
+	Family.Normal = FVector2D(-Family.Direction.Y, Family.Direction.X);
+
+	ExtensionFamilies.Add(Bucket, FamilyIndex);
+	return FamilyIndex;
+}
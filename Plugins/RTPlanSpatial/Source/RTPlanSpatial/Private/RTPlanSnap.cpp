@@ -0,0 +1,100 @@
+﻿#include "RTPlanSnap.h"
+
+const TCHAR* LexToString(ERTSnapType Type)
+{
+	switch (Type)
+	{
+	case ERTSnapType::Endpoint:      return TEXT("Endpoint");
+	case ERTSnapType::Midpoint:      return TEXT("Midpoint");
+	case ERTSnapType::Intersection:  return TEXT("Intersection");
+	case ERTSnapType::Perpendicular: return TEXT("Perpendicular");
+	case ERTSnapType::Projection:    return TEXT("Projection");
+	case ERTSnapType::Grid:          return TEXT("Grid");
+	case ERTSnapType::Alignment:     return TEXT("Alignment");
+	default:                         return TEXT("None");
+	}
+}
+
+void FRTSnapCandidates::Reset()
+{
+	FMemory::Memzero(Num, sizeof(Num));
+}
+
+void FRTSnapCandidates::Add(ERTSnapType Type, const FVector2D& Location, float Distance, const FGuid& WallId)
+{
+	const int32 Tier = TierIndex(Type);
+	if (Tier < 0 || Tier >= NumTiers)
+	{
+		return;
+	}
+
+	FRTSnapResult* Tiered = Results[Tier];
+	int32& Count = Num[Tier];
+
+	// Insertion into a small sorted array; equal distances keep the earlier candidate
+	int32 Slot = Count;
+	while (Slot > 0 && Distance < Tiered[Slot - 1].Distance)
+	{
+		--Slot;
+	}
+	if (Slot >= MaxPerTier)
+	{
+		return;
+	}
+
+	const int32 Last = FMath::Min(Count, MaxPerTier - 1);
+	for (int32 i = Last; i > Slot; --i)
+	{
+		Tiered[i] = Tiered[i - 1];
+	}
+
+	FRTSnapResult& Result = Tiered[Slot];
+	Result.bValid = true;
+	Result.Location = Location;
+	Result.Distance = Distance;
+	Result.Type = Type;
+	Result.WallId = WallId;
+
+	Count = FMath::Min(Count + 1, MaxPerTier);
+}
+
+TConstArrayView<FRTSnapResult> FRTSnapCandidates::Get(ERTSnapType Type) const
+{
+	const int32 Tier = TierIndex(Type);
+	if (Tier < 0 || Tier >= NumTiers)
+	{
+		return TConstArrayView<FRTSnapResult>();
+	}
+	return TConstArrayView<FRTSnapResult>(Results[Tier], Num[Tier]);
+}
+
+FRTSnapResult FRTSnapCandidates::GetBest() const
+{
+	const FRTSnapResult* Best = nullptr;
+
+	// Point-like snaps compete on distance
+	for (const ERTSnapType Type : { ERTSnapType::Endpoint, ERTSnapType::Midpoint, ERTSnapType::Intersection })
+	{
+		const int32 Tier = TierIndex(Type);
+		if (Num[Tier] > 0 && (!Best || Results[Tier][0].Distance < Best->Distance))
+		{
+			Best = &Results[Tier][0];
+		}
+	}
+
+	// Then edges, then the grid, in priority order
+	for (const ERTSnapType Type : { ERTSnapType::Perpendicular, ERTSnapType::Projection, ERTSnapType::Grid })
+	{
+		if (Best)
+		{
+			break;
+		}
+		const int32 Tier = TierIndex(Type);
+		if (Num[Tier] > 0)
+		{
+			Best = &Results[Tier][0];
+		}
+	}
+
+	return Best ? *Best : FRTSnapResult();
+}
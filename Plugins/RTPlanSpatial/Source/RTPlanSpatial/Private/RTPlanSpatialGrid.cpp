@@ -0,0 +1,139 @@
+﻿#include "RTPlanSpatialGrid.h"
+
+void FRTPlanSpatialGrid::Reset(float InCellSize)
+{
+	CellSize = FMath::Max(InCellSize, 1.0f);
+	InvCellSize = 1.0f / CellSize;
+	Cells.Reset();
+	VisitStamps.Reset();
+	CurrentStamp = 0;
+}
+
+void FRTPlanSpatialGrid::InsertPoint(int32 Item, const FVector2D& P)
+{
+	AddToCell(ToCell(P), Item);
+}
+
+template<typename FuncType>
+void FRTPlanSpatialGrid::ForEachSegmentCell(const FVector2D& A, const FVector2D& B, FuncType&& Func) const
+{
+	const FIntPoint CellA = ToCell(A);
+	const FIntPoint CellB = ToCell(B);
+
+	if (CellA == CellB)
+	{
+		Func(CellA);
+		return;
+	}
+
+	// Walk the rows the segment spans and visit the run of cells it covers in each row
+	const FVector2D Delta = B - A;
+	const int32 MinRow = FMath::Min(CellA.Y, CellB.Y);
+	const int32 MaxRow = FMath::Max(CellA.Y, CellB.Y);
+
+	for (int32 Row = MinRow; Row <= MaxRow; ++Row)
+	{
+		double X0, X1;
+		if (FMath::IsNearlyZero(Delta.Y))
+		{
+			X0 = A.X;
+			X1 = B.X;
+		}
+		else
+		{
+			// Clip the segment to this row's Y band
+			const double BandMin = Row * (double)CellSize;
+			const double BandMax = BandMin + CellSize;
+			const double T0 = FMath::Clamp((BandMin - A.Y) / Delta.Y, 0.0, 1.0);
+			const double T1 = FMath::Clamp((BandMax - A.Y) / Delta.Y, 0.0, 1.0);
+			X0 = A.X + Delta.X * T0;
+			X1 = A.X + Delta.X * T1;
+		}
+
+		const int32 ColA = FMath::FloorToInt32(FMath::Min(X0, X1) * InvCellSize);
+		const int32 ColB = FMath::FloorToInt32(FMath::Max(X0, X1) * InvCellSize);
+		for (int32 Col = ColA; Col <= ColB; ++Col)
+		{
+			Func(FIntPoint(Col, Row));
+		}
+	}
+}
+
+void FRTPlanSpatialGrid::InsertSegment(int32 Item, const FVector2D& A, const FVector2D& B)
+{
+	ForEachSegmentCell(A, B, [this, Item](const FIntPoint& Cell) { AddToCell(Cell, Item); });
+}
+
+void FRTPlanSpatialGrid::RemovePoint(int32 Item, const FVector2D& P)
+{
+	RemoveFromCell(ToCell(P), Item);
+}
+
+void FRTPlanSpatialGrid::RemoveSegment(int32 Item, const FVector2D& A, const FVector2D& B)
+{
+	// Same walk as InsertSegment, so the same cells are visited
+	ForEachSegmentCell(A, B, [this, Item](const FIntPoint& Cell) { RemoveFromCell(Cell, Item); });
+}
+
+template<typename FuncType>
+void FRTPlanSpatialGrid::ForEachBoxCell(const FBox2D& Box, FuncType&& Func) const
+{
+	const FIntPoint CellMin = ToCell(Box.Min);
+	const FIntPoint CellMax = ToCell(Box.Max);
+	for (int32 Y = CellMin.Y; Y <= CellMax.Y; ++Y)
+	{
+		for (int32 X = CellMin.X; X <= CellMax.X; ++X)
+		{
+			Func(FIntPoint(X, Y));
+		}
+	}
+}
+
+void FRTPlanSpatialGrid::InsertBox(int32 Item, const FBox2D& Box)
+{
+	ForEachBoxCell(Box, [this, Item](const FIntPoint& Cell) { AddToCell(Cell, Item); });
+}
+
+void FRTPlanSpatialGrid::RemoveBox(int32 Item, const FBox2D& Box)
+{
+	ForEachBoxCell(Box, [this, Item](const FIntPoint& Cell) { RemoveFromCell(Cell, Item); });
+}
+
+void FRTPlanSpatialGrid::AddToCell(const FIntPoint& Cell, int32 Item)
+{
+	TArray<int32>& Items = Cells.FindOrAdd(Cell);
+
+	// Row clipping can touch the same cell twice at band edges
+	if (Items.Num() == 0 || Items.Last() != Item)
+	{
+		Items.Add(Item);
+	}
+
+	if (Item >= VisitStamps.Num())
+	{
+		VisitStamps.SetNumZeroed(Item + 1);
+	}
+}
+
+void FRTPlanSpatialGrid::RemoveFromCell(const FIntPoint& Cell, int32 Item)
+{
+	if (TArray<int32>* Items = Cells.Find(Cell))
+	{
+		Items->RemoveSingleSwap(Item, EAllowShrinking::No);
+		if (Items->Num() == 0)
+		{
+			Cells.Remove(Cell);
+		}
+	}
+}
+
+uint32 FRTPlanSpatialGrid::NextStamp() const
+{
+	// On wrap-around clear the stamps so stale values can't match
+	if (++CurrentStamp == 0)
+	{
+		FMemory::Memzero(VisitStamps.GetData(), VisitStamps.Num() * sizeof(uint32));
+		CurrentStamp = 1;
+	}
+	return CurrentStamp;
+}
@@ -1,204 +1,1111 @@
 ﻿#include "RTPlanSpatialIndex.h"
 #include "RTPlanGeometryUtils.h"
+#include "RTPlanSegmentBatch.h"
+#include "RTPlanJunctionSolver.h"
 #include "DrawDebugHelpers.h"
 #include "Engine/World.h"
+#include "Algo/SortBy.h"
+
+namespace RTPlanSpatialIndexPrivate
+{
+	// Ray parameter where the ray crosses one boundary of a wall volume
+	struct FRayEvent
+	{
+		double T = 0.0;
+		FVector Normal = FVector::ZeroVector; // Zero: radial (arc wall faces), taken from the hit point
+	};
+
+	using FRayEventList = TArray<FRayEvent, TInlineAllocator<24>>;
+
+	// Crossing of the linear coordinate C0 + T * DC with Value, kept if in (0, MaxT)
+	void AddPlaneEvent(FRayEventList& Events, double C0, double DC, double Value, const FVector& Normal, double MaxT)
+	{
+		if (FMath::Abs(DC) > UE_DOUBLE_SMALL_NUMBER)
+		{
+			const double T = (Value - C0) / DC;
+			if (T > 0.0 && T < MaxT)
+			{
+				Events.Add({ T, Normal });
+			}
+		}
+	}
+
+	// Crossings of the 2D ray Origin + T * Direction with a circle
+	void AddCircleEvents(FRayEventList& Events, const FVector2D& Origin, const FVector2D& Direction, const FVector2D& Center, double Radius, double MaxT)
+	{
+		const FVector2D F = Origin - Center;
+		const double A = Direction | Direction;
+		const double B = 2.0 * (F | Direction);
+		const double C = (F | F) - Radius * Radius;
+		const double Discriminant = B * B - 4.0 * A * C;
+		if (A < UE_DOUBLE_SMALL_NUMBER || Radius <= 0.0 || Discriminant < 0.0)
+		{
+			return;
+		}
+
+		const double Root = FMath::Sqrt(Discriminant);
+		for (const double T : { (-B - Root) / (2.0 * A), (-B + Root) / (2.0 * A) })
+		{
+			if (T > 0.0 && T < MaxT)
+			{
+				Events.Add({ T, FVector::ZeroVector });
+			}
+		}
+	}
+
+	// Crossing of the 2D ray with the line through Center at AngleRadians
+	void AddRadialEvent(FRayEventList& Events, const FVector2D& Origin, const FVector2D& Direction, const FVector2D& Center, double AngleRadians, double MaxT)
+	{
+		const FVector2D L(FMath::Cos(AngleRadians), FMath::Sin(AngleRadians));
+		AddPlaneEvent(Events, FVector2D::CrossProduct(L, Origin - Center), FVector2D::CrossProduct(L, Direction), 0.0, FVector(-L.Y, L.X, 0.0), MaxT);
+	}
+
+	// Along-wall offset of a cut end face at distance N across the wall (left +, right -), as the mesher's sweep trims it
+	double GetEndTrim(double Left, double Right, double N, double HalfThickness)
+	{
+		return N >= 0.0 ? Left * (N / HalfThickness) : Right * (-N / HalfThickness);
+	}
+
+	// Frame a wall end's cut is measured in: the end point, the direction of travel A -> B there and its left.
+	// The mesher moves the end ring along this direction, which for arcs is the end tangent.
+	struct FWallEndFrame
+	{
+		FVector2D Point = FVector2D::ZeroVector;
+		FVector2D Along = FVector2D(1.0, 0.0);
+		FVector2D Left = FVector2D(0.0, 1.0);
+	};
+
+	FWallEndFrame GetArcEndFrame(const FRTPlanArc& Arc, bool bAtStart)
+	{
+		const double Angle = Arc.StartAngle + (bAtStart ? 0.0 : Arc.Sweep);
+		const FVector2D Radial(FMath::Cos(Angle), FMath::Sin(Angle));
+
+		FWallEndFrame Frame;
+		Frame.Point = Arc.Center + Radial * Arc.Radius;
+		Frame.Along = Arc.Sweep > 0.0 ? FVector2D(-Radial.Y, Radial.X) : FVector2D(Radial.Y, -Radial.X);
+		Frame.Left = FVector2D(-Frame.Along.Y, Frame.Along.X);
+		return Frame;
+	}
+
+	const FRTWall* ResolveDataWall(const FRTPlanData& Data, const FGuid& WallId, FVector2D& OutA, FVector2D& OutB)
+	{
+		const FRTWall* Wall = Data.Walls.Find(WallId);
+		const FRTVertex* VertexA = Wall ? Data.Vertices.Find(Wall->VertexAId) : nullptr;
+		const FRTVertex* VertexB = Wall ? Data.Vertices.Find(Wall->VertexBId) : nullptr;
+		if (!VertexA || !VertexB)
+		{
+			return nullptr;
+		}
+		OutA = VertexA->Position;
+		OutB = VertexB->Position;
+		return Wall;
+	}
+}
+
+void FRTPlanSpatialIndex::ResetStorage(float CellSize)
+{
+	SnapPoints.Empty();
+	SnapSegments.Empty();
+	SnapArcs.Empty();
+	FreePoints.Empty();
+	FreeSegments.Empty();
+	FreeArcs.Empty();
+	Openings.Empty();
+	FreeOpenings.Empty();
+	VertexPoints.Empty();
+	WallEntries.Empty();
+	OpeningEntries.Empty();
+	Alignment.Reset();
+
+	PointGrid.Reset(CellSize);
+	SegmentGrid.Reset(CellSize);
+	ArcGrid.Reset(CellSize);
+	OpeningGrid.Reset(CellSize);
+
+	WallVolumeBounds = FBox(ForceInit);
+	MaxWallReach = 0.0f;
+}
 
 void FRTPlanSpatialIndex::Build(const URTPlanDocument* Document)
 {
-	SnapPoints.Empty();
-	SnapSegments.Empty();
-	UniqueX.Empty();
-	UniqueY.Empty();
-	CachedDocument = Document;
+	CachedDocument = Document;
+	++Version;
+
+	if (!Document)
+	{
+		ResetStorage(MinCellSize);
+		return;
+	}
+
+	// Linear scans over the packed store
+	const FRTPlanDenseStore& Store = Document->GetDenseStore();
+	
+	UE_LOG(LogTemp, Verbose, TEXT("SpatialIndex::Build: %d vertices, %d walls"), Store.GetVertices().Num(), Store.GetWalls().Num());
+
+	// Cells around the typical wall length keep both the per-cell count and the cells per segment small
+	double TotalLength = 0.0;
+	int32 NumWalls = 0;
+	Store.ForEachWall([&TotalLength, &NumWalls](const FRTWall& Wall, const FVector2D& A, const FVector2D& B)
+	{
+		TotalLength += FVector2D::Distance(A, B);
+		++NumWalls;
+	});
+	const float CellSize = NumWalls > 0
+		? FMath::Clamp((float)(TotalLength / NumWalls), MinCellSize, MaxCellSize)
+		: MinCellSize;
+
+	ResetStorage(CellSize);
+
+	SnapPoints.Reserve(Store.GetVertices().Num() + Store.GetWalls().Num());
+	SnapSegments.Reserve(Store.GetWalls().Num());
+	VertexPoints.Reserve(Store.GetVertices().Num());
+	WallEntries.Reserve(Store.GetWalls().Num());
+
+	// Alignment guides are sorted once at the end rather than inserted one by one
+	Alignment.BeginBulkAdd();
+
+	// Collect Vertices (Endpoints)
+	for (const FRTVertex& Vertex : Store.GetVertices())
+	{
+		VertexPoints.Add(Vertex.Id, AddPoint(Vertex.Position, ERTSnapType::Endpoint, true, Vertex.Id, FGuid()));
+	}
+
+	// Collect Wall Midpoints and Segments, and cut them at their junctions
+	const FRTPlanData& Data = Document->GetData();
+	auto ResolveWall = [&Data](const FGuid& WallId, FVector2D& OutA, FVector2D& OutB)
+	{
+		return RTPlanSpatialIndexPrivate::ResolveDataWall(Data, WallId, OutA, OutB);
+	};
+	Store.ForEachWall([this, Document, &ResolveWall](const FRTWall& Wall, const FVector2D& A, const FVector2D& B)
+	{
+		FWallEntry& Entry = AddWallGeometry(Wall, A, B);
+		SolveWallEnds(Entry, Wall, A, B, Document->GetWallsAtVertex(Wall.VertexAId), Document->GetWallsAtVertex(Wall.VertexBId), ResolveWall);
+	});
+
+	Alignment.EndBulkAdd();
+
+	// Opening footprints (read their host wall back from the index)
+	Openings.Reserve(Data.Openings.Num());
+	for (const auto& Pair : Data.Openings)
+	{
+		UpdateOpening(Pair.Key);
+	}
+	
+	UE_LOG(LogTemp, Log, TEXT("SpatialIndex: Built with %d segments, %d arcs, %d openings"), GetNumSegments(), GetNumArcs(), GetNumOpenings());
+}
+
+void FRTPlanSpatialIndex::Build(const FRTPlanSnapshot& Snapshot)
+{
+	// Worker-safe: everything is read from the snapshot, nothing from the document
+	CachedDocument = nullptr;
+	++Version;
+
+	double TotalLength = 0.0;
+	int32 NumWalls = 0;
+	for (const auto& Pair : Snapshot.Walls)
+	{
+		const FRTVertex* VertexA = Snapshot.FindVertex(Pair.Value->VertexAId);
+		const FRTVertex* VertexB = Snapshot.FindVertex(Pair.Value->VertexBId);
+		if (VertexA && VertexB)
+		{
+			TotalLength += FVector2D::Distance(VertexA->Position, VertexB->Position);
+			++NumWalls;
+		}
+	}
+	const float CellSize = NumWalls > 0
+		? FMath::Clamp((float)(TotalLength / NumWalls), MinCellSize, MaxCellSize)
+		: MinCellSize;
+
+	ResetStorage(CellSize);
+
+	SnapPoints.Reserve(Snapshot.Vertices.Num() + Snapshot.Walls.Num());
+	SnapSegments.Reserve(Snapshot.Walls.Num());
+	VertexPoints.Reserve(Snapshot.Vertices.Num());
+	WallEntries.Reserve(Snapshot.Walls.Num());
+	Openings.Reserve(Snapshot.Openings.Num());
+
+	Alignment.BeginBulkAdd();
+
+	for (const auto& Pair : Snapshot.Vertices)
+	{
+		VertexPoints.Add(Pair.Key, AddPoint(Pair.Value->Position, ERTSnapType::Endpoint, true, Pair.Key, FGuid()));
+	}
+
+	// The snapshot has no reverse index: bucket the walls by vertex for the junction cuts
+	TMap<FGuid, TArray<FGuid, TInlineAllocator<4>>> WallsAtVertex;
+	WallsAtVertex.Reserve(Snapshot.Vertices.Num());
+	for (const auto& Pair : Snapshot.Walls)
+	{
+		const FRTWall& Wall = *Pair.Value;
+		WallsAtVertex.FindOrAdd(Wall.VertexAId).Add(Wall.Id);
+		if (Wall.VertexBId != Wall.VertexAId)
+		{
+			WallsAtVertex.FindOrAdd(Wall.VertexBId).Add(Wall.Id);
+		}
+	}
+	auto ResolveWall = [&Snapshot](const FGuid& WallId, FVector2D& OutA, FVector2D& OutB) -> const FRTWall*
+	{
+		const FRTWall* Wall = Snapshot.FindWall(WallId);
+		const FRTVertex* VertexA = Wall ? Snapshot.FindVertex(Wall->VertexAId) : nullptr;
+		const FRTVertex* VertexB = Wall ? Snapshot.FindVertex(Wall->VertexBId) : nullptr;
+		if (!VertexA || !VertexB)
+		{
+			return nullptr;
+		}
+		OutA = VertexA->Position;
+		OutB = VertexB->Position;
+		return Wall;
+	};
+
+	for (const auto& Pair : Snapshot.Walls)
+	{
+		const FRTWall& Wall = *Pair.Value;
+		const FRTVertex* VertexA = Snapshot.FindVertex(Wall.VertexAId);
+		const FRTVertex* VertexB = Snapshot.FindVertex(Wall.VertexBId);
+		if (VertexA && VertexB)
+		{
+			FWallEntry& Entry = AddWallGeometry(Wall, VertexA->Position, VertexB->Position);
+			SolveWallEnds(Entry, Wall, VertexA->Position, VertexB->Position,
+				WallsAtVertex.FindChecked(Wall.VertexAId), WallsAtVertex.FindChecked(Wall.VertexBId), ResolveWall);
+		}
+	}
+
+	Alignment.EndBulkAdd();
+
+	for (const auto& Pair : Snapshot.Openings)
+	{
+		const FRTOpening& Opening = *Pair.Value;
+		const FRTWall* Wall = Snapshot.FindWall(Opening.WallId);
+		FWallEntry* WallEntry = WallEntries.Find(Opening.WallId);
+		if (Wall && WallEntry)
+		{
+			AddOpening(Opening, *Wall, *WallEntry);
+		}
+	}
+
+	UE_LOG(LogTemp, Verbose, TEXT("SpatialIndex: Built revision %llu with %d segments, %d arcs, %d openings"),
+		Snapshot.Revision, GetNumSegments(), GetNumArcs(), GetNumOpenings());
+}
+
+void FRTPlanSpatialIndex::MoveFrom(FRTPlanSpatialIndex&& Other)
+{
+	const uint32 PreviousVersion = Version;
+	*this = MoveTemp(Other);
+
+	// Stay monotonic for this instance: caches keyed on (this, Version) must not match the new contents
+	Version = PreviousVersion + 1;
+}
+
+void FRTPlanSpatialIndex::ApplyDelta(const FRTPlanDelta& Delta)
+{
+	if (!CachedDocument || Delta.bFullRebuild)
+	{
+		Build(CachedDocument);
+		return;
+	}
+
+	for (const FGuid& WallId : Delta.Walls.Removed)
+	{
+		RemoveWall(WallId);
+	}
+
+	// Walls to re-index: edited walls plus every wall attached to a changed vertex (each once)
+	TSet<FGuid> DirtyWalls;
+	DirtyWalls.Append(Delta.Walls.Added);
+	DirtyWalls.Append(Delta.Walls.Modified);
+
+	auto UpdateVertices = [this, &DirtyWalls](const TSet<FGuid>& VertexIds)
+	{
+		for (const FGuid& VertexId : VertexIds)
+		{
+			UpdateVertexPoint(VertexId);
+			DirtyWalls.Append(CachedDocument->GetWallsAtVertex(VertexId));
+		}
+	};
+	UpdateVertices(Delta.Vertices.Added);
+	UpdateVertices(Delta.Vertices.Modified);
+	UpdateVertices(Delta.Vertices.Removed);
+
+	for (const FGuid& WallId : DirtyWalls)
+	{
+		AddWall(WallId);
+	}
+
+	// Openings edited on their own (walls re-indexed above already refreshed theirs)
+	for (const TSet<FGuid>* OpeningIds : { &Delta.Openings.Added, &Delta.Openings.Modified, &Delta.Openings.Removed })
+	{
+		for (const FGuid& OpeningId : *OpeningIds)
+		{
+			UpdateOpening(OpeningId);
+		}
+	}
+
+	UE_LOG(LogTemp, Verbose, TEXT("SpatialIndex: Updated %d walls, %d segments"), DirtyWalls.Num(), GetNumSegments());
+}
+
+void FRTPlanSpatialIndex::AddWall(const FGuid& WallId)
+{
+	RemoveWall(WallId);
+
+	if (!CachedDocument)
+	{
+		return;
+	}
+
+	const FRTPlanData& Data = CachedDocument->GetData();
+	const FRTWall* Wall = Data.Walls.Find(WallId);
+	if (!Wall)
+	{
+		return;
+	}
+
+	const FRTVertex* VertexA = Data.Vertices.Find(Wall->VertexAId);
+	const FRTVertex* VertexB = Data.Vertices.Find(Wall->VertexBId);
+	if (!VertexA || !VertexB)
+	{
+		return;
+	}
+
+	FWallEntry& Entry = AddWallGeometry(*Wall, VertexA->Position, VertexB->Position);
+	auto ResolveWall = [&Data](const FGuid& OtherId, FVector2D& OutA, FVector2D& OutB)
+	{
+		return RTPlanSpatialIndexPrivate::ResolveDataWall(Data, OtherId, OutA, OutB);
+	};
+	SolveWallEnds(Entry, *Wall, VertexA->Position, VertexB->Position,
+		CachedDocument->GetWallsAtVertex(Wall->VertexAId), CachedDocument->GetWallsAtVertex(Wall->VertexBId), ResolveWall);
+
+	for (const FGuid& OpeningId : CachedDocument->GetOpeningsOnWall(WallId))
+	{
+		if (const FRTOpening* Opening = Data.Openings.Find(OpeningId))
+		{
+			AddOpening(*Opening, *Wall, Entry);
+		}
+	}
+
+	// The walls it meets are cut against it now
+	UpdateJunctionEnds(Wall->VertexAId, WallId);
+	UpdateJunctionEnds(Wall->VertexBId, WallId);
+}
+
+void FRTPlanSpatialIndex::RemoveWall(const FGuid& WallId)
+{
+	FWallEntry Entry;
+	if (!WallEntries.RemoveAndCopyValue(WallId, Entry))
+	{
+		return;
+	}
+
+	if (Entry.bExtension)
+	{
+		const FSnapSegment& Seg = SnapSegments[Entry.Segments[0]];
+		Alignment.RemoveExtension(Seg.A, Seg.B, WallId);
+	}
+	if (Entry.MidPoint != INDEX_NONE)
+	{
+		RemovePoint(Entry.MidPoint);
+	}
+	if (Entry.Arc != INDEX_NONE)
+	{
+		RemoveArc(Entry.Arc);
+	}
+	for (const int32 Index : Entry.Segments)
+	{
+		RemoveSegment(Index);
+	}
+	for (const FGuid& OpeningId : Entry.Openings)
+	{
+		RemoveOpening(OpeningId);
+	}
+
+	UpdateJunctionEnds(Entry.VertexAId);
+	UpdateJunctionEnds(Entry.VertexBId);
+}
+
+void FRTPlanSpatialIndex::UpdateJunctionEnds(const FGuid& VertexId, const FGuid& SkipWallId)
+{
+	if (!CachedDocument || !VertexId.IsValid())
+	{
+		return;
+	}
+
+	const FRTPlanData& Data = CachedDocument->GetData();
+	auto ResolveWall = [&Data](const FGuid& WallId, FVector2D& OutA, FVector2D& OutB)
+	{
+		return RTPlanSpatialIndexPrivate::ResolveDataWall(Data, WallId, OutA, OutB);
+	};
+
+	for (const FGuid& WallId : CachedDocument->GetWallsAtVertex(VertexId))
+	{
+		FWallEntry* Entry = WallId != SkipWallId ? WallEntries.Find(WallId) : nullptr;
+		FVector2D A, B;
+		const FRTWall* Wall = Entry ? ResolveWall(WallId, A, B) : nullptr;
+		if (Wall)
+		{
+			SolveWallEnds(*Entry, *Wall, A, B, CachedDocument->GetWallsAtVertex(Wall->VertexAId), CachedDocument->GetWallsAtVertex(Wall->VertexBId), ResolveWall);
+		}
+	}
+}
+
+void FRTPlanSpatialIndex::SolveWallEnds(FWallEntry& Entry, const FRTWall& Wall, const FVector2D& A, const FVector2D& B,
+	TConstArrayView<FGuid> WallsAtA, TConstArrayView<FGuid> WallsAtB, FResolveWall ResolveWall)
+{
+	using namespace RTPlanSpatialIndexPrivate;
+
+	const FRTPlanArc* Arc = Entry.Arc != INDEX_NONE ? &SnapArcs[Entry.Arc].Arc : nullptr;
+	if (!Arc && Entry.Segments.Num() == 0)
+	{
+		return;
+	}
+
+	FRTPlanWallEnd Start, End;
+	FRTPlanJunctionSolver::SolveEnds(Wall, A, B, WallsAtA, WallsAtB, ResolveWall, Start, End);
+
+	// Same clamp as the mesher's sweep: never more than half the wall away from one end
+	const float HalfLength = (Arc ? Arc->GetLength() : FVector2D::Distance(A, B)) * 0.5f;
+	Entry.StartLeft = FMath::Clamp(Start.LeftOffset, -HalfLength, HalfLength);
+	Entry.StartRight = FMath::Clamp(Start.RightOffset, -HalfLength, HalfLength);
+	Entry.EndLeft = FMath::Clamp(End.LeftOffset, -HalfLength, HalfLength);
+	Entry.EndRight = FMath::Clamp(End.RightOffset, -HalfLength, HalfLength);
+
+	// Cut corners can reach past the ends of the centre line
+	const float MaxCut = FMath::Max(FMath::Max(FMath::Abs(Entry.StartLeft), FMath::Abs(Entry.StartRight)), FMath::Max(FMath::Abs(Entry.EndLeft), FMath::Abs(Entry.EndRight)));
+	MaxWallReach = FMath::Max(MaxWallReach, FMath::Sqrt(FMath::Square(Entry.HalfThickness) + FMath::Square(MaxCut)));
+
+	FWallEndFrame StartFrame, EndFrame;
+	if (Arc)
+	{
+		StartFrame = GetArcEndFrame(*Arc, true);
+		EndFrame = GetArcEndFrame(*Arc, false);
+	}
+	else
+	{
+		StartFrame.Point = A;
+		StartFrame.Along = (B - A).GetSafeNormal();
+		StartFrame.Left = FVector2D(-StartFrame.Along.Y, StartFrame.Along.X);
+		EndFrame = StartFrame;
+		EndFrame.Point = B;
+	}
+
+	FBox2D Footprint(ForceInit);
+	Footprint += StartFrame.Point + StartFrame.Left * Entry.HalfThickness + StartFrame.Along * Entry.StartLeft;
+	Footprint += StartFrame.Point - StartFrame.Left * Entry.HalfThickness + StartFrame.Along * Entry.StartRight;
+	Footprint += EndFrame.Point + EndFrame.Left * Entry.HalfThickness + EndFrame.Along * Entry.EndLeft;
+	Footprint += EndFrame.Point - EndFrame.Left * Entry.HalfThickness + EndFrame.Along * Entry.EndRight;
+	WallVolumeBounds += FBox(FVector(Footprint.Min, Entry.BaseZ), FVector(Footprint.Max, Entry.BaseZ + Entry.Height));
+}
+
+void FRTPlanSpatialIndex::UpdateVertex(const FGuid& VertexId)
+{
+	if (!CachedDocument)
+	{
+		return;
+	}
+
+	UpdateVertexPoint(VertexId);
+
+	for (const FGuid& WallId : CachedDocument->GetWallsAtVertex(VertexId))
+	{
+		AddWall(WallId);
+	}
+}
+
+void FRTPlanSpatialIndex::UpdateOpening(const FGuid& OpeningId)
+{
+	RemoveOpening(OpeningId);
+
+	if (!CachedDocument)
+	{
+		return;
+	}
+
+	const FRTPlanData& Data = CachedDocument->GetData();
+	const FRTOpening* Opening = Data.Openings.Find(OpeningId);
+	if (!Opening)
+	{
+		return;
+	}
+
+	// Host wall must be indexed (its geometry is read back from the index)
+	const FRTWall* Wall = Data.Walls.Find(Opening->WallId);
+	FWallEntry* WallEntry = WallEntries.Find(Opening->WallId);
+	if (Wall && WallEntry)
+	{
+		AddOpening(*Opening, *Wall, *WallEntry);
+	}
+}
+
+void FRTPlanSpatialIndex::UpdateVertexPoint(const FGuid& VertexId)
+{
+	int32 PointIndex = INDEX_NONE;
+	if (VertexPoints.RemoveAndCopyValue(VertexId, PointIndex))
+	{
+		RemovePoint(PointIndex);
+	}
+
+	if (const FRTVertex* Vertex = CachedDocument->GetData().Vertices.Find(VertexId))
+	{
+		VertexPoints.Add(VertexId, AddPoint(Vertex->Position, ERTSnapType::Endpoint, true, VertexId, FGuid()));
+	}
+}
+
+FRTPlanSpatialIndex::FWallEntry& FRTPlanSpatialIndex::AddWallGeometry(const FRTWall& Wall, const FVector2D& A, const FVector2D& B)
+{
+	FWallEntry& Entry = WallEntries.Add(Wall.Id);
+	Entry.HalfThickness = Wall.ThicknessCm * 0.5f;
+	Entry.BaseZ = Wall.BaseZCm;
+	Entry.Height = Wall.HeightCm;
+	Entry.VertexAId = Wall.VertexAId;
+	Entry.VertexBId = Wall.VertexBId;
+	MaxWallReach = FMath::Max(MaxWallReach, Entry.HalfThickness);
+
+	FBox2D Footprint(ForceInit);
+
+	// Arc walls are kept as exact arcs (one primitive, no tessellation)
+	if (Wall.bIsArc && FMath::Abs(Wall.ArcSweepAngle) > 0.1f)
+	{
+		const FRTPlanArc Arc = FRTPlanArc::FromCenterStartSweep(Wall.ArcCenter, A, Wall.ArcSweepAngle);
+
+		Entry.MidPoint = AddPoint(Arc.GetMidpoint(), ERTSnapType::Midpoint, false, FGuid(), Wall.Id);
+		Entry.Arc = AddArc(Arc, Wall.Id);
+		Footprint = Arc.GetBounds().ExpandBy(Entry.HalfThickness);
+		
+		UE_LOG(LogTemp, Verbose, TEXT("  Arc Wall %s: Center=(%0.1f,%0.1f), Radius=%0.1f, Sweep=%0.1f°"), 
+			*Wall.Id.ToString().Left(8), Wall.ArcCenter.X, Wall.ArcCenter.Y, Arc.Radius, Wall.ArcSweepAngle);
+	}
+	else
+	{
+		// Straight wall - add single segment
+		FVector2D Mid = (A + B) * 0.5f;
+		Entry.MidPoint = AddPoint(Mid, ERTSnapType::Midpoint, true, FGuid(), Wall.Id);
+		Entry.Segments.Add(AddSegment(A, B, Wall.Id));
+
+		Alignment.AddExtension(A, B, Wall.VertexAId, Wall.VertexBId, Wall.Id);
+		Entry.bExtension = true;
+
+		// Square ends; junction cuts grow the bounds once solved (SolveWallEnds)
+		Footprint += A;
+		Footprint += B;
+		Footprint = Footprint.ExpandBy(Entry.HalfThickness);
+		
+		UE_LOG(LogTemp, Verbose, TEXT("  Wall %s: (%0.1f,%0.1f)->(%0.1f,%0.1f)"), 
+			*Wall.Id.ToString().Left(8), A.X, A.Y, B.X, B.Y);
+	}
+
+	WallVolumeBounds += FBox(FVector(Footprint.Min, Wall.BaseZCm), FVector(Footprint.Max, Wall.BaseZCm + Wall.HeightCm));
+	return Entry;
+}
+
+int32 FRTPlanSpatialIndex::AddPoint(const FVector2D& Position, ERTSnapType Type, bool bAlignment, const FGuid& VertexId, const FGuid& WallId)
+{
+	++Version;
+	const int32 Index = FreePoints.Num() > 0 ? FreePoints.Pop(EAllowShrinking::No) : SnapPoints.AddDefaulted();
+
+	FSnapPoint& Point = SnapPoints[Index];
+	Point.Position = Position;
+	Point.Type = Type;
+	Point.bAlignment = bAlignment;
+	Point.VertexId = VertexId;
+	Point.WallId = WallId;
+	PointGrid.InsertPoint(Index, Position);
+
+	if (bAlignment)
+	{
+		Alignment.AddPoint(Position, VertexId, WallId);
+	}
+	return Index;
+}
+
+void FRTPlanSpatialIndex::RemovePoint(int32 Index)
+{
+	++Version;
+	FSnapPoint& Point = SnapPoints[Index];
+	PointGrid.RemovePoint(Index, Point.Position);
+
+	if (Point.bAlignment)
+	{
+		Alignment.RemovePoint(Point.Position, Point.VertexId, Point.WallId);
+		Point.bAlignment = false;
+	}
+
+	FreePoints.Add(Index);
+}
+
+int32 FRTPlanSpatialIndex::AddSegment(const FVector2D& A, const FVector2D& B, const FGuid& WallId)
+{
+	++Version;
+	const int32 Index = FreeSegments.Num() > 0 ? FreeSegments.Pop(EAllowShrinking::No) : SnapSegments.AddDefaulted();
+
+	FSnapSegment& Seg = SnapSegments[Index];
+	Seg.A = A;
+	Seg.B = B;
+	Seg.WallId = WallId;
+	SegmentGrid.InsertSegment(Index, A, B);
+	return Index;
+}
+
+void FRTPlanSpatialIndex::RemoveSegment(int32 Index)
+{
+	++Version;
+	FSnapSegment& Seg = SnapSegments[Index];
+	SegmentGrid.RemoveSegment(Index, Seg.A, Seg.B);
+	Seg.WallId.Invalidate();
+	FreeSegments.Add(Index);
+}
+
+int32 FRTPlanSpatialIndex::AddArc(const FRTPlanArc& Arc, const FGuid& WallId)
+{
+	++Version;
+	const int32 Index = FreeArcs.Num() > 0 ? FreeArcs.Pop(EAllowShrinking::No) : SnapArcs.AddDefaulted();
+
+	FSnapArc& Entry = SnapArcs[Index];
+	Entry.Arc = Arc;
+	Entry.Bounds = Arc.GetBounds();
+	Entry.WallId = WallId;
+	ArcGrid.InsertBox(Index, Entry.Bounds);
+	return Index;
+}
+
+void FRTPlanSpatialIndex::RemoveArc(int32 Index)
+{
+	++Version;
+	FSnapArc& Entry = SnapArcs[Index];
+	ArcGrid.RemoveBox(Index, Entry.Bounds);
+	Entry.WallId.Invalidate();
+	FreeArcs.Add(Index);
+}
+
+void FRTPlanSpatialIndex::AddOpening(const FRTOpening& Opening, const FRTWall& Wall, FWallEntry& WallEntry)
+{
+	FOpeningFootprint Footprint;
+	Footprint.OpeningId = Opening.Id;
+	Footprint.WallId = Wall.Id;
+	Footprint.HalfThickness = Wall.ThicknessCm * 0.5f;
+
+	// Hole height: sill to head above the wall base, clamped to the wall
+	Footprint.ZMin = Wall.BaseZCm + FMath::Clamp(Opening.SillHeightCm, 0.0f, Wall.HeightCm);
+	Footprint.ZMax = Wall.BaseZCm + FMath::Clamp(Opening.SillHeightCm + Opening.HeightCm, 0.0f, Wall.HeightCm);
+
+	// Same span as the wall mesh cut (FRTPlanOpeningUtils::ComputeSolidIntervals): clamped to the wall
+	auto ClampSpan = [&Opening](double WallLength, double& OutStart, double& OutEnd)
+	{
+		OutStart = FMath::Clamp((double)Opening.OffsetCm, 0.0, WallLength);
+		OutEnd = FMath::Clamp((double)(Opening.OffsetCm + Opening.WidthCm), 0.0, WallLength);
+		return OutEnd >= OutStart;
+	};
+
+	double Start = 0.0;
+	double End = 0.0;
+	if (WallEntry.Arc != INDEX_NONE)
+	{
+		const FRTPlanArc& WallArc = SnapArcs[WallEntry.Arc].Arc;
+		if (WallArc.Radius <= UE_DOUBLE_KINDA_SMALL_NUMBER || !ClampSpan(WallArc.GetLength(), Start, End))
+		{
+			return;
+		}
+
+		const double Sign = WallArc.Sweep >= 0.0 ? 1.0 : -1.0;
+		Footprint.bArc = true;
+		Footprint.Arc.Center = WallArc.Center;
+		Footprint.Arc.Radius = WallArc.Radius;
+		Footprint.Arc.StartAngle = WallArc.StartAngle + Sign * Start / WallArc.Radius;
+		Footprint.Arc.Sweep = Sign * (End - Start) / WallArc.Radius;
+		Footprint.Center = Footprint.Arc.GetMidpoint();
+		Footprint.Bounds = Footprint.Arc.GetBounds().ExpandBy(Footprint.HalfThickness);
+	}
+	else if (WallEntry.Segments.Num() > 0)
+	{
+		const FSnapSegment& Seg = SnapSegments[WallEntry.Segments[0]];
+		const FVector2D Dir = (Seg.B - Seg.A).GetSafeNormal();
+		if (Dir.IsZero() || !ClampSpan(FVector2D::Distance(Seg.A, Seg.B), Start, End))
+		{
+			return;
+		}
+
+		Footprint.Axis = Dir;
+		Footprint.HalfLength = (float)((End - Start) * 0.5);
+		Footprint.Center = Seg.A + Dir * ((Start + End) * 0.5);
+
+		const FVector2D U = Dir * Footprint.HalfLength;
+		const FVector2D V = FVector2D(-Dir.Y, Dir.X) * Footprint.HalfThickness;
+		Footprint.Bounds = FBox2D(ForceInit);
+		Footprint.Bounds += Footprint.Center + U + V;
+		Footprint.Bounds += Footprint.Center + U - V;
+		Footprint.Bounds += Footprint.Center - U + V;
+		Footprint.Bounds += Footprint.Center - U - V;
+	}
+	else
+	{
+		return;
+	}
+
+	const int32 Index = FreeOpenings.Num() > 0 ? FreeOpenings.Pop(EAllowShrinking::No) : Openings.AddDefaulted();
+	Openings[Index] = Footprint;
+	OpeningGrid.InsertBox(Index, Footprint.Bounds);
+	OpeningEntries.Add(Opening.Id, Index);
+	WallEntry.Openings.Add(Opening.Id);
+}
+
+void FRTPlanSpatialIndex::RemoveOpening(const FGuid& OpeningId)
+{
+	int32 Index = INDEX_NONE;
+	if (!OpeningEntries.RemoveAndCopyValue(OpeningId, Index))
+	{
+		return;
+	}
+
+	FOpeningFootprint& Footprint = Openings[Index];
+	OpeningGrid.RemoveBox(Index, Footprint.Bounds);
+
+	// Host entry is gone already when the whole wall is being removed
+	if (FWallEntry* WallEntry = WallEntries.Find(Footprint.WallId))
+	{
+		WallEntry->Openings.RemoveSingleSwap(OpeningId, EAllowShrinking::No);
+	}
+
+	Footprint.OpeningId.Invalidate();
+	Footprint.WallId.Invalidate();
+	FreeOpenings.Add(Index);
+}
+
+double FRTPlanSpatialIndex::FOpeningFootprint::Distance(const FVector2D& P) const
+{
+	if (bArc)
+	{
+		return FMath::Max(Arc.Distance(P) - HalfThickness, 0.0);
+	}
+
+	// Distance to an oriented rectangle (0 inside)
+	const FVector2D Local = P - Center;
+	const double DU = FMath::Max(FMath::Abs(Local | Axis) - HalfLength, 0.0);
+	const double DV = FMath::Max(FMath::Abs(Local | FVector2D(-Axis.Y, Axis.X)) - HalfThickness, 0.0);
+	return FMath::Sqrt(DU * DU + DV * DV);
+}
+
+bool FRTPlanSpatialIndex::FOpeningFootprint::IntersectsRect(const FVector2D& RectMin, const FVector2D& RectMax) const
+{
+	if (!Bounds.Intersect(FBox2D(RectMin, RectMax)))
+	{
+		return false;
+	}
+
+	if (bArc)
+	{
+		// Center arc against the rect grown by the half thickness
+		const FVector2D Grow(HalfThickness, HalfThickness);
+		return Arc.IntersectsRect(RectMin - Grow, RectMax + Grow);
+	}
+
+	// Separating axis test: the rect's axes are covered by the bounds check above,
+	// remaining candidates are the footprint's own axes
+	const FVector2D RectCenter = (RectMin + RectMax) * 0.5;
+	const FVector2D RectHalf = (RectMax - RectMin) * 0.5;
+	const FVector2D Delta = RectCenter - Center;
+	const FVector2D Perp(-Axis.Y, Axis.X);
+
+	const double RectOnAxis = RectHalf.X * FMath::Abs(Axis.X) + RectHalf.Y * FMath::Abs(Axis.Y);
+	if (FMath::Abs(Delta | Axis) > HalfLength + RectOnAxis)
+	{
+		return false;
+	}
+
+	const double RectOnPerp = RectHalf.X * FMath::Abs(Perp.X) + RectHalf.Y * FMath::Abs(Perp.Y);
+	return FMath::Abs(Delta | Perp) <= HalfThickness + RectOnPerp;
+}
+
+FRTSnapResult FRTPlanSpatialIndex::QuerySnap(const FVector2D& CursorPos, float Radius) const
+{
+	FRTSnapQuery Query;
+	Query.Cursor = CursorPos;
+	Query.Radius = Radius;
 
-	if (!Document)
+	FRTSnapCandidates Candidates;
+	QuerySnapCandidates(Query, Candidates);
+	return Candidates.GetBest();
+}
+
+void FRTPlanSpatialIndex::QuerySnapCandidates(const FRTSnapQuery& Query, FRTSnapCandidates& OutCandidates, FRTSnapQueryCache* Cache) const
+{
+	OutCandidates.Reset();
+
+	if (Query.GridSize > 0.0f)
+	{
+		const FVector2D GridPos(
+			FMath::RoundToDouble(Query.Cursor.X / Query.GridSize) * Query.GridSize,
+			FMath::RoundToDouble(Query.Cursor.Y / Query.GridSize) * Query.GridSize);
+		OutCandidates.Add(ERTSnapType::Grid, GridPos, FVector2D::Distance(Query.Cursor, GridPos));
+	}
+
+	// Temporal coherence: the cursor is still inside the area gathered by a previous query
+	if (Cache && Cache->Index == this && Cache->IndexVersion == Version
+		&& FVector2D::Distance(Query.Cursor, Cache->Center) + Query.Radius <= Cache->GatherRadius)
 	{
+		++Cache->NumReused;
+		ScoreSnapCandidates(Query, Cache->Points, Cache->Segments, Cache->Arcs, OutCandidates);
 		return;
 	}
 
-	const FRTPlanData& Data = Document->GetData();
-	
-	UE_LOG(LogTemp, Verbose, TEXT("SpatialIndex::Build: %d vertices, %d walls"), Data.Vertices.Num(), Data.Walls.Num());
+	// Gather from the grids (over an enlarged area when caching)
+	const float GatherRadius = Cache ? Query.Radius * FRTSnapQueryCache::GatherScale : Query.Radius;
+	const FVector2D GatherMin = Query.Cursor - FVector2D(GatherRadius, GatherRadius);
+	const FVector2D GatherMax = Query.Cursor + FVector2D(GatherRadius, GatherRadius);
 
-	// Collect Vertices (Endpoints)
-	for (const auto& Pair : Data.Vertices)
+	auto GatherAndScore = [&](auto& Points, auto& Segments, auto& Arcs)
 	{
-		FVector2D Pos = Pair.Value.Position;
-		SnapPoints.Add({ Pos, TEXT("Endpoint") });
-		
-		UniqueX.AddUnique(Pos.X);
-		UniqueY.AddUnique(Pos.Y);
-	}
+		Points.Reset();
+		Segments.Reset();
+		Arcs.Reset();
+
+		PointGrid.Query(GatherMin, GatherMax, [&Points](int32 Index) { Points.Add(Index); });
+		SegmentGrid.Query(GatherMin, GatherMax, [&Segments](int32 Index) { Segments.Add(Index); });
+		ArcGrid.Query(GatherMin, GatherMax, [&Arcs](int32 Index) { Arcs.Add(Index); });
+
+		// Index order keeps tie-breaking independent of grid visit order
+		Points.Sort();
+		Segments.Sort();
+		Arcs.Sort();
+
+		ScoreSnapCandidates(Query, Points, Segments, Arcs, OutCandidates);
+	};
 
-	// Collect Wall Midpoints and Segments
-	for (const auto& Pair : Data.Walls)
+	if (Cache)
 	{
-		const FRTWall& Wall = Pair.Value;
-		if (Data.Vertices.Contains(Wall.VertexAId) && Data.Vertices.Contains(Wall.VertexBId))
-		{
-			FVector2D A = Data.Vertices[Wall.VertexAId].Position;
-			FVector2D B = Data.Vertices[Wall.VertexBId].Position;
+		++Cache->NumGathered;
+		Cache->Index = this;
+		Cache->IndexVersion = Version;
+		Cache->Center = Query.Cursor;
+		Cache->GatherRadius = GatherRadius;
 
-			// Handle arc walls differently - add segments along the curve
-			if (Wall.bIsArc && FMath::Abs(Wall.ArcSweepAngle) > 0.1f)
-			{
-				// Calculate arc parameters
-				float CenterRadius = FVector2D::Distance(Wall.ArcCenter, A);
-				FVector2D ToStart = A - Wall.ArcCenter;
-				float StartAngleRad = FMath::Atan2(ToStart.Y, ToStart.X);
-				float SweepRad = FMath::DegreesToRadians(Wall.ArcSweepAngle);
-				
-				// Use enough segments for accurate hit testing (at least 1 per 15 degrees)
-				int32 NumSegments = FMath::Max(8, FMath::CeilToInt(FMath::Abs(Wall.ArcSweepAngle) / 15.0f));
-				float StepAngle = SweepRad / (float)NumSegments;
-				
-				// Add midpoint of the arc
-				float MidAngle = StartAngleRad + SweepRad * 0.5f;
-				FVector2D ArcMid = Wall.ArcCenter + FVector2D(FMath::Cos(MidAngle), FMath::Sin(MidAngle)) * CenterRadius;
-				SnapPoints.Add({ ArcMid, TEXT("Arc Midpoint") });
-				
-				// Add segments along the arc
-				for (int32 i = 0; i < NumSegments; ++i)
-				{
-					float Angle0 = StartAngleRad + StepAngle * i;
-					float Angle1 = StartAngleRad + StepAngle * (i + 1);
-					
-					FVector2D P0 = Wall.ArcCenter + FVector2D(FMath::Cos(Angle0), FMath::Sin(Angle0)) * CenterRadius;
-					FVector2D P1 = Wall.ArcCenter + FVector2D(FMath::Cos(Angle1), FMath::Sin(Angle1)) * CenterRadius;
-					
-					FSnapSegment Seg;
-					Seg.A = P0;
-					Seg.B = P1;
-					Seg.WallId = Wall.Id;
-					SnapSegments.Add(Seg);
-				}
-				
-				UE_LOG(LogTemp, Verbose, TEXT("  Arc Wall %s: Center=(%0.1f,%0.1f), Sweep=%0.1f°, %d segments"), 
-					*Wall.Id.ToString().Left(8), Wall.ArcCenter.X, Wall.ArcCenter.Y, Wall.ArcSweepAngle, NumSegments);
-			}
-			else
-			{
-				// Straight wall - add single segment
-				FVector2D Mid = (A + B) * 0.5f;
-				SnapPoints.Add({ Mid, TEXT("Midpoint") });
-				
-				UniqueX.AddUnique(Mid.X);
-				UniqueY.AddUnique(Mid.Y);
-
-				FSnapSegment Seg;
-				Seg.A = A;
-				Seg.B = B;
-				Seg.WallId = Wall.Id;
-				SnapSegments.Add(Seg);
-				
-				UE_LOG(LogTemp, Verbose, TEXT("  Wall %s: (%0.1f,%0.1f)->(%0.1f,%0.1f)"), 
-					*Wall.Id.ToString().Left(8), A.X, A.Y, B.X, B.Y);
-			}
-		}
+		// Persistent arrays: no allocation once they have reached the densest area visited
+		GatherAndScore(Cache->Points, Cache->Segments, Cache->Arcs);
+	}
+	else
+	{
+		// One-off query: stack storage, spills to the heap only in unusually dense areas.
+		// Repeated queries (cursor snapping) should pass a cache instead.
+		TArray<int32, TInlineAllocator<64>> Points;
+		TArray<int32, TInlineAllocator<64>> Segments;
+		TArray<int32, TInlineAllocator<16>> Arcs;
+		GatherAndScore(Points, Segments, Arcs);
 	}
-	
-	UE_LOG(LogTemp, Log, TEXT("SpatialIndex: Built with %d segments"), SnapSegments.Num());
 }
 
-FRTSnapResult FRTPlanSpatialIndex::QuerySnap(const FVector2D& CursorPos, float Radius) const
+template<typename PointListType, typename SegmentListType, typename ArcListType>
+void FRTPlanSpatialIndex::ScoreSnapCandidates(const FRTSnapQuery& Query, const PointListType& Points, const SegmentListType& Segments, const ArcListType& Arcs, FRTSnapCandidates& OutCandidates) const
 {
-	FRTSnapResult BestResult;
-	BestResult.Distance = Radius; // Initial threshold
+	const FVector2D& Cursor = Query.Cursor;
+	const float Radius = Query.Radius;
 
-	// 1. Check Points (Endpoints, Midpoints) - High Priority
-	for (const FSnapPoint& Pt : SnapPoints)
+	// 1. Points (endpoints, midpoints)
+	for (const int32 Index : Points)
 	{
-		float Dist = FVector2D::Distance(CursorPos, Pt.Position);
-		if (Dist < BestResult.Distance)
+		const FSnapPoint& Pt = SnapPoints[Index];
+		const float Dist = FVector2D::Distance(Cursor, Pt.Position);
+		if (Dist <= Radius)
 		{
-			BestResult.bValid = true;
-			BestResult.Distance = Dist;
-			BestResult.Location = Pt.Position;
-			BestResult.DebugType = Pt.Type;
+			OutCandidates.Add(Pt.Type, Pt.Position, Dist, Pt.WallId);
 		}
 	}
 
-	// If we found a point snap, return it (priority over edges)
-	if (BestResult.bValid)
+	// 2. Segments: projection, perpendicular foot from Query.From
+	// Segments within reach are remembered for the intersection pass (fixed storage; extras are skipped)
+	constexpr int32 MaxNearSegments = 16;
+	int32 NearSegments[MaxNearSegments];
+	int32 NumNearSegments = 0;
+
+	for (const int32 Index : Segments)
 	{
-		return BestResult;
+		const FSnapSegment& Seg = SnapSegments[Index];
+		const FVector2D Projected = FRTPlanGeometryUtils::ClosestPointOnSegment(Cursor, Seg.A, Seg.B);
+		const float Dist = FVector2D::Distance(Cursor, Projected);
+		if (Dist > Radius)
+		{
+			continue;
+		}
+
+		OutCandidates.Add(ERTSnapType::Projection, Projected, Dist, Seg.WallId);
+
+		if (NumNearSegments < MaxNearSegments)
+		{
+			NearSegments[NumNearSegments++] = Index;
+		}
+
+		if (Query.From.IsSet())
+		{
+			const FVector2D AB = Seg.B - Seg.A;
+			const double LengthSq = AB.SizeSquared();
+			if (LengthSq > UE_DOUBLE_SMALL_NUMBER)
+			{
+				const double T = ((Query.From.GetValue() - Seg.A) | AB) / LengthSq;
+				if (T >= 0.0 && T <= 1.0)
+				{
+					const FVector2D Foot = Seg.A + AB * T;
+					const float FootDist = FVector2D::Distance(Cursor, Foot);
+					if (FootDist <= Radius)
+					{
+						OutCandidates.Add(ERTSnapType::Perpendicular, Foot, FootDist, Seg.WallId);
+					}
+				}
+			}
+		}
 	}
 
-	// 2. Check Segments (Projection) - Lower Priority
-	for (const FSnapSegment& Seg : SnapSegments)
+	// 3. Arcs: exact projection, perpendicular feet (on the line through the center and From)
+	for (const int32 Index : Arcs)
 	{
-		FVector2D Projected = FRTPlanGeometryUtils::ClosestPointOnSegment(CursorPos, Seg.A, Seg.B);
-		float Dist = FVector2D::Distance(CursorPos, Projected);
+		const FSnapArc& Entry = SnapArcs[Index];
+		const FVector2D Projected = Entry.Arc.ClosestPoint(Cursor);
+		const float Dist = FVector2D::Distance(Cursor, Projected);
+		if (Dist > Radius)
+		{
+			continue;
+		}
+
+		OutCandidates.Add(ERTSnapType::Projection, Projected, Dist, Entry.WallId);
 
-		if (Dist < BestResult.Distance)
+		if (Query.From.IsSet())
 		{
-			BestResult.bValid = true;
-			BestResult.Distance = Dist;
-			BestResult.Location = Projected;
-			BestResult.DebugType = TEXT("Projection");
+			const FVector2D ToFrom = Query.From.GetValue() - Entry.Arc.Center;
+			if (!ToFrom.IsNearlyZero())
+			{
+				const FVector2D Dir = ToFrom.GetSafeNormal();
+				for (const double Sign : { 1.0, -1.0 })
+				{
+					const FVector2D Foot = Entry.Arc.Center + Dir * (Entry.Arc.Radius * Sign);
+					const FVector2D ToFoot = Foot - Entry.Arc.Center;
+					const float FootDist = FVector2D::Distance(Cursor, Foot);
+					if (FootDist <= Radius && Entry.Arc.ContainsAngle(FMath::Atan2(ToFoot.Y, ToFoot.X)))
+					{
+						OutCandidates.Add(ERTSnapType::Perpendicular, Foot, FootDist, Entry.WallId);
+					}
+				}
+			}
+		}
+
+		// Segment / arc crossings
+		for (int32 i = 0; i < NumNearSegments; ++i)
+		{
+			const FSnapSegment& Seg = SnapSegments[NearSegments[i]];
+			FVector2D Hits[2];
+			const int32 NumHits = Entry.Arc.IntersectSegment(Seg.A, Seg.B, Hits);
+			for (int32 h = 0; h < NumHits; ++h)
+			{
+				const float HitDist = FVector2D::Distance(Cursor, Hits[h]);
+				if (HitDist <= Radius && Seg.WallId != Entry.WallId)
+				{
+					OutCandidates.Add(ERTSnapType::Intersection, Hits[h], HitDist, Seg.WallId);
+				}
+			}
 		}
 	}
 
-	return BestResult;
+	// 4. Segment / segment crossings among the segments within reach
+	for (int32 i = 0; i < NumNearSegments; ++i)
+	{
+		const FSnapSegment& SegA = SnapSegments[NearSegments[i]];
+		for (int32 j = i + 1; j < NumNearSegments; ++j)
+		{
+			const FSnapSegment& SegB = SnapSegments[NearSegments[j]];
+			if (SegA.WallId == SegB.WallId)
+			{
+				continue;
+			}
+
+			FVector2D Hit;
+			if (!FRTPlanGeometryUtils::SegmentIntersection(SegA.A, SegA.B, SegB.A, SegB.B, Hit))
+			{
+				continue;
+			}
+
+			// Walls meeting at a shared vertex: already an endpoint snap
+			const bool bSharedEndpoint = (Hit.Equals(SegA.A, 0.01) || Hit.Equals(SegA.B, 0.01))
+				&& (Hit.Equals(SegB.A, 0.01) || Hit.Equals(SegB.B, 0.01));
+			const float HitDist = FVector2D::Distance(Cursor, Hit);
+			if (!bSharedEndpoint && HitDist <= Radius)
+			{
+				OutCandidates.Add(ERTSnapType::Intersection, Hit, HitDist, SegA.WallId);
+			}
+		}
+	}
 }
 
-bool FRTPlanSpatialIndex::QueryAlignment(const FVector2D& CursorPos, float Radius, FVector2D& OutAlignedPos) const
+bool FRTPlanSpatialIndex::QueryAlignment(const FVector2D& CursorPos, float Radius, FVector2D& OutAlignedPos, TArray<FRTAlignmentGuide>* OutGuides) const
 {
 	OutAlignedPos = CursorPos;
-	bool bAligned = false;
+	if (OutGuides)
+	{
+		OutGuides->Reset();
+	}
 
-	// Check X Alignment (Vertical Guide)
-	float BestDistX = Radius;
-	for (float X : UniqueX)
+	// Nearest guide per family, closest first
+	TArray<FRTAlignmentGuide> Guides;
+	Alignment.QueryGuides(CursorPos, Radius, Guides);
+	if (Guides.Num() == 0)
 	{
-		float Dist = FMath::Abs(CursorPos.X - X);
-		if (Dist < BestDistX)
-		{
-			OutAlignedPos.X = X;
-			BestDistX = Dist;
-			bAligned = true;
-		}
+		return false;
 	}
 
-	// Check Y Alignment (Horizontal Guide)
-	float BestDistY = Radius;
-	for (float Y : UniqueY)
+	// Prefer the crossing of the two nearest non-parallel guides (e.g. matching both X and Y)
+	for (int32 i = 1; i < Guides.Num(); ++i)
 	{
-		float Dist = FMath::Abs(CursorPos.Y - Y);
-		if (Dist < BestDistY)
+		FVector2D Crossing;
+		if (FRTAlignmentGuide::Intersect(Guides[0], Guides[i], Crossing)
+			&& FVector2D::Distance(Crossing, CursorPos) <= Radius * UE_SQRT_2)
 		{
-			OutAlignedPos.Y = Y;
-			BestDistY = Dist;
-			bAligned = true;
+			OutAlignedPos = Crossing;
+			if (OutGuides)
+			{
+				OutGuides->Add(Guides[0]);
+				OutGuides->Add(Guides[i]);
+			}
+			return true;
 		}
 	}
 
-	return bAligned;
+	OutAlignedPos = Guides[0].Project(CursorPos);
+	if (OutGuides)
+	{
+		OutGuides->Add(Guides[0]);
+	}
+	return true;
 }
 
 FGuid FRTPlanSpatialIndex::HitTestWall(const FVector2D& Point, float Tolerance) const
 {
 	FGuid BestWallId;
 	float BestDistance = Tolerance;
+	int32 BestIndex = INDEX_NONE;
 
 	UE_LOG(LogTemp, Verbose, TEXT("HitTestWall: Point=(%0.1f, %0.1f), Tolerance=%0.1f, NumSegments=%d"),
-		Point.X, Point.Y, Tolerance, SnapSegments.Num());
+		Point.X, Point.Y, Tolerance, GetNumSegments());
 
-	for (const FSnapSegment& Seg : SnapSegments)
+	SegmentGrid.Query(Point - FVector2D(Tolerance, Tolerance), Point + FVector2D(Tolerance, Tolerance), [&](int32 Index)
 	{
+		const FSnapSegment& Seg = SnapSegments[Index];
 		FVector2D Closest = FRTPlanGeometryUtils::ClosestPointOnSegment(Point, Seg.A, Seg.B);
 		float Dist = FVector2D::Distance(Point, Closest);
 
 		UE_LOG(LogTemp, Verbose, TEXT("  Segment %s: (%0.1f,%0.1f)->(%0.1f,%0.1f), Closest=(%0.1f,%0.1f), Dist=%0.1f"),
 			*Seg.WallId.ToString().Left(8), Seg.A.X, Seg.A.Y, Seg.B.X, Seg.B.Y, Closest.X, Closest.Y, Dist);
 
-		if (Dist < BestDistance)
+		if (Dist < BestDistance || (BestIndex != INDEX_NONE && Dist == BestDistance && Index < BestIndex))
 		{
 			BestDistance = Dist;
 			BestWallId = Seg.WallId;
+			BestIndex = Index;
 			UE_LOG(LogTemp, Verbose, TEXT("    -> New best!"));
 		}
-	}
+	});
+
+	ArcGrid.Query(Point - FVector2D(Tolerance, Tolerance), Point + FVector2D(Tolerance, Tolerance), [&](int32 Index)
+	{
+		const FSnapArc& Entry = SnapArcs[Index];
+		const float Dist = (float)Entry.Arc.Distance(Point);
+		if (Dist < BestDistance)
+		{
+			BestDistance = Dist;
+			BestWallId = Entry.WallId;
+		}
+	});
 
 	return BestWallId;
 }
@@ -208,40 +1115,48 @@ TArray<FGuid> FRTPlanSpatialIndex::HitTestWallsInRect(const FVector2D& RectMin,
 	TArray<FGuid> HitWalls;
 
 	UE_LOG(LogTemp, Verbose, TEXT("HitTestWallsInRect: Min=(%0.1f, %0.1f), Max=(%0.1f, %0.1f), NumSegments=%d"),
-		RectMin.X, RectMin.Y, RectMax.X, RectMax.Y, SnapSegments.Num());
+		RectMin.X, RectMin.Y, RectMax.X, RectMax.Y, GetNumSegments());
 
-	for (const FSnapSegment& Seg : SnapSegments)
+	// Gather candidate segments in index order so the result order is stable
+	TArray<int32, TInlineAllocator<64>> Candidates;
+	SegmentGrid.Query(RectMin, RectMax, [&Candidates](int32 Index)
 	{
-		// Check if either endpoint is inside the rect
-		bool bAInside = (Seg.A.X >= RectMin.X && Seg.A.X <= RectMax.X && 
-		                 Seg.A.Y >= RectMin.Y && Seg.A.Y <= RectMax.Y);
-		bool bBInside = (Seg.B.X >= RectMin.X && Seg.B.X <= RectMax.X && 
-		                 Seg.B.Y >= RectMin.Y && Seg.B.Y <= RectMax.Y);
+		Candidates.Add(Index);
+	});
+	Candidates.Sort();
 
-		UE_LOG(LogTemp, Verbose, TEXT("  Segment (%0.1f,%0.1f)->(%0.1f,%0.1f): AInside=%d, BInside=%d"),
-			Seg.A.X, Seg.A.Y, Seg.B.X, Seg.B.Y, bAInside, bBInside);
+	// Marquees over a large part of the plan gather many candidates: clip them against the rect four at a time
+	FRTPlanSegmentSoA CandidateSegments;
+	CandidateSegments.Reset(Candidates.Num());
+	for (const int32 Index : Candidates)
+	{
+		CandidateSegments.Add(SnapSegments[Index].A, SnapSegments[Index].B);
+	}
 
-		if (bAInside || bBInside)
-		{
-			HitWalls.AddUnique(Seg.WallId);
-			continue;
-		}
+	TArray<int32> Touching;
+	FRTPlanSegmentBatch::IntersectsRect(CandidateSegments, RectMin, RectMax, Touching);
+
+	// Straight walls own a single segment, so no wall is listed twice
+	HitWalls.Reserve(Touching.Num());
+	for (const int32 CandidateIndex : Touching)
+	{
+		HitWalls.Add(SnapSegments[Candidates[CandidateIndex]].WallId);
+	}
 
-		// Check if segment intersects any edge of the rectangle
-		// For simplicity, check if the segment crosses any of the 4 rect edges
-		FVector2D RectTL(RectMin.X, RectMax.Y);
-		FVector2D RectBR(RectMax.X, RectMin.Y);
+	// Arcs: exact curve vs rect test
+	TArray<int32, TInlineAllocator<16>> ArcCandidates;
+	ArcGrid.Query(RectMin, RectMax, [&ArcCandidates](int32 Index)
+	{
+		ArcCandidates.Add(Index);
+	});
+	ArcCandidates.Sort();
 
-		// Top edge
-		if (FRTPlanGeometryUtils::SegmentsIntersect(Seg.A, Seg.B, RectMin, RectTL) ||
-		    // Left edge
-		    FRTPlanGeometryUtils::SegmentsIntersect(Seg.A, Seg.B, RectTL, RectMax) ||
-		    // Bottom edge
-		    FRTPlanGeometryUtils::SegmentsIntersect(Seg.A, Seg.B, RectMax, RectBR) ||
-		    // Right edge
-		    FRTPlanGeometryUtils::SegmentsIntersect(Seg.A, Seg.B, RectBR, RectMin))
+	for (const int32 Index : ArcCandidates)
+	{
+		const FSnapArc& Entry = SnapArcs[Index];
+		if (Entry.Arc.IntersectsRect(RectMin, RectMax))
 		{
-			HitWalls.AddUnique(Seg.WallId);
+			HitWalls.AddUnique(Entry.WallId);
 		}
 	}
 
@@ -250,34 +1165,33 @@ TArray<FGuid> FRTPlanSpatialIndex::HitTestWallsInRect(const FVector2D& RectMin,
 
 FGuid FRTPlanSpatialIndex::HitTestOpening(const FVector2D& Point, float Tolerance) const
 {
-	if (!CachedDocument) return FGuid();
+	TArray<int32, TInlineAllocator<16>> Candidates;
+	OpeningGrid.Query(Point - FVector2D(Tolerance, Tolerance), Point + FVector2D(Tolerance, Tolerance), [&Candidates](int32 Index)
+	{
+		Candidates.Add(Index);
+	});
+	Candidates.Sort();
 
-	const FRTPlanData& Data = CachedDocument->GetData();
 	FGuid BestOpeningId;
-	float BestDistance = Tolerance;
+	double BestDistance = Tolerance;
+	double BestCenterDistance = UE_DOUBLE_BIG_NUMBER;
 
-	for (const auto& Pair : Data.Openings)
+	for (const int32 Index : Candidates)
 	{
-		const FRTOpening& Opening = Pair.Value;
-		
-		// Get the wall this opening is on
-		if (!Data.Walls.Contains(Opening.WallId)) continue;
-		const FRTWall& Wall = Data.Walls[Opening.WallId];
-		
-		if (!Data.Vertices.Contains(Wall.VertexAId) || !Data.Vertices.Contains(Wall.VertexBId)) continue;
-		
-		FVector2D WallA = Data.Vertices[Wall.VertexAId].Position;
-		FVector2D WallB = Data.Vertices[Wall.VertexBId].Position;
-		FVector2D WallDir = (WallB - WallA).GetSafeNormal();
-		
-		// Opening center position along the wall (OffsetCm is distance from VertexA)
-		FVector2D OpeningCenter = WallA + WallDir * Opening.OffsetCm;
-		
-		float Dist = FVector2D::Distance(Point, OpeningCenter);
-		if (Dist < BestDistance)
+		const FOpeningFootprint& Footprint = Openings[Index];
+		const double Dist = Footprint.Distance(Point);
+		if (Dist > BestDistance)
+		{
+			continue;
+		}
+
+		// Overlapping footprints (e.g. cursor inside two openings): nearest center wins
+		const double CenterDist = FVector2D::Distance(Point, Footprint.Center);
+		if (Dist < BestDistance || CenterDist < BestCenterDistance)
 		{
 			BestDistance = Dist;
-			BestOpeningId = Opening.Id;
+			BestCenterDistance = CenterDist;
+			BestOpeningId = Footprint.OpeningId;
 		}
 	}
 
@@ -287,45 +1201,352 @@ FGuid FRTPlanSpatialIndex::HitTestOpening(const FVector2D& Point, float Toleranc
 TArray<FGuid> FRTPlanSpatialIndex::HitTestOpeningsInRect(const FVector2D& RectMin, const FVector2D& RectMax) const
 {
 	TArray<FGuid> HitOpenings;
-	
-	if (!CachedDocument) return HitOpenings;
 
-	const FRTPlanData& Data = CachedDocument->GetData();
+	// Candidates in index order so the result order is stable
+	TArray<int32, TInlineAllocator<16>> Candidates;
+	OpeningGrid.Query(RectMin, RectMax, [&Candidates](int32 Index)
+	{
+		Candidates.Add(Index);
+	});
+	Candidates.Sort();
 
-	for (const auto& Pair : Data.Openings)
+	for (const int32 Index : Candidates)
 	{
-		const FRTOpening& Opening = Pair.Value;
-		
-		// Get the wall this opening is on
-		if (!Data.Walls.Contains(Opening.WallId)) continue;
-		const FRTWall& Wall = Data.Walls[Opening.WallId];
-		
-		if (!Data.Vertices.Contains(Wall.VertexAId) || !Data.Vertices.Contains(Wall.VertexBId)) continue;
-		
-		FVector2D WallA = Data.Vertices[Wall.VertexAId].Position;
-		FVector2D WallB = Data.Vertices[Wall.VertexBId].Position;
-		FVector2D WallDir = (WallB - WallA).GetSafeNormal();
-		
-		// Opening center position along the wall (OffsetCm is distance from VertexA)
-		FVector2D OpeningCenter = WallA + WallDir * Opening.OffsetCm;
-		
-		// Check if center is inside rect
-		if (OpeningCenter.X >= RectMin.X && OpeningCenter.X <= RectMax.X &&
-		    OpeningCenter.Y >= RectMin.Y && OpeningCenter.Y <= RectMax.Y)
+		const FOpeningFootprint& Footprint = Openings[Index];
+		if (Footprint.IntersectsRect(RectMin, RectMax))
 		{
-			HitOpenings.Add(Opening.Id);
+			HitOpenings.Add(Footprint.OpeningId);
 		}
 	}
 
 	return HitOpenings;
 }
 
+bool FRTPlanSpatialIndex::Raycast(const FVector& Origin, const FVector& Direction, double MaxDistance, FRTPlanRayHit& OutHit, bool bHitOpenings) const
+{
+	OutHit = FRTPlanRayHit();
+
+	const double DirectionLength = Direction.Size();
+	if (DirectionLength < UE_DOUBLE_SMALL_NUMBER || !WallVolumeBounds.IsValid)
+	{
+		return false;
+	}
+	const FVector Dir = Direction / DirectionLength;
+
+	// Clip the ray to the extent of all walls so the march only covers occupied space
+	double TEnter = 0.0;
+	double TExit = MaxDistance;
+	for (int32 Axis = 0; Axis < 3; ++Axis)
+	{
+		if (FMath::Abs(Dir[Axis]) < UE_DOUBLE_SMALL_NUMBER)
+		{
+			if (Origin[Axis] < WallVolumeBounds.Min[Axis] || Origin[Axis] > WallVolumeBounds.Max[Axis])
+			{
+				return false;
+			}
+			continue;
+		}
+
+		double T0 = (WallVolumeBounds.Min[Axis] - Origin[Axis]) / Dir[Axis];
+		double T1 = (WallVolumeBounds.Max[Axis] - Origin[Axis]) / Dir[Axis];
+		if (T0 > T1)
+		{
+			Swap(T0, T1);
+		}
+		TEnter = FMath::Max(TEnter, T0);
+		TExit = FMath::Min(TExit, T1);
+		if (TEnter > TExit)
+		{
+			return false;
+		}
+	}
+
+	// March the ray's plan projection one grid cell at a time, testing the walls near each step.
+	// Boxes are padded so every wall whose volume the step crosses is found (straight walls are
+	// indexed by their center line, arcs by their tight bounds; volumes reach MaxWallReach past them).
+	const FVector2D Origin2D(Origin.X, Origin.Y);
+	const FVector2D Dir2D(Dir.X, Dir.Y);
+	const double Speed2D = Dir2D.Size();
+	const double Step = Speed2D > UE_DOUBLE_SMALL_NUMBER ? SegmentGrid.GetCellSize() / Speed2D : UE_DOUBLE_BIG_NUMBER;
+	const FVector2D Pad(MaxWallReach + 1.0);
+
+	// Walls spanning several steps are simply tested again: the analytic test is cheaper than deduping
+	auto TestWall = [this, &Origin, &Dir, TExit, bHitOpenings, &OutHit](const FGuid& WallId)
+	{
+		if (const FWallEntry* Entry = WallEntries.Find(WallId))
+		{
+			RaycastWall(WallId, *Entry, Origin, Dir, TExit, bHitOpenings, OutHit);
+		}
+	};
+
+	for (double T0 = TEnter; ; )
+	{
+		const double T1 = FMath::Min(T0 + Step, TExit);
+		const FVector2D P0 = Origin2D + Dir2D * T0;
+		const FVector2D P1 = Origin2D + Dir2D * T1;
+		const FVector2D BoxMin = FVector2D::Min(P0, P1) - Pad;
+		const FVector2D BoxMax = FVector2D::Max(P0, P1) + Pad;
+
+		SegmentGrid.Query(BoxMin, BoxMax, [this, &TestWall](int32 Index)
+		{
+			TestWall(SnapSegments[Index].WallId);
+		});
+		ArcGrid.Query(BoxMin, BoxMax, [this, &TestWall](int32 Index)
+		{
+			TestWall(SnapArcs[Index].WallId);
+		});
+
+		// Every wall the ray can reach before T1 has been tested
+		if ((OutHit.bHit && OutHit.Distance <= T1) || T1 >= TExit)
+		{
+			break;
+		}
+		T0 = T1;
+	}
+
+	return OutHit.bHit;
+}
+
+void FRTPlanSpatialIndex::RaycastWall(const FGuid& WallId, const FWallEntry& Entry, const FVector& Origin, const FVector& Direction, double MaxT, bool bHitOpenings, FRTPlanRayHit& OutHit) const
+{
+	using namespace RTPlanSpatialIndexPrivate;
+
+	const double HalfThickness = Entry.HalfThickness;
+	const double ZMin = Entry.BaseZ;
+	const double ZMax = Entry.BaseZ + Entry.Height;
+	const double Limit = OutHit.bHit ? FMath::Min(MaxT, OutHit.Distance) : MaxT;
+	if (HalfThickness <= 0.0 || Entry.Height <= 0.0f || Limit <= 0.0)
+	{
+		return;
+	}
+
+	const FVector2D Origin2D(Origin.X, Origin.Y);
+	const FVector2D Dir2D(Direction.X, Direction.Y);
+
+	// Hosted openings (holes through the full thickness)
+	TArray<const FOpeningFootprint*, TInlineAllocator<4>> Holes;
+	for (const FGuid& OpeningId : Entry.Openings)
+	{
+		if (const int32* Index = OpeningEntries.Find(OpeningId))
+		{
+			Holes.Add(&Openings[*Index]);
+		}
+	}
+
+	// Every boundary the ray crosses; the volume is the same between consecutive events,
+	// so classifying one point per interval finds the first solid one exactly
+	FRayEventList Events;
+	Events.Add({ 0.0, -Direction }); // Origin inside the volume
+	AddPlaneEvent(Events, Origin.Z, Direction.Z, ZMin, FVector::UpVector, Limit);
+	AddPlaneEvent(Events, Origin.Z, Direction.Z, ZMax, FVector::UpVector, Limit);
+	for (const FOpeningFootprint* Hole : Holes)
+	{
+		AddPlaneEvent(Events, Origin.Z, Direction.Z, Hole->ZMin, FVector::UpVector, Limit);
+		AddPlaneEvent(Events, Origin.Z, Direction.Z, Hole->ZMax, FVector::UpVector, Limit);
+	}
+
+	// Each half of an end face lies on S - K * N = 0 in the end's frame, for its side's slope K
+	// (the face is a bent line left corner -> end point -> right corner, see FRTPlanWallEnd)
+	auto AddEndEvents = [&](const FWallEndFrame& Frame, double LeftCut, double RightCut)
+	{
+		const FVector2D Rel = Origin2D - Frame.Point;
+		const FVector Along3(Frame.Along, 0.0);
+		const FVector Left3(Frame.Left, 0.0);
+		for (const double K : { LeftCut / HalfThickness, -RightCut / HalfThickness })
+		{
+			AddPlaneEvent(Events, (Rel | Frame.Along) - K * (Rel | Frame.Left), (Dir2D | Frame.Along) - K * (Dir2D | Frame.Left), 0.0, (Along3 - Left3 * K).GetSafeNormal(), Limit);
+		}
+	};
+
+	// Arc walls: annular sector (radius +- half thickness). Within a quarter turn of an end, the nearer end's
+	// cut face bounds it instead of the end radius, as the mesher moves its end rings along the end tangents.
+	const FRTPlanArc* Arc = Entry.Arc != INDEX_NONE ? &SnapArcs[Entry.Arc].Arc : nullptr;
+	FWallEndFrame ArcStart, ArcEnd;
+
+	// Straight walls: S along, N across the wall's frame; |N| within the half thickness, S between the end faces
+	// cut at the junctions
+	FVector2D SegStart = FVector2D::ZeroVector;
+	FVector2D U(1.0, 0.0);
+	FVector2D N(0.0, 1.0);
+	double Length = 0.0;
+
+	if (Arc)
+	{
+		ArcStart = GetArcEndFrame(*Arc, true);
+		ArcEnd = GetArcEndFrame(*Arc, false);
+		AddCircleEvents(Events, Origin2D, Dir2D, Arc->Center, Arc->Radius - HalfThickness, Limit);
+		AddCircleEvents(Events, Origin2D, Dir2D, Arc->Center, Arc->Radius + HalfThickness, Limit);
+		AddEndEvents(ArcStart, Entry.StartLeft, Entry.StartRight);
+		AddEndEvents(ArcEnd, Entry.EndLeft, Entry.EndRight);
+		// Where the classification switches: the end radii, a quarter turn from each end, and half way between the ends
+		AddRadialEvent(Events, Origin2D, Dir2D, Arc->Center, Arc->StartAngle, Limit);
+		AddRadialEvent(Events, Origin2D, Dir2D, Arc->Center, Arc->StartAngle + Arc->Sweep, Limit);
+		AddRadialEvent(Events, Origin2D, Dir2D, Arc->Center, Arc->StartAngle + UE_DOUBLE_HALF_PI, Limit);
+		AddRadialEvent(Events, Origin2D, Dir2D, Arc->Center, Arc->StartAngle + Arc->Sweep + UE_DOUBLE_HALF_PI, Limit);
+		AddRadialEvent(Events, Origin2D, Dir2D, Arc->Center, Arc->StartAngle + Arc->Sweep * 0.5, Limit);
+		for (const FOpeningFootprint* Hole : Holes)
+		{
+			AddRadialEvent(Events, Origin2D, Dir2D, Arc->Center, Hole->Arc.StartAngle, Limit);
+			AddRadialEvent(Events, Origin2D, Dir2D, Arc->Center, Hole->Arc.StartAngle + Hole->Arc.Sweep, Limit);
+		}
+	}
+	else if (Entry.Segments.Num() > 0)
+	{
+		const FSnapSegment& Seg = SnapSegments[Entry.Segments[0]];
+		Length = FVector2D::Distance(Seg.A, Seg.B);
+		if (Length < UE_DOUBLE_KINDA_SMALL_NUMBER)
+		{
+			return;
+		}
+		SegStart = Seg.A;
+		U = (Seg.B - Seg.A) / Length;
+		N = FVector2D(-U.Y, U.X);
+		const double S0 = (Origin2D - Seg.A) | U;
+		const double DS = Dir2D | U;
+		const double N0 = (Origin2D - Seg.A) | N;
+		const double DN = Dir2D | N;
+		const FVector U3(U, 0.0);
+		const FVector N3(N, 0.0);
+
+		FWallEndFrame Frame;
+		Frame.Point = Seg.A;
+		Frame.Along = U;
+		Frame.Left = N;
+		AddEndEvents(Frame, Entry.StartLeft, Entry.StartRight);
+		Frame.Point = Seg.B;
+		AddEndEvents(Frame, Entry.EndLeft, Entry.EndRight);
+		AddPlaneEvent(Events, N0, DN, -HalfThickness, N3, Limit);
+		AddPlaneEvent(Events, N0, DN, HalfThickness, N3, Limit);
+		for (const FOpeningFootprint* Hole : Holes)
+		{
+			const double HoleCenter = (Hole->Center - Seg.A) | U;
+			AddPlaneEvent(Events, S0, DS, HoleCenter - Hole->HalfLength, U3, Limit);
+			AddPlaneEvent(Events, S0, DS, HoleCenter + Hole->HalfLength, U3, Limit);
+		}
+	}
+	else
+	{
+		return;
+	}
+
+	// Arc walls: inside the cut face of the end nearer by angle, or a quarter turn or more from both ends, inside the sweep
+	auto InsideArcEnds = [&](const FVector2D& P2D, double Angle)
+	{
+		const double SweepSign = Arc->Sweep >= 0.0 ? 1.0 : -1.0;
+		const double PastStart = FMath::UnwindRadians((Angle - Arc->StartAngle) * SweepSign);
+		const double PastEnd = FMath::UnwindRadians((Angle - Arc->StartAngle - Arc->Sweep) * SweepSign);
+		const bool bNearStart = FMath::Abs(PastStart) <= FMath::Abs(PastEnd);
+		if (FMath::Abs(bNearStart ? PastStart : PastEnd) >= UE_DOUBLE_HALF_PI)
+		{
+			return Arc->ContainsAngle(Angle);
+		}
+
+		const FWallEndFrame& Frame = bNearStart ? ArcStart : ArcEnd;
+		const FVector2D Rel = P2D - Frame.Point;
+		const double S = Rel | Frame.Along;
+		const double Across = Rel | Frame.Left;
+		return bNearStart
+			? S >= GetEndTrim(Entry.StartLeft, Entry.StartRight, Across, HalfThickness)
+			: S <= GetEndTrim(Entry.EndLeft, Entry.EndRight, Across, HalfThickness);
+	};
+
+	// True if the point at T is inside the wall's volume; OutHole is the hole containing it, if any
+	auto Classify = [&](double T, const FOpeningFootprint*& OutHole)
+	{
+		const FVector P = Origin + Direction * T;
+		if (P.Z < ZMin || P.Z > ZMax)
+		{
+			return false;
+		}
+
+		if (Arc)
+		{
+			const FVector2D ToP = FVector2D(P.X, P.Y) - Arc->Center;
+			const double Angle = FMath::Atan2(ToP.Y, ToP.X);
+			if (FMath::Abs(ToP.Size() - Arc->Radius) > HalfThickness || !InsideArcEnds(FVector2D(P.X, P.Y), Angle))
+			{
+				return false;
+			}
+			for (const FOpeningFootprint* Hole : Holes)
+			{
+				if (P.Z >= Hole->ZMin && P.Z <= Hole->ZMax && Hole->Arc.ContainsAngle(Angle))
+				{
+					OutHole = Hole;
+					break;
+				}
+			}
+			return true;
+		}
+
+		const FVector2D Rel = FVector2D(P.X, P.Y) - SegStart;
+		const double S = Rel | U;
+		const double Across = Rel | N;
+		if (FMath::Abs(Across) > HalfThickness
+			|| S < GetEndTrim(Entry.StartLeft, Entry.StartRight, Across, HalfThickness)
+			|| S > Length + GetEndTrim(Entry.EndLeft, Entry.EndRight, Across, HalfThickness))
+		{
+			return false;
+		}
+		for (const FOpeningFootprint* Hole : Holes)
+		{
+			const double HoleCenter = (Hole->Center - SegStart) | U;
+			if (P.Z >= Hole->ZMin && P.Z <= Hole->ZMax && FMath::Abs(S - HoleCenter) <= Hole->HalfLength)
+			{
+				OutHole = Hole;
+				break;
+			}
+		}
+		return true;
+	};
+
+	Algo::SortBy(Events, &FRayEvent::T);
+
+	for (int32 i = 0; i < Events.Num(); ++i)
+	{
+		const double TStart = Events[i].T;
+		const double TEnd = i + 1 < Events.Num() ? Events[i + 1].T : Limit;
+		if (TStart >= Limit)
+		{
+			break;
+		}
+		if (TEnd - TStart < UE_DOUBLE_KINDA_SMALL_NUMBER)
+		{
+			continue;
+		}
+
+		const FOpeningFootprint* Hole = nullptr;
+		if (!Classify((TStart + TEnd) * 0.5, Hole) || (Hole && !bHitOpenings))
+		{
+			continue;
+		}
+
+		OutHit.bHit = true;
+		OutHit.Distance = TStart;
+		OutHit.Location = Origin + Direction * TStart;
+		OutHit.WallId = WallId;
+		OutHit.OpeningId = Hole ? Hole->OpeningId : FGuid();
+
+		FVector Normal = Events[i].Normal;
+		if (Normal.IsZero())
+		{
+			Normal = FVector((FVector2D(OutHit.Location.X, OutHit.Location.Y) - Arc->Center).GetSafeNormal(), 0.0);
+		}
+		OutHit.Normal = (Normal | Direction) > 0.0 ? -Normal : Normal;
+		return;
+	}
+}
+
 void FRTPlanSpatialIndex::DrawDebugSegments(UWorld* World, float Duration) const
 {
 	if (!World) return;
 	
 	for (const FSnapSegment& Seg : SnapSegments)
 	{
+		if (!Seg.WallId.IsValid())
+		{
+			continue; // Free slot
+		}
+
 		FVector Start(Seg.A.X, Seg.A.Y, 5.0f);  // Slightly above ground
 		FVector End(Seg.B.X, Seg.B.Y, 5.0f);
 		
@@ -334,5 +1555,22 @@ void FRTPlanSpatialIndex::DrawDebugSegments(UWorld* World, float Duration) const
 		DrawDebugSphere(World, End, 10.0f, 6, FColor::Magenta, false, Duration);
 	}
 	
-	UE_LOG(LogTemp, Log, TEXT("DrawDebugSegments: Drew %d segments"), SnapSegments.Num());
+	for (const FSnapArc& Entry : SnapArcs)
+	{
+		if (!Entry.WallId.IsValid())
+		{
+			continue;
+		}
+
+		// Debug only: draw the exact arc as a fine polyline
+		const int32 NumSteps = 32;
+		for (int32 i = 0; i < NumSteps; ++i)
+		{
+			const FVector2D P0 = Entry.Arc.GetPoint((double)i / NumSteps);
+			const FVector2D P1 = Entry.Arc.GetPoint((double)(i + 1) / NumSteps);
+			DrawDebugLine(World, FVector(P0.X, P0.Y, 5.0f), FVector(P1.X, P1.Y, 5.0f), FColor::Cyan, false, Duration, 0, 3.0f);
+		}
+	}
+	
+	UE_LOG(LogTemp, Log, TEXT("DrawDebugSegments: Drew %d segments, %d arcs"), GetNumSegments(), GetNumArcs());
 }
@@ -2,6 +2,11 @@
 #include "Misc/AutomationTest.h"
 #include "RTPlanSpatialIndex.h"
 #include "RTPlanDocument.h"
+#include "RTPlanEditList.h"
+#include "RTPlanWallIntersections.h"
+#include "RTPlanGeometryUtils.h"
+#include "HAL/PlatformTime.h"
+#include "Async/Async.h"
 
 IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRTPlanSpatialSnapTest, "ArchVis.RTPlanSpatial.Snapping", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
 
@@ -30,21 +35,21 @@ bool FRTPlanSpatialSnapTest::RunTest(const FString& Parameters)
 	TestTrue("Snap to Endpoint Valid", Res1.bValid);
 	TestEqual("Snap Location X", Res1.Location.X, 0.0);
 	TestEqual("Snap Location Y", Res1.Location.Y, 0.0);
-	TestEqual("Snap Type", Res1.DebugType, FString("Endpoint"));
+	TestTrue("Snap Type", Res1.Type == ERTSnapType::Endpoint);
 
 	// Test 2: Snap to Midpoint
 	FRTSnapResult Res2 = Index.QuerySnap(FVector2D(50, 5), 10.0f);
 	TestTrue("Snap to Midpoint Valid", Res2.bValid);
 	TestEqual("Snap Location X", Res2.Location.X, 50.0);
 	TestEqual("Snap Location Y", Res2.Location.Y, 0.0);
-	TestEqual("Snap Type", Res2.DebugType, FString("Midpoint"));
+	TestTrue("Snap Type", Res2.Type == ERTSnapType::Midpoint);
 
 	// Test 3: Snap to Projection (Edge)
 	FRTSnapResult Res3 = Index.QuerySnap(FVector2D(25, 5), 10.0f);
 	TestTrue("Snap to Projection Valid", Res3.bValid);
 	TestEqual("Snap Location X", Res3.Location.X, 25.0);
 	TestEqual("Snap Location Y", Res3.Location.Y, 0.0);
-	TestEqual("Snap Type", Res3.DebugType, FString("Projection"));
+	TestTrue("Snap Type", Res3.Type == ERTSnapType::Projection);
 
 	// Test 4: No Snap (Too far)
 	FRTSnapResult Res4 = Index.QuerySnap(FVector2D(50, 50), 10.0f);
@@ -52,3 +57,1042 @@ bool FRTPlanSpatialSnapTest::RunTest(const FString& Parameters)
 
 	return true;
 }
+
+namespace RTPlanSpatialTestsPrivate
+{
+	// Square lattice of walls, Side x Side cells of 200cm (about 2 * Side^2 walls)
+	URTPlanDocument* MakeLatticePlan(int32 Side)
+	{
+		URTPlanDocument* Doc = NewObject<URTPlanDocument>();
+		FRTPlanData& Data = Doc->GetDataMutable();
+
+		TArray<FGuid> Ids;
+		Ids.SetNum((Side + 1) * (Side + 1));
+		for (int32 Y = 0; Y <= Side; ++Y)
+		{
+			for (int32 X = 0; X <= Side; ++X)
+			{
+				FRTVertex V; V.Id = FGuid::NewGuid(); V.Position = FVector2D(X * 200.0f, Y * 200.0f);
+				Data.Vertices.Add(V.Id, V);
+				Ids[Y * (Side + 1) + X] = V.Id;
+			}
+		}
+
+		auto AddWall = [&Data](const FGuid& A, const FGuid& B)
+		{
+			FRTWall W; W.Id = FGuid::NewGuid(); W.VertexAId = A; W.VertexBId = B;
+			Data.Walls.Add(W.Id, W);
+		};
+
+		for (int32 Y = 0; Y <= Side; ++Y)
+		{
+			for (int32 X = 0; X <= Side; ++X)
+			{
+				if (X < Side) AddWall(Ids[Y * (Side + 1) + X], Ids[Y * (Side + 1) + X + 1]);
+				if (Y < Side) AddWall(Ids[Y * (Side + 1) + X], Ids[(Y + 1) * (Side + 1) + X]);
+			}
+		}
+
+		Doc->MarkFullRebuild();
+		return Doc;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRTPlanSpatialGridTest, "ArchVis.RTPlanSpatial.Grid", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FRTPlanSpatialGridTest::RunTest(const FString& Parameters)
+{
+	FRTPlanSpatialGrid Grid;
+	Grid.Reset(100.0f);
+
+	// Diagonal segment only occupies the cells it crosses, not its whole bounding box
+	Grid.InsertSegment(0, FVector2D(0, 0), FVector2D(999, 999));
+	TestTrue("Diagonal covers about one row of cells", Grid.GetNumCells() < 30);
+
+	Grid.InsertPoint(1, FVector2D(550, 50));
+
+	TArray<int32> Found;
+	Grid.Query(FVector2D(500, 0), FVector2D(600, 100), [&Found](int32 Item) { Found.Add(Item); });
+	TestTrue("Point found", Found.Contains(1));
+	TestFalse("Far segment cells skipped", Found.Contains(0));
+
+	Found.Reset();
+	Grid.Query(FVector2D(-1000, -1000), FVector2D(2000, 2000), [&Found](int32 Item) { Found.Add(Item); });
+	TestEqual("Large query visits each item once", Found.Num(), 2);
+
+	// Grid-accelerated hit tests agree with the expected walls
+	URTPlanDocument* Doc = RTPlanSpatialTestsPrivate::MakeLatticePlan(10);
+	FRTPlanSpatialIndex Index;
+	Index.Build(Doc);
+
+	TestTrue("Hit wall on lattice", Index.HitTestWall(FVector2D(100, 3), 10.0f).IsValid());
+	TestFalse("Miss inside a cell", Index.HitTestWall(FVector2D(100, 100), 10.0f).IsValid());
+	TestEqual("Marquee hits the walls touching one cell's corners", Index.HitTestWallsInRect(FVector2D(-10, -10), FVector2D(210, 210)).Num(), 8);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRTPlanSpatialBenchmarkTest, "ArchVis.RTPlanSpatial.QueryBenchmark", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FRTPlanSpatialBenchmarkTest::RunTest(const FString& Parameters)
+{
+	// Query time should stay flat as the plan grows (grid) instead of growing linearly (scan)
+	const int32 Sides[] = { 10, 30, 70, 100 };
+	const int32 NumQueries = 2000;
+
+	for (const int32 Side : Sides)
+	{
+		URTPlanDocument* Doc = RTPlanSpatialTestsPrivate::MakeLatticePlan(Side);
+		FRTPlanSpatialIndex Index;
+		Index.Build(Doc);
+
+		FRandomStream Random(Side);
+		const float Extent = Side * 200.0f;
+
+		TArray<FVector2D> Cursors;
+		Cursors.Reserve(NumQueries);
+		for (int32 i = 0; i < NumQueries; ++i)
+		{
+			Cursors.Add(FVector2D(Random.FRandRange(0.0f, Extent), Random.FRandRange(0.0f, Extent)));
+		}
+
+		int32 NumHits = 0;
+		const double Start = FPlatformTime::Seconds();
+		for (const FVector2D& Cursor : Cursors)
+		{
+			NumHits += Index.QuerySnap(Cursor, 20.0f).bValid ? 1 : 0;
+			NumHits += Index.HitTestWall(Cursor, 10.0f).IsValid() ? 1 : 0;
+
+			FVector2D AlignedPos;
+			NumHits += Index.QueryAlignment(Cursor, 20.0f, AlignedPos) ? 1 : 0;
+		}
+		const double Elapsed = FPlatformTime::Seconds() - Start;
+
+		AddInfo(FString::Printf(TEXT("%6d segments: %.3f us per snap+hit+align query (%d hits)"),
+			Index.GetNumSegments(), Elapsed * 1e6 / NumQueries, NumHits));
+
+		// Cursor-like random walk: tiered snap with and without the temporal cache
+		{
+			TArray<FVector2D> Walk;
+			Walk.Reserve(NumQueries);
+			FVector2D WalkPos(Extent * 0.5f, Extent * 0.5f);
+			for (int32 i = 0; i < NumQueries; ++i)
+			{
+				WalkPos += FVector2D(Random.FRandRange(-3.0f, 3.0f), Random.FRandRange(-3.0f, 3.0f));
+				Walk.Add(WalkPos);
+			}
+
+			FRTSnapQuery Query;
+			Query.Radius = 20.0f;
+			Query.GridSize = 100.0f;
+			FRTSnapCandidates Candidates;
+
+			const double UncachedStart = FPlatformTime::Seconds();
+			for (const FVector2D& Cursor : Walk)
+			{
+				Query.Cursor = Cursor;
+				Index.QuerySnapCandidates(Query, Candidates);
+			}
+			const double UncachedElapsed = FPlatformTime::Seconds() - UncachedStart;
+
+			FRTSnapQueryCache Cache;
+			const double CachedStart = FPlatformTime::Seconds();
+			for (const FVector2D& Cursor : Walk)
+			{
+				Query.Cursor = Cursor;
+				Index.QuerySnapCandidates(Query, Candidates, &Cache);
+			}
+			const double CachedElapsed = FPlatformTime::Seconds() - CachedStart;
+
+			AddInfo(FString::Printf(TEXT("%6d segments: %.3f us per tiered snap, %.3f us cached (%d reused / %d gathered)"),
+				Index.GetNumSegments(), UncachedElapsed * 1e6 / NumQueries, CachedElapsed * 1e6 / NumQueries,
+				Cache.NumReused, Cache.NumGathered));
+			TestTrue(TEXT("Walking cursor mostly reuses its candidates"), Cache.NumReused > Cache.NumGathered);
+		}
+
+		// Spot-check against a brute-force scan on the ground-truth lattice:
+		// the nearest wall is within 10cm iff the cursor is within 10cm of a lattice line
+		for (int32 i = 0; i < 50; ++i)
+		{
+			const FVector2D& Cursor = Cursors[i];
+			const float DX = FMath::Abs(Cursor.X - FMath::RoundToFloat(Cursor.X / 200.0f) * 200.0f);
+			const float DY = FMath::Abs(Cursor.Y - FMath::RoundToFloat(Cursor.Y / 200.0f) * 200.0f);
+			const bool bExpectHit = FMath::Min(DX, DY) < 10.0f;
+			TestEqual(FString::Printf(TEXT("Hit test matches brute force (%d segments)"), Index.GetNumSegments()),
+				Index.HitTestWall(Cursor, 10.0f).IsValid(), bExpectHit);
+		}
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRTPlanSpatialIncrementalTest, "ArchVis.RTPlanSpatial.IncrementalUpdate", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FRTPlanSpatialIncrementalTest::RunTest(const FString& Parameters)
+{
+	URTPlanDocument* Doc = RTPlanSpatialTestsPrivate::MakeLatticePlan(5);
+
+	FRTPlanSpatialIndex Index;
+	Index.Build(Doc);
+	uint64 SyncedRevision = Doc->GetRevision();
+
+	auto Sync = [&]()
+	{
+		Index.ApplyDelta(Doc->GetChangedSince(SyncedRevision));
+		SyncedRevision = Doc->GetRevision();
+	};
+
+	// Incrementally updated index must answer like a fresh build
+	auto CheckMatchesRebuild = [&](const TCHAR* Step)
+	{
+		FRTPlanSpatialIndex Fresh;
+		Fresh.Build(Doc);
+
+		TestEqual(FString::Printf(TEXT("%s: segment count"), Step), Index.GetNumSegments(), Fresh.GetNumSegments());
+
+		FRandomStream Random(7);
+		for (int32 i = 0; i < 200; ++i)
+		{
+			const FVector2D Cursor(Random.FRandRange(-100.0f, 1200.0f), Random.FRandRange(-100.0f, 1200.0f));
+
+			const FRTSnapResult A = Index.QuerySnap(Cursor, 30.0f);
+			const FRTSnapResult B = Fresh.QuerySnap(Cursor, 30.0f);
+			if (A.bValid != B.bValid || (A.bValid && !A.Location.Equals(B.Location, 0.01)))
+			{
+				AddError(FString::Printf(TEXT("%s: snap differs at (%0.1f, %0.1f)"), Step, Cursor.X, Cursor.Y));
+				return;
+			}
+
+			FVector2D AlignedA, AlignedB;
+			const bool bAlignedA = Index.QueryAlignment(Cursor, 20.0f, AlignedA);
+			const bool bAlignedB = Fresh.QueryAlignment(Cursor, 20.0f, AlignedB);
+			if (bAlignedA != bAlignedB || !AlignedA.Equals(AlignedB, 0.01))
+			{
+				AddError(FString::Printf(TEXT("%s: alignment differs at (%0.1f, %0.1f)"), Step, Cursor.X, Cursor.Y));
+				return;
+			}
+
+			if (Index.HitTestWall(Cursor, 10.0f).IsValid() != Fresh.HitTestWall(Cursor, 10.0f).IsValid())
+			{
+				AddError(FString::Printf(TEXT("%s: wall hit differs at (%0.1f, %0.1f)"), Step, Cursor.X, Cursor.Y));
+				return;
+			}
+		}
+	};
+
+	// Find the lattice vertex at (400, 400)
+	FRTVertex Moved;
+	for (const auto& Pair : Doc->GetData().Vertices)
+	{
+		if (Pair.Value.Position.Equals(FVector2D(400, 400)))
+		{
+			Moved = Pair.Value;
+		}
+	}
+	TestTrue("Found lattice vertex", Moved.Id.IsValid());
+
+	// Move a vertex: its 4 walls follow
+	{
+		FRTPlanEditList Edits;
+		Moved.Position = FVector2D(430, 370);
+		Edits.SetVertex(Moved);
+		Doc->SubmitEdits(MoveTemp(Edits), TEXT("Move"));
+		Sync();
+		CheckMatchesRebuild(TEXT("Move vertex"));
+		TestTrue("Moved walls are hit at their new location", Index.HitTestWall(FVector2D(415, 485), 5.0f).IsValid());
+	}
+
+	// Add a new wall with new vertices
+	{
+		FRTVertex V1; V1.Id = FGuid::NewGuid(); V1.Position = FVector2D(1500, 0);
+		FRTVertex V2; V2.Id = FGuid::NewGuid(); V2.Position = FVector2D(1500, 900);
+		FRTWall W; W.Id = FGuid::NewGuid(); W.VertexAId = V1.Id; W.VertexBId = V2.Id;
+
+		FRTPlanEditList Edits;
+		Edits.SetVertex(V1);
+		Edits.SetVertex(V2);
+		Edits.SetWall(W);
+		Doc->SubmitEdits(MoveTemp(Edits), TEXT("Add"));
+		Sync();
+		CheckMatchesRebuild(TEXT("Add wall"));
+		TestEqual("New wall hit", Index.HitTestWall(FVector2D(1502, 450), 5.0f), W.Id);
+
+		// Remove it again: its slots are freed and nothing hits there
+		FRTPlanEditList Removal;
+		Removal.RemoveWall(W.Id);
+		Removal.RemoveVertex(V1.Id);
+		Removal.RemoveVertex(V2.Id);
+		Doc->SubmitEdits(MoveTemp(Removal), TEXT("Remove"));
+		Sync();
+		CheckMatchesRebuild(TEXT("Remove wall"));
+		TestFalse("Removed wall not hit", Index.HitTestWall(FVector2D(1502, 450), 5.0f).IsValid());
+		TestFalse("Removed endpoint no longer snaps", Index.QuerySnap(FVector2D(1500, 0), 5.0f).bValid);
+	}
+
+	// Undo everything
+	while (Doc->CanUndo())
+	{
+		Doc->Undo();
+	}
+	Sync();
+	CheckMatchesRebuild(TEXT("Undo"));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRTPlanSpatialAlignmentTest, "ArchVis.RTPlanSpatial.Alignment", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FRTPlanSpatialAlignmentTest::RunTest(const FString& Parameters)
+{
+	// Horizontal wall (0,0)-(300,0) and diagonal wall (0,0)-(100,100)
+	URTPlanDocument* Doc = NewObject<URTPlanDocument>();
+	FRTPlanData& Data = Doc->GetDataMutable();
+
+	FRTVertex V0; V0.Id = FGuid::NewGuid(); V0.Position = FVector2D(0, 0);
+	FRTVertex V1; V1.Id = FGuid::NewGuid(); V1.Position = FVector2D(300, 0);
+	FRTVertex V2; V2.Id = FGuid::NewGuid(); V2.Position = FVector2D(100, 100);
+	Data.Vertices.Add(V0.Id, V0);
+	Data.Vertices.Add(V1.Id, V1);
+	Data.Vertices.Add(V2.Id, V2);
+
+	FRTWall W0; W0.Id = FGuid::NewGuid(); W0.VertexAId = V0.Id; W0.VertexBId = V1.Id;
+	FRTWall W1; W1.Id = FGuid::NewGuid(); W1.VertexAId = V0.Id; W1.VertexBId = V2.Id;
+	Data.Walls.Add(W0.Id, W0);
+	Data.Walls.Add(W1.Id, W1);
+	Doc->MarkFullRebuild();
+
+	FRTPlanSpatialIndex Index;
+	Index.Build(Doc);
+
+	FVector2D Aligned;
+	TArray<FRTAlignmentGuide> Guides;
+
+	// Matching X of a vertex: vertical guide from that vertex
+	TestTrue("Vertical alignment", Index.QueryAlignment(FVector2D(302, 150), 20.0f, Aligned, &Guides));
+	TestTrue("Aligned to X = 300", Aligned.Equals(FVector2D(300, 150), 0.01));
+	if (TestEqual("One guide", Guides.Num(), 1))
+	{
+		TestEqual("Vertical guide", Guides[0].Type, ERTAlignmentGuideType::Vertical);
+		TestEqual("Guide source vertex", Guides[0].SourceVertexId, V1.Id);
+	}
+
+	// Extension of the diagonal wall beyond its endpoint
+	TestTrue("Extension alignment", Index.QueryAlignment(FVector2D(205, 195), 20.0f, Aligned, &Guides));
+	TestTrue("Projected onto y = x", Aligned.Equals(FVector2D(200, 200), 0.01));
+	if (TestEqual("One guide", Guides.Num(), 1))
+	{
+		TestEqual("Extension guide", Guides[0].Type, ERTAlignmentGuideType::Extension);
+		TestEqual("Nearest source is the far endpoint", Guides[0].SourceVertexId, V2.Id);
+		TestEqual("Source wall", Guides[0].SourceWallId, W1.Id);
+	}
+
+	// Crossing of the X guide and the diagonal extension
+	TestTrue("Crossing alignment", Index.QueryAlignment(FVector2D(298, 290), 20.0f, Aligned, &Guides));
+	TestTrue("Snapped to the crossing", Aligned.Equals(FVector2D(300, 300), 0.01));
+	TestEqual("Two guides", Guides.Num(), 2);
+
+	TestFalse("Nothing to align with", Index.QueryAlignment(FVector2D(600, 400), 20.0f, Aligned, &Guides));
+	TestEqual("No guides", Guides.Num(), 0);
+
+	// Removing the diagonal drops its extension family's line
+	FRTPlanEditList Edits;
+	Edits.RemoveWall(W1.Id);
+	const uint64 Revision = Doc->GetRevision();
+	Doc->SubmitEdits(MoveTemp(Edits), TEXT("Remove"));
+	Index.ApplyDelta(Doc->GetChangedSince(Revision));
+	TestFalse("Extension removed with its wall", Index.QueryAlignment(FVector2D(205, 195), 20.0f, Aligned));
+
+	// A wall 0.004 deg off the first wall of its direction bucket: its B end is ~0.07 cm off the family line
+	// through its A end, and removing the wall must still take both endpoint sources with it
+	{
+		FRTPlanAlignmentIndex Extensions;
+		const FGuid FirstId = FGuid::NewGuid();
+		const FGuid SecondId = FGuid::NewGuid();
+		Extensions.AddExtension(FVector2D(0, 0), FVector2D(1000, 1000), FGuid(), FGuid(), FirstId);
+
+		const double Angle = FMath::DegreesToRadians(45.004);
+		const FVector2D SecondA(0, 300);
+		const FVector2D SecondB = SecondA + FVector2D(FMath::Cos(Angle), FMath::Sin(Angle)) * 1000.0;
+		Extensions.AddExtension(SecondA, SecondB, FGuid(), FGuid(), SecondId);
+		TestEqual("Nearly parallel walls share a family", Extensions.GetNumFamilies(), 3);
+
+		const FVector2D BeyondB = SecondB + FVector2D(1, 1).GetSafeNormal() * 200.0 + FVector2D(-5, 5);
+		Extensions.QueryGuides(BeyondB, 20.0f, Guides);
+		if (TestEqual("Extension of the second wall", Guides.Num(), 1))
+		{
+			TestEqual("Guide from the second wall", Guides[0].SourceWallId, SecondId);
+		}
+
+		Extensions.RemoveExtension(SecondA, SecondB, SecondId);
+		Extensions.QueryGuides(BeyondB, 20.0f, Guides);
+		TestEqual("No guide left behind by the removed wall", Guides.Num(), 0);
+		Extensions.QueryGuides(FVector2D(1205, 1195), 20.0f, Guides);
+		TestEqual("First wall keeps its extension", Guides.Num(), 1);
+	}
+
+	// A bulk load (sort once, merge) builds the same guides as one sorted insert per source
+	FRTPlanAlignmentIndex Inserted;
+	FRTPlanAlignmentIndex Bulk;
+	Bulk.BeginBulkAdd();
+	FRandomStream Random(7);
+	for (int32 i = 0; i < 500; ++i)
+	{
+		const FVector2D P(Random.RandRange(0, 40) * 50.0, Random.RandRange(0, 40) * 50.0);
+		const FVector2D Q = P + FVector2D(Random.RandRange(1, 4) * 100.0, Random.RandRange(1, 4) * 100.0);
+		for (FRTPlanAlignmentIndex* Target : { &Inserted, &Bulk })
+		{
+			Target->AddPoint(P, FGuid(), FGuid());
+			Target->AddExtension(P, Q, FGuid(), FGuid(), FGuid());
+		}
+	}
+	Bulk.EndBulkAdd();
+	TestEqual("Same families", Bulk.GetNumFamilies(), Inserted.GetNumFamilies());
+
+	int32 NumMismatches = 0;
+	TArray<FRTAlignmentGuide> InsertedGuides;
+	TArray<FRTAlignmentGuide> BulkGuides;
+	for (int32 i = 0; i < 200; ++i)
+	{
+		const FVector2D Cursor(Random.FRandRange(0.0, 2500.0), Random.FRandRange(0.0, 2500.0));
+		Inserted.QueryGuides(Cursor, 20.0f, InsertedGuides);
+		Bulk.QueryGuides(Cursor, 20.0f, BulkGuides);
+		bool bSame = InsertedGuides.Num() == BulkGuides.Num();
+		for (int32 GuideIndex = 0; bSame && GuideIndex < BulkGuides.Num(); ++GuideIndex)
+		{
+			bSame = InsertedGuides[GuideIndex].Type == BulkGuides[GuideIndex].Type
+				&& InsertedGuides[GuideIndex].Source.Equals(BulkGuides[GuideIndex].Source, 0.01)
+				&& FMath::IsNearlyEqual(InsertedGuides[GuideIndex].Distance, BulkGuides[GuideIndex].Distance, 0.01f);
+		}
+		NumMismatches += bSame ? 0 : 1;
+	}
+	TestEqual("Bulk load matches sorted inserts", NumMismatches, 0);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRTPlanSpatialArcTest, "ArchVis.RTPlanSpatial.Arcs", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FRTPlanSpatialArcTest::RunTest(const FString& Parameters)
+{
+	// Quarter-circle wall of radius 1000 around the origin, from (1000, 0) CCW to (0, 1000)
+	URTPlanDocument* Doc = NewObject<URTPlanDocument>();
+	FRTPlanData& Data = Doc->GetDataMutable();
+
+	FRTVertex V0; V0.Id = FGuid::NewGuid(); V0.Position = FVector2D(1000, 0);
+	FRTVertex V1; V1.Id = FGuid::NewGuid(); V1.Position = FVector2D(0, 1000);
+	Data.Vertices.Add(V0.Id, V0);
+	Data.Vertices.Add(V1.Id, V1);
+
+	FRTWall Arc; Arc.Id = FGuid::NewGuid(); Arc.VertexAId = V0.Id; Arc.VertexBId = V1.Id;
+	Arc.bIsArc = true;
+	Arc.ArcCenter = FVector2D(0, 0);
+	Arc.ArcSweepAngle = 90.0f;
+	Data.Walls.Add(Arc.Id, Arc);
+	Doc->MarkFullRebuild();
+
+	FRTPlanSpatialIndex Index;
+	Index.Build(Doc);
+
+	TestEqual("One arc primitive", Index.GetNumArcs(), 1);
+	TestEqual("No tessellated segments", Index.GetNumSegments(), 0);
+
+	// A coarse tessellation is several cm off the curve between its vertices; the exact arc is not
+	const double Angle = FMath::DegreesToRadians(5.625);
+	const FVector2D OnCurve(1000.0 * FMath::Cos(Angle), 1000.0 * FMath::Sin(Angle));
+	TestEqual("Tight hit on the true curve", Index.HitTestWall(OnCurve, 1.0f), Arc.Id);
+
+	// Projection snap lands exactly on the curve
+	const double SnapAngle = FMath::DegreesToRadians(20.0);
+	const FVector2D Outside(1010.0 * FMath::Cos(SnapAngle), 1010.0 * FMath::Sin(SnapAngle));
+	const FRTSnapResult Snap = Index.QuerySnap(Outside, 15.0f);
+	TestTrue("Projection snap", Snap.bValid);
+	TestTrue("Snap on the curve", Snap.Location.Equals(FVector2D(1000.0 * FMath::Cos(SnapAngle), 1000.0 * FMath::Sin(SnapAngle)), 0.01));
+
+	TestFalse("Inside the curve misses", Index.HitTestWall(FVector2D(500, 500), 10.0f).IsValid());
+
+	// Marquee crossing the middle of the curve (no endpoint inside)
+	TArray<FGuid> Hits = Index.HitTestWallsInRect(FVector2D(690, 690), FVector2D(720, 720));
+	TestTrue("Marquee hits the arc", Hits.Contains(Arc.Id));
+	TestEqual("Marquee inside the chord misses", Index.HitTestWallsInRect(FVector2D(100, 100), FVector2D(400, 400)).Num(), 0);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRTPlanSpatialSnapTiersTest, "ArchVis.RTPlanSpatial.SnapTiers", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FRTPlanSpatialSnapTiersTest::RunTest(const FString& Parameters)
+{
+	// Two crossing walls that do not share a vertex: H (-100,0)-(200,0), V (0,-100)-(0,200)
+	URTPlanDocument* Doc = NewObject<URTPlanDocument>();
+	FRTPlanData& Data = Doc->GetDataMutable();
+
+	auto AddWall = [&Data](const FVector2D& A, const FVector2D& B)
+	{
+		FRTVertex VA; VA.Id = FGuid::NewGuid(); VA.Position = A;
+		FRTVertex VB; VB.Id = FGuid::NewGuid(); VB.Position = B;
+		FRTWall Wall; Wall.Id = FGuid::NewGuid(); Wall.VertexAId = VA.Id; Wall.VertexBId = VB.Id;
+		Data.Vertices.Add(VA.Id, VA);
+		Data.Vertices.Add(VB.Id, VB);
+		Data.Walls.Add(Wall.Id, Wall);
+	};
+	AddWall(FVector2D(-100, 0), FVector2D(200, 0));
+	AddWall(FVector2D(0, -100), FVector2D(0, 200));
+	Doc->MarkFullRebuild();
+
+	FRTPlanSpatialIndex Index;
+	Index.Build(Doc);
+
+	FRTSnapQuery Query;
+	Query.Cursor = FVector2D(4, 6);
+	Query.Radius = 20.0f;
+
+	// Intersection beats the projections onto either wall
+	FRTSnapCandidates Candidates;
+	Index.QuerySnapCandidates(Query, Candidates);
+	const FRTSnapResult Best = Candidates.GetBest();
+	TestTrue("Crossing snaps", Best.bValid);
+	TestTrue("Crossing is an intersection", Best.Type == ERTSnapType::Intersection);
+	TestTrue("Intersection location", Best.Location.Equals(FVector2D(0, 0), 0.01));
+	TestEqual("One intersection candidate", Candidates.Get(ERTSnapType::Intersection).Num(), 1);
+
+	// Top-k per tier, nearest first
+	const TConstArrayView<FRTSnapResult> Projections = Candidates.Get(ERTSnapType::Projection);
+	TestEqual("Two projection candidates", Projections.Num(), 2);
+	if (Projections.Num() == 2)
+	{
+		TestTrue("Projections sorted by distance", Projections[0].Distance <= Projections[1].Distance);
+		TestTrue("Nearest projection is onto V", Projections[0].Location.Equals(FVector2D(0, 6), 0.01));
+	}
+
+	// Perpendicular foot from the reference point beats a plain projection
+	Query.Cursor = FVector2D(95, 5);
+	Query.From = FVector2D(100, 100);
+	Index.QuerySnapCandidates(Query, Candidates);
+	const FRTSnapResult Perp = Candidates.GetBest();
+	TestTrue("Perpendicular snap", Perp.Type == ERTSnapType::Perpendicular);
+	TestTrue("Perpendicular foot", Perp.Location.Equals(FVector2D(100, 0), 0.01));
+
+	// Grid tier only when nothing else is in reach
+	Query.Cursor = FVector2D(1010, 1030);
+	Query.From.Reset();
+	Query.GridSize = 100.0f;
+	Index.QuerySnapCandidates(Query, Candidates);
+	const FRTSnapResult GridSnap = Candidates.GetBest();
+	TestTrue("Grid snap", GridSnap.bValid && GridSnap.Type == ERTSnapType::Grid);
+	TestTrue("Grid location", GridSnap.Location.Equals(FVector2D(1000, 1000), 0.01));
+
+	// Temporal coherence: small moves reuse the gathered candidates with identical results
+	FRTSnapQueryCache Cache;
+	FRTSnapCandidates Cached;
+	Query.GridSize = 0.0f;
+	Query.Cursor = FVector2D(4, 6);
+	Index.QuerySnapCandidates(Query, Cached, &Cache);
+	Query.Cursor = FVector2D(10, 12);
+	Index.QuerySnapCandidates(Query, Cached, &Cache);
+	Index.QuerySnapCandidates(Query, Candidates);
+	TestEqual("First query gathers", Cache.NumGathered, 1);
+	TestEqual("Small move reuses", Cache.NumReused, 1);
+	TestTrue("Cached result matches uncached", Cached.GetBest().Location.Equals(Candidates.GetBest().Location));
+
+	Query.Cursor = FVector2D(150, 0);
+	Index.QuerySnapCandidates(Query, Cached, &Cache);
+	TestEqual("Leaving the gathered area gathers again", Cache.NumGathered, 2);
+
+	// Edits invalidate the cache
+	Index.Build(Doc);
+	Index.QuerySnapCandidates(Query, Cached, &Cache);
+	TestEqual("Index change gathers again", Cache.NumGathered, 3);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRTPlanSpatialOpeningTest, "ArchVis.RTPlanSpatial.Openings", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FRTPlanSpatialOpeningTest::RunTest(const FString& Parameters)
+{
+	URTPlanDocument* Doc = NewObject<URTPlanDocument>();
+	FRTPlanData& Data = Doc->GetDataMutable();
+
+	// Straight wall (0,0)-(400,0), 20cm thick, door spanning 100..190
+	FRTVertex V1; V1.Id = FGuid::NewGuid(); V1.Position = FVector2D(0, 0);
+	FRTVertex V2; V2.Id = FGuid::NewGuid(); V2.Position = FVector2D(400, 0);
+	FRTWall Straight; Straight.Id = FGuid::NewGuid(); Straight.VertexAId = V1.Id; Straight.VertexBId = V2.Id; Straight.ThicknessCm = 20.0f;
+
+	// Quarter arc wall around the origin, radius 500, from (500,0) to (0,500)
+	FRTVertex V3; V3.Id = FGuid::NewGuid(); V3.Position = FVector2D(500, 0);
+	FRTVertex V4; V4.Id = FGuid::NewGuid(); V4.Position = FVector2D(0, 500);
+	FRTWall Curved; Curved.Id = FGuid::NewGuid(); Curved.VertexAId = V3.Id; Curved.VertexBId = V4.Id; Curved.ThicknessCm = 20.0f;
+	Curved.bIsArc = true; Curved.ArcCenter = FVector2D(0, 0); Curved.ArcSweepAngle = 90.0f;
+
+	FRTOpening Door; Door.Id = FGuid::NewGuid(); Door.WallId = Straight.Id; Door.OffsetCm = 100.0f; Door.WidthCm = 90.0f;
+	FRTOpening Window; Window.Id = FGuid::NewGuid(); Window.WallId = Curved.Id; Window.OffsetCm = 200.0f; Window.WidthCm = 100.0f;
+
+	Data.Vertices.Add(V1.Id, V1);
+	Data.Vertices.Add(V2.Id, V2);
+	Data.Vertices.Add(V3.Id, V3);
+	Data.Vertices.Add(V4.Id, V4);
+	Data.Walls.Add(Straight.Id, Straight);
+	Data.Walls.Add(Curved.Id, Curved);
+	Data.Openings.Add(Door.Id, Door);
+	Data.Openings.Add(Window.Id, Window);
+	Doc->MarkFullRebuild();
+
+	FRTPlanSpatialIndex Index;
+	Index.Build(Doc);
+	TestEqual("Footprints indexed", Index.GetNumOpenings(), 2);
+
+	// Straight wall: oriented rectangle 100..190 x -10..10
+	TestEqual("Hit door center", Index.HitTestOpening(FVector2D(145, 5), 10.0f), Door.Id);
+	TestEqual("Hit inside door near its edge", Index.HitTestOpening(FVector2D(105, -9), 10.0f), Door.Id);
+	TestEqual("Hit within tolerance of the door end", Index.HitTestOpening(FVector2D(95, 0), 10.0f), Door.Id);
+	TestFalse("Miss beside the wall face", Index.HitTestOpening(FVector2D(145, 25), 10.0f).IsValid());
+	TestFalse("Miss on the solid wall", Index.HitTestOpening(FVector2D(300, 0), 10.0f).IsValid());
+
+	// Arc wall: the window covers arc length 200..300 (angles 0.4..0.6 rad)
+	const FVector2D WindowMid(500.0 * FMath::Cos(0.5), 500.0 * FMath::Sin(0.5));
+	const FVector2D ArcSolid(500.0 * FMath::Cos(0.2), 500.0 * FMath::Sin(0.2));
+	TestEqual("Hit arc-hosted window", Index.HitTestOpening(WindowMid, 10.0f), Window.Id);
+	TestEqual("Hit arc-hosted window on its inner face", Index.HitTestOpening(WindowMid * (492.0 / 500.0), 10.0f), Window.Id);
+	TestFalse("Miss the solid part of the arc wall", Index.HitTestOpening(ArcSolid, 10.0f).IsValid());
+
+	// Marquee
+	TArray<FGuid> InRect = Index.HitTestOpeningsInRect(FVector2D(130, -50), FVector2D(160, 50));
+	TestEqual("Marquee over the door", InRect.Num(), 1);
+	TestTrue("Marquee finds the door", InRect.Contains(Door.Id));
+	TestEqual("Marquee beside the wall misses", Index.HitTestOpeningsInRect(FVector2D(0, 20), FVector2D(400, 40)).Num(), 0);
+	TestTrue("Marquee over the window", Index.HitTestOpeningsInRect(WindowMid - FVector2D(5, 5), WindowMid + FVector2D(5, 5)).Contains(Window.Id));
+
+	// Incremental: moving the door and the wall vertex refresh the footprint
+	uint64 SyncedRevision = Doc->GetRevision();
+	{
+		FRTPlanEditList Edits;
+		FRTOpening Moved = Door;
+		Moved.OffsetCm = 250.0f;
+		Edits.SetOpening(Moved);
+		Doc->SubmitEdits(MoveTemp(Edits), TEXT("Move Door"));
+		Index.ApplyDelta(Doc->GetChangedSince(SyncedRevision));
+		SyncedRevision = Doc->GetRevision();
+	}
+	TestFalse("Old door position is solid", Index.HitTestOpening(FVector2D(145, 0), 10.0f).IsValid());
+	TestEqual("Door found at its new position", Index.HitTestOpening(FVector2D(295, 0), 10.0f), Door.Id);
+
+	{
+		FRTPlanEditList Edits;
+		FRTVertex Rotated = V2;
+		Rotated.Position = FVector2D(0, -400);
+		Edits.SetVertex(Rotated);
+		Doc->SubmitEdits(MoveTemp(Edits), TEXT("Rotate Wall"));
+		Index.ApplyDelta(Doc->GetChangedSince(SyncedRevision));
+		SyncedRevision = Doc->GetRevision();
+	}
+	TestEqual("Door follows its wall", Index.HitTestOpening(FVector2D(0, -295), 10.0f), Door.Id);
+
+	{
+		FRTPlanEditList Edits;
+		Edits.RemoveOpening(Window.Id);
+		Doc->SubmitEdits(MoveTemp(Edits), TEXT("Remove Window"));
+		Index.ApplyDelta(Doc->GetChangedSince(SyncedRevision));
+		SyncedRevision = Doc->GetRevision();
+	}
+	TestFalse("Removed window no longer hit", Index.HitTestOpening(WindowMid, 10.0f).IsValid());
+	TestEqual("One footprint left", Index.GetNumOpenings(), 1);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRTPlanSpatialWallIntersectionsTest, "ArchVis.RTPlanSpatial.WallIntersections", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FRTPlanSpatialWallIntersectionsTest::RunTest(const FString& Parameters)
+{
+	// H (-100,0)-(200,0), V (0,-100)-(0,200) and a half circle of radius 50 from 45 to 225 degrees
+	{
+		URTPlanDocument* Doc = NewObject<URTPlanDocument>();
+		FRTPlanData& Data = Doc->GetDataMutable();
+
+		auto AddWall = [&Data](const FVector2D& A, const FVector2D& B)
+		{
+			FRTVertex VA; VA.Id = FGuid::NewGuid(); VA.Position = A;
+			FRTVertex VB; VB.Id = FGuid::NewGuid(); VB.Position = B;
+			FRTWall Wall; Wall.Id = FGuid::NewGuid(); Wall.VertexAId = VA.Id; Wall.VertexBId = VB.Id;
+			Data.Vertices.Add(VA.Id, VA);
+			Data.Vertices.Add(VB.Id, VB);
+			return &Data.Walls.Add(Wall.Id, Wall);
+		};
+		const FGuid H = AddWall(FVector2D(-100, 0), FVector2D(200, 0))->Id;
+		const FGuid V = AddWall(FVector2D(0, -100), FVector2D(0, 200))->Id;
+
+		const double Start = FMath::DegreesToRadians(45.0);
+		const double End = FMath::DegreesToRadians(225.0);
+		FRTWall* ArcWall = AddWall(FVector2D(FMath::Cos(Start), FMath::Sin(Start)) * 50.0, FVector2D(FMath::Cos(End), FMath::Sin(End)) * 50.0);
+		ArcWall->bIsArc = true;
+		ArcWall->ArcCenter = FVector2D(0, 0);
+		ArcWall->ArcSweepAngle = 180.0f;
+		const FGuid Arc = ArcWall->Id;
+		Doc->MarkFullRebuild();
+
+		FRTPlanWallIntersections Intersections;
+		TestTrue("First update builds", Intersections.Update(Doc));
+		TestFalse("Same revision is cached", Intersections.Update(Doc));
+		TestEqual("Three crossings", Intersections.GetNumIntersections(), 3);
+
+		auto CheckCrossings = [&](const TCHAR* Name, const FGuid& WallId, double T0, const FGuid& Other0, double T1, const FGuid& Other1)
+		{
+			const TConstArrayView<FRTWallCrossing> Crossings = Intersections.GetCrossings(WallId);
+			if (!TestEqual(FString::Printf(TEXT("%s: crossing count"), Name), Crossings.Num(), 2))
+			{
+				return;
+			}
+			TestEqual(FString::Printf(TEXT("%s: first T"), Name), Crossings[0].T, T0, 1e-4);
+			TestEqual(FString::Printf(TEXT("%s: first wall"), Name), Crossings[0].OtherWallId, Other0);
+			TestEqual(FString::Printf(TEXT("%s: second T"), Name), Crossings[1].T, T1, 1e-4);
+			TestEqual(FString::Printf(TEXT("%s: second wall"), Name), Crossings[1].OtherWallId, Other1);
+		};
+		CheckCrossings(TEXT("H"), H, 1.0 / 6.0, Arc, 1.0 / 3.0, V);
+		CheckCrossings(TEXT("V"), V, 1.0 / 3.0, H, 0.5, Arc);
+		CheckCrossings(TEXT("Arc"), Arc, 0.25, V, 0.75, H);
+
+		// Any edit bumps the revision; only the removed wall is re-tested
+		FRTPlanEditList Edits;
+		Edits.RemoveWall(Arc);
+		Doc->SubmitEdits(MoveTemp(Edits), TEXT("Remove Arc"));
+		TestTrue("Edit updates", Intersections.Update(Doc));
+		TestEqual("Removing a wall tests no pairs", Intersections.GetNumPairTests(), 0);
+		TestEqual("Arc crossings gone", Intersections.GetCrossings(H).Num(), 1);
+		TestEqual("Other crossing kept", Intersections.GetCrossings(H)[0].OtherWallId, V);
+	}
+
+	// Lattice crossed by diagonals: the grid agrees with the brute-force pairwise scan
+	{
+		URTPlanDocument* Doc = RTPlanSpatialTestsPrivate::MakeLatticePlan(20);
+		FRTPlanData& Data = Doc->GetDataMutable();
+		for (int32 i = 0; i < 10; ++i)
+		{
+			FRTVertex VA; VA.Id = FGuid::NewGuid(); VA.Position = FVector2D(-37.0, 13.0 + 311.0 * i);
+			FRTVertex VB; VB.Id = FGuid::NewGuid(); VB.Position = FVector2D(4037.0, 1013.0 + 311.0 * i);
+			FRTWall Wall; Wall.Id = FGuid::NewGuid(); Wall.VertexAId = VA.Id; Wall.VertexBId = VB.Id;
+			Data.Vertices.Add(VA.Id, VA);
+			Data.Vertices.Add(VB.Id, VB);
+			Data.Walls.Add(Wall.Id, Wall);
+		}
+		Doc->MarkFullRebuild();
+
+		FRTPlanWallIntersections Intersections;
+		const double GridStart = FPlatformTime::Seconds();
+		Intersections.Build(Doc);
+		const double GridElapsed = FPlatformTime::Seconds() - GridStart;
+
+		TArray<const FRTWall*> Walls;
+		for (const auto& Pair : Data.Walls)
+		{
+			Walls.Add(&Pair.Value);
+		}
+
+		const double BruteStart = FPlatformTime::Seconds();
+		TMap<FGuid, int32> Expected;
+		for (int32 i = 0; i < Walls.Num(); ++i)
+		{
+			const FVector2D A1 = Data.Vertices[Walls[i]->VertexAId].Position;
+			const FVector2D B1 = Data.Vertices[Walls[i]->VertexBId].Position;
+			for (int32 j = 0; j < Walls.Num(); ++j)
+			{
+				if (i == j) continue;
+				const FVector2D A2 = Data.Vertices[Walls[j]->VertexAId].Position;
+				const FVector2D B2 = Data.Vertices[Walls[j]->VertexBId].Position;
+				FVector2D Hit;
+				if (FRTPlanGeometryUtils::SegmentIntersection(A1, B1, A2, B2, Hit))
+				{
+					const double T = ((Hit - A1) | (B1 - A1)) / (B1 - A1).SizeSquared();
+					if (T > FRTPlanWallIntersections::EndpointTolerance && T < 1.0 - FRTPlanWallIntersections::EndpointTolerance)
+					{
+						Expected.FindOrAdd(Walls[i]->Id)++;
+					}
+				}
+			}
+		}
+		const double BruteElapsed = FPlatformTime::Seconds() - BruteStart;
+
+		int32 NumMismatches = 0;
+		for (const FRTWall* Wall : Walls)
+		{
+			const int32* Count = Expected.Find(Wall->Id);
+			NumMismatches += (Count ? *Count : 0) != Intersections.GetCrossings(Wall->Id).Num() ? 1 : 0;
+		}
+		TestEqual("Crossings match brute force", NumMismatches, 0);
+		TestTrue("Grid tests far fewer pairs than all pairs", Intersections.GetNumPairTests() < Walls.Num() * (Walls.Num() - 1) / 20);
+
+		AddInfo(FString::Printf(TEXT("%d walls, %d crossings: grid %.3f ms (%d pair tests), brute force %.3f ms"),
+			Walls.Num(), Intersections.GetNumIntersections(), GridElapsed * 1e3, Intersections.GetNumPairTests(), BruteElapsed * 1e3));
+
+		// Move a diagonal's end and delete a lattice wall it crosses: the update matches a fresh build
+		const FRTWall* Diagonal = Walls.Last();
+		FRTVertex MovedEnd = Data.Vertices[Diagonal->VertexBId];
+		const FGuid CrossedWallId = Intersections.GetCrossings(Diagonal->Id)[0].OtherWallId;
+		{
+			FRTPlanEditList Edits;
+			MovedEnd.Position += FVector2D(0.0, -700.0);
+			Edits.SetVertex(MovedEnd);
+			Edits.RemoveWall(CrossedWallId);
+			Doc->SubmitEdits(MoveTemp(Edits), TEXT("Edit"));
+		}
+		TestTrue("Edit updates", Intersections.Update(Doc));
+		TestTrue("Update re-tests only the edited walls", Intersections.GetNumPairTests() < 200);
+
+		FRTPlanWallIntersections Fresh;
+		Fresh.Build(Doc);
+		int32 NumUpdateMismatches = 0;
+		for (const auto& Pair : Doc->GetData().Walls)
+		{
+			const TConstArrayView<FRTWallCrossing> Updated = Intersections.GetCrossings(Pair.Key);
+			const TConstArrayView<FRTWallCrossing> Expected = Fresh.GetCrossings(Pair.Key);
+			bool bSame = Updated.Num() == Expected.Num();
+			for (int32 i = 0; bSame && i < Updated.Num(); ++i)
+			{
+				bSame = FMath::IsNearlyEqual(Updated[i].T, Expected[i].T, 1e-9);
+			}
+			NumUpdateMismatches += bSame ? 0 : 1;
+		}
+		TestEqual("Update matches a fresh build", NumUpdateMismatches, 0);
+		TestEqual("Removed wall has no crossings", Intersections.GetCrossings(CrossedWallId).Num(), 0);
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRTPlanSpatialSnapshotBuildTest, "ArchVis.RTPlanSpatial.SnapshotBuild", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FRTPlanSpatialSnapshotBuildTest::RunTest(const FString& Parameters)
+{
+	URTPlanDocument* Doc = RTPlanSpatialTestsPrivate::MakeLatticePlan(10);
+	FRTPlanData& Data = Doc->GetDataMutable();
+
+	// A door on one of the lattice walls and an arc wall
+	const FGuid HostId = Data.Walls.CreateConstIterator()->Key;
+	FRTOpening Door; Door.Id = FGuid::NewGuid(); Door.WallId = HostId; Door.OffsetCm = 50.0f; Door.WidthCm = 90.0f;
+	Data.Openings.Add(Door.Id, Door);
+
+	FRTVertex V1; V1.Id = FGuid::NewGuid(); V1.Position = FVector2D(2500, 0);
+	FRTVertex V2; V2.Id = FGuid::NewGuid(); V2.Position = FVector2D(2000, 500);
+	FRTWall Curved; Curved.Id = FGuid::NewGuid(); Curved.VertexAId = V1.Id; Curved.VertexBId = V2.Id;
+	Curved.bIsArc = true; Curved.ArcCenter = FVector2D(2000, 0); Curved.ArcSweepAngle = 90.0f;
+	Data.Vertices.Add(V1.Id, V1);
+	Data.Vertices.Add(V2.Id, V2);
+	Data.Walls.Add(Curved.Id, Curved);
+	Doc->MarkFullRebuild();
+
+	FRTPlanSpatialIndex FromDocument;
+	FromDocument.Build(Doc);
+
+	// Build from a snapshot on a worker, as the tool manager does for large plans
+	const FRTPlanSnapshotRef Snapshot = Doc->GetSnapshot();
+	TFuture<TSharedPtr<FRTPlanSpatialIndex, ESPMode::ThreadSafe>> Future = Async(EAsyncExecution::ThreadPool, [Snapshot]()
+	{
+		TSharedPtr<FRTPlanSpatialIndex, ESPMode::ThreadSafe> Built = MakeShared<FRTPlanSpatialIndex, ESPMode::ThreadSafe>();
+		Built->Build(*Snapshot);
+		return Built;
+	});
+	TSharedPtr<FRTPlanSpatialIndex, ESPMode::ThreadSafe> FromSnapshot = Future.Get();
+	if (!TestTrue("Worker produced an index", FromSnapshot.IsValid()))
+	{
+		return false;
+	}
+
+	TestEqual("Same segments", FromSnapshot->GetNumSegments(), FromDocument.GetNumSegments());
+	TestEqual("Same arcs", FromSnapshot->GetNumArcs(), FromDocument.GetNumArcs());
+	TestEqual("Door footprint indexed", FromSnapshot->GetNumOpenings(), 1);
+	TestEqual("Same openings", FromSnapshot->GetNumOpenings(), FromDocument.GetNumOpenings());
+
+	const FVector2D Probes[] = { FVector2D(5, 5), FVector2D(303, 4), FVector2D(2000 + 500 * UE_INV_SQRT_2, 3 + 500 * UE_INV_SQRT_2), FVector2D(1004, 1596) };
+	for (const FVector2D& Probe : Probes)
+	{
+		const FRTSnapResult A = FromDocument.QuerySnap(Probe, 20.0f);
+		const FRTSnapResult B = FromSnapshot->QuerySnap(Probe, 20.0f);
+		TestEqual(FString::Printf(TEXT("Snap at %s: validity"), *Probe.ToString()), B.bValid, A.bValid);
+		TestTrue(FString::Printf(TEXT("Snap at %s: location"), *Probe.ToString()), B.Location.Equals(A.Location, 1e-3));
+		TestEqual(FString::Printf(TEXT("Hit at %s"), *Probe.ToString()), FromSnapshot->HitTestWall(Probe, 10.0f), FromDocument.HitTestWall(Probe, 10.0f));
+	}
+
+	// Swap into a live index: contents move, the version still advances (snap caches refill)
+	FRTPlanSpatialIndex Live;
+	Live.Build(Doc);
+	const uint32 VersionBefore = Live.GetVersion();
+	Live.MoveFrom(MoveTemp(*FromSnapshot));
+	Live.SetDocument(Doc);
+	TestTrue("Version advances on swap", Live.GetVersion() > VersionBefore);
+	TestEqual("Swapped segments", Live.GetNumSegments(), FromDocument.GetNumSegments());
+
+	// Incremental updates continue from the swapped-in contents
+	const uint64 SyncedRevision = Doc->GetRevision();
+	FRTPlanEditList Edits;
+	Edits.RemoveWall(Curved.Id);
+	Doc->SubmitEdits(MoveTemp(Edits), TEXT("Remove Arc"));
+	Live.ApplyDelta(Doc->GetChangedSince(SyncedRevision));
+	TestEqual("Arc removed after swap", Live.GetNumArcs(), 0);
+	TestEqual("Segments untouched", Live.GetNumSegments(), FromDocument.GetNumSegments());
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRTPlanSpatialRaycastTest, "ArchVis.RTPlanSpatial.Raycast", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FRTPlanSpatialRaycastTest::RunTest(const FString& Parameters)
+{
+	URTPlanDocument* Doc = NewObject<URTPlanDocument>();
+	FRTPlanData& Data = Doc->GetDataMutable();
+
+	// Straight wall (0,0)-(400,0), 20cm thick, 300cm high, door 100..190 up to 210cm
+	FRTVertex V1; V1.Id = FGuid::NewGuid(); V1.Position = FVector2D(0, 0);
+	FRTVertex V2; V2.Id = FGuid::NewGuid(); V2.Position = FVector2D(400, 0);
+	FRTWall Straight; Straight.Id = FGuid::NewGuid(); Straight.VertexAId = V1.Id; Straight.VertexBId = V2.Id;
+
+	// Quarter arc wall around (2000,0), radius 500, window at arc length 200..300, 90..210cm high
+	FRTVertex V3; V3.Id = FGuid::NewGuid(); V3.Position = FVector2D(2500, 0);
+	FRTVertex V4; V4.Id = FGuid::NewGuid(); V4.Position = FVector2D(2000, 500);
+	FRTWall Curved; Curved.Id = FGuid::NewGuid(); Curved.VertexAId = V3.Id; Curved.VertexBId = V4.Id;
+	Curved.bIsArc = true; Curved.ArcCenter = FVector2D(2000, 0); Curved.ArcSweepAngle = 90.0f;
+
+	FRTOpening Door; Door.Id = FGuid::NewGuid(); Door.WallId = Straight.Id; Door.OffsetCm = 100.0f; Door.WidthCm = 90.0f; Door.HeightCm = 210.0f;
+	FRTOpening Window; Window.Id = FGuid::NewGuid(); Window.WallId = Curved.Id; Window.OffsetCm = 200.0f; Window.WidthCm = 100.0f;
+	Window.SillHeightCm = 90.0f; Window.HeightCm = 120.0f;
+
+	Data.Vertices.Add(V1.Id, V1);
+	Data.Vertices.Add(V2.Id, V2);
+	Data.Vertices.Add(V3.Id, V3);
+	Data.Vertices.Add(V4.Id, V4);
+	Data.Walls.Add(Straight.Id, Straight);
+	Data.Walls.Add(Curved.Id, Curved);
+	Data.Openings.Add(Door.Id, Door);
+	Data.Openings.Add(Window.Id, Window);
+	Doc->MarkFullRebuild();
+
+	FRTPlanSpatialIndex Index;
+	Index.Build(Doc);
+
+	auto CheckHit = [this, &Index](const TCHAR* Name, const FVector& Origin, const FVector& Direction, bool bHitOpenings, const FGuid& WallId, double Distance, const FVector& Normal)
+	{
+		FRTPlanRayHit Hit;
+		if (!TestTrue(FString::Printf(TEXT("%s: hit"), Name), Index.Raycast(Origin, Direction, 100000.0, Hit, bHitOpenings)))
+		{
+			return Hit;
+		}
+		TestEqual(FString::Printf(TEXT("%s: wall"), Name), Hit.WallId, WallId);
+		TestEqual(FString::Printf(TEXT("%s: distance"), Name), Hit.Distance, Distance, 1e-3);
+		TestTrue(FString::Printf(TEXT("%s: normal"), Name), Hit.Normal.Equals(Normal, 1e-3));
+		return Hit;
+	};
+	auto CheckMiss = [this, &Index](const TCHAR* Name, const FVector& Origin, const FVector& Direction)
+	{
+		FRTPlanRayHit Hit;
+		TestFalse(FString::Printf(TEXT("%s: miss"), Name), Index.Raycast(Origin, Direction, 100000.0, Hit));
+	};
+
+	// Straight wall faces
+	CheckHit(TEXT("Side face"), FVector(300, -500, 150), FVector(0, 1, 0), false, Straight.Id, 490.0, FVector(0, -1, 0));
+	CheckHit(TEXT("Free end face (square at the vertex, as meshed)"), FVector(-100, 0, 150), FVector(1, 0, 0), false, Straight.Id, 100.0, FVector(-1, 0, 0));
+	CheckHit(TEXT("Top face"), FVector(300, 0, 1000), FVector(0, 0, -2), false, Straight.Id, 700.0, FVector(0, 0, 1));
+	CheckMiss(TEXT("Over the wall"), FVector(300, -500, 350), FVector(0, 1, 0));
+
+	// Door: a hole unless openings are solid; the wall above the door is hit
+	CheckMiss(TEXT("Through the door"), FVector(145, -500, 100), FVector(0, 1, 0));
+	CheckHit(TEXT("Above the door"), FVector(145, -500, 250), FVector(0, 1, 0), false, Straight.Id, 490.0, FVector(0, -1, 0));
+	const FRTPlanRayHit DoorHit = CheckHit(TEXT("Solid door"), FVector(145, -500, 100), FVector(0, 1, 0), true, Straight.Id, 490.0, FVector(0, -1, 0));
+	TestEqual("Solid door reports the opening", DoorHit.OpeningId, Door.Id);
+	// Enters the door at x=185 on the front face, meets the door's side (x=190) inside the wall
+	CheckHit(TEXT("Door reveal"), FVector(-305, -500, 100), FVector(1, 1, 0), false, Straight.Id, 495.0 * UE_SQRT_2, FVector(-1, 0, 0));
+
+	// Arc wall: inner / outer faces of the annular sector, and the window hole
+	const FVector Diagonal(UE_INV_SQRT_2, UE_INV_SQRT_2, 0);
+	CheckHit(TEXT("Arc inner face"), FVector(2000, 0, 100), Diagonal, false, Curved.Id, 490.0, -Diagonal);
+	CheckHit(TEXT("Arc outer face"), FVector(2000, 0, 100) + Diagonal * 1000.0, -Diagonal, false, Curved.Id, 490.0, Diagonal);
+	CheckHit(TEXT("Outside the sweep reaches the straight wall"), FVector(2000, 0, 100), FVector(-1, 0, 0), false, Straight.Id, 1600.0, FVector(1, 0, 0));
+	const FVector WindowDir(FMath::Cos(0.5), FMath::Sin(0.5), 0);
+	CheckMiss(TEXT("Through the window"), FVector(2000, 0, 150), WindowDir);
+	CheckHit(TEXT("Below the window sill"), FVector(2000, 0, 50), WindowDir, false, Curved.Id, 490.0, -WindowDir);
+
+	// Incremental: the moved door's hole follows it
+	const uint64 SyncedRevision = Doc->GetRevision();
+	FRTPlanEditList Edits;
+	FRTOpening Moved = Door;
+	Moved.OffsetCm = 250.0f;
+	Edits.SetOpening(Moved);
+	Doc->SubmitEdits(MoveTemp(Edits), TEXT("Move Door"));
+	Index.ApplyDelta(Doc->GetChangedSince(SyncedRevision));
+	CheckHit(TEXT("Old door position is solid"), FVector(145, -500, 100), FVector(0, 1, 0), false, Straight.Id, 490.0, FVector(0, -1, 0));
+	CheckMiss(TEXT("Through the moved door"), FVector(295, -500, 100), FVector(0, 1, 0));
+
+	// Junctions: a stem from the straight wall's B end up to (400,400) and a continuation to (800,0) make a T.
+	// The two through walls are cut square at the vertex, and the stem ends in a wedge between them.
+	{
+		FRTVertex V5; V5.Id = FGuid::NewGuid(); V5.Position = FVector2D(400, 400);
+		FRTVertex V6; V6.Id = FGuid::NewGuid(); V6.Position = FVector2D(800, 0);
+		FRTWall Stem; Stem.Id = FGuid::NewGuid(); Stem.VertexAId = V2.Id; Stem.VertexBId = V5.Id;
+		FRTWall Through; Through.Id = FGuid::NewGuid(); Through.VertexAId = V2.Id; Through.VertexBId = V6.Id;
+		FRTPlanEditList Junction;
+		Junction.SetVertex(V5);
+		Junction.SetVertex(V6);
+		Junction.SetWall(Stem);
+		Junction.SetWall(Through);
+		const uint64 JunctionRevision = Doc->GetRevision();
+		Doc->SubmitEdits(MoveTemp(Junction), TEXT("T Junction"));
+		Index.ApplyDelta(Doc->GetChangedSince(JunctionRevision));
+
+		CheckHit(TEXT("T: left of the vertex"), FVector(397, -500, 150), FVector(0, 1, 0), false, Straight.Id, 490.0, FVector(0, -1, 0));
+		CheckHit(TEXT("T: right of the vertex"), FVector(403, -500, 150), FVector(0, 1, 0), false, Through.Id, 490.0, FVector(0, -1, 0));
+		CheckHit(TEXT("T: stem side"), FVector(300, 200, 150), FVector(1, 0, 0), false, Stem.Id, 90.0, FVector(-1, 0, 0));
+
+		// A rebuild from scratch cuts the same way
+		FRTPlanSpatialIndex Rebuilt;
+		Rebuilt.Build(Doc);
+		FRTPlanRayHit Hit;
+		TestTrue("T rebuilt: hit", Rebuilt.Raycast(FVector(403, -500, 150), FVector(0, 1, 0), 100000.0, Hit));
+		TestEqual("T rebuilt: wall", Hit.WallId, Through.Id);
+	}
+
+	// Arc junction: a wall from the arc's B end (2000,500) up to (2000,1000) meets the arc's end tangent at a right
+	// angle. Both are mitred along (1990,490)-(2010,510), so the arc's end is cut, not radial.
+	{
+		FRTVertex V7; V7.Id = FGuid::NewGuid(); V7.Position = FVector2D(2000, 1000);
+		FRTWall Upright; Upright.Id = FGuid::NewGuid(); Upright.VertexAId = V4.Id; Upright.VertexBId = V7.Id;
+		FRTPlanEditList Corner;
+		Corner.SetVertex(V7);
+		Corner.SetWall(Upright);
+		const uint64 CornerRevision = Doc->GetRevision();
+		Doc->SubmitEdits(MoveTemp(Corner), TEXT("Arc Corner"));
+		Index.ApplyDelta(Doc->GetChangedSince(CornerRevision));
+
+		// Past the end radius, below the mitre: the arc's inner corner reaches x = 1990
+		const double InnerY = FMath::Sqrt(490.0 * 490.0 - 25.0);
+		CheckHit(TEXT("Arc corner: inner face past the end radius"), FVector(1995, 0, 150), FVector(0, 1, 0), false, Curved.Id, InnerY, FVector(5, -InnerY, 0) / 490.0);
+		CheckHit(TEXT("Arc corner: top below the mitre"), FVector(1995, 492, 400), FVector(0, 0, -1), false, Curved.Id, 100.0, FVector(0, 0, 1));
+
+		// Inside the end radius, above the mitre: cut off the arc, part of the upright wall
+		CheckHit(TEXT("Arc corner: top above the mitre"), FVector(2008, 509, 400), FVector(0, 0, -1), false, Upright.Id, 100.0, FVector(0, 0, 1));
+	}
+
+	// Lattice: first wall along the ray, and timing over many rays
+	{
+		URTPlanDocument* Lattice = RTPlanSpatialTestsPrivate::MakeLatticePlan(50);
+		FRTPlanSpatialIndex LatticeIndex;
+		LatticeIndex.Build(Lattice);
+
+		FRTPlanRayHit Hit;
+		TestTrue("Lattice: hit from outside", LatticeIndex.Raycast(FVector(100, -1000, 150), FVector(0, 1, 0), 100000.0, Hit));
+		TestEqual("Lattice: nearest wall face", Hit.Distance, 990.0, 1e-3);
+		TestTrue("Lattice: hit inside a cell", LatticeIndex.Raycast(FVector(100, 90, 150), FVector(1, 1, 0), 100000.0, Hit));
+		TestEqual("Lattice: next to the cell corner", Hit.Distance, 90.0 * UE_SQRT_2, 1e-3);
+
+		FRandomStream Random(7);
+		int32 NumHits = 0;
+		const double Start = FPlatformTime::Seconds();
+		for (int32 i = 0; i < 1000; ++i)
+		{
+			const FVector Origin(Random.FRandRange(0, 10000), Random.FRandRange(0, 10000), 170.0);
+			const FVector Direction(Random.FRandRange(-1, 1), Random.FRandRange(-1, 1), Random.FRandRange(-0.5, 0.1));
+			NumHits += LatticeIndex.Raycast(Origin, Direction, 100000.0, Hit) ? 1 : 0;
+		}
+		const double Elapsed = FPlatformTime::Seconds() - Start;
+		TestTrue("Lattice: random rays hit", NumHits > 900);
+		AddInfo(FString::Printf(TEXT("1000 rays over %d walls: %.3f ms (%d hits)"), Lattice->GetData().Walls.Num(), Elapsed * 1e3, NumHits));
+	}
+
+	return true;
+}
@@ -0,0 +1,319 @@
+﻿#include "RTPlanWallIntersections.h"
+#include "RTPlanGeometryUtils.h"
+#include "RTPlanSpatialIndex.h"
+#include "Algo/Sort.h"
+
+namespace RTPlanWallIntersectionsPrivate
+{
+	// Bounds touching within this distance are tested (crossings exactly at a wall end)
+	constexpr double Slack = UE_KINDA_SMALL_NUMBER;
+}
+
+bool FRTPlanWallIntersections::Update(const URTPlanDocument* Document)
+{
+	if (bBuilt && Document == CachedDocument && (!Document || Document->GetRevision() == CachedRevision))
+	{
+		return false;
+	}
+
+	if (!bBuilt || Document != CachedDocument)
+	{
+		Build(Document);
+		return true;
+	}
+
+	const FRTPlanDelta Delta = Document->GetChangedSince(CachedRevision);
+	if (Delta.bFullRebuild)
+	{
+		Build(Document);
+		return true;
+	}
+
+	ApplyDelta(Document, Delta);
+	CachedRevision = Document->GetRevision();
+	return true;
+}
+
+void FRTPlanWallIntersections::Reset()
+{
+	Primitives.Reset();
+	FreePrimitives.Reset();
+	PrimitiveIndices.Reset();
+	Grid.Reset(FRTPlanSpatialIndex::MinCellSize);
+	Crossings.Reset();
+	ChangedCrossings.Reset();
+	CachedDocument = nullptr;
+	CachedRevision = 0;
+	bBuilt = false;
+	NumIntersections = 0;
+	NumPairTests = 0;
+}
+
+void FRTPlanWallIntersections::Build(const URTPlanDocument* Document)
+{
+	Reset();
+	CachedDocument = Document;
+	bBuilt = true;
+
+	if (!Document)
+	{
+		return;
+	}
+	CachedRevision = Document->GetRevision();
+
+	// Cells around the typical wall length, as in the spatial index
+	const FRTPlanDenseStore& Store = Document->GetDenseStore();
+	double TotalLength = 0.0;
+	int32 NumWalls = 0;
+	Store.ForEachWall([&TotalLength, &NumWalls](const FRTWall& Wall, const FVector2D& A, const FVector2D& B)
+	{
+		TotalLength += FVector2D::Distance(A, B);
+		++NumWalls;
+	});
+	Grid.Reset(NumWalls > 0
+		? FMath::Clamp((float)(TotalLength / NumWalls), FRTPlanSpatialIndex::MinCellSize, FRTPlanSpatialIndex::MaxCellSize)
+		: FRTPlanSpatialIndex::MinCellSize);
+
+	// Each wall is tested against the walls added before it, so every pair is tested once
+	Primitives.Reserve(NumWalls);
+	Store.ForEachWall([this](const FRTWall& Wall, const FVector2D& A, const FVector2D& B)
+	{
+		AddPrimitive(Wall, A, B);
+	});
+	RefreshCuts();
+
+	UE_LOG(LogTemp, Verbose, TEXT("WallIntersections: %d walls, %d pair tests, %d intersections"),
+		NumWalls, NumPairTests, NumIntersections);
+}
+
+void FRTPlanWallIntersections::ApplyDelta(const URTPlanDocument* Document, const FRTPlanDelta& Delta)
+{
+	NumIntersections = 0;
+	NumPairTests = 0;
+
+	// Edited walls plus every wall attached to a changed vertex (each once)
+	TSet<FGuid> DirtyWalls;
+	DirtyWalls.Append(Delta.Walls.Added);
+	DirtyWalls.Append(Delta.Walls.Modified);
+	DirtyWalls.Append(Delta.Walls.Removed);
+	for (const TSet<FGuid>* VertexIds : { &Delta.Vertices.Added, &Delta.Vertices.Modified, &Delta.Vertices.Removed })
+	{
+		for (const FGuid& VertexId : *VertexIds)
+		{
+			DirtyWalls.Append(Document->GetWallsAtVertex(VertexId));
+		}
+	}
+
+	// Take all of them out first: re-added walls are then tested against each other once
+	for (const FGuid& WallId : DirtyWalls)
+	{
+		RemovePrimitive(WallId);
+	}
+
+	const FRTPlanData& Data = Document->GetData();
+	for (const FGuid& WallId : DirtyWalls)
+	{
+		const FRTWall* Wall = Data.Walls.Find(WallId);
+		const FRTVertex* VA = Wall ? Data.Vertices.Find(Wall->VertexAId) : nullptr;
+		const FRTVertex* VB = Wall ? Data.Vertices.Find(Wall->VertexBId) : nullptr;
+		if (VA && VB)
+		{
+			AddPrimitive(*Wall, VA->Position, VB->Position);
+		}
+	}
+	RefreshCuts();
+
+	UE_LOG(LogTemp, Verbose, TEXT("WallIntersections: updated %d walls, %d pair tests, %d intersections"),
+		DirtyWalls.Num(), NumPairTests, NumIntersections);
+}
+
+void FRTPlanWallIntersections::AddPrimitive(const FRTWall& Wall, const FVector2D& A, const FVector2D& B)
+{
+	const int32 Index = FreePrimitives.Num() > 0 ? FreePrimitives.Pop(EAllowShrinking::No) : Primitives.AddDefaulted();
+	FPrimitive& Primitive = Primitives[Index];
+	Primitive = FPrimitive();
+	Primitive.WallId = Wall.Id;
+	Primitive.A = A;
+	Primitive.B = B;
+	if (IsArcWall(Wall))
+	{
+		Primitive.bArc = true;
+		Primitive.Arc = FRTPlanArc::FromCenterStartSweep(Wall.ArcCenter, A, Wall.ArcSweepAngle);
+		Primitive.Bounds = Primitive.Arc.GetBounds();
+	}
+	else
+	{
+		Primitive.Bounds += A;
+		Primitive.Bounds += B;
+	}
+	PrimitiveIndices.Add(Wall.Id, Index);
+
+	// Only walls sharing a cell with the bounds are visited, and only overlapping bounds are tested
+	const FBox2D QueryBounds = Primitive.Bounds.ExpandBy(RTPlanWallIntersectionsPrivate::Slack);
+	Grid.Query(QueryBounds.Min, QueryBounds.Max, [this, &Primitive, &QueryBounds](int32 OtherIndex)
+	{
+		const FPrimitive& Other = Primitives[OtherIndex];
+		if (Other.Bounds.Intersect(QueryBounds))
+		{
+			TestPair(Other, Primitive);
+		}
+	});
+
+	if (Primitive.bArc)
+	{
+		Grid.InsertBox(Index, Primitive.Bounds);
+	}
+	else
+	{
+		Grid.InsertSegment(Index, A, B);
+	}
+}
+
+void FRTPlanWallIntersections::RemovePrimitive(const FGuid& WallId)
+{
+	int32 Index;
+	if (!PrimitiveIndices.RemoveAndCopyValue(WallId, Index))
+	{
+		return;
+	}
+
+	const FPrimitive& Primitive = Primitives[Index];
+	if (Primitive.bArc)
+	{
+		Grid.RemoveBox(Index, Primitive.Bounds);
+	}
+	else
+	{
+		Grid.RemoveSegment(Index, Primitive.A, Primitive.B);
+	}
+
+	// Any wall that recorded a crossing with this one overlaps its bounds
+	const FBox2D QueryBounds = Primitive.Bounds.ExpandBy(RTPlanWallIntersectionsPrivate::Slack);
+	Grid.Query(QueryBounds.Min, QueryBounds.Max, [this, &WallId](int32 OtherIndex)
+	{
+		const FGuid& OtherWallId = Primitives[OtherIndex].WallId;
+		FWallCrossings* OtherCrossings = Crossings.Find(OtherWallId);
+		if (OtherCrossings && OtherCrossings->All.RemoveAllSwap([&WallId](const FRTWallCrossing& Crossing) { return Crossing.OtherWallId == WallId; }) > 0)
+		{
+			ChangedCrossings.Add(OtherWallId);
+		}
+	});
+
+	Crossings.Remove(WallId);
+	ChangedCrossings.Remove(WallId);
+	FreePrimitives.Add(Index);
+}
+
+void FRTPlanWallIntersections::RefreshCuts()
+{
+	for (const FGuid& WallId : ChangedCrossings)
+	{
+		FWallCrossings* WallCrossings = Crossings.Find(WallId);
+		if (!WallCrossings)
+		{
+			continue;
+		}
+		if (WallCrossings->All.Num() == 0)
+		{
+			Crossings.Remove(WallId);
+			continue;
+		}
+
+		Algo::SortBy(WallCrossings->All, &FRTWallCrossing::T);
+
+		// Several walls meeting in one point cut this wall once
+		TArray<FRTWallCrossing>& Cuts = WallCrossings->Cuts;
+		Cuts.Reset();
+		for (const FRTWallCrossing& Crossing : WallCrossings->All)
+		{
+			if (Cuts.Num() == 0 || Crossing.T - Cuts.Last().T >= EndpointTolerance)
+			{
+				Cuts.Add(Crossing);
+			}
+		}
+	}
+	ChangedCrossings.Reset();
+}
+
+void FRTPlanWallIntersections::TestPair(const FPrimitive& First, const FPrimitive& Second)
+{
+	++NumPairTests;
+
+	FVector2D Hits[2];
+	int32 NumHits = 0;
+
+	if (!First.bArc && !Second.bArc)
+	{
+		NumHits = FRTPlanGeometryUtils::SegmentIntersection(First.A, First.B, Second.A, Second.B, Hits[0]) ? 1 : 0;
+	}
+	else if (First.bArc && Second.bArc)
+	{
+		NumHits = First.Arc.IntersectArc(Second.Arc, Hits);
+	}
+	else
+	{
+		const FPrimitive& Arc = First.bArc ? First : Second;
+		const FPrimitive& Segment = First.bArc ? Second : First;
+		NumHits = Arc.Arc.IntersectSegment(Segment.A, Segment.B, Hits);
+	}
+
+	for (int32 i = 0; i < NumHits; ++i)
+	{
+		++NumIntersections;
+		AddCrossing(First, Hits[i], Second.WallId);
+		AddCrossing(Second, Hits[i], First.WallId);
+	}
+}
+
+void FRTPlanWallIntersections::AddCrossing(const FPrimitive& Wall, const FVector2D& Point, const FGuid& OtherWallId)
+{
+	double T = 0.0;
+	if (Wall.bArc)
+	{
+		const FVector2D ToPoint = Point - Wall.Arc.Center;
+		Wall.Arc.ContainsAngle(FMath::Atan2(ToPoint.Y, ToPoint.X), &T);
+	}
+	else
+	{
+		const FVector2D AB = Wall.B - Wall.A;
+		const double LengthSq = AB.SizeSquared();
+		T = LengthSq > UE_DOUBLE_KINDA_SMALL_NUMBER ? ((Point - Wall.A) | AB) / LengthSq : 0.0;
+	}
+
+	// Ends touching other walls (corners, T-junction stems) do not divide this wall
+	if (T > EndpointTolerance && T < 1.0 - EndpointTolerance)
+	{
+		Crossings.FindOrAdd(Wall.WallId).All.Add({ T, OtherWallId });
+		ChangedCrossings.Add(Wall.WallId);
+	}
+}
+
+TConstArrayView<FRTWallCrossing> FRTPlanWallIntersections::GetCrossings(const FGuid& WallId) const
+{
+	if (const FWallCrossings* WallCrossings = Crossings.Find(WallId))
+	{
+		return WallCrossings->Cuts;
+	}
+	return TConstArrayView<FRTWallCrossing>();
+}
+
+double FRTPlanWallIntersections::GetWallParameter(const FRTWall& Wall, const FVector2D& A, const FVector2D& B, const FVector2D& Point)
+{
+	if (IsArcWall(Wall))
+	{
+		const FRTPlanArc Arc = FRTPlanArc::FromCenterStartSweep(Wall.ArcCenter, A, Wall.ArcSweepAngle);
+		const FVector2D Closest = Arc.ClosestPoint(Point);
+		const FVector2D ToClosest = Closest - Arc.Center;
+		double T = 0.0;
+		if (!Arc.ContainsAngle(FMath::Atan2(ToClosest.Y, ToClosest.X), &T))
+		{
+			// Rounding just past an end
+			T = FVector2D::DistSquared(Closest, Arc.GetStart()) <= FVector2D::DistSquared(Closest, Arc.GetEnd()) ? 0.0 : 1.0;
+		}
+		return T;
+	}
+
+	const FVector2D AB = B - A;
+	const double LengthSq = AB.SizeSquared();
+	return LengthSq > UE_DOUBLE_KINDA_SMALL_NUMBER ? FMath::Clamp(((Point - A) | AB) / LengthSq, 0.0, 1.0) : 0.5;
+}
@@ -0,0 +1,125 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * RTPlanAlignmentIndex.h
+ * Alignment guides (CAD "tracking lines") kept in sorted arrays for O(log n) cursor queries.
+ * Guides are grouped in families of parallel lines: vertical lines through every point (matching X),
+ * horizontal lines through every point (matching Y), and one family per wall direction for extension
+ * lines of non-axis-aligned walls. Each family is sorted by the lines' offset along its normal, and
+ * each line's sources are sorted along the line, so both the nearest line and its nearest source are
+ * binary searches.
+ */
+
+enum class ERTAlignmentGuideType : uint8
+{
+	Vertical,   // Same X as the source
+	Horizontal, // Same Y as the source
+	Extension   // Continuation of a wall through its endpoints
+};
+
+/**
+ * An alignment guide near the cursor: infinite line through Source along Direction.
+ */
+struct RTPLANSPATIAL_API FRTAlignmentGuide
+{
+	ERTAlignmentGuideType Type = ERTAlignmentGuideType::Vertical;
+	FVector2D Source = FVector2D::ZeroVector;     // Geometry the guide comes from (nearest to the cursor)
+	FVector2D Direction = FVector2D(0.0f, 1.0f);  // Unit direction of the line
+	FGuid SourceVertexId;                         // Invalid for wall midpoints
+	FGuid SourceWallId;                           // Set for wall midpoints and extension lines
+	float Distance = FLT_MAX;                     // Cursor distance to the line
+
+	// Closest point on the guide line
+	FVector2D Project(const FVector2D& P) const { return Source + Direction * ((P - Source) | Direction); }
+
+	// Intersection of two guide lines. Returns false if they are parallel.
+	static bool Intersect(const FRTAlignmentGuide& A, const FRTAlignmentGuide& B, FVector2D& OutPoint);
+};
+
+class RTPLANSPATIAL_API FRTPlanAlignmentIndex
+{
+public:
+	FRTPlanAlignmentIndex() { Reset(); }
+
+	void Reset();
+
+	/**
+	 * Bulk loading for full rebuilds: sources added in between are only collected, then sorted once and merged
+	 * into lines in one linear pass (instead of a sorted insert each). No queries or removals until EndBulkAdd.
+	 */
+	void BeginBulkAdd();
+	void EndBulkAdd();
+
+	// Vertical + horizontal guides through P (vertex or wall midpoint)
+	void AddPoint(const FVector2D& P, const FGuid& VertexId, const FGuid& WallId);
+	void RemovePoint(const FVector2D& P, const FGuid& VertexId, const FGuid& WallId);
+
+	// Extension guide along a straight wall (sources at both endpoints). Axis-aligned walls are skipped:
+	// their extensions are already the horizontal / vertical guides through the endpoints.
+	void AddExtension(const FVector2D& A, const FVector2D& B, const FGuid& VertexAId, const FGuid& VertexBId, const FGuid& WallId);
+	void RemoveExtension(const FVector2D& A, const FVector2D& B, const FGuid& WallId);
+
+	/**
+	 * The nearest guide of each family within Radius of Cursor, sorted by distance.
+	 * O(F log n) for F guide families (two plus the number of distinct non-axis wall directions).
+	 */
+	void QueryGuides(const FVector2D& Cursor, float Radius, TArray<FRTAlignmentGuide>& OutGuides) const;
+
+	int32 GetNumFamilies() const { return Families.Num(); }
+
+	// Offsets closer than this are the same line (cm)
+	static constexpr double LineTolerance = 1e-3;
+
+	// Wall directions are bucketed to this resolution (degrees) to form extension families
+	static constexpr double DirectionResolution = 0.01;
+
+private:
+	struct FSource
+	{
+		double T = 0.0; // Position along the line
+		FVector2D Position = FVector2D::ZeroVector;
+		FGuid VertexId;
+		FGuid WallId;
+	};
+
+	struct FLine
+	{
+		double Offset = 0.0; // Position along the family normal
+		TArray<FSource, TInlineAllocator<2>> Sources; // Sorted by T
+	};
+
+	struct FFamily
+	{
+		ERTAlignmentGuideType Type = ERTAlignmentGuideType::Vertical;
+		FVector2D Direction = FVector2D::ZeroVector;
+		FVector2D Normal = FVector2D::ZeroVector;
+		TArray<FLine> Lines; // Sorted by Offset, one entry per distinct line
+	};
+
+	// Source collected during a bulk load
+	struct FPendingSource
+	{
+		int32 Family = 0;
+		double Offset = 0.0;
+		FSource Source;
+	};
+
+	// [0] vertical, [1] horizontal, then extension families
+	TArray<FFamily> Families;
+	TMap<int32, int32> ExtensionFamilies; // Direction bucket -> index in Families
+
+	TArray<FPendingSource> PendingSources;
+	bool bBulkAdd = false;
+
+	// Sorted insert into the line at Offset (along the family normal), or collected for EndBulkAdd during a bulk load
+	void AddSource(int32 FamilyIndex, double Offset, const FVector2D& P, const FGuid& VertexId, const FGuid& WallId);
+
+	// Removes sources of the line through P matching the predicate; drops the line when it has none left
+	template<typename PredicateType>
+	static void RemoveSources(FFamily& Family, const FVector2D& P, PredicateType&& Predicate);
+
+	// Returns INDEX_NONE for axis-aligned or degenerate walls
+	int32 FindExtensionFamily(const FVector2D& A, const FVector2D& B, bool bCreate);
+};
@@ -0,0 +1,117 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/Optional.h"
+
+/**
+ * RTPlanSnap.h
+ * Snap query types: enum-tagged results, per-tier candidate sets in fixed storage and a
+ * per-caller cache that lets consecutive cursor queries skip the grid traversal.
+ */
+
+class FRTPlanSpatialIndex;
+
+enum class ERTSnapType : uint8
+{
+	None,
+	Endpoint,
+	Midpoint,
+	Intersection,
+	Perpendicular,
+	Projection,
+	Grid,
+	Alignment
+};
+
+RTPLANSPATIAL_API const TCHAR* LexToString(ERTSnapType Type);
+
+/**
+ * Result of a snap query.
+ */
+struct FRTSnapResult
+{
+	bool bValid = false;
+	FVector2D Location = FVector2D::ZeroVector;
+	float Distance = FLT_MAX;
+	ERTSnapType Type = ERTSnapType::None;
+	FGuid WallId; // Wall the snap lies on (midpoints, projections, perpendiculars, first wall of an intersection)
+};
+
+/**
+ * Snap query parameters.
+ */
+struct FRTSnapQuery
+{
+	FVector2D Cursor = FVector2D::ZeroVector;
+	float Radius = 20.0f;
+
+	// Reference point for perpendicular snaps (e.g. start of the wall being drawn)
+	TOptional<FVector2D> From;
+
+	// Grid tier spacing; 0 disables it. The grid candidate is always offered (not limited by Radius).
+	float GridSize = 0.0f;
+
+	// Spacing tools use for the grid tier unless configured otherwise
+	static constexpr float DefaultGridSize = 100.0f;
+};
+
+/**
+ * Up to MaxPerTier nearest candidates for each snap tier, in fixed storage (no heap allocations).
+ */
+struct RTPLANSPATIAL_API FRTSnapCandidates
+{
+	static constexpr int32 MaxPerTier = 4;
+	static constexpr int32 NumTiers = (int32)ERTSnapType::Grid; // Endpoint .. Grid
+
+	void Reset();
+
+	// Keep the candidate if it is among the nearest of its tier
+	void Add(ERTSnapType Type, const FVector2D& Location, float Distance, const FGuid& WallId = FGuid());
+
+	// Candidates of one tier, nearest first
+	TConstArrayView<FRTSnapResult> Get(ERTSnapType Type) const;
+
+	/**
+	 * The snap to apply: nearest point-like candidate (endpoint, midpoint, intersection),
+	 * else perpendicular, else projection, else grid.
+	 */
+	FRTSnapResult GetBest() const;
+
+private:
+	static int32 TierIndex(ERTSnapType Type) { return (int32)Type - 1; }
+
+	FRTSnapResult Results[NumTiers][MaxPerTier];
+	int32 Num[NumTiers] = {};
+};
+
+/**
+ * Candidate set carried between consecutive queries of one caller (e.g. a tool's cursor snapping).
+ * The first query gathers grid candidates over an enlarged area; while the cursor stays inside it and
+ * the index is unchanged, later queries only re-score those candidates.
+ * Owned by the caller, filled by FRTPlanSpatialIndex::QuerySnapCandidates.
+ * The candidate arrays are reset, not freed, between gathers: once they have grown to the densest
+ * area visited, later queries allocate nothing, however many candidates the area holds.
+ */
+struct FRTSnapQueryCache
+{
+	// Gather area = query radius * this
+	static constexpr float GatherScale = 3.0f;
+
+	void Invalidate() { Index = nullptr; }
+
+	// Stats (for profiling / tests)
+	int32 NumReused = 0;
+	int32 NumGathered = 0;
+
+private:
+	friend class FRTPlanSpatialIndex;
+
+	const FRTPlanSpatialIndex* Index = nullptr;
+	uint32 IndexVersion = 0;
+	FVector2D Center = FVector2D::ZeroVector;
+	float GatherRadius = 0.0f;
+
+	TArray<int32> Points;
+	TArray<int32> Segments;
+	TArray<int32> Arcs;
+};
@@ -0,0 +1,114 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * RTPlanSpatialGrid.h
+ * Uniform hash grid over 2D items (points or segments) referenced by index.
+ * Only occupied cells are stored, so memory is O(items) regardless of the plan extent.
+ * Queries visit the cells overlapping a box: O(1 + k) for the small radii used by snapping and picking.
+ * Items can be removed individually (pass the same coordinates they were inserted with).
+ */
+class RTPLANSPATIAL_API FRTPlanSpatialGrid
+{
+public:
+	// Clear and set the cell size (world units, cm)
+	void Reset(float InCellSize);
+
+	void InsertPoint(int32 Item, const FVector2D& P);
+
+	// Inserted into every cell the segment passes through (not its whole bounding box)
+	void InsertSegment(int32 Item, const FVector2D& A, const FVector2D& B);
+
+	void RemovePoint(int32 Item, const FVector2D& P);
+	void RemoveSegment(int32 Item, const FVector2D& A, const FVector2D& B);
+
+	// Inserted into every cell overlapping the box (curves: pass their tight bounds)
+	void InsertBox(int32 Item, const FBox2D& Box);
+	void RemoveBox(int32 Item, const FBox2D& Box);
+
+	/**
+	 * Visit every item in the cells overlapping [Min, Max]. Each item is visited once.
+	 * Candidates only: callers still run their exact distance / intersection test.
+	 * Not thread-safe (uses an internal visit stamp); call from the owning thread.
+	 */
+	template<typename FuncType>
+	void Query(const FVector2D& Min, const FVector2D& Max, FuncType&& Visitor) const
+	{
+		if (Cells.Num() == 0)
+		{
+			return;
+		}
+
+		const FIntPoint CellMin = ToCell(Min);
+		const FIntPoint CellMax = ToCell(Max);
+
+		// Huge query boxes (e.g. a marquee over the whole plan) are cheaper as a scan of occupied cells
+		const int64 NumQueryCells = int64(CellMax.X - CellMin.X + 1) * int64(CellMax.Y - CellMin.Y + 1);
+		const uint32 Stamp = NextStamp();
+
+		auto VisitCell = [this, Stamp, &Visitor](const TArray<int32>& Items)
+		{
+			for (const int32 Item : Items)
+			{
+				if (VisitStamps[Item] != Stamp)
+				{
+					VisitStamps[Item] = Stamp;
+					Visitor(Item);
+				}
+			}
+		};
+
+		if (NumQueryCells > Cells.Num())
+		{
+			for (const auto& Pair : Cells)
+			{
+				if (Pair.Key.X >= CellMin.X && Pair.Key.X <= CellMax.X && Pair.Key.Y >= CellMin.Y && Pair.Key.Y <= CellMax.Y)
+				{
+					VisitCell(Pair.Value);
+				}
+			}
+			return;
+		}
+
+		for (int32 Y = CellMin.Y; Y <= CellMax.Y; ++Y)
+		{
+			for (int32 X = CellMin.X; X <= CellMax.X; ++X)
+			{
+				if (const TArray<int32>* Items = Cells.Find(FIntPoint(X, Y)))
+				{
+					VisitCell(*Items);
+				}
+			}
+		}
+	}
+
+	FIntPoint ToCell(const FVector2D& P) const
+	{
+		return FIntPoint(FMath::FloorToInt32(P.X * InvCellSize), FMath::FloorToInt32(P.Y * InvCellSize));
+	}
+
+	float GetCellSize() const { return CellSize; }
+	int32 GetNumCells() const { return Cells.Num(); }
+
+private:
+	void AddToCell(const FIntPoint& Cell, int32 Item);
+	void RemoveFromCell(const FIntPoint& Cell, int32 Item);
+
+	// Calls Func(Cell) for every cell the segment passes through
+	template<typename FuncType>
+	void ForEachSegmentCell(const FVector2D& A, const FVector2D& B, FuncType&& Func) const;
+
+	template<typename FuncType>
+	void ForEachBoxCell(const FBox2D& Box, FuncType&& Func) const;
+	uint32 NextStamp() const;
+
+	float CellSize = 100.0f;
+	float InvCellSize = 0.01f;
+
+	TMap<FIntPoint, TArray<int32>> Cells;
+
+	// Per-item stamp of the last query that visited it (dedupes items spanning several cells)
+	mutable TArray<uint32> VisitStamps;
+	mutable uint32 CurrentStamp = 0;
+};
@@ -3,33 +3,91 @@
 #include "CoreMinimal.h"
 #include "RTPlanSchema.h"
 #include "RTPlanDocument.h"
+#include "RTPlanDelta.h"
+#include "RTPlanSnapshot.h"
+#include "RTPlanSpatialGrid.h"
+#include "RTPlanAlignmentIndex.h"
+#include "RTPlanArc.h"
+#include "RTPlanSnap.h"
 
 /**
- * Result of a snap query.
+ * Result of a 3D ray query against the wall volumes.
  */
-struct FRTSnapResult
+struct FRTPlanRayHit
 {
-	bool bValid = false;
-	FVector2D Location = FVector2D::ZeroVector;
-	float Distance = FLT_MAX;
-	FString DebugType; // "Endpoint", "Midpoint", "Grid", "Alignment"
+	bool bHit = false;
+	FVector Location = FVector::ZeroVector;
+	FVector Normal = FVector::ZeroVector; // Face normal, facing the ray
+	double Distance = 0.0; // Along the ray, world units
+	FGuid WallId;
+	FGuid OpeningId; // Opening whose volume was hit (only when openings are treated as solid)
 };
 
 /**
  * Spatial Index for fast queries and snapping.
- * Rebuilt when PlanDocument changes.
+ * Built once from the PlanDocument, then kept in sync per entity (ApplyDelta / AddWall / UpdateVertex ...)
+ * so an edit only touches the snap points and segments of the walls it affects.
+ * Snap points and segments are bucketed in uniform hash grids so snap / hit queries only
+ * look at nearby candidates instead of scanning the whole plan.
+ * Arc walls are stored as exact arcs (FRTPlanArc), not tessellated, so snapping and picking
+ * follow the true curve.
+ * Walls also keep their extrusion (thickness, base, height) and junction cuts, so 3D rays can be
+ * picked against the same wall volumes the shell meshes analytically (Raycast) without mesh collision.
+ * Large rebuilds can run on a worker from a plan snapshot (Build(Snapshot)) into a separate
+ * index that the owner then swaps in on the game thread (MoveFrom).
  */
 class RTPLANSPATIAL_API FRTPlanSpatialIndex
 {
 public:
 	void Build(const URTPlanDocument* Document);
 
+	// Build from an immutable snapshot. Safe on any thread (touches no UObjects).
+	// Call SetDocument afterwards (on the game thread) before applying incremental updates.
+	void Build(const FRTPlanSnapshot& Snapshot);
+
+	// Document read by incremental updates
+	void SetDocument(const URTPlanDocument* Document) { CachedDocument = Document; }
+
+	// Take over the contents of an index built elsewhere (e.g. on a worker).
+	// The version still advances, so snap caches filled from the old contents are invalidated.
+	void MoveFrom(FRTPlanSpatialIndex&& Other);
+
+	// --- Incremental updates (read current values from the document passed to Build) ---
+
+	// Apply a document change-set. Falls back to Build() for full-rebuild deltas.
+	void ApplyDelta(const FRTPlanDelta& Delta);
+
+	// Index a wall (replaces its previous entries if already indexed). Walls with missing vertices are skipped.
+	// Adding or removing a wall also re-cuts the ends of the walls sharing its junctions.
+	void AddWall(const FGuid& WallId);
+	void RemoveWall(const FGuid& WallId);
+	void UpdateWall(const FGuid& WallId) { AddWall(WallId); }
+
+	// Re-index a vertex (added, moved or removed) and the walls attached to it
+	void UpdateVertex(const FGuid& VertexId);
+
+	// Re-index an opening (added, moved, resized or removed). Hosted openings are also re-indexed with their wall.
+	void UpdateOpening(const FGuid& OpeningId);
+
 	// Find the best snap point near CursorPos within Radius.
 	FRTSnapResult QuerySnap(const FVector2D& CursorPos, float Radius) const;
 
-	// Find alignment guides (matching X or Y coordinates of existing vertices)
-	// Returns a modified position that aligns with existing geometry if within Radius.
-	bool QueryAlignment(const FVector2D& CursorPos, float Radius, FVector2D& OutAlignedPos) const;
+	/**
+	 * Tiered snap query: fills the nearest candidates per tier (endpoint, midpoint, intersection,
+	 * perpendicular, projection, grid) without heap allocations in the common case.
+	 * Pass the caller's Cache on consecutive cursor queries to reuse the previous candidate set
+	 * while the cursor moves within it.
+	 */
+	void QuerySnapCandidates(const FRTSnapQuery& Query, FRTSnapCandidates& OutCandidates, FRTSnapQueryCache* Cache = nullptr) const;
+
+	// Bumped on every change to the indexed geometry (invalidates snap caches)
+	uint32 GetVersion() const { return Version; }
+
+	// Find alignment guides (matching X or Y of existing points, or extending existing walls)
+	// Returns a modified position that aligns with existing geometry if within Radius:
+	// the intersection of the two nearest crossing guides when close enough, else the nearest guide.
+	// OutGuides (optional) receives the guides the aligned position lies on, for drawing.
+	bool QueryAlignment(const FVector2D& CursorPos, float Radius, FVector2D& OutAlignedPos, TArray<FRTAlignmentGuide>* OutGuides = nullptr) const;
 
 	// --- Hit Testing for Selection ---
 	
@@ -40,27 +98,50 @@ public:
 	// Hit test a rectangle against walls, returns all wall IDs that intersect
 	TArray<FGuid> HitTestWallsInRect(const FVector2D& RectMin, const FVector2D& RectMax) const;
 
-	// Hit test a single point against openings, returns the closest opening ID within tolerance
+	// Hit test a single point against opening footprints, returns the closest opening ID within tolerance
+	// (points inside several footprints pick the opening whose center is nearest)
 	FGuid HitTestOpening(const FVector2D& Point, float Tolerance = 10.0f) const;
 
-	// Hit test a rectangle against openings, returns all opening IDs that intersect
+	// Hit test a rectangle against opening footprints, returns all opening IDs that intersect
 	TArray<FGuid> HitTestOpeningsInRect(const FVector2D& RectMin, const FVector2D& RectMax) const;
 
+	/**
+	 * Nearest hit of a 3D ray with the extruded wall volumes. Straight walls are boxes between their end faces:
+	 * square at the vertex for free ends, cut where walls meet as FRTPlanJunctionSolver cuts them for the shell
+	 * mesh (mitres, T / X hubs). Arc walls are exact annular sectors, with their ends cut the same way along the
+	 * end tangents (between the ends the mesh is a tessellation of the sector, so picks there agree to within its chord error).
+	 * Openings cut holes (OffsetCm .. OffsetCm + WidthCm, BaseZ + SillHeightCm .. + HeightCm) the ray passes
+	 * through; with bHitOpenings they are solid instead and the hit reports the opening.
+	 * Direction need not be normalized; MaxDistance and OutHit.Distance are world units along it.
+	 */
+	bool Raycast(const FVector& Origin, const FVector& Direction, double MaxDistance, FRTPlanRayHit& OutHit, bool bHitOpenings = false) const;
+
 	// Debug: Draw all segments in the spatial index
 	void DrawDebugSegments(UWorld* World, float Duration = 5.0f) const;
 
 	// Get the number of segments in the index
-	int32 GetNumSegments() const { return SnapSegments.Num(); }
+	int32 GetNumSegments() const { return SnapSegments.Num() - FreeSegments.Num(); }
+	int32 GetNumArcs() const { return SnapArcs.Num() - FreeArcs.Num(); }
+	int32 GetNumOpenings() const { return Openings.Num() - FreeOpenings.Num(); }
+
+	// Grid cell size is derived from the average wall length at Build() time, clamped to this range (cm).
+	// Incremental updates keep the cell size.
+	static constexpr float MinCellSize = 50.0f;
+	static constexpr float MaxCellSize = 1000.0f;
 
 private:
 	// Cache of snap points (Endpoints, Midpoints)
 	struct FSnapPoint
 	{
 		FVector2D Position;
-		FString Type;
+		ERTSnapType Type = ERTSnapType::Endpoint;
+		bool bAlignment = false; // Contributes alignment guides
+		FGuid VertexId; // Source entity (vertex for endpoints, wall for midpoints)
+		FGuid WallId;
 	};
 
 	TArray<FSnapPoint> SnapPoints;
+	TArray<int32> FreePoints;
 
 	// Cache of segments for projection snapping and hit testing
 	struct FSnapSegment
@@ -71,11 +152,123 @@ private:
 	};
 
 	TArray<FSnapSegment> SnapSegments;
+	TArray<int32> FreeSegments; // Removed slots (WallId invalid), reused by later adds
+
+	// Arc walls, queried analytically
+	struct FSnapArc
+	{
+		FRTPlanArc Arc;
+		FBox2D Bounds = FBox2D(ForceInit);
+		FGuid WallId;
+	};
+
+	TArray<FSnapArc> SnapArcs;
+	TArray<int32> FreeArcs;
+
+	// Opening footprint (OffsetCm .. OffsetCm + WidthCm along the host wall, wall thickness across),
+	// precomputed when the opening or its wall is indexed
+	struct FOpeningFootprint
+	{
+		FGuid OpeningId;
+		FGuid WallId;
+		FVector2D Center = FVector2D::ZeroVector;
+		FBox2D Bounds = FBox2D(ForceInit);
+		float HalfThickness = 0.0f;
+
+		// Straight walls: oriented rectangle
+		FVector2D Axis = FVector2D(1.0, 0.0); // Unit, along the wall
+		float HalfLength = 0.0f;
+
+		// Arc walls: the covered part of the wall's center arc
+		bool bArc = false;
+		FRTPlanArc Arc;
 
-	// Unique coordinates for alignment guides
-	TArray<float> UniqueX;
-	TArray<float> UniqueY;
+		// Height range of the hole (world Z)
+		float ZMin = 0.0f;
+		float ZMax = 0.0f;
+
+		double Distance(const FVector2D& P) const;
+		bool IntersectsRect(const FVector2D& RectMin, const FVector2D& RectMax) const;
+	};
+
+	TArray<FOpeningFootprint> Openings;
+	TArray<int32> FreeOpenings;
+
+	// Index entries owned by each entity, so updates touch only those
+	struct FWallEntry
+	{
+		int32 MidPoint = INDEX_NONE;
+		int32 Arc = INDEX_NONE; // Arc walls
+		TArray<int32, TInlineAllocator<1>> Segments; // Straight walls
+		bool bExtension = false; // Straight wall registered as an extension guide
+		TArray<FGuid, TInlineAllocator<2>> Openings; // Hosted openings indexed with this wall
+
+		// Extrusion, for ray picking
+		float HalfThickness = 0.0f;
+		float BaseZ = 0.0f;
+		float Height = 0.0f;
+
+		// End cuts as the wall mesher solves them (see FRTPlanWallEnd), i.e. offsets along the wall (the end tangent
+		// for arcs) of the left / right face at A (Start) and B (End). Free ends are cut square at the vertex.
+		float StartLeft = 0.0f;
+		float StartRight = 0.0f;
+		float EndLeft = 0.0f;
+		float EndRight = 0.0f;
+
+		// Junctions the wall took part in, re-cut when it goes away
+		FGuid VertexAId;
+		FGuid VertexBId;
+	};
+
+	TMap<FGuid, int32> VertexPoints;
+	TMap<FGuid, FWallEntry> WallEntries;
+	TMap<FGuid, int32> OpeningEntries;
+
+	// Acceleration grids (items are indices into SnapPoints / SnapSegments / SnapArcs)
+	FRTPlanSpatialGrid PointGrid;
+	FRTPlanSpatialGrid SegmentGrid;
+	FRTPlanSpatialGrid ArcGrid;
+	FRTPlanSpatialGrid OpeningGrid; // Footprint bounds
+
+	// Conservative extent of all wall volumes (grown on add, reset on build) bounding ray marches
+	FBox WallVolumeBounds = FBox(ForceInit);
+	// Farthest any wall volume reaches from its indexed centre line / arc (half thickness, end cut corners)
+	float MaxWallReach = 0.0f;
+
+	void ResetStorage(float CellSize);
+	FWallEntry& AddWallGeometry(const FRTWall& Wall, const FVector2D& A, const FVector2D& B);
+
+	// Resolves a wall and its endpoint positions from the plan being indexed, or nullptr if it is gone / disconnected
+	using FResolveWall = TFunctionRef<const FRTWall*(const FGuid& WallId, FVector2D& OutA, FVector2D& OutB)>;
+
+	// Cut a wall's ends against the walls meeting at its endpoints, as the wall mesher does
+	void SolveWallEnds(FWallEntry& Entry, const FRTWall& Wall, const FVector2D& A, const FVector2D& B,
+		TConstArrayView<FGuid> WallsAtA, TConstArrayView<FGuid> WallsAtB, FResolveWall ResolveWall);
+	// Re-solve the end cuts of the indexed walls at a vertex (one of their neighbours changed)
+	void UpdateJunctionEnds(const FGuid& VertexId, const FGuid& SkipWallId = FGuid());
+	void UpdateVertexPoint(const FGuid& VertexId);
+
+	int32 AddPoint(const FVector2D& Position, ERTSnapType Type, bool bAlignment, const FGuid& VertexId, const FGuid& WallId);
+
+	// Score the given candidates into OutCandidates
+	template<typename PointListType, typename SegmentListType, typename ArcListType>
+	void ScoreSnapCandidates(const FRTSnapQuery& Query, const PointListType& Points, const SegmentListType& Segments, const ArcListType& Arcs, FRTSnapCandidates& OutCandidates) const;
+	void RemovePoint(int32 Index);
+	int32 AddSegment(const FVector2D& A, const FVector2D& B, const FGuid& WallId);
+	void RemoveSegment(int32 Index);
+	int32 AddArc(const FRTPlanArc& Arc, const FGuid& WallId);
+	void RemoveArc(int32 Index);
+	void AddOpening(const FRTOpening& Opening, const FRTWall& Wall, FWallEntry& WallEntry);
+	void RemoveOpening(const FGuid& OpeningId);
+
+	// Ray against one wall's volume, closer than OutHit (or MaxT when there is no hit yet)
+	void RaycastWall(const FGuid& WallId, const FWallEntry& Entry, const FVector& Origin, const FVector& Direction, double MaxT, bool bHitOpenings, FRTPlanRayHit& OutHit) const;
+
+	// Sorted alignment guides (X / Y through points, wall extensions)
+	FRTPlanAlignmentIndex Alignment;
 
 	// Cached document reference for hit testing
 	const URTPlanDocument* CachedDocument = nullptr;
+
+	uint32 Version = 0;
 };
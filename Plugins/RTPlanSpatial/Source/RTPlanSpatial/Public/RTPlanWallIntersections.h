@@ -0,0 +1,95 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "RTPlanDocument.h"
+#include "RTPlanArc.h"
+#include "RTPlanDelta.h"
+#include "RTPlanSpatialGrid.h"
+
+/**
+ * RTPlanWallIntersections.h
+ * All crossings between walls (straight / straight, straight / arc, arc / arc), cached against the
+ * document revision, so trim / extend look up the cut parameters of a wall instead of testing it
+ * against every other wall. Walls live in a uniform grid: each wall is only tested against the walls
+ * in the cells its bounds overlap, and an edit re-tests just the walls in the document's change log.
+ */
+
+// A crossing on one wall
+struct FRTWallCrossing
+{
+	// Parameter along the wall: 0 at VertexA, 1 at VertexB (fraction of the sweep on arc walls)
+	double T = 0.0;
+	FGuid OtherWallId;
+};
+
+class RTPLANSPATIAL_API FRTPlanWallIntersections
+{
+public:
+	// Bring the cache up to the document revision: the changed walls only, or a full build for a new
+	// document (or once the change log no longer reaches back to the cached revision).
+	// Returns true if anything was recomputed.
+	bool Update(const URTPlanDocument* Document);
+
+	void Build(const URTPlanDocument* Document);
+	void Reset();
+
+	// Crossings strictly inside the wall (shared endpoints excluded), sorted by T
+	TConstArrayView<FRTWallCrossing> GetCrossings(const FGuid& WallId) const;
+
+	// Wall parameter of a point on (or near) the wall, with the same convention as FRTWallCrossing::T
+	static double GetWallParameter(const FRTWall& Wall, const FVector2D& A, const FVector2D& B, const FVector2D& Point);
+
+	// Arc walls as the spatial index treats them (straight otherwise)
+	static bool IsArcWall(const FRTWall& Wall) { return Wall.bIsArc && FMath::Abs(Wall.ArcSweepAngle) > 0.1f; }
+
+	// Stats of the last build or update
+	int32 GetNumIntersections() const { return NumIntersections; }
+	int32 GetNumPairTests() const { return NumPairTests; }
+
+	// Crossings closer than this (in T) to a wall end are junctions, not cuts
+	static constexpr double EndpointTolerance = UE_KINDA_SMALL_NUMBER;
+
+private:
+	struct FPrimitive
+	{
+		FGuid WallId;
+		FVector2D A = FVector2D::ZeroVector;
+		FVector2D B = FVector2D::ZeroVector;
+		bool bArc = false;
+		FRTPlanArc Arc;
+		FBox2D Bounds = FBox2D(ForceInit);
+	};
+
+	struct FWallCrossings
+	{
+		TArray<FRTWallCrossing> All;  // One entry per crossing wall, so removing a wall can't drop a shared cut
+		TArray<FRTWallCrossing> Cuts; // All sorted by T, crossings in one point merged (GetCrossings)
+	};
+
+	void ApplyDelta(const URTPlanDocument* Document, const FRTPlanDelta& Delta);
+
+	// Test the wall against the walls already in the grid, then add it
+	void AddPrimitive(const FRTWall& Wall, const FVector2D& A, const FVector2D& B);
+	// Drop the wall and every crossing other walls recorded with it
+	void RemovePrimitive(const FGuid& WallId);
+	// Re-derive Cuts for the walls whose crossings changed
+	void RefreshCuts();
+
+	void TestPair(const FPrimitive& First, const FPrimitive& Second);
+	void AddCrossing(const FPrimitive& Wall, const FVector2D& Point, const FGuid& OtherWallId);
+
+	TArray<FPrimitive> Primitives;
+	TArray<int32> FreePrimitives;
+	TMap<FGuid, int32> PrimitiveIndices;
+	FRTPlanSpatialGrid Grid;
+
+	TMap<FGuid, FWallCrossings> Crossings;
+	TSet<FGuid> ChangedCrossings;
+
+	const URTPlanDocument* CachedDocument = nullptr;
+	uint64 CachedRevision = 0;
+	bool bBuilt = false;
+
+	int32 NumIntersections = 0;
+	int32 NumPairTests = 0;
+};
@@ -45,33 +45,53 @@ bool URTPlanToolBase::GetGroundIntersection(const FRTPointerEvent& Event, FVecto
 	return true;
 }
 
-FVector2D URTPlanToolBase::GetSnappedPoint(const FVector& WorldPoint, float SnapRadius) const
+bool URTPlanToolBase::IsSpatialIndexCurrent() const
+{
+	const URTPlanToolManager* ToolManager = Cast<URTPlanToolManager>(GetOuter());
+	return ToolManager ? ToolManager->IsSpatialIndexCurrent() : true;
+}
+
+FVector2D URTPlanToolBase::GetSnappedPoint(const FVector& WorldPoint, float SnapRadius, const FVector2D* From, ERTSnapType* OutType) const
 {
 	FVector2D CursorPos(WorldPoint.X, WorldPoint.Y);
 
 	URTPlanToolManager* ToolManager = Cast<URTPlanToolManager>(GetOuter());
 	bool bSnapEnabled = ToolManager ? ToolManager->IsSnapEnabled() : true;
 	bool bGridEnabled = ToolManager ? ToolManager->IsGridEnabled() : true;
+	const float GridSize = ToolManager ? ToolManager->GridSize : FRTSnapQuery::DefaultGridSize;
 
-	if (bSnapEnabled && SpatialIndex)
+	FRTSnapQuery Query;
+	Query.Cursor = CursorPos;
+	Query.Radius = SnapRadius;
+	if (From)
+	{
+		Query.From = *From;
+	}
+	if (bGridEnabled && GridSize > 0.0f)
 	{
-		FRTSnapResult Snap = SpatialIndex->QuerySnap(CursorPos, SnapRadius);
-		if (Snap.bValid)
-		{
-			return Snap.Location;
-		}
+		// Grid tier: only used when no geometry snap is in reach
+		Query.GridSize = GridSize;
 	}
 
-	if (bGridEnabled)
+	FRTSnapResult Snap;
+	if (bSnapEnabled && SpatialIndex)
+	{
+		FRTSnapCandidates Candidates;
+		SpatialIndex->QuerySnapCandidates(Query, Candidates, &SnapCache);
+		Snap = Candidates.GetBest();
+	}
+	else if (Query.GridSize > 0.0f)
 	{
-		// Fallback: Grid Snap (e.g. 10cm)
-		// TODO: Make grid size configurable
-		float GridSize = 100.0f;
-		return FVector2D(
-			FMath::RoundToFloat(CursorPos.X / GridSize) * GridSize,
-			FMath::RoundToFloat(CursorPos.Y / GridSize) * GridSize
-		);
+		FRTSnapCandidates Candidates;
+		Candidates.Add(ERTSnapType::Grid, FVector2D(
+			FMath::RoundToDouble(CursorPos.X / Query.GridSize) * Query.GridSize,
+			FMath::RoundToDouble(CursorPos.Y / Query.GridSize) * Query.GridSize), 0.0f);
+		Snap = Candidates.GetBest();
 	}
 
-	return CursorPos;
+	if (OutType)
+	{
+		*OutType = Snap.bValid ? Snap.Type : ERTSnapType::None;
+	}
+	return Snap.bValid ? Snap.Location : CursorPos;
 }
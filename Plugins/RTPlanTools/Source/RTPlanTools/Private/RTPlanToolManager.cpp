@@ -4,6 +4,7 @@
 #include "Tools/RTPlanTrimTool.h"
 #include "Tools/RTPlanArcTool.h"
 #include "RTPlanCommand.h"
+#include "Async/Async.h"
 
 void URTPlanToolManager::Initialize(URTPlanDocument* InDoc)
 {
@@ -11,7 +12,7 @@ void URTPlanToolManager::Initialize(URTPlanDocument* InDoc)
 	if (Document)
 	{
 		// Listen for changes to rebuild the index
-		Document->OnPlanChanged.AddDynamic(this, &URTPlanToolManager::UpdateSpatialIndex);
+		Document->OnPlanChanged.AddDynamic(this, &URTPlanToolManager::OnPlanChanged);
 	}
 	
 	UpdateSpatialIndex();
@@ -160,8 +161,8 @@ void URTPlanToolManager::DeleteSelection()
 		return;
 	}
 
-	// TODO: Group into a transaction/macro command if we want single undo step
-	// For now, just submit individual commands
+	// Single undo step for the whole selection
+	FRTPlanScopedTransaction Transaction(Document, TEXT("Delete Selection"));
 
 	for (const FGuid& WallId : SelectedWalls)
 	{
@@ -180,6 +181,8 @@ void URTPlanToolManager::DeleteSelection()
 	}
 	*/
 
+	Transaction.Commit();
+
 	// Clear selection after deletion
 	CachedSelectTool->ClearSelection();
 }
@@ -196,8 +199,139 @@ void URTPlanToolManager::UpdateSpatialIndex()
 {
 	if (Document)
 	{
+		// The synchronous build supersedes whatever the worker is producing
+		if (PendingSpatialIndex.IsValid())
+		{
+			PendingSpatialIndex.Wait();
+			PendingSpatialIndex.Reset();
+		}
+
 		SpatialIndex.Build(Document);
+		SpatialIndexRevision = Document->GetRevision();
+	}
+}
+
+bool URTPlanToolManager::IsSpatialIndexCurrent() const
+{
+	return !PendingSpatialIndex.IsValid() && (!Document || SpatialIndexRevision == Document->GetRevision());
+}
+
+void URTPlanToolManager::FlushSpatialIndexBuild()
+{
+	// Finishing may start another build if the document moved on a lot in the meantime
+	while (PendingSpatialIndex.IsValid())
+	{
+		PendingSpatialIndex.Wait();
+		FinishAsyncSpatialIndexBuild();
+	}
+}
+
+void URTPlanToolManager::OnPlanChanged(const FRTPlanDelta& Delta)
+{
+	SyncSpatialIndex();
+}
+
+void URTPlanToolManager::SyncSpatialIndex()
+{
+	// A background build is in flight: its result is caught up when it is swapped in
+	if (!Document || PendingSpatialIndex.IsValid())
+	{
+		return;
+	}
+
+	// Catch up from the last synced revision (covers notifications we did not act on)
+	// Objects and runs are not part of the spatial index
+	const FRTPlanDelta Changes = Document->GetChangedSince(SpatialIndexRevision);
+	if (!Changes.AffectsWallGeometry())
+	{
+		SpatialIndexRevision = Document->GetRevision();
+		return;
+	}
+
+	const int32 NumChanged = Changes.bFullRebuild
+		? Document->GetData().Walls.Num()
+		: Changes.Walls.Num() + Changes.Vertices.Num();
+	if (AsyncRebuildThreshold > 0 && NumChanged > AsyncRebuildThreshold)
+	{
+		StartAsyncSpatialIndexBuild();
+		return;
 	}
+
+	// Only the touched walls / vertices are re-indexed (full rebuild deltas fall back to Build)
+	SpatialIndex.ApplyDelta(Changes);
+	SpatialIndexRevision = Document->GetRevision();
+}
+
+void URTPlanToolManager::StartAsyncSpatialIndexBuild()
+{
+	// The snapshot is immutable, so the worker never touches the document
+	const FRTPlanSnapshotRef Snapshot = Document->GetSnapshot();
+	PendingSpatialIndexRevision = Snapshot->Revision;
+
+	PendingSpatialIndex = Async(EAsyncExecution::ThreadPool, [Snapshot]()
+	{
+		TSharedPtr<FRTPlanSpatialIndex, ESPMode::ThreadSafe> Built = MakeShared<FRTPlanSpatialIndex, ESPMode::ThreadSafe>();
+		Built->Build(*Snapshot);
+		return Built;
+	});
+
+	if (!SpatialIndexTickHandle.IsValid())
+	{
+		SpatialIndexTickHandle = FTSTicker::GetCoreTicker().AddTicker(
+			FTickerDelegate::CreateUObject(this, &URTPlanToolManager::TickSpatialIndexBuild));
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("ToolManager: Rebuilding spatial index in the background (revision %llu)"), PendingSpatialIndexRevision);
+}
+
+void URTPlanToolManager::FinishAsyncSpatialIndexBuild()
+{
+	TSharedPtr<FRTPlanSpatialIndex, ESPMode::ThreadSafe> Built = PendingSpatialIndex.Get();
+	PendingSpatialIndex.Reset();
+
+	// Swap on the game thread: tools keep their pointer to SpatialIndex, only its contents change
+	if (Built.IsValid())
+	{
+		SpatialIndex.MoveFrom(MoveTemp(*Built));
+		SpatialIndex.SetDocument(Document);
+		SpatialIndexRevision = PendingSpatialIndexRevision;
+	}
+
+	// Apply the edits made while the worker was busy
+	SyncSpatialIndex();
+}
+
+bool URTPlanToolManager::TickSpatialIndexBuild(float DeltaTime)
+{
+	if (PendingSpatialIndex.IsValid() && PendingSpatialIndex.IsReady())
+	{
+		FinishAsyncSpatialIndexBuild();
+	}
+
+	if (!PendingSpatialIndex.IsValid())
+	{
+		SpatialIndexTickHandle.Reset();
+		return false;
+	}
+	return true;
+}
+
+void URTPlanToolManager::BeginDestroy()
+{
+	if (SpatialIndexTickHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(SpatialIndexTickHandle);
+		SpatialIndexTickHandle.Reset();
+	}
+
+	// The worker owns its own index and snapshot; just make sure it is done before we go
+	if (PendingSpatialIndex.IsValid())
+	{
+		PendingSpatialIndex.Wait();
+		PendingSpatialIndex.Reset();
+	}
+
+	Super::BeginDestroy();
 }
 
 void URTPlanToolManager::ToggleSnap()
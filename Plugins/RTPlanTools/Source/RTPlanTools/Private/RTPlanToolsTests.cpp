@@ -3,6 +3,7 @@
 #include "RTPlanToolManager.h"
 #include "Tools/RTPlanLineTool.h"
 #include "RTPlanDocument.h"
+#include "RTPlanEditList.h"
 
 IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRTPlanToolsLineTest, "ArchVis.RTPlanTools.LineTool", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
 
@@ -69,3 +70,66 @@ bool FRTPlanToolsLineTest::RunTest(const FString& Parameters)
 
 	return true;
 }
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRTPlanToolsAsyncSpatialIndexTest, "ArchVis.RTPlanTools.AsyncSpatialIndex", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FRTPlanToolsAsyncSpatialIndexTest::RunTest(const FString& Parameters)
+{
+	URTPlanDocument* Doc = NewObject<URTPlanDocument>();
+	URTPlanToolManager* ToolMgr = NewObject<URTPlanToolManager>();
+	ToolMgr->AsyncRebuildThreshold = 10;
+	ToolMgr->Initialize(Doc);
+	ToolMgr->SelectTool(URTPlanLineTool::StaticClass());
+	TestTrue("Empty plan is current", ToolMgr->IsSpatialIndexCurrent());
+
+	// A row of 20 walls in one edit goes to the worker
+	FRTPlanEditList Edits;
+	FGuid PrevId;
+	for (int32 i = 0; i <= 20; ++i)
+	{
+		FRTVertex V; V.Id = FGuid::NewGuid(); V.Position = FVector2D(i * 100.0f, 0.0f);
+		Edits.SetVertex(V);
+		if (PrevId.IsValid())
+		{
+			FRTWall W; W.Id = FGuid::NewGuid(); W.VertexAId = PrevId; W.VertexBId = V.Id;
+			Edits.SetWall(W);
+		}
+		PrevId = V.Id;
+	}
+	Doc->SubmitEdits(MoveTemp(Edits), TEXT("Add Row"));
+
+	TestFalse("Index lags while the worker builds", ToolMgr->IsSpatialIndexCurrent());
+	TestFalse("Tools see the stale flag", ToolMgr->GetActiveTool()->IsSpatialIndexCurrent());
+
+	// An edit made during the build is caught up when the result is swapped in
+	FRTPlanEditList Late;
+	FRTVertex Extra; Extra.Id = FGuid::NewGuid(); Extra.Position = FVector2D(0.0f, 500.0f);
+	FRTWall Spur; Spur.Id = FGuid::NewGuid(); Spur.VertexAId = PrevId; Spur.VertexBId = Extra.Id;
+	Late.SetVertex(Extra);
+	Late.SetWall(Spur);
+	Doc->SubmitEdits(MoveTemp(Late), TEXT("Add Spur"));
+
+	ToolMgr->FlushSpatialIndexBuild();
+	TestTrue("Current after the swap", ToolMgr->IsSpatialIndexCurrent());
+	TestTrue("Tools see the current flag", ToolMgr->GetActiveTool()->IsSpatialIndexCurrent());
+
+	// Snapping through the tool uses the swapped-in index (endpoint at (1000,0), spur endpoint at (0,500))
+	FRTPointerEvent Move;
+	Move.Action = ERTPointerAction::Move;
+	Move.WorldOrigin = FVector(1004, 3, 1000);
+	Move.WorldDirection = FVector(0, 0, -1);
+	ToolMgr->ProcessInput(Move);
+	TestTrue("Snapped to a rebuilt endpoint", ToolMgr->GetActiveTool()->GetSnappedCursorPos().Equals(FVector(1000, 0, 0), 0.1));
+
+	Move.WorldOrigin = FVector(3, 504, 1000);
+	ToolMgr->ProcessInput(Move);
+	TestTrue("Snapped to the late edit", ToolMgr->GetActiveTool()->GetSnappedCursorPos().Equals(FVector(0, 500, 0), 0.1));
+
+	// Small edits stay synchronous
+	FRTPlanEditList Small;
+	Small.RemoveWall(Spur.Id);
+	Doc->SubmitEdits(MoveTemp(Small), TEXT("Remove Spur"));
+	TestTrue("Small edit applied in place", ToolMgr->IsSpatialIndexCurrent());
+
+	return true;
+}
@@ -162,16 +162,12 @@ void URTPlanArcTool::OnPointerEvent(const FRTPointerEvent& Event)
 
 	if (Event.bSnapEnabled)
 	{
-		SnappedPos = GetSnappedPoint(GroundPoint);
+		ERTSnapType SnapType = ERTSnapType::None;
+		SnappedPos = GetSnappedPoint(GroundPoint, 20.0f, nullptr, &SnapType);
 		
 		if (SpatialIndex)
 		{
-			FRTSnapResult HardSnap = SpatialIndex->QuerySnap(CursorPos, 20.0f);
-			if (HardSnap.bValid)
-			{
-				SnappedPos = HardSnap.Location;
-			}
-			else
+			if (SnapType == ERTSnapType::None || SnapType == ERTSnapType::Grid)
 			{
 				FVector2D AlignedPos;
 				if (SpatialIndex->QueryAlignment(CursorPos, 20.0f, AlignedPos))
@@ -408,6 +404,9 @@ void URTPlanArcTool::CommitArc()
 	UE_LOG(LogRTPlanArcTool, Log, TEXT("Committing Arc: Start=%s, End=%s, Center=%s, Radius=%.1f, Sweep=%.1f"), 
 		*StartPoint.ToString(), *EndPoint.ToString(), *CenterPoint.ToString(), Radius, SweepAngleDegrees);
 
+	// One undo step / one rebuild for the whole arc
+	FRTPlanScopedTransaction Transaction(Document, TEXT("Add Arc Wall"));
+
 	// Create start vertex
 	FRTVertex V1;
 	V1.Id = FGuid::NewGuid();
@@ -438,6 +437,7 @@ void URTPlanArcTool::CommitArc()
 	URTCmdAddWall* CmdWall = NewObject<URTCmdAddWall>();
 	CmdWall->Wall = ArcWall;
 	Document->SubmitCommand(CmdWall);
+	Transaction.Commit();
 
 	// Reset tool
 	State = EState::WaitingForStart;
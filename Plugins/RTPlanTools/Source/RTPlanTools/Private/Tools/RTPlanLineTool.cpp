@@ -43,6 +43,17 @@ FRTDraftingState URTPlanLineTool::GetDraftingState() const
 	DraftState.LengthCm = CachedLengthCm;
 	DraftState.AngleDegrees = CachedAngleDegrees;
 	DraftState.bOrthoSnapped = bIsOrthoSnapped;
+
+	// Only while the cursor still sits on the guides (ortho / angle constraints may have moved it off)
+	if (CurrentEndPoint.Equals(AlignedGuidePoint, 0.1f))
+	{
+		for (const FRTAlignmentGuide& Guide : ActiveGuides)
+		{
+			FRTDraftingGuide& DraftGuide = DraftState.AlignmentGuides.AddDefaulted_GetRef();
+			DraftGuide.Source = Guide.Source;
+			DraftGuide.Target = AlignedGuidePoint;
+		}
+	}
 	return DraftState;
 }
 
@@ -304,23 +315,25 @@ void URTPlanLineTool::OnPointerEvent(const FRTPointerEvent& Event)
 
 	FVector2D CursorPos(GroundPoint.X, GroundPoint.Y);
 	FVector2D SnappedPos = CursorPos;
+	ActiveGuides.Reset();
 
 	// Only apply snapping if snap is enabled
 	if (Event.bSnapEnabled)
 	{
-		// 1. Base Snap (Vertex/Grid)
-		SnappedPos = GetSnappedPoint(GroundPoint);
+		// 1. Base Snap (Geometry/Grid); perpendicular to the wall being drawn once the start is placed
+		ERTSnapType SnapType = ERTSnapType::None;
+		SnappedPos = GetSnappedPoint(GroundPoint, 20.0f, State == EState::WaitingForEnd ? &StartPoint : nullptr, &SnapType);
 
-		// 2. Soft Alignment Snap (if not snapped to vertex)
+		// 2. Soft Alignment Snap (if not snapped to geometry)
 		if (SpatialIndex)
 		{
-			FRTSnapResult HardSnap = SpatialIndex->QuerySnap(CursorPos, 20.0f);
-			if (!HardSnap.bValid)
+			if (SnapType == ERTSnapType::None || SnapType == ERTSnapType::Grid)
 			{
 				FVector2D AlignedPos;
-				if (SpatialIndex->QueryAlignment(CursorPos, 20.0f, AlignedPos))
+				if (SpatialIndex->QueryAlignment(CursorPos, 20.0f, AlignedPos, &ActiveGuides))
 				{
 					SnappedPos = AlignedPos;
+					AlignedGuidePoint = AlignedPos;
 				}
 			}
 		}
@@ -480,9 +493,17 @@ void URTPlanLineTool::CommitWallSegment(bool bContinuePolyline)
 	FRTWall NewWall; NewWall.Id = FGuid::NewGuid(); NewWall.VertexAId = V1.Id; NewWall.VertexBId = V2.Id;
 	NewWall.ThicknessCm = 20.0f; NewWall.HeightCm = 300.0f;
 
-	URTCmdAddVertex* CmdV1 = NewObject<URTCmdAddVertex>(); CmdV1->Vertex = V1; Document->SubmitCommand(CmdV1);
-	URTCmdAddVertex* CmdV2 = NewObject<URTCmdAddVertex>(); CmdV2->Vertex = V2; Document->SubmitCommand(CmdV2);
-	URTCmdAddWall* CmdWall = NewObject<URTCmdAddWall>(); CmdWall->Wall = NewWall; Document->SubmitCommand(CmdWall);
+	// One undo step / one rebuild for the whole segment
+	{
+		FRTPlanScopedTransaction Transaction(Document, TEXT("Add Wall"));
+		URTCmdAddVertex* CmdV1 = NewObject<URTCmdAddVertex>(); CmdV1->Vertex = V1; Document->SubmitCommand(CmdV1);
+		URTCmdAddVertex* CmdV2 = NewObject<URTCmdAddVertex>(); CmdV2->Vertex = V2; Document->SubmitCommand(CmdV2);
+		URTCmdAddWall* CmdWall = NewObject<URTCmdAddWall>(); CmdWall->Wall = NewWall; Document->SubmitCommand(CmdWall);
+		if (!Transaction.Commit())
+		{
+			return;
+		}
+	}
 
 	// Track placed elements for undo
 	PlacedVertexIds.Add(V1.Id);
@@ -2,8 +2,6 @@
 #include "RTPlanSpatialIndex.h"
 #include "DrawDebugHelpers.h"
 #include "Engine/World.h"
-#include "CollisionQueryParams.h"
-#include "Engine/EngineTypes.h"
 
 DEFINE_LOG_CATEGORY(LogRTPlanSelectTool);
 
@@ -279,49 +277,30 @@ bool URTPlanSelectTool::GetWorldPosition(const FRTPointerEvent& Event, FVector&
 
 bool URTPlanSelectTool::PerformLineTrace(const FRTPointerEvent& Event, FVector& OutHitLocation) const
 {
-	if (!GWorld) return false;
+	if (!SpatialIndex) return false;
 	
-	FVector TraceStart = Event.WorldOrigin;
-	FVector TraceEnd = Event.WorldOrigin + Event.WorldDirection * 100000.0f;
+	const double MaxDistance = 100000.0;
 	
-	FHitResult HitResult;
-	FCollisionQueryParams QueryParams;
-	QueryParams.bTraceComplex = true;
-	QueryParams.bReturnFaceIndex = false;
+	// Openings count as solid so clicking a door / window selects it rather than what is behind
+	FRTPlanRayHit Hit;
+	const bool bHit = SpatialIndex->Raycast(Event.WorldOrigin, Event.WorldDirection, MaxDistance, Hit, true);
 	
-	// Ignore the pawn
-	if (GWorld->GetFirstPlayerController())
-	{
-		if (APawn* Pawn = GWorld->GetFirstPlayerController()->GetPawn())
-		{
-			QueryParams.AddIgnoredActor(Pawn);
-		}
-	}
-	
-	bool bHit = GWorld->LineTraceSingleByChannel(
-		HitResult,
-		TraceStart,
-		TraceEnd,
-		ECC_Visibility,
-		QueryParams
-	);
-	
-	if (bDebugEnabled)
+	if (bDebugEnabled && GWorld)
 	{
 		// Draw the trace line
-		DrawDebugLine(GWorld, TraceStart, bHit ? HitResult.ImpactPoint : TraceEnd, 
+		const FVector TraceEnd = Event.WorldOrigin + Event.WorldDirection.GetSafeNormal() * MaxDistance;
+		DrawDebugLine(GWorld, Event.WorldOrigin, bHit ? Hit.Location : TraceEnd, 
 			bHit ? FColor::Green : FColor::Red, false, 3.0f, 0, 2.0f);
 		
 		if (bHit)
 		{
 			// Draw hit point
-			DrawDebugSphere(GWorld, HitResult.ImpactPoint, 15.0f, 12, FColor::Green, false, 3.0f);
-			DrawDebugLine(GWorld, HitResult.ImpactPoint, HitResult.ImpactPoint + HitResult.ImpactNormal * 50.0f, 
+			DrawDebugSphere(GWorld, Hit.Location, 15.0f, 12, FColor::Green, false, 3.0f);
+			DrawDebugLine(GWorld, Hit.Location, Hit.Location + Hit.Normal * 50.0f, 
 				FColor::Blue, false, 3.0f, 0, 2.0f);
 			
-			UE_LOG(LogRTPlanSelectTool, Log, TEXT("LineTrace: Hit %s at (%0.1f, %0.1f, %0.1f)"),
-				*HitResult.GetActor()->GetName(),
-				HitResult.ImpactPoint.X, HitResult.ImpactPoint.Y, HitResult.ImpactPoint.Z);
+			UE_LOG(LogRTPlanSelectTool, Log, TEXT("LineTrace: Hit wall %s at (%0.1f, %0.1f, %0.1f)"),
+				*Hit.WallId.ToString(), Hit.Location.X, Hit.Location.Y, Hit.Location.Z);
 		}
 		else
 		{
@@ -331,7 +310,7 @@ bool URTPlanSelectTool::PerformLineTrace(const FRTPointerEvent& Event, FVector&
 	
 	if (bHit)
 	{
-		OutHitLocation = HitResult.ImpactPoint;
+		OutHitLocation = Hit.Location;
 		return true;
 	}
 	
@@ -4,8 +4,6 @@
 #include "RTPlanCommand.h"
 #include "DrawDebugHelpers.h"
 #include "Engine/World.h"
-#include "CollisionQueryParams.h"
-#include "Engine/EngineTypes.h"
 
 DEFINE_LOG_CATEGORY(LogRTPlanTrimTool);
 
@@ -156,6 +154,7 @@ void URTPlanTrimTool::PerformMarqueeTrim()
 
 	// Fence trim: Find all walls intersected by the fence line (MarqueeStartWorld -> MarqueeEndWorld)
 	// For each intersected wall, trim the segment that was crossed.
+	// All spans are resolved against the current plan and applied as one edit.
 
 	const FRTPlanData& Data = Document->GetData();
 	FVector2D FenceStart = MarqueeStartWorld;
@@ -172,7 +171,8 @@ void URTPlanTrimTool::PerformMarqueeTrim()
 
 	TArray<FGuid> CandidateWalls = SpatialIndex->HitTestWallsInRect(Min, Max);
 	
-	bool bAnyTrim = false;
+	FRTPlanEditList Edits;
+	int32 NumTrimmed = 0;
 
 	for (const FGuid& WallId : CandidateWalls)
 	{
@@ -183,307 +183,202 @@ void URTPlanTrimTool::PerformMarqueeTrim()
 		const FRTVertex* V2 = Data.Vertices.Find(Wall->VertexBId);
 		if (!V1 || !V2) continue;
 
-		if (Wall->bIsArc)
+		// Fence crossings on this wall (an arc can be crossed twice)
+		FVector2D Hits[2];
+		int32 NumHits = 0;
+		if (FRTPlanWallIntersections::IsArcWall(*Wall))
 		{
-			// Handle arc wall intersection with fence line
-			FVector2D ArcCenter = Wall->ArcCenter;
-			float Radius = FVector2D::Distance(ArcCenter, V1->Position);
-			
-			// Find line-circle intersections
-			FVector2D D = FenceEnd - FenceStart;
-			FVector2D F = FenceStart - ArcCenter;
-			
-			float a = D | D;
-			float b = 2.0f * (F | D);
-			float c = (F | F) - Radius * Radius;
-			
-			float Discriminant = b * b - 4.0f * a * c;
-			
-			if (Discriminant >= 0 && a > KINDA_SMALL_NUMBER)
-			{
-				float SqrtDisc = FMath::Sqrt(Discriminant);
-				float T1 = (-b - SqrtDisc) / (2.0f * a);
-				float T2 = (-b + SqrtDisc) / (2.0f * a);
-				
-				for (float T : { T1, T2 })
-				{
-					if (T >= 0.0f && T <= 1.0f)
-					{
-						FVector2D Intersection = FenceStart + D * T;
-						
-						// Check if intersection is within arc sweep
-						FVector2D ToIntersect = Intersection - ArcCenter;
-						float IntersectAngle = FMath::Atan2(ToIntersect.Y, ToIntersect.X);
-						
-						FVector2D ToStart = V1->Position - ArcCenter;
-						float StartAngle = FMath::Atan2(ToStart.Y, ToStart.X);
-						
-						float AngleDiff = IntersectAngle - StartAngle;
-						float SweepRad = FMath::DegreesToRadians(Wall->ArcSweepAngle);
-						
-						if (SweepRad > 0)
-						{
-							while (AngleDiff < 0) AngleDiff += 2.0f * PI;
-							while (AngleDiff > 2.0f * PI) AngleDiff -= 2.0f * PI;
-						}
-						else
-						{
-							while (AngleDiff > 0) AngleDiff -= 2.0f * PI;
-							while (AngleDiff < -2.0f * PI) AngleDiff += 2.0f * PI;
-						}
-						
-						float ArcT = AngleDiff / SweepRad;
-						if (ArcT >= 0.0f && ArcT <= 1.0f)
-						{
-							TrimArcWallAtPoint(WallId, Intersection);
-							bAnyTrim = true;
-						}
-					}
-				}
-			}
+			const FRTPlanArc Arc = FRTPlanArc::FromCenterStartSweep(Wall->ArcCenter, V1->Position, Wall->ArcSweepAngle);
+			NumHits = Arc.IntersectSegment(FenceStart, FenceEnd, Hits);
+		}
+		else if (FRTPlanGeometryUtils::SegmentIntersection(FenceStart, FenceEnd, V1->Position, V2->Position, Hits[0]))
+		{
+			NumHits = 1;
 		}
-		else
+
+		TArray<TPair<float, float>> Spans;
+		for (int32 i = 0; i < NumHits; ++i)
 		{
-			FVector2D Intersection;
-			if (FRTPlanGeometryUtils::SegmentIntersection(FenceStart, FenceEnd, V1->Position, V2->Position, Intersection))
+			float StartT, EndT;
+			if (FindTrimSpan(WallId, Hits[i], StartT, EndT))
 			{
-				TrimWallAtPoint(WallId, Intersection);
-				bAnyTrim = true;
+				Spans.AddUnique(TPair<float, float>(StartT, EndT));
 			}
 		}
+
+		if (Spans.Num() > 0)
+		{
+			AddWallTrim(Edits, WallId, MoveTemp(Spans));
+			++NumTrimmed;
+		}
 	}
 
-	if (bAnyTrim)
+	if (NumTrimmed > 0)
 	{
-		UE_LOG(LogRTPlanTrimTool, Log, TEXT("Fence trim completed"));
+		Document->SubmitEdits(MoveTemp(Edits), TEXT("Fence Trim"));
+		UE_LOG(LogRTPlanTrimTool, Log, TEXT("Fence trim completed (%d walls)"), NumTrimmed);
 	}
 }
 
 void URTPlanTrimTool::FindIntersectionsOnWall(const FGuid& WallId, TArray<float>& OutIntersections) const
 {
 	if (!Document) return;
-	const FRTPlanData& Data = Document->GetData();
-	
-	const FRTWall* TargetWall = Data.Walls.Find(WallId);
-	if (!TargetWall) return;
-	
-	const FRTVertex* V1 = Data.Vertices.Find(TargetWall->VertexAId);
-	const FRTVertex* V2 = Data.Vertices.Find(TargetWall->VertexBId);
-	if (!V1 || !V2) return;
-	
-	FVector2D A = V1->Position;
-	FVector2D B = V2->Position;
-	
-	// Add endpoints (0 and 1)
+
+	// Crossings of the whole plan are cached; edits since the last call re-test only the changed walls
+	Intersections.Update(Document);
+
+	// Endpoints (0 and 1) plus the interior crossings, already sorted
+	const TConstArrayView<FRTWallCrossing> Crossings = Intersections.GetCrossings(WallId);
+	OutIntersections.Reserve(OutIntersections.Num() + Crossings.Num() + 2);
 	OutIntersections.Add(0.0f);
-	OutIntersections.Add(1.0f);
-	
-	// Check against all other walls
-	for (const auto& Pair : Data.Walls)
+	for (const FRTWallCrossing& Crossing : Crossings)
 	{
-		if (Pair.Key == WallId) continue; // Skip self
-		
-		const FRTWall& OtherWall = Pair.Value;
-		const FRTVertex* OV1 = Data.Vertices.Find(OtherWall.VertexAId);
-		const FRTVertex* OV2 = Data.Vertices.Find(OtherWall.VertexBId);
-		
-		if (OV1 && OV2)
-		{
-			FVector2D Intersection;
-			if (FRTPlanGeometryUtils::SegmentIntersection(A, B, OV1->Position, OV2->Position, Intersection))
-			{
-				// Calculate T along target wall
-				FVector2D AB = B - A;
-				float LengthSq = AB.SizeSquared();
-				if (LengthSq > KINDA_SMALL_NUMBER)
-				{
-					float T = ((Intersection - A) | AB) / LengthSq;
-					
-					// Use a slightly larger epsilon to avoid treating endpoints as intersections
-					// unless they are true T-junctions.
-					// However, for T-junctions (where one wall ends exactly on another),
-					// SegmentIntersection might return true.
-					// We want to include these points if they are strictly inside the segment [0,1]
-					// OR if they are endpoints that connect to other geometry.
-					
-					// For trim logic, we care about points that divide the wall into segments.
-					// Endpoints (0 and 1) are already added.
-					// So we only add strictly interior points.
-					if (T > KINDA_SMALL_NUMBER && T < 1.0f - KINDA_SMALL_NUMBER)
-					{
-						OutIntersections.Add(T);
-					}
-				}
-			}
-		}
+		OutIntersections.Add((float)Crossing.T);
 	}
-	
-	// Sort intersections
-	OutIntersections.Sort();
+	OutIntersections.Add(1.0f);
 }
 
-void URTPlanTrimTool::TrimWallAtPoint(const FGuid& WallId, const FVector2D& ClickPoint)
+bool URTPlanTrimTool::FindTrimSpan(const FGuid& WallId, const FVector2D& Point, float& OutStartT, float& OutEndT) const
 {
-	if (!Document) return;
+	if (!Document) return false;
 	const FRTPlanData& Data = Document->GetData();
-	
+
 	const FRTWall* Wall = Data.Walls.Find(WallId);
-	if (!Wall) return;
-	
+	if (!Wall) return false;
+
 	const FRTVertex* V1 = Data.Vertices.Find(Wall->VertexAId);
 	const FRTVertex* V2 = Data.Vertices.Find(Wall->VertexBId);
-	if (!V1 || !V2) return;
-	
-	// Handle arc walls separately
-	if (Wall->bIsArc && FMath::Abs(Wall->ArcSweepAngle) > 0.1f)
-	{
-		TrimArcWallAtPoint(WallId, ClickPoint);
-		return;
-	}
-	
-	// Calculate T of click point for straight walls
-	FVector2D A = V1->Position;
-	FVector2D B = V2->Position;
-	FVector2D Closest = FRTPlanGeometryUtils::ClosestPointOnSegment(ClickPoint, A, B);
-	
-	FVector2D AB = B - A;
-	float LengthSq = AB.SizeSquared();
-	float ClickT = 0.5f;
-	if (LengthSq > KINDA_SMALL_NUMBER)
-	{
-		ClickT = ((Closest - A) | AB) / LengthSq;
-	}
-	
+	if (!V1 || !V2) return false;
+
+	// Point as T along the wall (fraction of the sweep on arcs)
+	const float ClickT = (float)FRTPlanWallIntersections::GetWallParameter(*Wall, V1->Position, V2->Position, Point);
+
 	// Find all intersections
-	TArray<float> Intersections;
-	FindIntersectionsOnWall(WallId, Intersections);
-	
+	TArray<float> Cuts;
+	FindIntersectionsOnWall(WallId, Cuts);
+
 	// Find the segment containing ClickT
-	float StartT = 0.0f;
-	float EndT = 1.0f;
-	
-	// Robustness fix: Handle cases where ClickT is very close to an intersection
-	// If ClickT is essentially equal to an intersection, we need to decide which side to trim.
-	// Usually, the user clicks slightly "inside" the segment they want to remove.
-	// But if they click exactly on a T-junction, it's ambiguous.
-	// For now, assume standard behavior.
+	OutStartT = 0.0f;
+	OutEndT = 1.0f;
 	
-	for (int32 i = 0; i < Intersections.Num() - 1; ++i)
+	// If ClickT is essentially equal to an intersection (a click exactly on a T-junction is ambiguous),
+	// the first span touching it wins.
+	for (int32 i = 0; i < Cuts.Num() - 1; ++i)
 	{
 		// Use a small epsilon for comparison to handle precision issues
-		if (ClickT >= Intersections[i] - KINDA_SMALL_NUMBER && ClickT <= Intersections[i+1] + KINDA_SMALL_NUMBER)
+		if (ClickT >= Cuts[i] - KINDA_SMALL_NUMBER && ClickT <= Cuts[i+1] + KINDA_SMALL_NUMBER)
 		{
-			StartT = Intersections[i];
-			EndT = Intersections[i+1];
+			OutStartT = Cuts[i];
+			OutEndT = Cuts[i+1];
 			break;
 		}
 	}
 	
-	// Edge case fix: If StartT and EndT are effectively the same (due to multiple intersections at same point),
-	// expand to find a valid segment.
-	if (FMath::IsNearlyEqual(StartT, EndT))
+	// Edge case: If StartT and EndT are effectively the same (due to multiple intersections at same point)
+	if (FMath::IsNearlyEqual(OutStartT, OutEndT))
 	{
 		UE_LOG(LogRTPlanTrimTool, Warning, TEXT("Trim segment collapsed (StartT ~ EndT). Aborting trim."));
+		return false;
+	}
+
+	UE_LOG(LogRTPlanTrimTool, Log, TEXT("Trim segment: T [%0.2f, %0.2f], ClickT=%0.2f"), OutStartT, OutEndT, ClickT);
+	return true;
+}
+
+void URTPlanTrimTool::TrimWallAtPoint(const FGuid& WallId, const FVector2D& ClickPoint)
+{
+	float StartT, EndT;
+	if (!FindTrimSpan(WallId, ClickPoint, StartT, EndT))
+	{
 		return;
 	}
 
-	UE_LOG(LogRTPlanTrimTool, Log, TEXT("Trim segment: T [%0.2f, %0.2f]"), StartT, EndT);
-	
-	// Create macro command
-	URTCmdMacro* MacroCmd = NewObject<URTCmdMacro>();
-	MacroCmd->Description = TEXT("Trim Wall");
-	MacroCmd->Document = Document;
-	
-	// Case 1: Trim entire wall (0 to 1) -> Delete wall
-	if (FMath::IsNearlyEqual(StartT, 0.0f) && FMath::IsNearlyEqual(EndT, 1.0f))
+	// Collect all edits into one batch command
+	FRTPlanEditList Edits;
+	AddWallTrim(Edits, WallId, { TPair<float, float>(StartT, EndT) });
+
+	Document->SubmitEdits(MoveTemp(Edits), TEXT("Trim Wall"));
+}
+
+void URTPlanTrimTool::AddWallTrim(FRTPlanEditList& Edits, const FGuid& WallId, TArray<TPair<float, float>> Spans) const
+{
+	const FRTPlanData& Data = Document->GetData();
+
+	const FRTWall* Wall = Data.Walls.Find(WallId);
+	if (!Wall) return;
+
+	const FRTVertex* V1 = Data.Vertices.Find(Wall->VertexAId);
+	const FRTVertex* V2 = Data.Vertices.Find(Wall->VertexBId);
+	if (!V1 || !V2) return;
+
+	const bool bArc = FRTPlanWallIntersections::IsArcWall(*Wall);
+	const FRTPlanArc Arc = bArc ? FRTPlanArc::FromCenterStartSweep(Wall->ArcCenter, V1->Position, Wall->ArcSweepAngle) : FRTPlanArc();
+	auto GetPoint = [&](float T)
+	{
+		return bArc ? Arc.GetPoint(T) : V1->Position + (V2->Position - V1->Position) * T;
+	};
+
+	// Pieces that remain: the complement of the removed spans
+	Spans.Sort([](const TPair<float, float>& Lhs, const TPair<float, float>& Rhs) { return Lhs.Key < Rhs.Key; });
+
+	TArray<TPair<float, float>, TInlineAllocator<4>> Pieces;
+	float Cursor = 0.0f;
+	for (const TPair<float, float>& Span : Spans)
 	{
-		URTCmdDeleteWall* DelCmd = NewObject<URTCmdDeleteWall>();
-		DelCmd->WallId = WallId;
-		MacroCmd->AddCommand(DelCmd);
+		if (Span.Key - Cursor > KINDA_SMALL_NUMBER)
+		{
+			Pieces.Emplace(Cursor, Span.Key);
+		}
+		Cursor = FMath::Max(Cursor, Span.Value);
 	}
-	// Case 2: Trim start (0 to T) -> Update Vertex A
-	else if (FMath::IsNearlyEqual(StartT, 0.0f))
+	if (1.0f - Cursor > KINDA_SMALL_NUMBER)
 	{
-		// We need to move Vertex A to EndT
-		FVector2D NewPos = A + AB * EndT;
-		
-		FGuid NewVertexId = FGuid::NewGuid();
-		FRTVertex NewVertex;
-		NewVertex.Id = NewVertexId;
-		NewVertex.Position = NewPos;
-		
-		URTCmdAddVertex* AddVertCmd = NewObject<URTCmdAddVertex>();
-		AddVertCmd->Vertex = NewVertex;
-		MacroCmd->AddCommand(AddVertCmd);
-		
-		// Update wall to use new vertex A
-		URTCmdAddWall* UpdateWallCmd = NewObject<URTCmdAddWall>();
-		UpdateWallCmd->Wall = *Wall;
-		UpdateWallCmd->Wall.VertexAId = NewVertexId;
-		UpdateWallCmd->bIsNew = false;
-		MacroCmd->AddCommand(UpdateWallCmd);
+		Pieces.Emplace(Cursor, 1.0f);
 	}
-	// Case 3: Trim end (T to 1) -> Update Vertex B
-	else if (FMath::IsNearlyEqual(EndT, 1.0f))
+
+	// Whole wall trimmed -> Delete wall
+	if (Pieces.Num() == 0)
 	{
-		// We need to move Vertex B to StartT
-		FVector2D NewPos = A + AB * StartT;
-		
-		FGuid NewVertexId = FGuid::NewGuid();
-		FRTVertex NewVertex;
-		NewVertex.Id = NewVertexId;
-		NewVertex.Position = NewPos;
-		
-		URTCmdAddVertex* AddVertCmd = NewObject<URTCmdAddVertex>();
-		AddVertCmd->Vertex = NewVertex;
-		MacroCmd->AddCommand(AddVertCmd);
-		
-		// Update wall to use new vertex B
-		URTCmdAddWall* UpdateWallCmd = NewObject<URTCmdAddWall>();
-		UpdateWallCmd->Wall = *Wall;
-		UpdateWallCmd->Wall.VertexBId = NewVertexId;
-		UpdateWallCmd->bIsNew = false;
-		MacroCmd->AddCommand(UpdateWallCmd);
+		Edits.RemoveWall(WallId);
+		return;
 	}
-	// Case 4: Trim middle (T1 to T2) -> Split into two walls
-	else
+
+	// Each piece keeps the original ends it still reaches; cut ends get new vertices.
+	// Arc pieces keep the center and take their share of the sweep.
+	for (int32 i = 0; i < Pieces.Num(); ++i)
 	{
-		// Original wall becomes Wall 1 (0 to StartT)
-		// New wall becomes Wall 2 (EndT to 1)
-		
-		FVector2D Pos1 = A + AB * StartT;
-		FVector2D Pos2 = A + AB * EndT;
-		
-		// Create two new vertices
-		FGuid V1Id = FGuid::NewGuid();
-		FGuid V2Id = FGuid::NewGuid();
-		
-		FRTVertex Vert1; Vert1.Id = V1Id; Vert1.Position = Pos1;
-		FRTVertex Vert2; Vert2.Id = V2Id; Vert2.Position = Pos2;
-		
-		URTCmdAddVertex* AddV1 = NewObject<URTCmdAddVertex>(); AddV1->Vertex = Vert1; MacroCmd->AddCommand(AddV1);
-		URTCmdAddVertex* AddV2 = NewObject<URTCmdAddVertex>(); AddV2->Vertex = Vert2; MacroCmd->AddCommand(AddV2);
-		
-		// Update original wall to end at V1
-		URTCmdAddWall* UpdateOriginal = NewObject<URTCmdAddWall>();
-		UpdateOriginal->Wall = *Wall;
-		UpdateOriginal->Wall.VertexBId = V1Id;
-		UpdateOriginal->bIsNew = false;
-		MacroCmd->AddCommand(UpdateOriginal);
-		
-		// Create new wall starting at V2
-		FRTWall NewWall = *Wall;
-		NewWall.Id = FGuid::NewGuid();
-		NewWall.VertexAId = V2Id;
-		// VertexBId remains original B
-		
-		URTCmdAddWall* AddNewWall = NewObject<URTCmdAddWall>();
-		AddNewWall->Wall = NewWall;
-		AddNewWall->bIsNew = true;
-		MacroCmd->AddCommand(AddNewWall);
+		const float StartT = Pieces[i].Key;
+		const float EndT = Pieces[i].Value;
+
+		FRTWall Piece = *Wall;
+		if (i > 0)
+		{
+			Piece.Id = FGuid::NewGuid();
+		}
+
+		if (!FMath::IsNearlyEqual(StartT, 0.0f))
+		{
+			FRTVertex NewVertex;
+			NewVertex.Id = FGuid::NewGuid();
+			NewVertex.Position = GetPoint(StartT);
+			Edits.SetVertex(NewVertex);
+			Piece.VertexAId = NewVertex.Id;
+		}
+		if (!FMath::IsNearlyEqual(EndT, 1.0f))
+		{
+			FRTVertex NewVertex;
+			NewVertex.Id = FGuid::NewGuid();
+			NewVertex.Position = GetPoint(EndT);
+			Edits.SetVertex(NewVertex);
+			Piece.VertexBId = NewVertex.Id;
+		}
+		if (bArc)
+		{
+			Piece.ArcSweepAngle = Wall->ArcSweepAngle * (EndT - StartT);
+		}
+
+		Edits.SetWall(Piece);
 	}
-	
-	Document->SubmitCommand(MacroCmd);
 }
 
 bool URTPlanTrimTool::GetWorldPosition(const FRTPointerEvent& Event, FVector& OutWorldPos3D, FVector2D& OutWorldPos2D) const
@@ -541,328 +436,15 @@ bool URTPlanTrimTool::GetWorldPosition(const FRTPointerEvent& Event, FVector& Ou
 
 bool URTPlanTrimTool::PerformLineTrace(const FRTPointerEvent& Event, FVector& OutHitLocation) const
 {
-	if (!GWorld) return false;
-	
-	FVector TraceStart = Event.WorldOrigin;
-	FVector TraceEnd = Event.WorldOrigin + Event.WorldDirection * 100000.0f;
-	
-	FHitResult HitResult;
-	FCollisionQueryParams QueryParams;
-	QueryParams.bTraceComplex = true;
-	QueryParams.bReturnFaceIndex = false;
-	
-	// Ignore the pawn
-	if (GWorld->GetFirstPlayerController())
-	{
-		if (APawn* Pawn = GWorld->GetFirstPlayerController()->GetPawn())
-		{
-			QueryParams.AddIgnoredActor(Pawn);
-		}
-	}
+	if (!SpatialIndex) return false;
 	
-	bool bHit = GWorld->LineTraceSingleByChannel(
-		HitResult,
-		TraceStart,
-		TraceEnd,
-		ECC_Visibility,
-		QueryParams
-	);
-	
-	if (bHit)
+	// Openings count as solid: a click on a door still lands on its host wall
+	FRTPlanRayHit Hit;
+	if (SpatialIndex->Raycast(Event.WorldOrigin, Event.WorldDirection, 100000.0, Hit, true))
 	{
-		OutHitLocation = HitResult.ImpactPoint;
+		OutHitLocation = Hit.Location;
 		return true;
 	}
 	
 	return false;
 }
-
-void URTPlanTrimTool::FindIntersectionsOnArcWall(const FGuid& WallId, TArray<float>& OutIntersections) const
-{
-	if (!Document) return;
-	const FRTPlanData& Data = Document->GetData();
-	
-	const FRTWall* TargetWall = Data.Walls.Find(WallId);
-	if (!TargetWall || !TargetWall->bIsArc) return;
-	
-	const FRTVertex* V1 = Data.Vertices.Find(TargetWall->VertexAId);
-	const FRTVertex* V2 = Data.Vertices.Find(TargetWall->VertexBId);
-	if (!V1 || !V2) return;
-	
-	FVector2D A = V1->Position;
-	FVector2D ArcCenter = TargetWall->ArcCenter;
-	float Radius = FVector2D::Distance(ArcCenter, A);
-	
-	FVector2D ToStart = A - ArcCenter;
-	float StartAngleRad = FMath::Atan2(ToStart.Y, ToStart.X);
-	float SweepRad = FMath::DegreesToRadians(TargetWall->ArcSweepAngle);
-	
-	// Add endpoints (0 and 1)
-	OutIntersections.Add(0.0f);
-	OutIntersections.Add(1.0f);
-	
-	// Check against all other walls for intersections
-	for (const auto& Pair : Data.Walls)
-	{
-		if (Pair.Key == WallId) continue; // Skip self
-		
-		const FRTWall& OtherWall = Pair.Value;
-		const FRTVertex* OV1 = Data.Vertices.Find(OtherWall.VertexAId);
-		const FRTVertex* OV2 = Data.Vertices.Find(OtherWall.VertexBId);
-		
-		if (!OV1 || !OV2) continue;
-		
-		FVector2D OtherA = OV1->Position;
-		FVector2D OtherB = OV2->Position;
-		
-		// Find line-circle intersections
-		// Line from OtherA to OtherB, circle at ArcCenter with Radius
-		FVector2D D = OtherB - OtherA;
-		FVector2D F = OtherA - ArcCenter;
-		
-		float a = D | D;
-		float b = 2.0f * (F | D);
-		float c = (F | F) - Radius * Radius;
-		
-		float Discriminant = b * b - 4.0f * a * c;
-		
-		if (Discriminant >= 0 && a > KINDA_SMALL_NUMBER)
-		{
-			float SqrtDisc = FMath::Sqrt(Discriminant);
-			
-			// Two potential intersection points
-			float T1 = (-b - SqrtDisc) / (2.0f * a);
-			float T2 = (-b + SqrtDisc) / (2.0f * a);
-			
-			for (float T : { T1, T2 })
-			{
-				// Check if intersection is within the line segment
-				if (T >= -KINDA_SMALL_NUMBER && T <= 1.0f + KINDA_SMALL_NUMBER)
-				{
-					FVector2D IntersectionPoint = OtherA + D * T;
-					
-					// Check if intersection is within the arc's angular range
-					FVector2D ToIntersect = IntersectionPoint - ArcCenter;
-					float IntersectAngle = FMath::Atan2(ToIntersect.Y, ToIntersect.X);
-					
-					// Calculate angle difference from start
-					float AngleDiff = IntersectAngle - StartAngleRad;
-					
-					// Normalize to the sweep direction
-					if (SweepRad > 0)
-					{
-						while (AngleDiff < 0) AngleDiff += 2.0f * PI;
-						while (AngleDiff > 2.0f * PI) AngleDiff -= 2.0f * PI;
-					}
-					else
-					{
-						while (AngleDiff > 0) AngleDiff -= 2.0f * PI;
-						while (AngleDiff < -2.0f * PI) AngleDiff += 2.0f * PI;
-					}
-					
-					// Calculate T along arc (0 to 1)
-					float ArcT = AngleDiff / SweepRad;
-					
-					// Only include strictly interior points
-					if (ArcT > KINDA_SMALL_NUMBER && ArcT < 1.0f - KINDA_SMALL_NUMBER)
-					{
-						OutIntersections.Add(ArcT);
-					}
-				}
-			}
-		}
-	}
-	
-	// Sort intersections
-	OutIntersections.Sort();
-}
-
-void URTPlanTrimTool::TrimArcWallAtPoint(const FGuid& WallId, const FVector2D& ClickPoint)
-{
-	if (!Document) return;
-	const FRTPlanData& Data = Document->GetData();
-	
-	const FRTWall* Wall = Data.Walls.Find(WallId);
-	if (!Wall || !Wall->bIsArc) return;
-	
-	const FRTVertex* V1 = Data.Vertices.Find(Wall->VertexAId);
-	const FRTVertex* V2 = Data.Vertices.Find(Wall->VertexBId);
-	if (!V1 || !V2) return;
-	
-	FVector2D A = V1->Position;
-	FVector2D ArcCenter = Wall->ArcCenter;
-	float Radius = FVector2D::Distance(ArcCenter, A);
-	float SweepAngleDeg = Wall->ArcSweepAngle;
-	float SweepRad = FMath::DegreesToRadians(SweepAngleDeg);
-	
-	FVector2D ToStart = A - ArcCenter;
-	float StartAngleRad = FMath::Atan2(ToStart.Y, ToStart.X);
-	
-	// Calculate click position as T along the arc (0 to 1)
-	// Project click point onto the arc by finding the closest point
-	FVector2D ToClick = ClickPoint - ArcCenter;
-	float ClickAngle = FMath::Atan2(ToClick.Y, ToClick.X);
-	
-	// Calculate angle difference from start
-	float AngleDiff = ClickAngle - StartAngleRad;
-	
-	// Normalize to the sweep direction
-	if (SweepRad > 0)
-	{
-		while (AngleDiff < 0) AngleDiff += 2.0f * PI;
-		while (AngleDiff > 2.0f * PI) AngleDiff -= 2.0f * PI;
-		// Handle case where angle wrapped around
-		if (AngleDiff > SweepRad + 0.1f)
-		{
-			AngleDiff -= 2.0f * PI;
-		}
-	}
-	else
-	{
-		while (AngleDiff > 0) AngleDiff -= 2.0f * PI;
-		while (AngleDiff < -2.0f * PI) AngleDiff += 2.0f * PI;
-		if (AngleDiff < SweepRad - 0.1f)
-		{
-			AngleDiff += 2.0f * PI;
-		}
-	}
-	
-	float ClickT = FMath::Clamp(AngleDiff / SweepRad, 0.0f, 1.0f);
-	
-	// Find all intersections on the arc
-	TArray<float> Intersections;
-	FindIntersectionsOnArcWall(WallId, Intersections);
-	
-	// Find the segment containing ClickT
-	float StartT = 0.0f;
-	float EndT = 1.0f;
-	
-	for (int32 i = 0; i < Intersections.Num() - 1; ++i)
-	{
-		if (ClickT >= Intersections[i] - KINDA_SMALL_NUMBER && ClickT <= Intersections[i+1] + KINDA_SMALL_NUMBER)
-		{
-			StartT = Intersections[i];
-			EndT = Intersections[i+1];
-			break;
-		}
-	}
-	
-	if (FMath::IsNearlyEqual(StartT, EndT))
-	{
-		UE_LOG(LogRTPlanTrimTool, Warning, TEXT("Arc trim segment collapsed. Aborting."));
-		return;
-	}
-	
-	UE_LOG(LogRTPlanTrimTool, Log, TEXT("Arc Trim: T [%0.2f, %0.2f], ClickT=%0.2f"), StartT, EndT, ClickT);
-	
-	// Create macro command
-	URTCmdMacro* MacroCmd = NewObject<URTCmdMacro>();
-	MacroCmd->Description = TEXT("Trim Arc Wall");
-	MacroCmd->Document = Document;
-	
-	// Case 1: Trim entire arc (0 to 1) -> Delete wall
-	if (FMath::IsNearlyEqual(StartT, 0.0f) && FMath::IsNearlyEqual(EndT, 1.0f))
-	{
-		URTCmdDeleteWall* DelCmd = NewObject<URTCmdDeleteWall>();
-		DelCmd->WallId = WallId;
-		MacroCmd->AddCommand(DelCmd);
-	}
-	// Case 2: Trim start of arc (0 to EndT) -> Move VertexA and adjust sweep angle
-	else if (FMath::IsNearlyEqual(StartT, 0.0f))
-	{
-		// Calculate new start position at EndT along the arc
-		float NewStartAngle = StartAngleRad + SweepRad * EndT;
-		FVector2D NewPos = ArcCenter + FVector2D(FMath::Cos(NewStartAngle), FMath::Sin(NewStartAngle)) * Radius;
-		
-		FGuid NewVertexId = FGuid::NewGuid();
-		FRTVertex NewVertex;
-		NewVertex.Id = NewVertexId;
-		NewVertex.Position = NewPos;
-		
-		URTCmdAddVertex* AddVertCmd = NewObject<URTCmdAddVertex>();
-		AddVertCmd->Vertex = NewVertex;
-		MacroCmd->AddCommand(AddVertCmd);
-		
-		// Update wall with new start vertex and adjusted sweep angle
-		URTCmdAddWall* UpdateWallCmd = NewObject<URTCmdAddWall>();
-		UpdateWallCmd->Wall = *Wall;
-		UpdateWallCmd->Wall.VertexAId = NewVertexId;
-		// New sweep angle covers the remaining portion (1 - EndT) of original sweep
-		UpdateWallCmd->Wall.ArcSweepAngle = SweepAngleDeg * (1.0f - EndT);
-		UpdateWallCmd->bIsNew = false;
-		MacroCmd->AddCommand(UpdateWallCmd);
-	}
-	// Case 3: Trim end of arc (StartT to 1) -> Move VertexB and adjust sweep angle
-	else if (FMath::IsNearlyEqual(EndT, 1.0f))
-	{
-		// Calculate new end position at StartT along the arc
-		float NewEndAngle = StartAngleRad + SweepRad * StartT;
-		FVector2D NewPos = ArcCenter + FVector2D(FMath::Cos(NewEndAngle), FMath::Sin(NewEndAngle)) * Radius;
-		
-		FGuid NewVertexId = FGuid::NewGuid();
-		FRTVertex NewVertex;
-		NewVertex.Id = NewVertexId;
-		NewVertex.Position = NewPos;
-		
-		URTCmdAddVertex* AddVertCmd = NewObject<URTCmdAddVertex>();
-		AddVertCmd->Vertex = NewVertex;
-		MacroCmd->AddCommand(AddVertCmd);
-		
-		// Update wall with new end vertex and adjusted sweep angle
-		URTCmdAddWall* UpdateWallCmd = NewObject<URTCmdAddWall>();
-		UpdateWallCmd->Wall = *Wall;
-		UpdateWallCmd->Wall.VertexBId = NewVertexId;
-		// New sweep angle covers the first portion (StartT) of original sweep
-		UpdateWallCmd->Wall.ArcSweepAngle = SweepAngleDeg * StartT;
-		UpdateWallCmd->bIsNew = false;
-		MacroCmd->AddCommand(UpdateWallCmd);
-	}
-	// Case 4: Trim middle of arc (StartT to EndT) -> Split into two arcs
-	else
-	{
-		// Calculate positions at StartT and EndT
-		float Angle1 = StartAngleRad + SweepRad * StartT;
-		float Angle2 = StartAngleRad + SweepRad * EndT;
-		
-		FVector2D Pos1 = ArcCenter + FVector2D(FMath::Cos(Angle1), FMath::Sin(Angle1)) * Radius;
-		FVector2D Pos2 = ArcCenter + FVector2D(FMath::Cos(Angle2), FMath::Sin(Angle2)) * Radius;
-		
-		// Create two new vertices
-		FGuid V1Id = FGuid::NewGuid();
-		FGuid V2Id = FGuid::NewGuid();
-		
-		FRTVertex Vert1; Vert1.Id = V1Id; Vert1.Position = Pos1;
-		FRTVertex Vert2; Vert2.Id = V2Id; Vert2.Position = Pos2;
-		
-		URTCmdAddVertex* AddV1 = NewObject<URTCmdAddVertex>(); 
-		AddV1->Vertex = Vert1; 
-		MacroCmd->AddCommand(AddV1);
-		
-		URTCmdAddVertex* AddV2 = NewObject<URTCmdAddVertex>(); 
-		AddV2->Vertex = Vert2; 
-		MacroCmd->AddCommand(AddV2);
-		
-		// Update original arc wall to end at V1 (covers 0 to StartT)
-		URTCmdAddWall* UpdateOriginal = NewObject<URTCmdAddWall>();
-		UpdateOriginal->Wall = *Wall;
-		UpdateOriginal->Wall.VertexBId = V1Id;
-		UpdateOriginal->Wall.ArcSweepAngle = SweepAngleDeg * StartT;
-		UpdateOriginal->bIsNew = false;
-		MacroCmd->AddCommand(UpdateOriginal);
-		
-		// Create new arc wall from V2 to original B (covers EndT to 1)
-		FRTWall NewWall = *Wall;
-		NewWall.Id = FGuid::NewGuid();
-		NewWall.VertexAId = V2Id;
-		// VertexBId remains original B
-		NewWall.ArcSweepAngle = SweepAngleDeg * (1.0f - EndT);
-		
-		URTCmdAddWall* AddNewWall = NewObject<URTCmdAddWall>();
-		AddNewWall->Wall = NewWall;
-		AddNewWall->bIsNew = true;
-		MacroCmd->AddCommand(AddNewWall);
-	}
-	
-	Document->SubmitCommand(MacroCmd);
-}
-
@@ -47,6 +47,10 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "RTPlan|Tools")
 	virtual FVector GetSnappedCursorPos() const { return LastSnappedWorldPos; }
 
+	// False while the spatial index is being rebuilt in the background (snaps / picks may be one revision stale)
+	UFUNCTION(BlueprintCallable, Category = "RTPlan|Tools")
+	bool IsSpatialIndexCurrent() const;
+
 protected:
 	UPROPERTY(Transient)
 	TObjectPtr<URTPlanDocument> Document;
@@ -61,5 +65,9 @@ protected:
 	bool GetGroundIntersection(const FRTPointerEvent& Event, FVector& OutPoint) const;
 
 	// Helper: Snap a world point to the grid/geometry using the Spatial Index
-	FVector2D GetSnappedPoint(const FVector& WorldPoint, float SnapRadius = 20.0f) const;
+	// From: reference point for perpendicular snaps. OutType: the tier that won (None if unsnapped).
+	FVector2D GetSnappedPoint(const FVector& WorldPoint, float SnapRadius = 20.0f, const FVector2D* From = nullptr, ERTSnapType* OutType = nullptr) const;
+
+	// Candidate set reused between consecutive cursor snaps
+	mutable FRTSnapQueryCache SnapCache;
 };
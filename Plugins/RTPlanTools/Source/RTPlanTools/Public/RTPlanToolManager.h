@@ -5,6 +5,8 @@
 #include "RTPlanToolBase.h"
 #include "RTPlanDocument.h"
 #include "RTPlanSpatialIndex.h"
+#include "Async/Future.h"
+#include "Containers/Ticker.h"
 #include "RTPlanToolManager.generated.h"
 
 /**
@@ -25,6 +27,9 @@ class URTPlanSelectTool;
 
 /**
  * Manages the active tool and routes input.
+ * Owns the spatial index: small edits are applied incrementally, large rebuilds run on a worker
+ * from a plan snapshot and are swapped in on the game thread once done. Until then tools keep
+ * querying the previous (consistent, possibly stale) index.
  */
 UCLASS(BlueprintType)
 class RTPLANTOOLS_API URTPlanToolManager : public UObject
@@ -69,9 +74,26 @@ public:
 	void DeleteSelection();
 
 	// Call this every frame or when document changes to keep spatial index fresh
+	// Synchronous full rebuild (drops any pending background build)
 	UFUNCTION()
 	void UpdateSpatialIndex();
 
+	// False while the index lags the document (a background rebuild is in flight)
+	UFUNCTION(BlueprintCallable, Category = "RTPlan|Tools")
+	bool IsSpatialIndexCurrent() const;
+
+	// Block until a pending background rebuild is swapped in (tests, save, commands needing exact picks)
+	void FlushSpatialIndexBuild();
+
+	// Changes touching more walls + vertices than this (or full rebuilds of plans with more walls)
+	// are indexed on a worker thread. 0 disables background rebuilds.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "RTPlan|Tools")
+	int32 AsyncRebuildThreshold = 2000;
+
+	// Grid snap spacing in world units, used by all tools while the grid is enabled
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "RTPlan|Tools", meta = (ClampMin = "1.0"))
+	float GridSize = FRTSnapQuery::DefaultGridSize;
+
 	// Toggle snapping
 	UFUNCTION(BlueprintCallable, Category = "RTPlan|Tools")
 	void ToggleSnap();
@@ -96,7 +118,19 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "RTPlan|Tools")
 	bool IsGridEnabled() const { return bGridEnabled; }
 
+	virtual void BeginDestroy() override;
+
 private:
+	// Rebuilds the spatial index when wall geometry changed
+	UFUNCTION()
+	void OnPlanChanged(const FRTPlanDelta& Delta);
+
+	// Bring the index up to the document revision (incrementally, or by starting a background build)
+	void SyncSpatialIndex();
+	void StartAsyncSpatialIndexBuild();
+	void FinishAsyncSpatialIndexBuild();
+	bool TickSpatialIndexBuild(float DeltaTime);
+
 	UPROPERTY(Transient)
 	TObjectPtr<URTPlanDocument> Document;
 
@@ -113,6 +147,14 @@ private:
 	// The spatial index is owned here
 	FRTPlanSpatialIndex SpatialIndex;
 
+	// Document revision the spatial index was last synced to
+	uint64 SpatialIndexRevision = 0;
+
+	// Background rebuild in flight (built from the snapshot at PendingSpatialIndexRevision)
+	TFuture<TSharedPtr<FRTPlanSpatialIndex, ESPMode::ThreadSafe>> PendingSpatialIndex;
+	uint64 PendingSpatialIndexRevision = 0;
+	FTSTicker::FDelegateHandle SpatialIndexTickHandle;
+
 	// Snapping state
 	bool bSnapEnabled = true;
 
@@ -123,6 +123,10 @@ private:
 	float CachedLengthCm = 0.0f;
 	float CachedAngleDegrees = 0.0f;
 
+	// Alignment guides the cursor snapped to, and the aligned position (for HUD)
+	TArray<FRTAlignmentGuide> ActiveGuides;
+	FVector2D AlignedGuidePoint = FVector2D::ZeroVector;
+
 	// Apply soft ortho snap - snaps to 0/90/180/270 if within threshold, otherwise free angle
 	FVector2D ApplySoftOrthoSnap(const FVector2D& Start, const FVector2D& End);
 
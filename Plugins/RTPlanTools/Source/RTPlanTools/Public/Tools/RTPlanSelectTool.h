@@ -159,6 +159,6 @@ private:
 	// OutWorldPos2D contains the 2D plan coordinates (for selection logic).
 	bool GetWorldPosition(const FRTPointerEvent& Event, FVector& OutWorldPos3D, FVector2D& OutWorldPos2D) const;
 	
-	// Helper: Perform 3D line trace for selection
+	// Helper: Pick the wall / opening volumes along the pointer ray (analytic, via the spatial index; no collision needed)
 	bool PerformLineTrace(const FRTPointerEvent& Event, FVector& OutHitLocation) const;
 };
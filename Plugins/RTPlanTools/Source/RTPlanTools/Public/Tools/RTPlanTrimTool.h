@@ -2,6 +2,7 @@
 
 #include "CoreMinimal.h"
 #include "RTPlanToolBase.h"
+#include "RTPlanWallIntersections.h"
 #include "RTPlanTrimTool.generated.h"
 
 DECLARE_LOG_CATEGORY_EXTERN(LogRTPlanTrimTool, Log, All);
@@ -83,20 +84,23 @@ private:
 	// Helper: Get world position from pointer event
 	bool GetWorldPosition(const FRTPointerEvent& Event, FVector& OutWorldPos3D, FVector2D& OutWorldPos2D) const;
 	
-	// Helper: Perform 3D line trace for selection
+	// Helper: Pick the wall / opening volumes along the pointer ray (analytic, via the spatial index; no collision needed)
 	bool PerformLineTrace(const FRTPointerEvent& Event, FVector& OutHitLocation) const;
 
-	// Helper: Find intersection points on a wall
-	// Returns a sorted list of intersection points (T values 0..1) along the wall
+	// Helper: Find intersection points on a wall (straight or arc)
+	// Returns a sorted list of intersection points (T values 0..1) along the wall, including both ends
 	void FindIntersectionsOnWall(const FGuid& WallId, TArray<float>& OutIntersections) const;
 
+	// Helper: Find the span between the intersections around the given point. False if it collapsed.
+	bool FindTrimSpan(const FGuid& WallId, const FVector2D& Point, float& OutStartT, float& OutEndT) const;
+
 	// Helper: Trim a wall at the clicked point
 	void TrimWallAtPoint(const FGuid& WallId, const FVector2D& ClickPoint);
 
-	// Helper: Find intersection points on an arc wall
-	// Returns a sorted list of intersection points (T values 0..1) along the arc
-	void FindIntersectionsOnArcWall(const FGuid& WallId, TArray<float>& OutIntersections) const;
+	// Helper: Queue the edits removing the given spans (StartT, EndT) of a wall.
+	// The remaining pieces keep the wall's properties; the first keeps its Id.
+	void AddWallTrim(class FRTPlanEditList& Edits, const FGuid& WallId, TArray<TPair<float, float>> Spans) const;
 
-	// Helper: Trim an arc wall at the clicked point
-	void TrimArcWallAtPoint(const FGuid& WallId, const FVector2D& ClickPoint);
+	// Wall / wall crossings, rebuilt when the document revision changes
+	mutable FRTPlanWallIntersections Intersections;
 };
@@ -16,7 +16,7 @@ void URTPlanProperties::SetDocument(URTPlanDocument* InDoc)
 	}
 }
 
-void URTPlanProperties::OnPlanChanged()
+void URTPlanProperties::OnPlanChanged(const FRTPlanDelta& Delta)
 {
 	Refresh();
 }
@@ -23,7 +23,7 @@ public:
 
 protected:
 	UFUNCTION()
-	void OnPlanChanged();
+	void OnPlanChanged(const FRTPlanDelta& Delta);
 
 	UPROPERTY(BlueprintReadOnly, Category = "RTPlan|UI")
 	TObjectPtr<URTPlanDocument> Document;
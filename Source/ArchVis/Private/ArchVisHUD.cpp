@@ -63,6 +63,9 @@ void AArchVisHUD::DrawHUD()
 		// Vertical Line
 		DrawLine(CrosshairPos.X, 0, CrosshairPos.X, ScreenH, CrosshairColor, CrosshairThickness);
 
+		// Alignment guides (shown while placing the first point as well)
+		DrawAlignmentGuides(DraftState);
+
 		// Draw CAD-style visualization if drafting is active
 		if (DraftState.bIsActive)
 		{
@@ -235,6 +238,25 @@ void AArchVisHUD::DrawDraftingVisualization(const FRTDraftingState& DraftState,
 	DrawLabelWithBackground(AngleText, AngleLabelPos, LabelTextColor, AngleBgColor);
 }
 
+void AArchVisHUD::DrawAlignmentGuides(const FRTDraftingState& DraftState)
+{
+	for (const FRTDraftingGuide& Guide : DraftState.AlignmentGuides)
+	{
+		FVector SourceScreen = Project(FVector(Guide.Source.X, Guide.Source.Y, 0.0f));
+		FVector TargetScreen = Project(FVector(Guide.Target.X, Guide.Target.Y, 0.0f));
+
+		FVector2D Source2D(SourceScreen.X, SourceScreen.Y);
+		FVector2D Target2D(TargetScreen.X, TargetScreen.Y);
+
+		DrawDashedLine(Source2D, Target2D, AlignmentGuideColor, AlignmentGuideThickness, DashLength, GapLength);
+
+		// Small cross on the source point
+		const float S = AlignmentSourceMarkerSize;
+		DrawLine(Source2D.X - S, Source2D.Y - S, Source2D.X + S, Source2D.Y + S, AlignmentGuideColor, AlignmentGuideThickness);
+		DrawLine(Source2D.X - S, Source2D.Y + S, Source2D.X + S, Source2D.Y - S, AlignmentGuideColor, AlignmentGuideThickness);
+	}
+}
+
 void AArchVisHUD::DrawDashedLine(const FVector2D& Start, const FVector2D& End, const FLinearColor& Color, float Thickness, float DashLen, float GapLen)
 {
 	FVector2D Direction = End - Start;
@@ -12,6 +12,7 @@
  * - Dashed measurement line for length
  * - Dashed arc for angle visualization
  * - Length and angle labels with active/inactive states
+ * - Dashed alignment guides to the geometry the cursor lines up with
  */
 UCLASS()
 class ARCHVIS_API AArchVisHUD : public AHUD
@@ -95,6 +96,16 @@ protected:
 	UPROPERTY(EditAnywhere, Category = "Drafting|ArcPreview")
 	int32 ArcPreviewSegments = 32;
 
+	// --- Alignment Guides ---
+	UPROPERTY(EditAnywhere, Category = "Drafting|Alignment")
+	FLinearColor AlignmentGuideColor = FLinearColor(0.2f, 1.0f, 0.4f, 0.9f); // Green tracking lines
+
+	UPROPERTY(EditAnywhere, Category = "Drafting|Alignment")
+	float AlignmentGuideThickness = 1.0f;
+
+	UPROPERTY(EditAnywhere, Category = "Drafting|Alignment")
+	float AlignmentSourceMarkerSize = 4.0f;
+
 private:
 	// Draw a dashed line between two screen points
 	void DrawDashedLine(const FVector2D& Start, const FVector2D& End, const FLinearColor& Color, float Thickness, float DashLen, float GapLen);
@@ -116,4 +127,7 @@ private:
 
 	// Draw arc-specific drafting visualization (arc preview, chord, radius/angle labels)
 	void DrawArcDraftingVisualization(const FRTDraftingState& DraftState, const FRTNumericInputBuffer& InputBuffer);
+
+	// Draw alignment guides (dashed line from source geometry to the aligned cursor, marker at the source)
+	void DrawAlignmentGuides(const FRTDraftingState& DraftState);
 };